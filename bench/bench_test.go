@@ -0,0 +1,183 @@
+package bench
+
+import (
+	"bytes"
+	"encoding/csv"
+	"encoding/json"
+	"math/rand"
+	"slices"
+	"strings"
+	"testing"
+	"time"
+)
+
+func TestHistogramQuantiles(t *testing.T) {
+	var h Histogram
+	if h.Quantile(0.5) != 0 || h.Mean() != 0 {
+		t.Fatal("empty histogram should report zeros")
+	}
+
+	// Spread over several decades so most values land in shifted buckets
+	rng := rand.New(rand.NewSource(1))
+	vals := make([]time.Duration, 100000)
+	for i := range vals {
+		vals[i] = time.Duration(rng.ExpFloat64() * 50_000)
+		h.Record(vals[i])
+	}
+	slices.Sort(vals)
+
+	if h.Count() != uint64(len(vals)) || h.Min() != vals[0] || h.Max() != vals[len(vals)-1] {
+		t.Fatalf("count/min/max = %d/%v/%v, want %d/%v/%v",
+			h.Count(), h.Min(), h.Max(), len(vals), vals[0], vals[len(vals)-1])
+	}
+	for _, q := range []float64{0.01, 0.07, 0.5, 0.9, 0.99, 0.999, 1} {
+		want := vals[max(int(q*float64(len(vals))+0.5)-1, 0)]
+		got := h.Quantile(q)
+		// Within one bucket of the exact order statistic
+		if got < want || float64(got-want) > float64(want)/1024+1 {
+			t.Errorf("Quantile(%v) = %v, want %v within 1/1024", q, got, want)
+		}
+	}
+}
+
+func TestHistogramExactSmallValues(t *testing.T) {
+	var h Histogram
+	for v := 0; v < 100; v++ {
+		h.Record(time.Duration(v))
+	}
+	h.Record(-5)
+	if h.Min() != 0 || h.Quantile(0.5) != 49 || h.Quantile(1) != 99 {
+		t.Errorf("min/p50/p100 = %v/%v/%v, want 0/49/99", h.Min(), h.Quantile(0.5), h.Quantile(1))
+	}
+}
+
+func TestHistogramBuckets(t *testing.T) {
+	// Every value is at most its bucket's bound, and above the previous one
+	for _, v := range []uint64{0, 1, subCount - 1, subCount, subCount + 1, 4095, 4096, 1 << 30, 1<<40 + 12345, 1<<62 + 1} {
+		i := bucketOf(v)
+		if v > bucketMax(i) || (i > 0 && v <= bucketMax(i-1)) {
+			t.Errorf("value %d in bucket %d with bounds (%d, %d]", v, i, bucketMax(i-1), bucketMax(i))
+		}
+	}
+}
+
+func TestHistogramMerge(t *testing.T) {
+	var a, b, all Histogram
+	for v := 1; v <= 1000; v++ {
+		d := time.Duration(v * 1000)
+		if v%2 == 0 {
+			a.Record(d)
+		} else {
+			b.Record(d)
+		}
+		all.Record(d)
+	}
+	a.Merge(&b)
+	for _, q := range []float64{0.5, 0.99, 1} {
+		if a.Quantile(q) != all.Quantile(q) {
+			t.Errorf("merged Quantile(%v) = %v, want %v", q, a.Quantile(q), all.Quantile(q))
+		}
+	}
+	if a.Count() != all.Count() || a.Min() != all.Min() || a.Max() != all.Max() || a.Mean() != all.Mean() {
+		t.Error("merged count/min/max/mean differ")
+	}
+}
+
+var sink []byte
+
+func TestMeasure(t *testing.T) {
+	calls := 0
+	s := Measure(Options{Iterations: 200, Warmup: 5}, func() {
+		calls++
+		sink = make([]byte, 64)
+	})
+	if s.Calls != 200 || s.Latency.Count() != 200 {
+		t.Errorf("Calls = %d, recorded %d, want 200", s.Calls, s.Latency.Count())
+	}
+	// Warmup, the batch-size probe and the timed calls
+	if calls < 205 {
+		t.Errorf("fn called %d times, want at least 205", calls)
+	}
+	if a := s.AllocsPerOp(); a != 1 {
+		t.Errorf("AllocsPerOp = %v, want 1", a)
+	}
+	if none := Measure(Options{Iterations: 100}, func() {}); none.Allocs != 0 {
+		t.Errorf("empty fn: Allocs = %d, want 0", none.Allocs)
+	}
+	if s.Batch < 1 || s.Wall <= 0 {
+		t.Errorf("Batch = %d, Wall = %v", s.Batch, s.Wall)
+	}
+
+	slow := Measure(Options{Iterations: 3, MinSample: time.Microsecond}, func() { time.Sleep(50 * time.Microsecond) })
+	if slow.Batch != 1 || slow.Latency.Min() < 50*time.Microsecond {
+		t.Errorf("slow call: Batch = %d, Min = %v, want 1 and >= 50µs", slow.Batch, slow.Latency.Min())
+	}
+}
+
+func TestReportFormats(t *testing.T) {
+	cfg := &Config{Options: Options{Iterations: 10}, Format: "text", Run: "^go/"}
+	if err := cfg.Validate(); err != nil {
+		t.Fatal(err)
+	}
+	r := cfg.NewRunner("vector")
+	r.Run("go", "sum", map[string]string{"n": "100"}, func() {})
+	r.Run("cgo", "sum", map[string]string{"n": "100"}, func() {})
+	r.Run("go", "scan", map[string]string{"patterns": "8", "hit": "first"}, func() {})
+	if len(r.Results()) != 2 {
+		t.Fatalf("got %d results, want 2 (-run should drop cgo)", len(r.Results()))
+	}
+	rep := NewReport("v1", r.Results())
+
+	var buf bytes.Buffer
+	if err := rep.WriteJSON(&buf); err != nil {
+		t.Fatal(err)
+	}
+	var back Report
+	if err := json.Unmarshal(buf.Bytes(), &back); err != nil {
+		t.Fatal(err)
+	}
+	if back.Label != "v1" || len(back.Results) != 2 || back.Results[1].Params["hit"] != "first" {
+		t.Errorf("JSON round trip = %+v", back)
+	}
+
+	buf.Reset()
+	if err := rep.WriteCSV(&buf); err != nil {
+		t.Fatal(err)
+	}
+	rows, err := csv.NewReader(&buf).ReadAll()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(rows) != 3 || !slices.Contains(rows[0], "hit") || !slices.Contains(rows[0], "n") || !slices.Contains(rows[0], "p999_ns") {
+		t.Fatalf("CSV = %v", rows)
+	}
+	for _, row := range rows {
+		if len(row) != len(rows[0]) {
+			t.Errorf("CSV row %v has %d columns, header has %d", row, len(row), len(rows[0]))
+		}
+	}
+
+	buf.Reset()
+	if err := rep.WriteText(&buf); err != nil {
+		t.Fatal(err)
+	}
+	if !strings.Contains(buf.String(), "go/scan/hit=first/patterns=8") {
+		t.Errorf("text output missing benchmark name:\n%s", buf.String())
+	}
+
+	if err := (&Config{Format: "xml"}).Validate(); err == nil {
+		t.Error("expected error for unknown format")
+	}
+}
+
+func TestIntList(t *testing.T) {
+	l := IntList{1, 2}
+	if err := l.Set("100, 1000,10000"); err != nil || l.String() != "100,1000,10000" {
+		t.Errorf("Set = %v, %v", l, err)
+	}
+	for _, bad := range []string{"", "1,,2", "0", "-3", "x"} {
+		if err := l.Set(bad); err == nil {
+			t.Errorf("Set(%q) succeeded", bad)
+		}
+	}
+}
@@ -0,0 +1,8 @@
+//go:build !unix
+
+package bench
+
+import "time"
+
+// cpuTime reports CPU time as unavailable.
+func cpuTime() time.Duration { return 0 }
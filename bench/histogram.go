@@ -0,0 +1,145 @@
+// Package bench is the benchmark harness shared by the cmd/bench drivers.
+//
+// It times a function call by call into an HDR-style histogram, so tail
+// percentiles are reported rather than just a mean, measures allocations
+// and CPU time over the same calls, and writes the results as a table,
+// JSON or CSV so runs can be compared across releases.
+package bench
+
+import (
+	"math"
+	"math/bits"
+	"time"
+)
+
+// subBits sets the histogram's precision: each power-of-two range of
+// values is split into 2^(subBits-1) linear buckets, so a recorded value
+// is reported within 1/1024 (better than 3 significant digits).
+const (
+	subBits  = 11
+	subCount = 1 << subBits
+	subHalf  = subCount / 2
+)
+
+// Histogram records non-negative durations in log-linear buckets, as
+// HdrHistogram does: values below 2^subBits nanoseconds are counted
+// exactly, and every power-of-two range above that uses subHalf buckets.
+// Memory grows with the largest value recorded, to about 8KB per
+// doubling. The zero value is empty and ready to use.
+type Histogram struct {
+	counts   []uint64
+	total    uint64
+	sum      time.Duration
+	min, max time.Duration
+}
+
+// bucketOf returns the bucket index of v nanoseconds.
+func bucketOf(v uint64) int {
+	if v < subCount {
+		return int(v)
+	}
+	// v>>shift falls in [subHalf, subCount)
+	shift := bits.Len64(v) - subBits
+	return subCount + (shift-1)*subHalf + int(v>>shift) - subHalf
+}
+
+// bucketMax returns the largest value that lands in bucket i.
+func bucketMax(i int) uint64 {
+	if i < subCount {
+		return uint64(i)
+	}
+	shift := (i-subCount)/subHalf + 1
+	sub := uint64((i-subCount)%subHalf + subHalf)
+	return (sub+1)<<shift - 1
+}
+
+// Reserve sizes the histogram to record values up to d without
+// allocating.
+func (h *Histogram) Reserve(d time.Duration) {
+	if n := bucketOf(uint64(max(d, 0))) + 1; n > len(h.counts) {
+		h.counts = append(h.counts, make([]uint64, n-len(h.counts))...)
+	}
+}
+
+// Record adds one value; negative durations count as 0.
+func (h *Histogram) Record(d time.Duration) {
+	h.RecordN(d, 1)
+}
+
+// RecordN adds n occurrences of one value, as when a batch of n calls is
+// timed together and each is charged the batch's mean.
+func (h *Histogram) RecordN(d time.Duration, n uint64) {
+	if n == 0 {
+		return
+	}
+	d = max(d, 0)
+	h.Reserve(d)
+	i := bucketOf(uint64(d))
+	if h.total == 0 || d < h.min {
+		h.min = d
+	}
+	h.max = max(h.max, d)
+	h.counts[i] += n
+	h.total += n
+	h.sum += d * time.Duration(n)
+}
+
+// Count returns the number of values recorded.
+func (h *Histogram) Count() uint64 { return h.total }
+
+// Min returns the smallest value recorded, exactly.
+func (h *Histogram) Min() time.Duration { return h.min }
+
+// Max returns the largest value recorded, exactly.
+func (h *Histogram) Max() time.Duration { return h.max }
+
+// Mean returns the mean of the values recorded.
+func (h *Histogram) Mean() time.Duration {
+	if h.total == 0 {
+		return 0
+	}
+	return h.sum / time.Duration(h.total)
+}
+
+// Quantile returns the value at quantile q (0.99 for p99): the smallest
+// bucket bound that at least q of the values fall at or below, capped at
+// Max. It returns 0 for an empty histogram.
+func (h *Histogram) Quantile(q float64) time.Duration {
+	if h.total == 0 {
+		return 0
+	}
+	if q <= 0 {
+		return h.min
+	}
+	// The epsilon keeps 0.07*100 from rounding up to rank 8
+	rank := uint64(math.Ceil(q*float64(h.total) - 1e-9))
+	rank = min(max(rank, 1), h.total)
+
+	var seen uint64
+	for i, c := range h.counts {
+		seen += c
+		if seen >= rank {
+			return min(time.Duration(bucketMax(i)), h.max)
+		}
+	}
+	return h.max
+}
+
+// Merge adds every value recorded in o.
+func (h *Histogram) Merge(o *Histogram) {
+	if o.total == 0 {
+		return
+	}
+	if len(o.counts) > len(h.counts) {
+		h.counts = append(h.counts, make([]uint64, len(o.counts)-len(h.counts))...)
+	}
+	for i, c := range o.counts {
+		h.counts[i] += c
+	}
+	if h.total == 0 || o.min < h.min {
+		h.min = o.min
+	}
+	h.max = max(h.max, o.max)
+	h.total += o.total
+	h.sum += o.sum
+}
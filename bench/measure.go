@@ -0,0 +1,129 @@
+package bench
+
+import (
+	"fmt"
+	"runtime"
+	"time"
+)
+
+// Options controls one measurement.
+type Options struct {
+	// Iterations is the number of timed calls (default 1000).
+	Iterations int
+
+	// Warmup is the number of untimed calls made first (default
+	// Iterations/10).
+	Warmup int
+
+	// MinSample is the shortest interval worth timing on its own (default
+	// 1µs). Calls faster than that are timed in batches, each charged its
+	// batch's mean, so the clock reads do not swamp what is measured.
+	MinSample time.Duration
+}
+
+func (o Options) withDefaults() Options {
+	if o.Iterations <= 0 {
+		o.Iterations = 1000
+	}
+	if o.Warmup <= 0 {
+		o.Warmup = o.Iterations / 10
+	}
+	if o.MinSample <= 0 {
+		o.MinSample = time.Microsecond
+	}
+	return o
+}
+
+// Stats is what Measure observed over the timed calls.
+type Stats struct {
+	Latency Histogram     // per-call latency
+	Calls   int           // timed calls
+	Batch   int           // calls per timed sample
+	Wall    time.Duration // wall time of the timed calls
+	CPU     time.Duration // process user+system CPU time, 0 if unavailable
+	Allocs  uint64        // heap allocations
+	Bytes   uint64        // heap bytes allocated
+}
+
+// AllocsPerOp returns the mean heap allocations per call.
+func (s *Stats) AllocsPerOp() float64 { return float64(s.Allocs) / float64(max(s.Calls, 1)) }
+
+// BytesPerOp returns the mean heap bytes allocated per call.
+func (s *Stats) BytesPerOp() float64 { return float64(s.Bytes) / float64(max(s.Calls, 1)) }
+
+// CPUPerOp returns the mean process CPU time per call. It includes any
+// other goroutines, such as GC workers, running meanwhile.
+func (s *Stats) CPUPerOp() time.Duration { return s.CPU / time.Duration(max(s.Calls, 1)) }
+
+func (s *Stats) String() string {
+	return fmt.Sprintf("p50=%-8s p99=%-8s p999=%-8s max=%-8s mean=%-8s",
+		FormatDuration(s.Latency.Quantile(0.5)),
+		FormatDuration(s.Latency.Quantile(0.99)),
+		FormatDuration(s.Latency.Quantile(0.999)),
+		FormatDuration(s.Latency.Max()),
+		FormatDuration(s.Latency.Mean()))
+}
+
+// Measure calls fn Warmup times, then Iterations times timing each call
+// (or batch, see MinSample) into a histogram, and counts the allocations
+// and CPU time of the timed calls.
+func Measure(opts Options, fn func()) *Stats {
+	opts = opts.withDefaults()
+	for i := 0; i < opts.Warmup; i++ {
+		fn()
+	}
+	s := &Stats{Calls: opts.Iterations, Batch: batchSize(opts.MinSample, fn)}
+
+	// Sized up front so recording does not count as fn's allocations
+	s.Latency.Reserve(10 * time.Second)
+
+	var before, after runtime.MemStats
+	runtime.ReadMemStats(&before)
+	cpu := cpuTime()
+	start := time.Now()
+
+	for done := 0; done < opts.Iterations; {
+		n := min(s.Batch, opts.Iterations-done)
+		t := time.Now()
+		for j := 0; j < n; j++ {
+			fn()
+		}
+		s.Latency.RecordN(time.Since(t)/time.Duration(n), uint64(n))
+		done += n
+	}
+
+	s.Wall = time.Since(start)
+	if cpu > 0 {
+		s.CPU = cpuTime() - cpu
+	}
+	runtime.ReadMemStats(&after)
+	s.Allocs = after.Mallocs - before.Mallocs
+	s.Bytes = after.TotalAlloc - before.TotalAlloc
+	return s
+}
+
+// batchSize returns how many calls of fn take about minSample, at least 1,
+// timing a few calls to get past clock granularity.
+func batchSize(minSample time.Duration, fn func()) int {
+	const probe = 8
+	start := time.Now()
+	for i := 0; i < probe; i++ {
+		fn()
+	}
+	per := time.Since(start) / probe
+	if per >= minSample {
+		return 1
+	}
+	return int(minSample/max(per, 1)) + 1
+}
+
+// FormatDuration formats d with a precision suited to its magnitude.
+func FormatDuration(d time.Duration) string {
+	if d < time.Microsecond {
+		return fmt.Sprintf("%dns", d.Nanoseconds())
+	}
+	if d < time.Millisecond {
+		return fmt.Sprintf("%.1fµs", float64(d.Nanoseconds())/1000)
+	}
+	return d.Round(time.Microsecond).String()
+}
@@ -0,0 +1,297 @@
+package bench
+
+import (
+	"encoding/csv"
+	"encoding/json"
+	"flag"
+	"fmt"
+	"io"
+	"os"
+	"regexp"
+	"runtime"
+	"slices"
+	"strconv"
+	"strings"
+	"text/tabwriter"
+	"time"
+)
+
+// Result is one benchmark's record: what ran, with which parameters, and
+// what Measure observed. Latencies are in nanoseconds.
+type Result struct {
+	Suite   string            `json:"suite"`
+	Backend string            `json:"backend"`
+	Op      string            `json:"op"`
+	Params  map[string]string `json:"params,omitempty"`
+
+	Samples     int     `json:"samples"`
+	Batch       int     `json:"batch"`
+	MinNs       int64   `json:"min_ns"`
+	MeanNs      int64   `json:"mean_ns"`
+	P50Ns       int64   `json:"p50_ns"`
+	P99Ns       int64   `json:"p99_ns"`
+	P999Ns      int64   `json:"p999_ns"`
+	MaxNs       int64   `json:"max_ns"`
+	AllocsPerOp float64 `json:"allocs_per_op"`
+	BytesPerOp  float64 `json:"bytes_per_op"`
+	CPUNsPerOp  int64   `json:"cpu_ns_per_op"`
+}
+
+// NewResult summarizes s.
+func NewResult(suite, backend, op string, params map[string]string, s *Stats) Result {
+	h := &s.Latency
+	return Result{
+		Suite:       suite,
+		Backend:     backend,
+		Op:          op,
+		Params:      params,
+		Samples:     s.Calls,
+		Batch:       s.Batch,
+		MinNs:       int64(h.Min()),
+		MeanNs:      int64(h.Mean()),
+		P50Ns:       int64(h.Quantile(0.5)),
+		P99Ns:       int64(h.Quantile(0.99)),
+		P999Ns:      int64(h.Quantile(0.999)),
+		MaxNs:       int64(h.Max()),
+		AllocsPerOp: s.AllocsPerOp(),
+		BytesPerOp:  s.BytesPerOp(),
+		CPUNsPerOp:  int64(s.CPUPerOp()),
+	}
+}
+
+// Name identifies the result as backend/op/key=value..., with the
+// parameters in key order; -run matches against it.
+func (r *Result) Name() string {
+	return name(r.Backend, r.Op, r.Params)
+}
+
+func name(backend, op string, params map[string]string) string {
+	parts := []string{backend, op}
+	for _, k := range sortedKeys(params) {
+		parts = append(parts, k+"="+params[k])
+	}
+	return strings.Join(parts, "/")
+}
+
+func sortedKeys(m map[string]string) []string {
+	keys := make([]string, 0, len(m))
+	for k := range m {
+		keys = append(keys, k)
+	}
+	slices.Sort(keys)
+	return keys
+}
+
+// Report is a run's results with the environment they were measured in.
+type Report struct {
+	Label      string    `json:"label,omitempty"`
+	Time       time.Time `json:"time"`
+	GoVersion  string    `json:"go_version"`
+	GOOS       string    `json:"goos"`
+	GOARCH     string    `json:"goarch"`
+	NumCPU     int       `json:"num_cpu"`
+	GOMAXPROCS int       `json:"gomaxprocs"`
+	Results    []Result  `json:"results"`
+}
+
+// NewReport wraps results with the current environment.
+func NewReport(label string, results []Result) *Report {
+	return &Report{
+		Label:      label,
+		Time:       time.Now().UTC().Truncate(time.Second),
+		GoVersion:  runtime.Version(),
+		GOOS:       runtime.GOOS,
+		GOARCH:     runtime.GOARCH,
+		NumCPU:     runtime.NumCPU(),
+		GOMAXPROCS: runtime.GOMAXPROCS(0),
+		Results:    results,
+	}
+}
+
+// WriteJSON writes the report as indented JSON.
+func (rep *Report) WriteJSON(w io.Writer) error {
+	enc := json.NewEncoder(w)
+	enc.SetIndent("", "  ")
+	return enc.Encode(rep)
+}
+
+// WriteCSV writes one row per result. Every parameter key used by any
+// result gets a column, so runs of one driver always share a header.
+func (rep *Report) WriteCSV(w io.Writer) error {
+	keySet := map[string]string{}
+	for _, r := range rep.Results {
+		for k := range r.Params {
+			keySet[k] = ""
+		}
+	}
+	keys := sortedKeys(keySet)
+
+	cw := csv.NewWriter(w)
+	header := append([]string{"label", "time", "suite", "backend", "op"}, keys...)
+	header = append(header, "samples", "batch", "min_ns", "mean_ns", "p50_ns", "p99_ns", "p999_ns", "max_ns",
+		"allocs_per_op", "bytes_per_op", "cpu_ns_per_op")
+	if err := cw.Write(header); err != nil {
+		return err
+	}
+
+	i64 := func(v int64) string { return strconv.FormatInt(v, 10) }
+	f64 := func(v float64) string { return strconv.FormatFloat(v, 'g', 6, 64) }
+	for _, r := range rep.Results {
+		row := []string{rep.Label, rep.Time.Format(time.RFC3339), r.Suite, r.Backend, r.Op}
+		for _, k := range keys {
+			row = append(row, r.Params[k])
+		}
+		row = append(row, strconv.Itoa(r.Samples), strconv.Itoa(r.Batch),
+			i64(r.MinNs), i64(r.MeanNs), i64(r.P50Ns), i64(r.P99Ns), i64(r.P999Ns), i64(r.MaxNs),
+			f64(r.AllocsPerOp), f64(r.BytesPerOp), i64(r.CPUNsPerOp))
+		if err := cw.Write(row); err != nil {
+			return err
+		}
+	}
+	cw.Flush()
+	return cw.Error()
+}
+
+// WriteText writes the results as an aligned table.
+func (rep *Report) WriteText(w io.Writer) error {
+	tw := tabwriter.NewWriter(w, 0, 0, 2, ' ', tabwriter.AlignRight)
+	fmt.Fprintln(tw, "benchmark\tp50\tp99\tp99.9\tmax\tmean\tcpu/op\tallocs/op\tB/op\t")
+	d := func(ns int64) string { return FormatDuration(time.Duration(ns)) }
+	for _, r := range rep.Results {
+		fmt.Fprintf(tw, "%s\t%s\t%s\t%s\t%s\t%s\t%s\t%.1f\t%.0f\t\n",
+			r.Name(), d(r.P50Ns), d(r.P99Ns), d(r.P999Ns), d(r.MaxNs), d(r.MeanNs), d(r.CPUNsPerOp),
+			r.AllocsPerOp, r.BytesPerOp)
+	}
+	return tw.Flush()
+}
+
+// Config holds the command-line settings the drivers share.
+type Config struct {
+	Options
+	Format string // text, json or csv
+	Output string // output file, or "" for stdout
+	Label  string // recorded in the report, e.g. a release tag
+	Run    string // regexp selecting benchmarks by Name
+
+	run *regexp.Regexp
+}
+
+// RegisterFlags defines the shared flags on fs.
+func (c *Config) RegisterFlags(fs *flag.FlagSet) {
+	fs.IntVar(&c.Iterations, "iterations", 1000, "timed calls per benchmark")
+	fs.IntVar(&c.Warmup, "warmup", 0, "untimed calls before timing (default iterations/10)")
+	fs.DurationVar(&c.MinSample, "min-sample", time.Microsecond, "time calls faster than this in batches")
+	fs.StringVar(&c.Format, "format", "text", "output format: text, json or csv")
+	fs.StringVar(&c.Output, "o", "", "write results to `file` instead of stdout")
+	fs.StringVar(&c.Label, "label", "", "label recorded with the results (e.g. a release tag)")
+	fs.StringVar(&c.Run, "run", "", "only run benchmarks whose backend/op/params name matches `regexp`")
+}
+
+// Validate checks the settings after flags are parsed.
+func (c *Config) Validate() error {
+	switch c.Format {
+	case "text", "json", "csv":
+	default:
+		return fmt.Errorf("unknown format %q (want text, json or csv)", c.Format)
+	}
+	if c.Run != "" {
+		re, err := regexp.Compile(c.Run)
+		if err != nil {
+			return fmt.Errorf("invalid -run: %w", err)
+		}
+		c.run = re
+	}
+	return nil
+}
+
+// Write writes results in the configured format to the configured output.
+func (c *Config) Write(results []Result) (err error) {
+	w := io.Writer(os.Stdout)
+	if c.Output != "" {
+		f, err := os.Create(c.Output)
+		if err != nil {
+			return err
+		}
+		defer func() {
+			if cerr := f.Close(); err == nil {
+				err = cerr
+			}
+		}()
+		w = f
+	}
+
+	rep := NewReport(c.Label, results)
+	switch c.Format {
+	case "json":
+		return rep.WriteJSON(w)
+	case "csv":
+		return rep.WriteCSV(w)
+	default:
+		return rep.WriteText(w)
+	}
+}
+
+// IntList is a flag.Value holding a comma-separated list of positive
+// integers, such as vector lengths or pattern counts.
+type IntList []int
+
+func (l *IntList) String() string {
+	parts := make([]string, len(*l))
+	for i, v := range *l {
+		parts[i] = strconv.Itoa(v)
+	}
+	return strings.Join(parts, ",")
+}
+
+// Set replaces the list with the values in s.
+func (l *IntList) Set(s string) error {
+	var vals []int
+	for _, f := range strings.Split(s, ",") {
+		v, err := strconv.Atoi(strings.TrimSpace(f))
+		if err != nil || v <= 0 {
+			return fmt.Errorf("%q is not a positive integer", f)
+		}
+		vals = append(vals, v)
+	}
+	*l = vals
+	return nil
+}
+
+// Runner measures a suite of benchmarks under one Config. Unless the
+// table is going to stdout anyway, each result is also logged to stderr as
+// it completes.
+type Runner struct {
+	cfg     *Config
+	suite   string
+	results []Result
+}
+
+// NewRunner returns a Runner for suite (e.g. "vector").
+func (c *Config) NewRunner(suite string) *Runner {
+	return &Runner{cfg: c, suite: suite}
+}
+
+// Run measures fn as backend/op with params, unless -run excludes it.
+func (r *Runner) Run(backend, op string, params map[string]string, fn func()) {
+	r.RunWith(r.cfg.Options, backend, op, params, fn)
+}
+
+// RunWith is Run with different Options, e.g. fewer iterations for a slow
+// operation.
+func (r *Runner) RunWith(opts Options, backend, op string, params map[string]string, fn func()) {
+	n := name(backend, op, params)
+	if r.cfg.run != nil && !r.cfg.run.MatchString(n) {
+		return
+	}
+	s := Measure(opts, fn)
+	if r.cfg.Format != "text" || r.cfg.Output != "" {
+		fmt.Fprintf(os.Stderr, "%-48s %s\n", n, s)
+	}
+	r.results = append(r.results, NewResult(r.suite, backend, op, params, s))
+}
+
+// Results returns the results measured so far.
+func (r *Runner) Results() []Result { return r.results }
+
+// Write writes the results measured so far (see Config.Write).
+func (r *Runner) Write() error { return r.cfg.Write(r.results) }
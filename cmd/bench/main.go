@@ -0,0 +1,139 @@
+// Command bench measures the vector operations on every backend - pure
+// Go, cgo and each built WASM module - over a range of vector lengths, and
+// reports latency percentiles, allocations and CPU time per call as a
+// table, JSON or CSV (see package bench).
+//
+// Usage:
+//
+//	go run ./cmd/bench [-sizes 100,1000,10000,100000] [-wasm-dir wasm]
+//	        [-run regexp] [-format text|json|csv] [-o file] [-label tag]
+//
+// WASM modules that have not been built are skipped.
+package main
+
+import (
+	"flag"
+	"fmt"
+	"math/rand"
+	"os"
+	"path/filepath"
+	"slices"
+	"strconv"
+
+	ffi "github.com/paulstuart/cgo-ffi"
+	"github.com/paulstuart/cgo-ffi/bench"
+	"github.com/paulstuart/cgo-ffi/wasm/host"
+)
+
+// backend is one implementation of the benchmarked operations.
+type backend struct {
+	name  string
+	sum   func(a []float64) float64
+	dot   func(a, b []float64) float64
+	mul   func(a, b, dst []float64) // nil if unsupported
+	close func()
+}
+
+// Results go here so no call can be optimized away
+var sink float64
+
+func main() {
+	var cfg bench.Config
+	cfg.RegisterFlags(flag.CommandLine)
+	sizes := bench.IntList{100, 1000, 10000, 100000}
+	flag.Var(&sizes, "sizes", "comma-separated vector lengths")
+	wasmDir := flag.String("wasm-dir", "wasm", "directory holding the built WASM modules")
+	flag.Parse()
+	if err := cfg.Validate(); err != nil {
+		fatal(err)
+	}
+
+	backends := append(nativeBackends(slices.Max(sizes)), wasmBackends(*wasmDir, slices.Max(sizes))...)
+	defer func() {
+		for _, b := range backends {
+			if b.close != nil {
+				b.close()
+			}
+		}
+	}()
+
+	r := cfg.NewRunner("vector")
+	for _, n := range sizes {
+		a, b, dst := makeData(n), makeData(n), make([]float64, n)
+		params := map[string]string{"n": strconv.Itoa(n)}
+		for _, be := range backends {
+			r.Run(be.name, "sum", params, func() { sink = be.sum(a) })
+			r.Run(be.name, "dot", params, func() { sink = be.dot(a, b) })
+			if be.mul != nil {
+				r.Run(be.name, "mul", params, func() { be.mul(a, b, dst) })
+			}
+		}
+	}
+	if err := r.Write(); err != nil {
+		fatal(err)
+	}
+}
+
+// nativeBackends returns pure Go and the cgo paths, with buffers for
+// capacity elements.
+func nativeBackends(capacity int) []backend {
+	ops := ffi.NewVectorOps(capacity)
+	return []backend{
+		{name: "go", sum: ffi.GoSum, dot: ffi.GoDot, mul: ffi.GoMulInto},
+		{name: "cgo", sum: ops.Sum, dot: ops.Dot, mul: ops.MulInto, close: ops.Close},
+		{name: "cgo-direct", sum: ffi.DirectSum, dot: ffi.DirectDot},
+	}
+}
+
+// wasmBackends loads each WASM module built under dir, with its buffers
+// grown to capacity up front so growth is not measured.
+func wasmBackends(dir string, capacity int) []backend {
+	modules := []struct {
+		runtime host.WasmRuntime
+		path    string
+	}{
+		{host.RuntimeC, "c/vector.wasm"},
+		{host.RuntimeCSIMD, "c/vector_simd.wasm"},
+		{host.RuntimeRust, "rust/vector.wasm"},
+		{host.RuntimeRustSIMD, "rust/vector_simd.wasm"},
+		{host.RuntimeTinyGo, "tinygo/vector.wasm"},
+	}
+
+	var backends []backend
+	for _, m := range modules {
+		path := filepath.Join(dir, m.path)
+		if _, err := os.Stat(path); err != nil {
+			fmt.Fprintf(os.Stderr, "skipping wasm-%s: %s not built\n", m.runtime, path)
+			continue
+		}
+		ops, err := host.NewWasmVectorOpsFromFile(path)
+		if err != nil {
+			fmt.Fprintf(os.Stderr, "skipping wasm-%s: %v\n", m.runtime, err)
+			continue
+		}
+		if err := ops.Reserve(capacity); err != nil {
+			fmt.Fprintf(os.Stderr, "wasm-%s: %v; longer inputs are chunked\n", m.runtime, err)
+		}
+		backends = append(backends, backend{
+			name:  "wasm-" + string(m.runtime),
+			sum:   ops.Sum,
+			dot:   ops.Dot,
+			mul:   ops.MulInto,
+			close: ops.Close,
+		})
+	}
+	return backends
+}
+
+func makeData(n int) []float64 {
+	data := make([]float64, n)
+	for i := range data {
+		data[i] = rand.Float64() * 100
+	}
+	return data
+}
+
+func fatal(err error) {
+	fmt.Fprintln(os.Stderr, "bench:", err)
+	os.Exit(1)
+}
@@ -8,12 +8,15 @@
 package ffi
 
 /*
-#cgo CFLAGS: -O3 -march=native
+#cgo CFLAGS: -O3 -pthread
+#cgo LDFLAGS: -pthread
+#include <stdlib.h>
 #include "vector.h"
 */
 import "C"
 
 import (
+	"fmt"
 	"runtime"
 	"sync"
 	"unsafe"
@@ -37,16 +40,52 @@ type VectorOps struct {
 	ptrB *C.double
 	ptrR *C.double
 
-	// Capacity
+	// Capacity; grows on demand, see reserveLocked
 	capacity int
 
+	// Vectors handed out by Alloc and not yet unpinned; Close unpins them
+	vecs map[*PinnedVec]struct{}
+
 	// Mutex for thread safety (C code may not be thread-safe)
 	mu sync.Mutex
 }
 
+// kernelsOnce resolves the C SIMD dispatch table on first use.
+var kernelsOnce sync.Once
+
+func initKernels() {
+	kernelsOnce.Do(func() { C.vector_init() })
+}
+
+// Kernels returns the SIMD kernels the C functions dispatch to on this CPU:
+// "avx512vnni", "avx512", "avx2", "neondot", "neon" or "generic". The C code
+// is built without -march flags, so one binary picks the widest kernels each
+// host supports.
+func Kernels() string {
+	initKernels()
+	return C.GoString(C.vector_kernel_name())
+}
+
+// SetKernels switches the C functions to the named kernels, for benchmarking
+// or to keep a host off AVX-512. It affects every VectorOps in the process.
+// Returns an error if the kernels are unknown or unsupported on this CPU.
+func SetKernels(name string) error {
+	initKernels()
+	cname := C.CString(name)
+	defer C.free(unsafe.Pointer(cname))
+	if C.vector_select(cname) != 0 {
+		return fmt.Errorf("kernels %q not supported on this CPU", name)
+	}
+	return nil
+}
+
 // NewVectorOps creates a new VectorOps with pre-allocated buffers.
 // This is the one-time initialization cost.
 func NewVectorOps(capacity int) *VectorOps {
+	initKernels()
+	if capacity < 1 {
+		capacity = 1
+	}
 	v := &VectorOps{
 		bufferA:  make([]float64, capacity),
 		bufferB:  make([]float64, capacity),
@@ -54,39 +93,91 @@ func NewVectorOps(capacity int) *VectorOps {
 		capacity: capacity,
 	}
 
-	// Pin the buffers so GC won't move them
-	v.pinnerA.Pin(&v.bufferA[0])
-	v.pinnerB.Pin(&v.bufferB[0])
-	v.pinnerR.Pin(&v.result[0])
-
-	// Cache the C pointers - these won't change now
-	v.ptrA = (*C.double)(unsafe.Pointer(&v.bufferA[0]))
-	v.ptrB = (*C.double)(unsafe.Pointer(&v.bufferB[0]))
-	v.ptrR = (*C.double)(unsafe.Pointer(&v.result[0]))
+	// Pin the buffers so GC won't move them, and cache the C pointers -
+	// these only change if an operation grows the buffers
+	v.pin()
 
 	return v
 }
 
-// Close releases pinned memory. Must be called when done.
+// Close releases pinned memory, including vectors from Alloc.
+// Must be called when done.
 func (v *VectorOps) Close() {
 	v.pinnerA.Unpin()
 	v.pinnerB.Unpin()
 	v.pinnerR.Unpin()
+
+	v.mu.Lock()
+	vecs := v.vecs
+	v.vecs = nil
+	v.mu.Unlock()
+	for p := range vecs {
+		p.Unpin()
+	}
+}
+
+// Capacity returns the number of elements the internal buffers hold.
+// Operations on longer inputs grow them.
+func (v *VectorOps) Capacity() int {
+	v.mu.Lock()
+	defer v.mu.Unlock()
+	return v.capacity
+}
+
+// Reserve grows the internal buffers to hold at least n elements, so a
+// later call on a long input does not pay for the reallocation.
+func (v *VectorOps) Reserve(n int) {
+	v.mu.Lock()
+	defer v.mu.Unlock()
+	v.reserveLocked(n)
+}
+
+// reserveLocked reallocates and re-pins the buffers if n exceeds the
+// capacity, at least doubling it; the caller must hold v.mu.
+func (v *VectorOps) reserveLocked(n int) {
+	if n <= v.capacity {
+		return
+	}
+	if n < 2*v.capacity {
+		n = 2 * v.capacity
+	}
+
+	v.pinnerA.Unpin()
+	v.pinnerB.Unpin()
+	v.pinnerR.Unpin()
+	v.bufferA = make([]float64, n)
+	v.bufferB = make([]float64, n)
+	v.result = make([]float64, n)
+	v.capacity = n
+	v.pin()
+}
+
+// pin pins the buffers and caches their C pointers.
+func (v *VectorOps) pin() {
+	v.pinnerA.Pin(&v.bufferA[0])
+	v.pinnerB.Pin(&v.bufferB[0])
+	v.pinnerR.Pin(&v.result[0])
+
+	v.ptrA = (*C.double)(unsafe.Pointer(&v.bufferA[0]))
+	v.ptrB = (*C.double)(unsafe.Pointer(&v.bufferB[0]))
+	v.ptrR = (*C.double)(unsafe.Pointer(&v.result[0]))
 }
 
 // Sum returns the sum of all elements.
 // After initialization, this is effectively just a C function call.
 func (v *VectorOps) Sum(data []float64) float64 {
+	v.mu.Lock()
+	defer v.mu.Unlock()
+	return v.sumLocked(data)
+}
+
+// sumLocked is Sum; the caller must hold v.mu.
+func (v *VectorOps) sumLocked(data []float64) float64 {
 	n := len(data)
 	if n == 0 {
 		return 0
 	}
-	if n > v.capacity {
-		n = v.capacity
-	}
-
-	v.mu.Lock()
-	defer v.mu.Unlock()
+	v.reserveLocked(n)
 
 	// Copy data to pinned buffer
 	copy(v.bufferA[:n], data[:n])
@@ -96,17 +187,15 @@ func (v *VectorOps) Sum(data []float64) float64 {
 }
 
 // SumSIMD uses the SIMD-optimized C function.
+// Sum dispatches to the same kernels; SumSIMD remains for existing callers.
 func (v *VectorOps) SumSIMD(data []float64) float64 {
 	n := len(data)
 	if n == 0 {
 		return 0
 	}
-	if n > v.capacity {
-		n = v.capacity
-	}
-
 	v.mu.Lock()
 	defer v.mu.Unlock()
+	v.reserveLocked(n)
 
 	copy(v.bufferA[:n], data[:n])
 	return float64(C.vector_sum_simd(v.ptrA, C.size_t(n)))
@@ -114,16 +203,18 @@ func (v *VectorOps) SumSIMD(data []float64) float64 {
 
 // Dot computes the dot product of two vectors.
 func (v *VectorOps) Dot(a, b []float64) float64 {
+	v.mu.Lock()
+	defer v.mu.Unlock()
+	return v.dotLocked(a, b)
+}
+
+// dotLocked is Dot; the caller must hold v.mu.
+func (v *VectorOps) dotLocked(a, b []float64) float64 {
 	n := len(a)
 	if n == 0 || len(b) < n {
 		return 0
 	}
-	if n > v.capacity {
-		n = v.capacity
-	}
-
-	v.mu.Lock()
-	defer v.mu.Unlock()
+	v.reserveLocked(n)
 
 	copy(v.bufferA[:n], a[:n])
 	copy(v.bufferB[:n], b[:n])
@@ -134,16 +225,18 @@ func (v *VectorOps) Dot(a, b []float64) float64 {
 // Mul performs element-wise multiplication: result[i] = a[i] * b[i]
 // Returns a slice view into the internal result buffer.
 func (v *VectorOps) Mul(a, b []float64) []float64 {
+	v.mu.Lock()
+	defer v.mu.Unlock()
+	return v.mulLocked(a, b)
+}
+
+// mulLocked is Mul; the caller must hold v.mu.
+func (v *VectorOps) mulLocked(a, b []float64) []float64 {
 	n := len(a)
 	if n == 0 || len(b) < n {
 		return nil
 	}
-	if n > v.capacity {
-		n = v.capacity
-	}
-
-	v.mu.Lock()
-	defer v.mu.Unlock()
+	v.reserveLocked(n)
 
 	copy(v.bufferA[:n], a[:n])
 	copy(v.bufferB[:n], b[:n])
@@ -159,16 +252,18 @@ func (v *VectorOps) Mul(a, b []float64) []float64 {
 // MulInto performs element-wise multiplication into a provided destination.
 // This avoids allocation if caller provides the buffer.
 func (v *VectorOps) MulInto(a, b, dst []float64) {
+	v.mu.Lock()
+	defer v.mu.Unlock()
+	v.mulIntoLocked(a, b, dst)
+}
+
+// mulIntoLocked is MulInto; the caller must hold v.mu.
+func (v *VectorOps) mulIntoLocked(a, b, dst []float64) {
 	n := len(a)
 	if n == 0 || len(b) < n || len(dst) < n {
 		return
 	}
-	if n > v.capacity {
-		n = v.capacity
-	}
-
-	v.mu.Lock()
-	defer v.mu.Unlock()
+	v.reserveLocked(n)
 
 	copy(v.bufferA[:n], a[:n])
 	copy(v.bufferB[:n], b[:n])
@@ -180,16 +275,18 @@ func (v *VectorOps) MulInto(a, b, dst []float64) {
 
 // Scale multiplies all elements by a scalar in-place.
 func (v *VectorOps) Scale(data []float64, scalar float64) {
+	v.mu.Lock()
+	defer v.mu.Unlock()
+	v.scaleLocked(data, scalar)
+}
+
+// scaleLocked is Scale; the caller must hold v.mu.
+func (v *VectorOps) scaleLocked(data []float64, scalar float64) {
 	n := len(data)
 	if n == 0 {
 		return
 	}
-	if n > v.capacity {
-		n = v.capacity
-	}
-
-	v.mu.Lock()
-	defer v.mu.Unlock()
+	v.reserveLocked(n)
 
 	copy(v.bufferA[:n], data[:n])
 
@@ -198,6 +295,389 @@ func (v *VectorOps) Scale(data []float64, scalar float64) {
 	copy(data[:n], v.bufferA[:n])
 }
 
+// --- Zero-copy operations on pinned vectors ---
+
+// PinnedVec is a []float64 pinned for its whole lifetime, so C reads and
+// writes it in place: no copy into VectorOps' buffers and no per-call
+// pinning. Fill Data() directly, run operations, read the results back.
+//
+// A PinnedVec is not locked; callers must not share one between goroutines
+// that write to it. Call Unpin when done, after which it must not be used.
+type PinnedVec struct {
+	data   []float64
+	ptr    *C.double
+	pinner runtime.Pinner
+	owner  *VectorOps // set by Alloc until Unpin
+}
+
+// NewPinnedVec allocates and pins a zeroed vector of n elements.
+func NewPinnedVec(n int) *PinnedVec {
+	return PinSlice(make([]float64, n))
+}
+
+// PinSlice pins a caller-owned slice. Operations on the PinnedVec read and
+// write data itself, and data must not be appended to while it is pinned.
+func PinSlice(data []float64) *PinnedVec {
+	initKernels()
+	p := &PinnedVec{data: data}
+	if len(data) > 0 {
+		p.pinner.Pin(&data[0])
+		p.ptr = (*C.double)(unsafe.Pointer(&data[0]))
+	}
+	return p
+}
+
+// Alloc returns a pinned vector of n elements that Close unpins along with
+// the VectorOps buffers, unless Unpin releases it first.
+func (v *VectorOps) Alloc(n int) *PinnedVec {
+	p := NewPinnedVec(n)
+	p.owner = v
+	v.mu.Lock()
+	if v.vecs == nil {
+		v.vecs = make(map[*PinnedVec]struct{})
+	}
+	v.vecs[p] = struct{}{}
+	v.mu.Unlock()
+	return p
+}
+
+// Data returns the pinned slice. Writes to it are seen by the next operation.
+func (p *PinnedVec) Data() []float64 { return p.data }
+
+// Len returns the number of elements.
+func (p *PinnedVec) Len() int { return len(p.data) }
+
+// Unpin releases the vector to the GC, dropping it from the VectorOps that
+// allocated it. Unpinning twice is safe.
+func (p *PinnedVec) Unpin() {
+	if v := p.owner; v != nil {
+		p.owner = nil
+		v.mu.Lock()
+		delete(v.vecs, p)
+		v.mu.Unlock()
+	}
+	p.pinner.Unpin()
+	p.ptr = nil
+}
+
+// Sum returns the sum of all elements.
+func (p *PinnedVec) Sum() float64 {
+	if p.ptr == nil {
+		return 0
+	}
+	return float64(C.vector_sum(p.ptr, C.size_t(len(p.data))))
+}
+
+// Dot computes the dot product with q over the shorter of the two lengths.
+func (p *PinnedVec) Dot(q *PinnedVec) float64 {
+	n := min(len(p.data), len(q.data))
+	if p.ptr == nil || q.ptr == nil || n == 0 {
+		return 0
+	}
+	return float64(C.vector_dot(p.ptr, q.ptr, C.size_t(n)))
+}
+
+// Mul writes p[i] * q[i] into dst, over the shortest of the three lengths.
+// dst may be p or q.
+func (p *PinnedVec) Mul(q, dst *PinnedVec) {
+	n := min(len(p.data), len(q.data), len(dst.data))
+	if p.ptr == nil || q.ptr == nil || dst.ptr == nil || n == 0 {
+		return
+	}
+	C.vector_mul(p.ptr, q.ptr, dst.ptr, C.size_t(n))
+}
+
+// Scale multiplies all elements by a scalar in place.
+func (p *PinnedVec) Scale(scalar float64) {
+	if p.ptr == nil {
+		return
+	}
+	C.vector_scale(p.ptr, C.double(scalar), C.size_t(len(p.data)))
+}
+
+// --- Fused pipelines ---
+
+// Pipeline records a chain of element-wise operations and reductions and
+// runs it in one C call (vector_exec). C walks the vectors in cache-sized
+// blocks applying every step to a block before the next, so
+//
+//	p := NewPipeline().Load(a).Mul(b).Scale(0.5).Sum()
+//	defer p.Close()
+//	results, err := p.Run()
+//
+// costs one cgo call and one pass over a and b, where Mul, Scale and Sum
+// on VectorOps cost three calls and three passes.
+//
+// Every vector must have the length of the first Load. A Pipeline pins its
+// vectors when they are added and runs repeatedly without copying or
+// re-pinning them; Close unpins them. It is not safe for concurrent use.
+type Pipeline struct {
+	ops      []C.vector_op
+	ptrs     []*C.double
+	cptrs    **C.double // ptrs copied to C memory, see RunInto
+	ncptrs   int
+	pinner   runtime.Pinner
+	n        int
+	nresults int
+	err      error
+}
+
+// NewPipeline returns an empty pipeline. The first step must be Load.
+func NewPipeline() *Pipeline {
+	return &Pipeline{}
+}
+
+// vec pins x and returns its index in p.ptrs.
+func (p *Pipeline) vec(x []float64) C.int32_t {
+	if len(p.ptrs) == 0 {
+		p.n = len(x)
+	} else if p.err == nil && len(x) != p.n {
+		p.err = fmt.Errorf("pipeline step %d: vector length %d, want %d", len(p.ops), len(x), p.n)
+	}
+	var ptr *C.double
+	if len(x) > 0 {
+		p.pinner.Pin(&x[0])
+		ptr = (*C.double)(unsafe.Pointer(&x[0]))
+	}
+	p.ptrs = append(p.ptrs, ptr)
+	return C.int32_t(len(p.ptrs) - 1)
+}
+
+func (p *Pipeline) add(code C.int32_t, arg, arg2 C.int32_t, imm float64) *Pipeline {
+	if p.err == nil && len(p.ops) == 0 && code != C.VECTOR_OP_LOAD {
+		p.err = fmt.Errorf("pipeline must start with Load")
+	}
+	p.ops = append(p.ops, C.vector_op{code: code, arg: arg, arg2: arg2, imm: C.double(imm)})
+	return p
+}
+
+// Load sets the accumulator to x.
+func (p *Pipeline) Load(x []float64) *Pipeline {
+	return p.add(C.VECTOR_OP_LOAD, p.vec(x), 0, 0)
+}
+
+// Store writes the accumulator to dst, which may be a loaded vector.
+func (p *Pipeline) Store(dst []float64) *Pipeline {
+	return p.add(C.VECTOR_OP_STORE, p.vec(dst), 0, 0)
+}
+
+// Add adds x element-wise to the accumulator.
+func (p *Pipeline) Add(x []float64) *Pipeline {
+	return p.add(C.VECTOR_OP_ADD, p.vec(x), 0, 0)
+}
+
+// Mul multiplies the accumulator element-wise by x.
+func (p *Pipeline) Mul(x []float64) *Pipeline {
+	return p.add(C.VECTOR_OP_MUL, p.vec(x), 0, 0)
+}
+
+// AddScalar adds s to every element of the accumulator.
+func (p *Pipeline) AddScalar(s float64) *Pipeline {
+	return p.add(C.VECTOR_OP_ADDS, 0, 0, s)
+}
+
+// Scale multiplies every element of the accumulator by s.
+func (p *Pipeline) Scale(s float64) *Pipeline {
+	return p.add(C.VECTOR_OP_SCALE, 0, 0, s)
+}
+
+// Sum appends the sum of the accumulator to the results.
+func (p *Pipeline) Sum() *Pipeline {
+	p.nresults++
+	return p.add(C.VECTOR_OP_SUM, C.int32_t(p.nresults-1), 0, 0)
+}
+
+// Dot appends the dot product of the accumulator and x to the results.
+func (p *Pipeline) Dot(x []float64) *Pipeline {
+	p.nresults++
+	return p.add(C.VECTOR_OP_DOT, C.int32_t(p.nresults-1), p.vec(x), 0)
+}
+
+// Results returns the number of values Run produces, one per Sum or Dot.
+func (p *Pipeline) Results() int {
+	return p.nresults
+}
+
+// Run executes the pipeline and returns its results in the order the Sum
+// and Dot steps were added.
+func (p *Pipeline) Run() ([]float64, error) {
+	results := make([]float64, p.nresults)
+	if err := p.RunInto(results); err != nil {
+		return nil, err
+	}
+	return results, nil
+}
+
+// RunInto executes the pipeline, writing its results into results, which
+// must hold at least Results() values. It does not allocate.
+func (p *Pipeline) RunInto(results []float64) error {
+	if p.err != nil {
+		return p.err
+	}
+	if len(p.ops) == 0 {
+		return fmt.Errorf("pipeline must start with Load")
+	}
+	if len(results) < p.nresults {
+		return fmt.Errorf("results has %d values, pipeline produces %d", len(results), p.nresults)
+	}
+	if p.n == 0 {
+		for i := range results[:p.nresults] {
+			results[i] = 0
+		}
+		return nil
+	}
+	initKernels()
+
+	// Pinned pointers may be stored in C memory. Passing the array from Go
+	// memory instead would make cgo check it on every call, allocating.
+	if p.ncptrs != len(p.ptrs) {
+		C.free(unsafe.Pointer(p.cptrs))
+		p.cptrs = (**C.double)(C.malloc(C.size_t(len(p.ptrs)) * C.size_t(unsafe.Sizeof(p.ptrs[0]))))
+		copy(unsafe.Slice(p.cptrs, len(p.ptrs)), p.ptrs)
+		p.ncptrs = len(p.ptrs)
+	}
+
+	var res *C.double
+	if p.nresults > 0 {
+		res = (*C.double)(unsafe.Pointer(&results[0]))
+	}
+
+	rc := C.vector_exec(&p.ops[0], C.int(len(p.ops)), p.cptrs, C.int(p.ncptrs),
+		C.size_t(p.n), res, C.int(p.nresults))
+	if rc != 0 {
+		return fmt.Errorf("vector_exec rejected the pipeline")
+	}
+	return nil
+}
+
+// Close unpins the pipeline's vectors. The pipeline must not be run again.
+func (p *Pipeline) Close() {
+	p.pinner.Unpin()
+	C.free(unsafe.Pointer(p.cptrs))
+	p.cptrs = nil
+	p.ncptrs = 0
+	p.ops = nil
+	p.ptrs = nil
+}
+
+// --- Parallel reductions ---
+
+// ParallelThreshold is the length below which ParallelSum and ParallelDot
+// run serially: splitting shorter inputs costs more than it saves.
+const ParallelThreshold = C.VECTOR_PARALLEL_MIN
+
+// ParallelSum returns the sum of data, splitting inputs of at least
+// ParallelThreshold elements into cache-sized chunks summed by a persistent
+// C worker pool. Partials are combined pairwise in a fixed order, so the
+// result is reproducible whatever the thread count, though it may differ in
+// the last bits from Sum.
+func ParallelSum(data []float64) float64 {
+	if len(data) == 0 {
+		return 0
+	}
+	initKernels()
+	// Workers only read data while the call is in progress, so cgo's usual
+	// guarantee for Go pointer arguments covers them; no pinning needed
+	return float64(C.vector_sum_parallel((*C.double)(unsafe.Pointer(&data[0])), C.size_t(len(data))))
+}
+
+// ParallelDot computes the dot product of a and b like ParallelSum.
+func ParallelDot(a, b []float64) float64 {
+	if len(a) == 0 || len(b) < len(a) {
+		return 0
+	}
+	initKernels()
+	return float64(C.vector_dot_parallel((*C.double)(unsafe.Pointer(&a[0])),
+		(*C.double)(unsafe.Pointer(&b[0])), C.size_t(len(a))))
+}
+
+// SetParallelThreads restarts the worker pool with n threads including the
+// caller; n <= 0 uses one per online CPU, the default on first use. n == 1
+// keeps parallel calls on the calling thread. Returns an error if no
+// worker thread could be started.
+func SetParallelThreads(n int) error {
+	if C.vector_parallel_init(C.int(n)) < 0 {
+		return fmt.Errorf("failed to start %d parallel threads", n)
+	}
+	return nil
+}
+
+// ParallelThreads returns the number of threads parallel calls use.
+func ParallelThreads() int {
+	return int(C.vector_parallel_threads())
+}
+
+// --- Batched dot products ---
+
+// matrixRows returns the number of len(query)-element rows in matrix.
+func matrixRows(query, matrix []float64) (int, error) {
+	if len(query) == 0 {
+		return 0, fmt.Errorf("empty query")
+	}
+	if len(matrix)%len(query) != 0 {
+		return 0, fmt.Errorf("matrix has %d elements, not a multiple of query length %d", len(matrix), len(query))
+	}
+	return len(matrix) / len(query), nil
+}
+
+// DotMany scores query against every row of matrix, a row-major array of
+// len(query)-element rows: out[r] = Dot(query, matrix[r*dim:(r+1)*dim]).
+// The whole batch is one C call over the caller's slices, with no copy or
+// pin, and the kernel scores four rows per pass over the query.
+func DotMany(query, matrix, out []float64) error {
+	rows, err := matrixRows(query, matrix)
+	if err != nil {
+		return err
+	}
+	if len(out) < rows {
+		return fmt.Errorf("out has %d elements, matrix has %d rows", len(out), rows)
+	}
+	if rows == 0 {
+		return nil
+	}
+	initKernels()
+	C.vector_dot_many((*C.double)(unsafe.Pointer(&query[0])), (*C.double)(unsafe.Pointer(&matrix[0])),
+		C.size_t(rows), C.size_t(len(query)), (*C.double)(unsafe.Pointer(&out[0])))
+	return nil
+}
+
+// Match is a TopK result: a matrix row and its dot product with the query.
+// The layout matches C's vector_match, so results are written in place.
+type Match struct {
+	Index int64
+	Score float64
+}
+
+// TopK returns the k rows of matrix (laid out as for DotMany) with the
+// highest dot product with query, best first; ties go to the lower index
+// and rows scoring NaN are never returned. Scoring and selection run in one
+// C call without materializing a score per row.
+func TopK(query, matrix []float64, k int) ([]Match, error) {
+	rows, err := matrixRows(query, matrix)
+	if err != nil {
+		return nil, err
+	}
+	dst := make([]Match, max(0, min(k, rows)))
+	n, err := TopKInto(query, matrix, dst)
+	return dst[:n], err
+}
+
+// TopKInto is TopK with k = len(dst). It returns the number of matches
+// written to the front of dst.
+func TopKInto(query, matrix []float64, dst []Match) (int, error) {
+	rows, err := matrixRows(query, matrix)
+	if err != nil {
+		return 0, err
+	}
+	if rows == 0 || len(dst) == 0 {
+		return 0, nil
+	}
+	initKernels()
+	n := C.vector_topk((*C.double)(unsafe.Pointer(&query[0])), (*C.double)(unsafe.Pointer(&matrix[0])),
+		C.size_t(rows), C.size_t(len(query)), C.size_t(len(dst)), (*C.vector_match)(unsafe.Pointer(&dst[0])))
+	return int(n), nil
+}
+
 // --- Direct FFI calls (for comparison - shows per-call overhead) ---
 
 // DirectSum calls C directly without pre-allocated buffers.
@@ -206,6 +686,8 @@ func DirectSum(data []float64) float64 {
 	if len(data) == 0 {
 		return 0
 	}
+	initKernels()
+
 	// Each call pins, calls C, unpins
 	var pinner runtime.Pinner
 	pinner.Pin(&data[0])
@@ -220,6 +702,8 @@ func DirectDot(a, b []float64) float64 {
 	if len(a) == 0 || len(b) < len(a) {
 		return 0
 	}
+	initKernels()
+
 	var pinnerA, pinnerB runtime.Pinner
 	pinnerA.Pin(&a[0])
 	pinnerB.Pin(&b[0])
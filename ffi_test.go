@@ -1,8 +1,11 @@
 package ffi
 
 import (
+	"fmt"
 	"math"
 	"math/rand"
+	"sort"
+	"sync"
 	"testing"
 )
 
@@ -67,6 +70,177 @@ func TestMulCorrectness(t *testing.T) {
 	}
 }
 
+func TestVectorOpsGrows(t *testing.T) {
+	ops := NewVectorOps(10)
+	defer ops.Close()
+
+	data := makeData(1000)
+	if got, want := ops.Sum(data), GoSum(data); math.Abs(got-want) > 1e-9 {
+		t.Errorf("Sum beyond capacity = %v, want %v", got, want)
+	}
+	if ops.Capacity() < len(data) {
+		t.Errorf("Capacity() = %d after Sum of %d elements", ops.Capacity(), len(data))
+	}
+
+	b := makeData(5000)
+	a := makeData(5000)
+	want := GoMul(a, b)
+	got := ops.Mul(a, b)
+	for i := range want {
+		if got[i] != want[i] {
+			t.Fatalf("Mul[%d] beyond capacity = %v, want %v", i, got[i], want[i])
+		}
+	}
+}
+
+func TestPinnedVec(t *testing.T) {
+	ops := NewVectorOps(1)
+	defer ops.Close()
+
+	for _, n := range []int{0, 1, 7, 1000} {
+		a := ops.Alloc(n)
+		copy(a.Data(), makeData(n))
+		bData := makeData(n)
+		b := PinSlice(bData)
+
+		if got, want := a.Sum(), GoSum(a.Data()); math.Abs(got-want) > 1e-9 {
+			t.Errorf("n=%d: Sum = %v, want %v", n, got, want)
+		}
+		if got, want := a.Dot(b), GoDot(a.Data(), bData); math.Abs(got-want) > 1e-6 {
+			t.Errorf("n=%d: Dot = %v, want %v", n, got, want)
+		}
+
+		want := GoMul(a.Data(), bData)
+		dst := NewPinnedVec(n)
+		a.Mul(b, dst)
+		for i := range want {
+			if dst.Data()[i] != want[i] {
+				t.Fatalf("n=%d: Mul[%d] = %v, want %v", n, i, dst.Data()[i], want[i])
+			}
+		}
+
+		// Scale works in place on the caller's slice
+		orig := append([]float64(nil), bData...)
+		b.Scale(2)
+		for i := range orig {
+			if bData[i] != 2*orig[i] {
+				t.Fatalf("n=%d: Scale[%d] = %v, want %v", n, i, bData[i], 2*orig[i])
+			}
+		}
+		dst.Unpin()
+		b.Unpin()
+		a.Unpin()
+	}
+
+	// Unpinned vectors are no longer held by the VectorOps
+	for i := 0; i < 100; i++ {
+		ops.Alloc(8).Unpin()
+	}
+	kept := ops.Alloc(8)
+	if n := len(ops.vecs); n != 1 {
+		t.Errorf("VectorOps holds %d vectors after Unpin, want 1", n)
+	}
+	ops.Close()
+	if kept.ptr != nil || len(ops.vecs) != 0 {
+		t.Error("Close did not unpin the remaining vector")
+	}
+}
+
+// kernelNames lists the kernels supported here, the default last
+func kernelNames(t testing.TB) []string {
+	def := Kernels()
+	var names []string
+	for _, k := range []string{"generic", "avx2", "avx512", "avx512vnni", "neon", "neondot"} {
+		if k != def && SetKernels(k) == nil {
+			names = append(names, k)
+		}
+	}
+	if err := SetKernels(def); err != nil {
+		t.Fatalf("SetKernels(%q) failed: %v", def, err)
+	}
+	return append(names, def)
+}
+
+// Lengths around every vector width and unroll factor exercise the SIMD
+// kernels' main loops, single-vector loops and scalar or masked tails
+func TestKernelsTails(t *testing.T) {
+	const maxLen = 80
+	ops := NewVectorOps(maxLen + 1)
+	defer ops.Close()
+
+	for _, k := range kernelNames(t) {
+		if err := SetKernels(k); err != nil {
+			t.Fatalf("SetKernels(%q) failed: %v", k, err)
+		}
+		for n := 1; n <= maxLen; n++ {
+			a, b := makeData(n), makeData(n)
+
+			if got, want := ops.Sum(a), GoSum(a); math.Abs(got-want) > 1e-9 {
+				t.Errorf("%s: Sum(len %d) = %v, want %v", k, n, got, want)
+			}
+			if got, want := ops.Dot(a, b), GoDot(a, b); math.Abs(got-want) > 1e-6 {
+				t.Errorf("%s: Dot(len %d) = %v, want %v", k, n, got, want)
+			}
+
+			// Sentinels just past n in the pinned buffers must survive the tails
+			ops.result[n] = -1
+			dst := make([]float64, n)
+			ops.MulInto(a, b, dst)
+			for i := range dst {
+				if dst[i] != a[i]*b[i] {
+					t.Fatalf("%s: Mul(len %d)[%d] = %v, want %v", k, n, i, dst[i], a[i]*b[i])
+				}
+			}
+			if ops.result[n] != -1 {
+				t.Fatalf("%s: Mul(len %d) wrote past the end", k, n)
+			}
+
+			ops.bufferA[n] = -1
+			scaled := append([]float64(nil), a...)
+			ops.Scale(scaled, 0.5)
+			for i := range scaled {
+				if scaled[i] != a[i]*0.5 {
+					t.Fatalf("%s: Scale(len %d)[%d] = %v, want %v", k, n, i, scaled[i], a[i]*0.5)
+				}
+			}
+			if ops.bufferA[n] != -1 {
+				t.Fatalf("%s: Scale(len %d) wrote past the end", k, n)
+			}
+		}
+	}
+
+	if err := SetKernels("sse9"); err == nil {
+		t.Error("expected SetKernels error for unknown kernels")
+	}
+}
+
+// Sum and Dot per kernel set on this CPU
+func BenchmarkKernels(b *testing.B) {
+	defer SetKernels(Kernels())
+	for _, k := range kernelNames(b) {
+		for _, n := range []int{1000, 100000} {
+			ops := NewVectorOps(n)
+			x, y := makeData(n), makeData(n)
+
+			b.Run(fmt.Sprintf("Sum/%s/%d", k, n), func(b *testing.B) {
+				SetKernels(k)
+				b.SetBytes(int64(n * 8))
+				for i := 0; i < b.N; i++ {
+					ops.Sum(x)
+				}
+			})
+			b.Run(fmt.Sprintf("Dot/%s/%d", k, n), func(b *testing.B) {
+				SetKernels(k)
+				b.SetBytes(int64(n * 16))
+				for i := 0; i < b.N; i++ {
+					ops.Dot(x, y)
+				}
+			})
+			ops.Close()
+		}
+	}
+}
+
 // --- Benchmarks ---
 
 // BenchmarkSum compares sum implementations
@@ -95,6 +269,11 @@ func BenchmarkSum_C_Direct_1000(b *testing.B)   { benchmarkCDirect(b, 1000) }
 func BenchmarkSum_C_Direct_10000(b *testing.B)  { benchmarkCDirect(b, 10000) }
 func BenchmarkSum_C_Direct_100000(b *testing.B) { benchmarkCDirect(b, 100000) }
 
+func BenchmarkSum_C_Pinned_100(b *testing.B)    { benchmarkCPinned(b, 100) }
+func BenchmarkSum_C_Pinned_1000(b *testing.B)   { benchmarkCPinned(b, 1000) }
+func BenchmarkSum_C_Pinned_10000(b *testing.B)  { benchmarkCPinned(b, 10000) }
+func BenchmarkSum_C_Pinned_100000(b *testing.B) { benchmarkCPinned(b, 100000) }
+
 func benchmarkGoSum(b *testing.B, n int) {
 	data := makeData(n)
 	b.ResetTimer()
@@ -141,6 +320,16 @@ func benchmarkCDirect(b *testing.B, n int) {
 	}
 }
 
+func benchmarkCPinned(b *testing.B, n int) {
+	data := PinSlice(makeData(n))
+	defer data.Unpin()
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		_ = data.Sum()
+	}
+}
+
 // BenchmarkDot compares dot product implementations
 func BenchmarkDot_Go_1000(b *testing.B)      { benchmarkGoDot(b, 1000) }
 func BenchmarkDot_Go_10000(b *testing.B)     { benchmarkGoDot(b, 10000) }
@@ -158,6 +347,10 @@ func BenchmarkDot_C_Direct_1000(b *testing.B)   { benchmarkCDotDirect(b, 1000) }
 func BenchmarkDot_C_Direct_10000(b *testing.B)  { benchmarkCDotDirect(b, 10000) }
 func BenchmarkDot_C_Direct_100000(b *testing.B) { benchmarkCDotDirect(b, 100000) }
 
+func BenchmarkDot_C_Pinned_1000(b *testing.B)   { benchmarkCDotPinned(b, 1000) }
+func BenchmarkDot_C_Pinned_10000(b *testing.B)  { benchmarkCDotPinned(b, 10000) }
+func BenchmarkDot_C_Pinned_100000(b *testing.B) { benchmarkCDotPinned(b, 100000) }
+
 func benchmarkGoDot(b *testing.B, n int) {
 	a, c := makeData(n), makeData(n)
 	b.ResetTimer()
@@ -199,6 +392,17 @@ func BenchmarkMul_GoInto_10000(b *testing.B)      { benchmarkGoMulInto(b, 10000)
 func BenchmarkMul_C_Optimized_10000(b *testing.B) { benchmarkCMul(b, 10000) }
 func BenchmarkMul_C_Into_10000(b *testing.B)      { benchmarkCMulInto(b, 10000) }
 
+func benchmarkCDotPinned(b *testing.B, n int) {
+	a, c := PinSlice(makeData(n)), PinSlice(makeData(n))
+	defer a.Unpin()
+	defer c.Unpin()
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		_ = a.Dot(c)
+	}
+}
+
 func benchmarkGoMul(b *testing.B, n int) {
 	a, c := makeData(n), makeData(n)
 	b.ResetTimer()
@@ -266,3 +470,339 @@ func BenchmarkOverhead_C_Direct_Empty(b *testing.B) {
 		_ = DirectSum(data)
 	}
 }
+
+// --- Fused pipelines ---
+
+func TestPipeline(t *testing.T) {
+	for _, n := range []int{1, 7, 512, 1000, 5000} {
+		a, b, c := makeData(n), makeData(n), makeData(n)
+		dst := make([]float64, n)
+
+		p := NewPipeline().Load(a).Mul(b).Scale(0.5).Sum().
+			AddScalar(1).Add(c).Store(dst).Dot(c)
+		got, err := p.Run()
+		p.Close()
+		if err != nil {
+			t.Fatalf("n=%d: %v", n, err)
+		}
+
+		var sum, dot float64
+		for i := range a {
+			x := a[i] * b[i] * 0.5
+			sum += x
+			x = x + 1 + c[i]
+			if math.Abs(dst[i]-x) > 1e-9 {
+				t.Fatalf("n=%d: dst[%d] = %v, want %v", n, i, dst[i], x)
+			}
+			dot += x * c[i]
+		}
+		if math.Abs(got[0]-sum) > 1e-9*math.Abs(sum) {
+			t.Errorf("n=%d: Sum = %v, want %v", n, got[0], sum)
+		}
+		if math.Abs(got[1]-dot) > 1e-9*math.Abs(dot) {
+			t.Errorf("n=%d: Dot = %v, want %v", n, got[1], dot)
+		}
+	}
+}
+
+func TestPipelineErrors(t *testing.T) {
+	a := makeData(10)
+	for name, p := range map[string]*Pipeline{
+		"no Load":    NewPipeline().Sum(),
+		"mismatched": NewPipeline().Load(a).Mul(makeData(9)).Sum(),
+		"empty":      NewPipeline(),
+	} {
+		if _, err := p.Run(); err == nil {
+			t.Errorf("%s: expected error", name)
+		}
+		p.Close()
+	}
+
+	p := NewPipeline().Load(a).Sum().Sum()
+	defer p.Close()
+	if err := p.RunInto(make([]float64, 1)); err == nil {
+		t.Error("short results: expected error")
+	}
+}
+
+// BenchmarkPipeline compares Mul, Scale, Sum as three calls and as one
+func BenchmarkPipeline(b *testing.B) {
+	for _, n := range []int{1000, 100000} {
+		x, y := makeData(n), makeData(n)
+
+		b.Run(fmt.Sprintf("Separate/%d", n), func(b *testing.B) {
+			ops := NewVectorOps(n)
+			defer ops.Close()
+			tmp := make([]float64, n)
+			b.SetBytes(int64(16 * n))
+			for i := 0; i < b.N; i++ {
+				ops.MulInto(x, y, tmp)
+				ops.Scale(tmp, 0.5)
+				_ = ops.Sum(tmp)
+			}
+		})
+		b.Run(fmt.Sprintf("Pinned/%d", n), func(b *testing.B) {
+			px, py, tmp := PinSlice(x), PinSlice(y), NewPinnedVec(n)
+			defer px.Unpin()
+			defer py.Unpin()
+			defer tmp.Unpin()
+			b.SetBytes(int64(16 * n))
+			for i := 0; i < b.N; i++ {
+				px.Mul(py, tmp)
+				tmp.Scale(0.5)
+				_ = tmp.Sum()
+			}
+		})
+		b.Run(fmt.Sprintf("Fused/%d", n), func(b *testing.B) {
+			p := NewPipeline().Load(x).Mul(y).Scale(0.5).Sum()
+			defer p.Close()
+			results := make([]float64, p.Results())
+			b.SetBytes(int64(16 * n))
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				if err := p.RunInto(results); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+}
+
+// --- Parallel reductions ---
+
+func TestParallelReductions(t *testing.T) {
+	defer SetParallelThreads(0)
+
+	for _, n := range []int{10, ParallelThreshold - 1, ParallelThreshold, 10*ParallelThreshold + 12345} {
+		a, b := makeData(n), makeData(n)
+		wantSum, wantDot := GoSum(a), GoDot(a, b)
+
+		var sums, dots []float64
+		for _, threads := range []int{1, 2, 3, 8} {
+			if err := SetParallelThreads(threads); err != nil {
+				t.Fatal(err)
+			}
+			if got := ParallelThreads(); got != threads {
+				t.Errorf("ParallelThreads() = %d, want %d", got, threads)
+			}
+			sums = append(sums, ParallelSum(a))
+			dots = append(dots, ParallelDot(a, b))
+		}
+
+		if math.Abs(sums[0]-wantSum) > 1e-9*wantSum {
+			t.Errorf("n=%d: ParallelSum = %v, want %v", n, sums[0], wantSum)
+		}
+		if math.Abs(dots[0]-wantDot) > 1e-9*wantDot {
+			t.Errorf("n=%d: ParallelDot = %v, want %v", n, dots[0], wantDot)
+		}
+		// Bit-identical whatever the thread count
+		for i := range sums {
+			if sums[i] != sums[0] || dots[i] != dots[0] {
+				t.Errorf("n=%d: results vary with thread count: sums %v, dots %v", n, sums, dots)
+				break
+			}
+		}
+	}
+}
+
+func TestParallelConcurrentCallers(t *testing.T) {
+	a := makeData(4 * ParallelThreshold)
+	want := ParallelSum(a)
+
+	// Callers that find the pool busy run the same chunks themselves
+	var wg sync.WaitGroup
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := 0; i < 10; i++ {
+				if got := ParallelSum(a); got != want {
+					t.Errorf("ParallelSum = %v, want %v", got, want)
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+}
+
+func BenchmarkParallelSum(b *testing.B) {
+	for _, n := range []int{100000, 1000000, 10000000} {
+		data := makeData(n)
+		b.Run(fmt.Sprintf("Serial/%d", n), func(b *testing.B) {
+			b.SetBytes(int64(8 * n))
+			for i := 0; i < b.N; i++ {
+				_ = DirectSum(data)
+			}
+		})
+		b.Run(fmt.Sprintf("Parallel/%d", n), func(b *testing.B) {
+			b.SetBytes(int64(8 * n))
+			for i := 0; i < b.N; i++ {
+				_ = ParallelSum(data)
+			}
+		})
+	}
+}
+
+func BenchmarkParallelDot(b *testing.B) {
+	for _, n := range []int{1000000, 10000000} {
+		x, y := makeData(n), makeData(n)
+		b.Run(fmt.Sprintf("Serial/%d", n), func(b *testing.B) {
+			b.SetBytes(int64(16 * n))
+			for i := 0; i < b.N; i++ {
+				_ = DirectDot(x, y)
+			}
+		})
+		b.Run(fmt.Sprintf("Parallel/%d", n), func(b *testing.B) {
+			b.SetBytes(int64(16 * n))
+			for i := 0; i < b.N; i++ {
+				_ = ParallelDot(x, y)
+			}
+		})
+	}
+}
+
+// --- Batched dot products ---
+
+func TestDotMany(t *testing.T) {
+	defer SetKernels(Kernels())
+
+	// Row counts around the 4-row blocks; dims around the vector widths and
+	// past the 2048-element column tile
+	for _, k := range kernelNames(t) {
+		if err := SetKernels(k); err != nil {
+			t.Fatal(err)
+		}
+		for _, rows := range []int{1, 3, 4, 5, 9} {
+			for _, dim := range []int{1, 3, 7, 8, 17, 33, 2048, 4100} {
+				query, matrix := makeData(dim), makeData(rows*dim)
+				out := make([]float64, rows+1)
+				out[rows] = -1
+				if err := DotMany(query, matrix, out); err != nil {
+					t.Fatal(err)
+				}
+				for r := 0; r < rows; r++ {
+					want := GoDot(query, matrix[r*dim:(r+1)*dim])
+					if math.Abs(out[r]-want) > 1e-9*want {
+						t.Errorf("%s: DotMany(%dx%d)[%d] = %v, want %v", k, rows, dim, r, out[r], want)
+					}
+				}
+				if out[rows] != -1 {
+					t.Fatalf("%s: DotMany(%dx%d) wrote past the last row", k, rows, dim)
+				}
+			}
+		}
+	}
+
+	if err := DotMany(nil, nil, nil); err == nil {
+		t.Error("expected error for empty query")
+	}
+	if err := DotMany(makeData(3), makeData(10), make([]float64, 4)); err == nil {
+		t.Error("expected error for ragged matrix")
+	}
+	if err := DotMany(makeData(3), makeData(9), make([]float64, 2)); err == nil {
+		t.Error("expected error for short out")
+	}
+}
+
+func TestTopK(t *testing.T) {
+	const rows, dim = 1000, 24
+	query, matrix := makeData(dim), makeData(rows*dim)
+	// Duplicate rows tie, and the lower index wins; a NaN row never ranks
+	copy(matrix[7*dim:8*dim], matrix[500*dim:501*dim])
+	matrix[3*dim] = math.NaN()
+
+	scores := make([]float64, rows)
+	if err := DotMany(query, matrix, scores); err != nil {
+		t.Fatal(err)
+	}
+	if scores[7] != scores[500] {
+		t.Fatalf("duplicate rows scored %v and %v", scores[7], scores[500])
+	}
+	want := make([]Match, 0, rows)
+	for r, s := range scores {
+		if r != 3 {
+			want = append(want, Match{int64(r), s})
+		}
+	}
+	sort.Slice(want, func(i, j int) bool {
+		if want[i].Score != want[j].Score {
+			return want[i].Score > want[j].Score
+		}
+		return want[i].Index < want[j].Index
+	})
+
+	for _, k := range []int{0, 1, 10, 300, rows - 1, rows + 5} {
+		got, err := TopK(query, matrix, k)
+		if err != nil {
+			t.Fatal(err)
+		}
+		n := min(k, len(want))
+		if len(got) != n {
+			t.Fatalf("TopK(%d) returned %d matches, want %d", k, len(got), n)
+		}
+		for i := range got {
+			if got[i] != want[i] {
+				t.Fatalf("TopK(%d)[%d] = %+v, want %+v", k, i, got[i], want[i])
+			}
+		}
+	}
+}
+
+// BenchmarkDotMany scores one query against a matrix row by row (one cgo
+// call, and for VectorOps one copy, per row) and as a single batch.
+func BenchmarkDotMany(b *testing.B) {
+	for _, dim := range []int{128, 768} {
+		const rows = 10000
+		query, matrix := makeData(dim), makeData(rows*dim)
+		out := make([]float64, rows)
+
+		b.Run(fmt.Sprintf("Go/%d", dim), func(b *testing.B) {
+			b.SetBytes(int64(8 * rows * dim))
+			for i := 0; i < b.N; i++ {
+				for r := range out {
+					out[r] = GoDot(query, matrix[r*dim:(r+1)*dim])
+				}
+			}
+		})
+		b.Run(fmt.Sprintf("VectorOps/%d", dim), func(b *testing.B) {
+			ops := NewVectorOps(dim)
+			defer ops.Close()
+			b.SetBytes(int64(8 * rows * dim))
+			for i := 0; i < b.N; i++ {
+				for r := range out {
+					out[r] = ops.Dot(query, matrix[r*dim:(r+1)*dim])
+				}
+			}
+		})
+		b.Run(fmt.Sprintf("Pinned/%d", dim), func(b *testing.B) {
+			q := PinSlice(query)
+			defer q.Unpin()
+			vecs := make([]*PinnedVec, rows)
+			for r := range vecs {
+				vecs[r] = PinSlice(matrix[r*dim : (r+1)*dim])
+				defer vecs[r].Unpin()
+			}
+			b.SetBytes(int64(8 * rows * dim))
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				for r, v := range vecs {
+					out[r] = q.Dot(v)
+				}
+			}
+		})
+		b.Run(fmt.Sprintf("Batch/%d", dim), func(b *testing.B) {
+			b.SetBytes(int64(8 * rows * dim))
+			for i := 0; i < b.N; i++ {
+				_ = DotMany(query, matrix, out)
+			}
+		})
+		b.Run(fmt.Sprintf("TopK10/%d", dim), func(b *testing.B) {
+			dst := make([]Match, 10)
+			b.SetBytes(int64(8 * rows * dim))
+			for i := 0; i < b.N; i++ {
+				_, _ = TopKInto(query, matrix, dst)
+			}
+		})
+	}
+}
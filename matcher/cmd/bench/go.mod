@@ -0,0 +1,22 @@
+// The matcher benchmark driver is its own module so that neither library
+// module depends on the other: it needs package bench from the root module
+// and the backends from the matcher module. Nothing imports it, so the
+// local replaces below never reach a consumer.
+module github.com/paulstuart/cgo-ffi/matcher/cmd/bench
+
+go 1.25.4
+
+require (
+	github.com/paulstuart/cgo-ffi v0.0.0
+	github.com/paulstuart/cgo-ffi/matcher v0.0.0
+)
+
+require (
+	github.com/bytecodealliance/wasmtime-go/v39 v39.0.1 // indirect
+	github.com/flier/gohs v1.2.3 // indirect
+)
+
+replace (
+	github.com/paulstuart/cgo-ffi => ../../..
+	github.com/paulstuart/cgo-ffi/matcher => ../..
+)
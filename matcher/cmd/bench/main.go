@@ -0,0 +1,174 @@
+// Command bench measures multi-pattern matching on every backend - pure
+// Go (sequential and combined alternations), native Vectorscan and WASM
+// Vectorscan - over a range of pattern counts and hit positions, and
+// reports latency percentiles, allocations and CPU time per call as a
+// table, JSON or CSV, in the same schema as the vector harness in the root
+// module's cmd/bench.
+//
+// Usage:
+//
+//	cd matcher/cmd/bench
+//	go run . [-patterns 8,64,128,256] [-scan-iterations 100]
+//	        [-run regexp] [-format text|json|csv] [-o file] [-label tag]
+//
+// Each pattern count runs on two pattern sets: "full" (the regexps in
+// testdata.MalwarePatterns) and "simple" (the literals in
+// testdata.SimpleMalwarePatterns, which the WASM backend is limited to).
+// Counts larger than a set are skipped for it.
+//
+// The command is a module of its own (see go.mod), since it uses both the
+// root module's package bench and the matcher module, and neither library
+// module depends on the other.
+package main
+
+import (
+	"flag"
+	"fmt"
+	"os"
+	"slices"
+	"strconv"
+
+	"github.com/paulstuart/cgo-ffi/bench"
+	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+	"github.com/paulstuart/cgo-ffi/matcher/vectorscan"
+	wasmvs "github.com/paulstuart/cgo-ffi/matcher/wasm/host"
+)
+
+// Matcher is the part of the backends' API that is benchmarked
+type Matcher interface {
+	Match(input string) int
+	Close()
+}
+
+// backend builds a matcher over a pattern set
+type backend struct {
+	name       string
+	literalsOK bool // only usable on the simple set
+	build      func(patterns []string) (Matcher, error)
+}
+
+var backends = []backend{
+	{"go", false, func(p []string) (Matcher, error) { return gomatcher.NewGoMatcher(p) }},
+	{"go-combined", false, func(p []string) (Matcher, error) { return gomatcher.NewCombinedGoMatcher(p) }},
+	{"vectorscan", false, func(p []string) (Matcher, error) { return vectorscan.NewVsMatcher(p) }},
+	{"wasm-vectorscan", true, func(p []string) (Matcher, error) { return wasmvs.NewWasmMatcher(p) }},
+}
+
+var patternSets = []struct {
+	name     string
+	patterns []string
+}{
+	{"full", testdata.MalwarePatterns},
+	{"simple", testdata.SimpleMalwarePatterns},
+}
+
+// Results go here so no call can be optimized away
+var sink int
+
+func main() {
+	var cfg bench.Config
+	cfg.RegisterFlags(flag.CommandLine)
+	counts := bench.IntList{8, 64, 128, 256}
+	flag.Var(&counts, "patterns", "comma-separated pattern counts")
+	scanIterations := flag.Int("scan-iterations", 100, "timed scans of all test filenames per benchmark")
+	flag.Parse()
+	if err := cfg.Validate(); err != nil {
+		fatal(err)
+	}
+	scanOpts := cfg.Options
+	scanOpts.Iterations = *scanIterations
+	scanOpts.Warmup = 0
+
+	r := cfg.NewRunner("matcher")
+	for _, set := range patternSets {
+		for _, count := range counts {
+			if count > len(set.patterns) {
+				continue
+			}
+			patterns := set.patterns[:count]
+			inputs, err := hitInputs(patterns)
+			if err != nil {
+				fatal(err)
+			}
+
+			for _, be := range backends {
+				if be.literalsOK && set.name != "simple" {
+					continue
+				}
+				m, err := be.build(patterns)
+				if err != nil {
+					fmt.Fprintf(os.Stderr, "skipping %s on %d %s patterns: %v\n", be.name, count, set.name, err)
+					continue
+				}
+
+				params := func(kv ...string) map[string]string {
+					p := map[string]string{"set": set.name, "patterns": strconv.Itoa(count)}
+					for i := 0; i+1 < len(kv); i += 2 {
+						p[kv[i]] = kv[i+1]
+					}
+					return p
+				}
+				for _, hit := range []string{"first", "middle", "last", "none"} {
+					if in, ok := inputs[hit]; ok {
+						r.Run(be.name, "match", params("hit", hit), func() { sink = m.Match(in) })
+					}
+				}
+				files := testdata.TestFilenames
+				r.RunWith(scanOpts, be.name, "scan", params("inputs", strconv.Itoa(len(files))), func() {
+					for _, f := range files {
+						sink = m.Match(f)
+					}
+				})
+				m.Close()
+			}
+		}
+	}
+	if err := r.Write(); err != nil {
+		fatal(err)
+	}
+}
+
+// hitInputs picks test filenames whose first matching pattern (per the Go
+// reference matcher) is the lowest, median and highest index that any
+// filename hits, and one that matches nothing. Every backend is measured
+// on the same inputs.
+func hitInputs(patterns []string) (map[string]string, error) {
+	ref, err := gomatcher.NewGoMatcher(patterns)
+	if err != nil {
+		return nil, err
+	}
+	defer ref.Close()
+
+	type hit struct {
+		file    string
+		pattern int
+	}
+	var hits []hit
+	inputs := map[string]string{}
+	for _, f := range testdata.TestFilenames {
+		if idx := ref.Match(f); idx >= 0 {
+			hits = append(hits, hit{f, idx})
+		} else if _, ok := inputs["none"]; !ok {
+			inputs["none"] = f
+		}
+	}
+	if len(hits) == 0 {
+		return inputs, nil
+	}
+
+	slices.SortStableFunc(hits, func(a, b hit) int { return a.pattern - b.pattern })
+	inputs["first"] = hits[0].file
+	if len(hits) > 2 {
+		inputs["middle"] = hits[len(hits)/2].file
+	}
+	if len(hits) > 1 {
+		inputs["last"] = hits[len(hits)-1].file
+	}
+	return inputs, nil
+}
+
+func fatal(err error) {
+	fmt.Fprintln(os.Stderr, "bench:", err)
+	os.Exit(1)
+}
@@ -11,7 +11,9 @@ package main
 import (
 	"fmt"
 	"math/rand"
+	"runtime"
 	"slices"
+	"sync"
 	"time"
 
 	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
@@ -111,6 +113,12 @@ func main() {
 
 	// WASM comparison (with literal patterns only)
 	runWasmComparison()
+
+	// WASM per-call vs batched matching
+	runBatchComparison()
+
+	// Result cache on skewed traffic
+	runCacheComparison()
 }
 
 func runComparison(patternCount int) {
@@ -168,6 +176,52 @@ func runComparison(patternCount int) {
 	}
 	fmt.Println("  └────────────────────────────────────────────────────────────────────────────┘")
 
+	// === Go combined alternations ===
+	fmt.Println("\n  ┌─ Pure Go (combined alternations) ───────────────────────────────────────┐")
+
+	combStart := time.Now()
+	combMatcher, err := gomatcher.NewCombinedGoMatcher(patterns)
+	if err != nil {
+		fmt.Printf("  │ ERROR: %v\n", err)
+	} else {
+		defer combMatcher.Close()
+		fmt.Printf("  │ Compile time: %v (%d groups)\n", time.Since(combStart), combMatcher.Groups())
+
+		firstHit, middleHit, lastHit := findHitPositions(combMatcher, patternCount)
+
+		if firstHit != "" {
+			s := benchmark(iterations, func() { combMatcher.Match(firstHit) })
+			fmt.Printf("  │ First hit:    %s\n", s)
+		}
+		if middleHit != "" {
+			s := benchmark(iterations, func() { combMatcher.Match(middleHit) })
+			fmt.Printf("  │ Middle hit:   %s\n", s)
+		}
+		if lastHit != "" {
+			s := benchmark(iterations, func() { combMatcher.Match(lastHit) })
+			fmt.Printf("  │ Last hit:     %s\n", s)
+		}
+		if len(benignFiles) > 0 {
+			benign := benignFiles[rand.Intn(len(benignFiles))]
+			s := benchmark(iterations, func() { combMatcher.Match(benign) })
+			fmt.Printf("  │ No match:     %s\n", s)
+		}
+
+		// Batch scan
+		var combMatches int
+		batchStart := time.Now()
+		for _, f := range testdata.TestFilenames {
+			if combMatcher.Match(f) >= 0 {
+				combMatches++
+			}
+		}
+		batchTime := time.Since(batchStart)
+		fmt.Printf("  │ Scan all:     %v (%d files, %d matches, %.0f files/sec)\n",
+			batchTime, len(testdata.TestFilenames), combMatches,
+			float64(len(testdata.TestFilenames))/batchTime.Seconds())
+	}
+	fmt.Println("  └────────────────────────────────────────────────────────────────────────────┘")
+
 	// === Vectorscan Matcher ===
 	fmt.Println("\n  ┌─ Vectorscan (simultaneous matching) ────────────────────────────────────┐")
 
@@ -312,6 +366,68 @@ func runThroughputComparison() {
 	fmt.Printf("  Matches per scan: Go=%d, Vectorscan=%d\n",
 		goTotalMatches/numScans, vsTotalMatches/numScans)
 	fmt.Println()
+
+	runParallelScaling()
+}
+
+// runParallelScaling compares one shared WASM instance against a pool
+// as the number of concurrent workers grows.
+func runParallelScaling() {
+	patterns := testdata.SimpleMalwarePatterns
+	maxProcs := runtime.GOMAXPROCS(0)
+
+	single, err := wasmvs.NewWasmMatcher(patterns)
+	if err != nil {
+		fmt.Printf("WASM ERROR: %v\n", err)
+		return
+	}
+	defer single.Close()
+
+	poolStart := time.Now()
+	pool, err := wasmvs.NewWasmMatcherPool(patterns, maxProcs)
+	if err != nil {
+		fmt.Printf("WASM pool ERROR: %v\n", err)
+		return
+	}
+	defer pool.Close()
+	poolInit := time.Since(poolStart)
+
+	fmt.Printf("  Parallel WASM scaling (%d simple patterns, pool of %d instances, init %v)\n\n",
+		len(patterns), pool.Size(), poolInit.Round(time.Millisecond))
+
+	fmt.Println("  ┌─────────┬──────────────────┬──────────────────┬──────────┐")
+	fmt.Println("  │ Workers │ Single files/sec │ Pool files/sec   │ Pool/1P  │")
+	fmt.Println("  ├─────────┼──────────────────┼──────────────────┼──────────┤")
+
+	var poolBase float64
+	for workers := 1; workers <= maxProcs; workers *= 2 {
+		singleRate := parallelScan(single, testdata.TestFilenames, workers)
+		poolRate := parallelScan(pool, testdata.TestFilenames, workers)
+		if workers == 1 {
+			poolBase = poolRate
+		}
+		fmt.Printf("  │ %7d │ %16.0f │ %16.0f │ %7.1fx │\n",
+			workers, singleRate, poolRate, poolRate/poolBase)
+	}
+	fmt.Println("  └─────────┴──────────────────┴──────────────────┴──────────┘")
+	fmt.Println()
+}
+
+// parallelScan has each worker scan all inputs once and returns files/sec.
+func parallelScan(m Matcher, inputs []string, workers int) float64 {
+	var wg sync.WaitGroup
+	start := time.Now()
+	for w := 0; w < workers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for _, f := range inputs {
+				m.Match(f)
+			}
+		}()
+	}
+	wg.Wait()
+	return float64(workers*len(inputs)) / time.Since(start).Seconds()
 }
 
 // findHitPositions finds test files that match patterns at different positions (Go matcher)
@@ -427,7 +543,23 @@ func runWasmComparison() {
 	}
 	defer wasmMatcher.Close()
 	wasmInitTime := time.Since(wasmStart)
-	fmt.Printf("  WASM initialization time: %v\n\n", wasmInitTime)
+	fmt.Printf("  WASM initialization time: %v\n", wasmInitTime)
+
+	// Startup from a precompiled database instead of compiling patterns
+	if db, err := wasmMatcher.Serialize(); err != nil {
+		fmt.Printf("  WASM serialize ERROR: %v\n", err)
+	} else {
+		loadStart := time.Now()
+		loaded, err := wasmvs.NewWasmMatcherFromDB(db)
+		if err != nil {
+			fmt.Printf("  WASM load ERROR: %v\n", err)
+		} else {
+			fmt.Printf("  WASM load-from-DB time: %v (database: %.1f KB)\n",
+				time.Since(loadStart), float64(len(db))/1024)
+			loaded.Close()
+		}
+	}
+	fmt.Println()
 
 	// Warm up
 	for _, f := range testInputs[:10] {
@@ -526,3 +658,158 @@ func runWasmComparison() {
 	fmt.Printf("  Native vs WASM:        %.1fx faster\n", wasmAvg.Seconds()/vsAvg.Seconds())
 	fmt.Printf("\n  Matches: Go=%d, Native=%d, WASM=%d\n\n", goMatches, vsMatches, wasmMatches)
 }
+
+func runBatchComparison() {
+	fmt.Printf("╔══════════════════════════════════════════════════════════════════════════════╗\n")
+	fmt.Printf("║  WASM BATCH COMPARISON (per-call Match vs MatchBatch)                        ║\n")
+	fmt.Printf("╚══════════════════════════════════════════════════════════════════════════════╝\n\n")
+
+	patterns := testdata.SimpleMalwarePatterns
+	testInputs := testdata.TestFilenames
+	numScans := 10
+
+	wasmMatcher, err := wasmvs.NewWasmMatcher(patterns)
+	if err != nil {
+		fmt.Printf("WASM ERROR: %v\n", err)
+		return
+	}
+	defer wasmMatcher.Close()
+
+	// Warm up (also sizes the batch arena)
+	for _, f := range testInputs[:10] {
+		wasmMatcher.Match(f)
+	}
+	wasmMatcher.MatchBatch(testInputs)
+
+	// Benchmark per-call Match
+	var callTimes []time.Duration
+	var callMatches int
+	for i := 0; i < numScans; i++ {
+		matches := 0
+		start := time.Now()
+		for _, f := range testInputs {
+			if wasmMatcher.Match(f) >= 0 {
+				matches++
+			}
+		}
+		callTimes = append(callTimes, time.Since(start))
+		if i == 0 {
+			callMatches = matches
+		}
+	}
+
+	// Benchmark MatchBatch
+	var batchTimes []time.Duration
+	var batchMatches int
+	for i := 0; i < numScans; i++ {
+		matches := 0
+		start := time.Now()
+		for _, r := range wasmMatcher.MatchBatch(testInputs) {
+			if r >= 0 {
+				matches++
+			}
+		}
+		batchTimes = append(batchTimes, time.Since(start))
+		if i == 0 {
+			batchMatches = matches
+		}
+	}
+
+	slices.Sort(callTimes)
+	slices.Sort(batchTimes)
+
+	var callTotal, batchTotal time.Duration
+	for i := 0; i < numScans; i++ {
+		callTotal += callTimes[i]
+		batchTotal += batchTimes[i]
+	}
+	callAvg := callTotal / time.Duration(numScans)
+	batchAvg := batchTotal / time.Duration(numScans)
+
+	callFilesPerSec := float64(len(testInputs)) / callAvg.Seconds()
+	batchFilesPerSec := float64(len(testInputs)) / batchAvg.Seconds()
+
+	fmt.Printf("  Patterns: %d (simple literals from SimpleMalwarePatterns)\n", len(patterns))
+	fmt.Printf("  Inputs per batch: %d\n", len(testInputs))
+	fmt.Printf("  Scans: %d\n\n", numScans)
+
+	fmt.Println("  ┌─────────────────────┬──────────────┬──────────────┬────────────┐")
+	fmt.Println("  │ Implementation      │ Avg Time     │ Min Time     │ Files/sec  │")
+	fmt.Println("  ├─────────────────────┼──────────────┼──────────────┼────────────┤")
+	fmt.Printf("  │ WASM Match          │ %12v │ %12v │ %10.0f │\n",
+		callAvg.Round(time.Microsecond), callTimes[0].Round(time.Microsecond), callFilesPerSec)
+	fmt.Printf("  │ WASM MatchBatch     │ %12v │ %12v │ %10.0f │\n",
+		batchAvg.Round(time.Microsecond), batchTimes[0].Round(time.Microsecond), batchFilesPerSec)
+	fmt.Println("  └─────────────────────┴──────────────┴──────────────┴────────────┘")
+
+	fmt.Printf("\n  Batch vs per-call speedup: %.1fx\n", callAvg.Seconds()/batchAvg.Seconds())
+	fmt.Printf("  Per-input cost: Match=%s, MatchBatch=%s\n",
+		formatDuration(callAvg/time.Duration(len(testInputs))),
+		formatDuration(batchAvg/time.Duration(len(testInputs))))
+	fmt.Printf("\n  Matches: Match=%d, MatchBatch=%d\n\n", callMatches, batchMatches)
+}
+
+// runCacheComparison replays a Zipf-distributed stream of filenames, where a
+// few names dominate as in production, against each matcher with and
+// without a CachedMatcher in front.
+func runCacheComparison() {
+	fmt.Printf("╔══════════════════════════════════════════════════════════════════════════════╗\n")
+	fmt.Printf("║  RESULT CACHE (Zipf s=1.1 over test filenames, 256 patterns)                 ║\n")
+	fmt.Printf("╚══════════════════════════════════════════════════════════════════════════════╝\n\n")
+
+	patterns := testdata.MalwarePatterns
+	files := testdata.TestFilenames
+	cacheSize := 256
+	numInputs := 100000
+
+	zipf := rand.NewZipf(rand.New(rand.NewSource(1)), 1.1, 1, uint64(len(files)-1))
+	inputs := make([]string, numInputs)
+	for i := range inputs {
+		inputs[i] = files[zipf.Uint64()]
+	}
+
+	goMatcher, err := gomatcher.NewGoMatcher(patterns)
+	if err != nil {
+		fmt.Printf("Go ERROR: %v\n", err)
+		return
+	}
+	vsMatcher, err := vectorscan.NewVsMatcher(patterns)
+	if err != nil {
+		fmt.Printf("Vectorscan ERROR: %v\n", err)
+		return
+	}
+	// The cached wrappers own (and close) the matchers
+	cachedGo := gomatcher.NewCachedMatcher(goMatcher, cacheSize)
+	defer cachedGo.Close()
+	cachedVs := gomatcher.NewCachedMatcher(vsMatcher, cacheSize)
+	defer cachedVs.Close()
+
+	run := func(m Matcher) time.Duration {
+		start := time.Now()
+		for _, in := range inputs {
+			m.Match(in)
+		}
+		return time.Since(start)
+	}
+
+	fmt.Printf("  Inputs: %d (%d distinct files), cache size: %d entries\n\n", numInputs, len(files), cacheSize)
+	fmt.Println("  ┌─────────────────┬──────────────┬──────────────┬──────────┬──────────┐")
+	fmt.Println("  │ Implementation  │ Uncached     │ Cached       │ Speedup  │ Hit rate │")
+	fmt.Println("  ├─────────────────┼──────────────┼──────────────┼──────────┼──────────┤")
+	for _, row := range []struct {
+		name   string
+		plain  Matcher
+		cached *gomatcher.CachedMatcher
+	}{
+		{"Pure Go", goMatcher, cachedGo},
+		{"Vectorscan", vsMatcher, cachedVs},
+	} {
+		plain := run(row.plain)
+		cached := run(row.cached)
+		fmt.Printf("  │ %-15s │ %12v │ %12v │ %7.1fx │ %7.1f%% │\n",
+			row.name, plain.Round(time.Microsecond), cached.Round(time.Microsecond),
+			plain.Seconds()/cached.Seconds(), row.cached.Stats().HitRate()*100)
+	}
+	fmt.Println("  └─────────────────┴──────────────┴──────────────┴──────────┴──────────┘")
+	fmt.Println()
+}
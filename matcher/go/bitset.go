@@ -0,0 +1,75 @@
+package matcher
+
+import "math/bits"
+
+// Bitset is a reusable set of pattern indices, one bit per pattern, used as
+// the destination of the MatchAllInto methods. Reusing one Bitset across
+// calls makes all-matches scans allocation-free.
+type Bitset struct {
+	words []uint64
+	n     int
+}
+
+// NewBitset returns an empty Bitset sized for n patterns.
+func NewBitset(n int) *Bitset {
+	b := &Bitset{}
+	b.Reset(n)
+	return b
+}
+
+// Reset empties b and sizes it for n patterns, reusing its storage when
+// large enough.
+func (b *Bitset) Reset(n int) {
+	w := (n + 63) / 64
+	if cap(b.words) < w {
+		b.words = make([]uint64, w)
+	} else {
+		b.words = b.words[:w]
+		for i := range b.words {
+			b.words[i] = 0
+		}
+	}
+	b.n = n
+}
+
+// Len returns the number of patterns b is sized for.
+func (b *Bitset) Len() int {
+	return b.n
+}
+
+// Words returns the backing words; bit i%64 of word i/64 is pattern i.
+// Backends fill it directly.
+func (b *Bitset) Words() []uint64 {
+	return b.words
+}
+
+// Set adds pattern i.
+func (b *Bitset) Set(i int) {
+	b.words[i/64] |= 1 << (uint(i) % 64)
+}
+
+// Has reports whether pattern i is in b.
+func (b *Bitset) Has(i int) bool {
+	if i < 0 || i >= b.n {
+		return false
+	}
+	return b.words[i/64]&(1<<(uint(i)%64)) != 0
+}
+
+// Count returns the number of patterns in b.
+func (b *Bitset) Count() int {
+	n := 0
+	for _, w := range b.words {
+		n += bits.OnesCount64(w)
+	}
+	return n
+}
+
+// AppendTo appends the patterns in b to dst in ascending order.
+func (b *Bitset) AppendTo(dst []int) []int {
+	forEachCandidate(b.words, func(i int) bool {
+		dst = append(dst, i)
+		return true
+	})
+	return dst
+}
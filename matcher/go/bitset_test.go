@@ -0,0 +1,32 @@
+package matcher
+
+import "testing"
+
+func TestBitset(t *testing.T) {
+	b := NewBitset(130)
+	if b.Len() != 130 || len(b.Words()) != 3 {
+		t.Fatalf("Len() = %d, words = %d; want 130, 3", b.Len(), len(b.Words()))
+	}
+	for _, i := range []int{0, 63, 64, 129} {
+		b.Set(i)
+	}
+	if b.Count() != 4 {
+		t.Errorf("Count() = %d, want 4", b.Count())
+	}
+	if !b.Has(64) || b.Has(65) || b.Has(-1) || b.Has(130) {
+		t.Error("Has returned wrong membership")
+	}
+	if got := b.AppendTo(nil); !intSliceEqual(got, []int{0, 63, 64, 129}) {
+		t.Errorf("AppendTo = %v", got)
+	}
+
+	// Reset reuses storage and clears it
+	words := &b.Words()[0]
+	b.Reset(70)
+	if &b.Words()[0] != words || b.Count() != 0 || len(b.Words()) != 2 {
+		t.Error("Reset did not clear and reuse storage")
+	}
+	if n := testing.AllocsPerRun(100, func() { b.Reset(128); b.Set(100) }); n != 0 {
+		t.Errorf("Reset allocs/op = %v, want 0", n)
+	}
+}
@@ -0,0 +1,204 @@
+package matcher
+
+import (
+	"fmt"
+	"hash/maphash"
+	"sync"
+	"sync/atomic"
+)
+
+// CachedMatcher memoizes Match results of any Matcher.
+//
+// Real traffic is heavily skewed - the same filenames and user agents
+// arrive over and over - so a small cache in front of the matcher lets
+// repeated inputs skip the regex engine, cgo or WASM call entirely.
+//
+// The cache is set-associative: an input's hash selects one bucket of
+// cacheWays slots, each an atomic pointer to an immutable entry. Lookups
+// are lock-free loads and compares; inserts take a per-stripe mutex and
+// evict with CLOCK (second chance) inside the bucket. Every entry carries
+// the generation it was computed under, and Reload/Invalidate bump the
+// generation, so stale results vanish without touching the table.
+//
+// Only Match is cached; MatchAll goes straight to the wrapped matcher.
+type CachedMatcher struct {
+	inner Matcher
+	seed  maphash.Seed
+
+	slots []atomic.Pointer[cacheEntry]
+	mask  uint64 // bucket count - 1
+
+	gen     atomic.Uint64
+	stripes [cacheStripes]cacheStripe
+}
+
+// cacheEntry is never modified after publication, except its CLOCK bit.
+type cacheEntry struct {
+	hash   uint64
+	gen    uint64
+	key    string
+	result int
+	ref    atomic.Uint32
+}
+
+// cacheStripe serializes inserts into its buckets - bucket b belongs to
+// stripe b % cacheStripes, so each bucket has exactly one lock - and keeps
+// its own counters, so hits on different stripes never share a cache line.
+type cacheStripe struct {
+	mu     sync.Mutex
+	hits   atomic.Uint64
+	misses atomic.Uint64
+	_      [40]byte
+}
+
+const (
+	cacheWays    = 4
+	cacheStripes = 64
+
+	// DefaultCacheSize is the entry count NewCachedMatcher uses for size <= 0.
+	DefaultCacheSize = 4096
+
+	// MaxCachedInput is the longest input that is cached. Entries keep a
+	// reference to the input, so big ones would pin memory for little gain.
+	MaxCachedInput = 1024
+)
+
+// CacheStats reports cache effectiveness.
+type CacheStats struct {
+	Hits   uint64
+	Misses uint64
+}
+
+// HitRate returns Hits / (Hits + Misses), or 0 before any lookup.
+func (s CacheStats) HitRate() float64 {
+	if total := s.Hits + s.Misses; total > 0 {
+		return float64(s.Hits) / float64(total)
+	}
+	return 0
+}
+
+// NewCachedMatcher wraps m with a result cache of about size entries
+// (rounded up to a power of two). A size <= 0 uses DefaultCacheSize.
+// The cache takes ownership of m; Close closes it.
+func NewCachedMatcher(m Matcher, size int) *CachedMatcher {
+	if size <= 0 {
+		size = DefaultCacheSize
+	}
+	buckets := 1
+	for buckets*cacheWays < size {
+		buckets <<= 1
+	}
+	return &CachedMatcher{
+		inner: m,
+		seed:  maphash.MakeSeed(),
+		slots: make([]atomic.Pointer[cacheEntry], buckets*cacheWays),
+		mask:  uint64(buckets - 1),
+	}
+}
+
+// Match returns the index of the first matching pattern, or -1 if no match,
+// from the cache when input was seen since the last reload.
+func (c *CachedMatcher) Match(input string) int {
+	if len(input) > MaxCachedInput {
+		return c.inner.Match(input)
+	}
+
+	h := maphash.String(c.seed, input)
+	gen := c.gen.Load()
+	b := h & c.mask
+	stripe := &c.stripes[b%cacheStripes]
+	bucket := c.slots[b*cacheWays : (b+1)*cacheWays]
+
+	for i := range bucket {
+		e := bucket[i].Load()
+		if e != nil && e.hash == h && e.gen == gen && e.key == input {
+			if e.ref.Load() == 0 {
+				e.ref.Store(1)
+			}
+			stripe.hits.Add(1)
+			return e.result
+		}
+	}
+
+	stripe.misses.Add(1)
+	result := c.inner.Match(input)
+
+	// Tagged with the generation read before matching: if a reload raced
+	// with this call the entry is already stale and never served
+	e := &cacheEntry{hash: h, gen: gen, key: input, result: result}
+	stripe.mu.Lock()
+	c.insertLocked(bucket, e)
+	stripe.mu.Unlock()
+	return result
+}
+
+// insertLocked stores e in its bucket. A slot that is empty, stale or holds
+// the same key is reused first; otherwise CLOCK evicts the first entry whose
+// bit is clear, clearing bits as it passes.
+func (c *CachedMatcher) insertLocked(bucket []atomic.Pointer[cacheEntry], e *cacheEntry) {
+	gen := c.gen.Load()
+	for i := range bucket {
+		old := bucket[i].Load()
+		if old == nil || old.gen != gen || (old.hash == e.hash && old.key == e.key) {
+			bucket[i].Store(e)
+			return
+		}
+	}
+	for pass := 0; pass < 2; pass++ {
+		for i := range bucket {
+			old := bucket[i].Load()
+			if old.ref.Load() == 0 {
+				bucket[i].Store(e)
+				return
+			}
+			old.ref.Store(0)
+		}
+	}
+	bucket[0].Store(e)
+}
+
+// MatchAll returns indices of all matching patterns. It is not cached.
+func (c *CachedMatcher) MatchAll(input string) []int {
+	return c.inner.MatchAll(input)
+}
+
+// PatternCount returns the number of patterns.
+func (c *CachedMatcher) PatternCount() int {
+	return c.inner.PatternCount()
+}
+
+// Invalidate drops every cached result. Call it after changing the wrapped
+// matcher's rules by any means other than Reload.
+func (c *CachedMatcher) Invalidate() {
+	c.gen.Add(1)
+}
+
+// Reload reloads the wrapped matcher and invalidates the cache. The matcher
+// must have a Reload(patterns []string) error method (VsMatcher,
+// WasmMatcher, WasmMatcherPool).
+func (c *CachedMatcher) Reload(patterns []string) error {
+	r, ok := c.inner.(interface{ Reload([]string) error })
+	if !ok {
+		return fmt.Errorf("%T does not support Reload", c.inner)
+	}
+	if err := r.Reload(patterns); err != nil {
+		return err
+	}
+	c.Invalidate()
+	return nil
+}
+
+// Stats returns the hit and miss counts since creation.
+func (c *CachedMatcher) Stats() CacheStats {
+	var s CacheStats
+	for i := range c.stripes {
+		s.Hits += c.stripes[i].hits.Load()
+		s.Misses += c.stripes[i].misses.Load()
+	}
+	return s
+}
+
+// Close closes the wrapped matcher.
+func (c *CachedMatcher) Close() {
+	c.inner.Close()
+}
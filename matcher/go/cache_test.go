@@ -0,0 +1,197 @@
+package matcher
+
+import (
+	"math/rand"
+	"sync"
+	"testing"
+
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+)
+
+// reloadableMatcher counts Match calls and supports Reload
+type reloadableMatcher struct {
+	*GoMatcher
+	calls int
+}
+
+func (r *reloadableMatcher) Match(input string) int {
+	r.calls++
+	return r.GoMatcher.Match(input)
+}
+
+func (r *reloadableMatcher) Reload(patterns []string) error {
+	m, err := NewGoMatcher(patterns)
+	if err != nil {
+		return err
+	}
+	r.GoMatcher = m
+	return nil
+}
+
+func TestCachedMatcher_Match(t *testing.T) {
+	gm, err := NewGoMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	inner := &reloadableMatcher{GoMatcher: gm}
+	// Far more buckets than names, so no bucket overflows whatever the
+	// hash seed and nothing is evicted
+	c := NewCachedMatcher(inner, 1<<16)
+	defer c.Close()
+
+	for pass := 0; pass < 2; pass++ {
+		for _, f := range testdata.TestFilenames {
+			if got, want := c.Match(f), gm.Match(f); got != want {
+				t.Fatalf("pass %d: Match(%q) = %d, want %d", pass, f, got, want)
+			}
+		}
+	}
+
+	// Only the first sighting of each name reaches the matcher
+	unique := make(map[string]bool)
+	for _, f := range testdata.TestFilenames {
+		unique[f] = true
+	}
+	if inner.calls != len(unique) {
+		t.Errorf("inner Match called %d times, want %d", inner.calls, len(unique))
+	}
+	s := c.Stats()
+	total := uint64(2 * len(testdata.TestFilenames))
+	if s.Misses != uint64(len(unique)) || s.Hits != total-s.Misses {
+		t.Errorf("Stats() = %+v, want %d misses of %d", s, len(unique), total)
+	}
+	if want := float64(s.Hits) / float64(total); s.HitRate() != want {
+		t.Errorf("HitRate() = %v, want %v", s.HitRate(), want)
+	}
+}
+
+func TestCachedMatcher_Reload(t *testing.T) {
+	gm, err := NewGoMatcher([]string{`foo`})
+	if err != nil {
+		t.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	c := NewCachedMatcher(&reloadableMatcher{GoMatcher: gm}, 16)
+	defer c.Close()
+
+	if got := c.Match("foobar"); got != 0 {
+		t.Fatalf("Match(foobar) = %d, want 0", got)
+	}
+	if err := c.Reload([]string{`bar`, `foo`}); err != nil {
+		t.Fatalf("Reload failed: %v", err)
+	}
+	if got := c.Match("foobar"); got != 0 {
+		t.Errorf("Match(foobar) after reload = %d, want 0", got)
+	}
+	if got := c.Match("foo"); got != 1 {
+		t.Errorf("Match(foo) after reload = %d, want 1", got)
+	}
+
+	plain := NewCachedMatcher(gm, 16)
+	if err := plain.Reload([]string{`bar`}); err == nil {
+		t.Error("expected Reload error for a matcher without Reload")
+	}
+}
+
+// A small cache stays bounded and correct under constant eviction
+func TestCachedMatcher_Eviction(t *testing.T) {
+	gm, err := NewGoMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	c := NewCachedMatcher(gm, 8)
+	if len(c.slots) != 8 {
+		t.Fatalf("cache has %d slots, want 8", len(c.slots))
+	}
+
+	for pass := 0; pass < 3; pass++ {
+		for _, f := range testdata.TestFilenames {
+			if got, want := c.Match(f), gm.Match(f); got != want {
+				t.Fatalf("Match(%q) = %d, want %d", f, got, want)
+			}
+		}
+	}
+}
+
+func TestCachedMatcher_Concurrent(t *testing.T) {
+	gm, err := NewGoMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	c := NewCachedMatcher(gm, 64)
+
+	want := make([]int, len(testdata.TestFilenames))
+	for i, f := range testdata.TestFilenames {
+		want[i] = gm.Match(f)
+	}
+
+	var wg sync.WaitGroup
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func(seed int64) {
+			defer wg.Done()
+			r := rand.New(rand.NewSource(seed))
+			for n := 0; n < 2000; n++ {
+				i := r.Intn(len(testdata.TestFilenames))
+				if got := c.Match(testdata.TestFilenames[i]); got != want[i] {
+					t.Errorf("Match(%q) = %d, want %d", testdata.TestFilenames[i], got, want[i])
+					return
+				}
+				if n%500 == 0 {
+					c.Invalidate()
+				}
+			}
+		}(int64(g))
+	}
+	wg.Wait()
+}
+
+// Skewed traffic: a Zipf draw over the filenames, as in cmd's cache demo
+func BenchmarkGoMatcher_Zipf(b *testing.B) {
+	gm, err := NewGoMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	benchmarkZipf(b, gm)
+}
+
+func BenchmarkCachedMatcher_Zipf(b *testing.B) {
+	gm, err := NewGoMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	c := NewCachedMatcher(gm, 256)
+	benchmarkZipf(b, c)
+	b.ReportMetric(c.Stats().HitRate()*100, "hit%")
+}
+
+func benchmarkZipf(b *testing.B, m Matcher) {
+	files := testdata.TestFilenames
+	zipf := rand.NewZipf(rand.New(rand.NewSource(1)), 1.1, 1, uint64(len(files)-1))
+	inputs := make([]string, 1<<16)
+	for i := range inputs {
+		inputs[i] = files[zipf.Uint64()]
+	}
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.Match(inputs[i&(len(inputs)-1)])
+	}
+}
+
+func BenchmarkCachedMatcher_Parallel(b *testing.B) {
+	gm, err := NewGoMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	c := NewCachedMatcher(gm, 0)
+	files := testdata.TestFilenames
+
+	b.ResetTimer()
+	b.RunParallel(func(pb *testing.PB) {
+		i := 0
+		for pb.Next() {
+			c.Match(files[i%len(files)])
+			i++
+		}
+	})
+}
@@ -0,0 +1,164 @@
+package matcher
+
+import (
+	"fmt"
+	"regexp"
+	"regexp/syntax"
+	"strings"
+)
+
+// altGroup is a run of consecutive patterns compiled as one alternation.
+type altGroup struct {
+	screen *regexp.Regexp // (p0)|(p1)|...; nil for a single pattern matched on its own
+	re     *regexp.Regexp // branch-identifying form, run only after screen hits
+	lo, hi int            // pattern indices [lo, hi)
+	slots  []int          // submatch-index slot of each branch's capture group
+}
+
+// Group limits for NewCombinedGoMatcher. Go's regexp has no DFA; its NFA
+// costs grow with program size times input length, and a wide alternation
+// defeats the literal-prefix scan single patterns get, so groups are capped
+// both in branches and in total compiled instructions. A pattern over the
+// instruction budget on its own is matched alone.
+const (
+	maxGroupPatterns = 8
+	maxGroupInsts    = 2000
+)
+
+// NewCombinedGoMatcher creates a GoMatcher that merges consecutive patterns
+// into bounded alternations, so one regexp pass replaces a MatchString per
+// pattern.
+//
+// A group is first screened with a (p0)|(p1)|... MatchString. The branches
+// are captures rather than (?:p) because the parser factors common prefixes
+// out of non-capturing alternations, merging e.g. a literal A from one
+// pattern with a case-folded a from the next. Only on a hit does the
+// identifying form run: each branch wrapped as (?s:.*?)(p) with the group
+// anchored at ^, so every branch starts at offset 0 and leftmost-first
+// alternation picks the first branch that matches anywhere - the lowest
+// pattern index, as GoMatcher.Match requires. The wrapping capture group
+// names that branch in FindStringSubmatchIndex.
+func NewCombinedGoMatcher(patterns []string) (*GoMatcher, error) {
+	m, err := NewGoMatcher(patterns)
+	if err != nil {
+		return nil, err
+	}
+
+	start, insts := 0, 0
+	for i, p := range patterns {
+		n := progSize(p)
+		if i > start && (i-start == maxGroupPatterns || insts+n > maxGroupInsts) {
+			if err := m.addGroup(start, i); err != nil {
+				return nil, err
+			}
+			start, insts = i, 0
+		}
+		insts += n
+	}
+	if err := m.addGroup(start, len(patterns)); err != nil {
+		return nil, err
+	}
+	return m, nil
+}
+
+// progSize returns the compiled program length of p.
+func progSize(p string) int {
+	re, err := syntax.Parse(p, syntax.Perl)
+	if err != nil {
+		return maxGroupInsts
+	}
+	prog, err := syntax.Compile(re.Simplify())
+	if err != nil {
+		return maxGroupInsts
+	}
+	return len(prog.Inst)
+}
+
+// addGroup compiles patterns [lo, hi) as one group. A group of one pattern
+// keeps using the pattern's own regexp.
+func (m *GoMatcher) addGroup(lo, hi int) error {
+	if hi <= lo {
+		return nil
+	}
+	g := altGroup{lo: lo, hi: hi}
+	if hi-lo == 1 {
+		m.groups = append(m.groups, g)
+		return nil
+	}
+
+	var screen, ident strings.Builder
+	ident.WriteString("^(?:")
+	group := 1
+	for i := lo; i < hi; i++ {
+		if i > lo {
+			screen.WriteByte('|')
+			ident.WriteByte('|')
+		}
+		src := m.patterns[i].String()
+		screen.WriteString("(" + src + ")")
+		ident.WriteString("(?s:.*?)(" + src + ")")
+		g.slots = append(g.slots, 2*group)
+		group += 1 + m.patterns[i].NumSubexp()
+	}
+	ident.WriteByte(')')
+
+	var err error
+	if g.screen, err = regexp.Compile(screen.String()); err == nil {
+		g.re, err = regexp.Compile(ident.String())
+	}
+	if err != nil {
+		return fmt.Errorf("patterns %d-%d: combining: %w", lo, hi-1, err)
+	}
+	m.groups = append(m.groups, g)
+	return nil
+}
+
+// matchCombined runs one pass per group, in pattern order.
+func (m *GoMatcher) matchCombined(input string) int {
+	for i := range m.groups {
+		g := &m.groups[i]
+		if g.screen == nil {
+			if m.patterns[g.lo].MatchString(input) {
+				return g.lo
+			}
+			continue
+		}
+		if !g.screen.MatchString(input) {
+			continue
+		}
+		loc := g.re.FindStringSubmatchIndex(input)
+		if loc == nil {
+			continue
+		}
+		for b, slot := range g.slots {
+			if loc[slot] >= 0 {
+				return g.lo + b
+			}
+		}
+	}
+	return -1
+}
+
+// matchAllCombined screens each group with one pass and confirms its
+// patterns individually only when the group matches.
+func (m *GoMatcher) matchAllCombined(input string) []int {
+	var matches []int
+	for i := range m.groups {
+		g := &m.groups[i]
+		if g.screen != nil && !g.screen.MatchString(input) {
+			continue
+		}
+		for p := g.lo; p < g.hi; p++ {
+			if m.patterns[p].MatchString(input) {
+				matches = append(matches, p)
+			}
+		}
+	}
+	return matches
+}
+
+// Groups returns the number of regexp passes a combined matcher makes per
+// Match, or 0 for other modes.
+func (m *GoMatcher) Groups() int {
+	return len(m.groups)
+}
@@ -0,0 +1,148 @@
+package matcher
+
+import (
+	"math/rand"
+	"strings"
+	"testing"
+
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+)
+
+// Combined groups must keep GoMatcher's lowest-index result even when a
+// higher-index pattern matches earlier in the input
+func TestCombinedGoMatcher_Equivalent(t *testing.T) {
+	mixed := []string{
+		`tail$`,
+		`(?i)MIDDLE`, // flag must not leak into later branches
+		`middle(\d+)`,
+		`^head`,
+		`(a)(b)(c)`,
+		`x|y`,
+	}
+	inputs := append(append([]string{}, testdata.TestFilenames...),
+		"head middle tail", "xx MIDDLE", "middle42", "abc", "y", "Head", "", "no",
+	)
+
+	for name, patterns := range map[string][]string{
+		"mixed":   mixed,
+		"simple":  testdata.SimpleMalwarePatterns,
+		"malware": testdata.MalwarePatterns,
+	} {
+		plain, err := NewGoMatcher(patterns)
+		if err != nil {
+			t.Fatalf("%s: NewGoMatcher failed: %v", name, err)
+		}
+		combined, err := NewCombinedGoMatcher(patterns)
+		if err != nil {
+			t.Fatalf("%s: NewCombinedGoMatcher failed: %v", name, err)
+		}
+		t.Logf("%s: %d patterns in %d groups", name, combined.PatternCount(), combined.Groups())
+
+		for _, input := range inputs {
+			if got, want := combined.Match(input), plain.Match(input); got != want {
+				t.Errorf("%s: Match(%q) = %d, want %d", name, input, got, want)
+			}
+			if got, want := combined.MatchAll(input), plain.MatchAll(input); !intSliceEqual(got, want) {
+				t.Errorf("%s: MatchAll(%q) = %v, want %v", name, input, got, want)
+			}
+		}
+	}
+}
+
+// Random patterns over a small alphabet mix case folding, anchors and
+// repetition so neighbouring branches share prefixes the regexp parser
+// would otherwise factor across patterns
+func TestCombinedGoMatcher_Differential(t *testing.T) {
+	atoms := []string{"a", "A", "b", "k", "x", `\.`, `\d`, "exe", "EXE", "[ab]", "(?:k|k)", "(?:b|EXE)", "(?i)a"}
+	reps := []string{"", "", "?", "+", "*", "{0,1}", "{2}"}
+	pattern := func(r *rand.Rand) string {
+		var sb strings.Builder
+		for n := 1 + r.Intn(3); n > 0; n-- {
+			sb.WriteString(atoms[r.Intn(len(atoms))] + reps[r.Intn(len(reps))])
+		}
+		if r.Intn(3) == 0 {
+			sb.WriteByte('$')
+		}
+		return sb.String()
+	}
+	const alphabet = "aAbkKx.1eE"
+	input := func(r *rand.Rand) string {
+		b := make([]byte, r.Intn(6))
+		for i := range b {
+			b[i] = alphabet[r.Intn(len(alphabet))]
+		}
+		return string(b)
+	}
+
+	check := func(patterns, inputs []string) {
+		t.Helper()
+		plain, err := NewGoMatcher(patterns)
+		if err != nil {
+			t.Fatalf("NewGoMatcher(%q) failed: %v", patterns, err)
+		}
+		combined, err := NewCombinedGoMatcher(patterns)
+		if err != nil {
+			t.Fatalf("NewCombinedGoMatcher(%q) failed: %v", patterns, err)
+		}
+		for _, in := range inputs {
+			if got, want := combined.Match(in), plain.Match(in); got != want {
+				t.Fatalf("patterns %q: Match(%q) = %d, want %d", patterns, in, got, want)
+			}
+			if got, want := combined.MatchAll(in), plain.MatchAll(in); !intSliceEqual(got, want) {
+				t.Fatalf("patterns %q: MatchAll(%q) = %v, want %v", patterns, in, got, want)
+			}
+		}
+	}
+
+	// A prefix factored out of A\d$|(?i)a$ once hid pattern 6 here
+	check([]string{"a?exe{0,1}$", "A{2}(?:k|k){0,1}", "a{0,1}b(?i)ab*(?:x|[ab])", `\.{2}$`,
+		`\.{0,1}k+$`, `A\dx{0,1}$`, "(?i)ab*$", `(?:b|EXE)+\d?`, `\.?`}, []string{"KKa"})
+
+	r := rand.New(rand.NewSource(1))
+	for iter := 0; iter < 500; iter++ {
+		patterns := make([]string, 2+r.Intn(2*maxGroupPatterns))
+		for i := range patterns {
+			patterns[i] = pattern(r)
+		}
+		inputs := make([]string, 50)
+		for i := range inputs {
+			inputs[i] = input(r)
+		}
+		check(patterns, inputs)
+	}
+}
+
+func TestCombinedGoMatcher_Groups(t *testing.T) {
+	m, err := NewCombinedGoMatcher(generatePatterns(100))
+	if err != nil {
+		t.Fatalf("NewCombinedGoMatcher failed: %v", err)
+	}
+	if want := (100 + maxGroupPatterns - 1) / maxGroupPatterns; m.Groups() != want {
+		t.Errorf("Groups() = %d, want %d", m.Groups(), want)
+	}
+
+	// A pattern over the instruction budget is matched on its own
+	huge := "(" + strings.Repeat("[a-z]", maxGroupInsts) + ")"
+	m, err = NewCombinedGoMatcher([]string{"a", "b", huge, "c"})
+	if err != nil {
+		t.Fatalf("NewCombinedGoMatcher failed: %v", err)
+	}
+	if m.Groups() != 3 {
+		t.Errorf("Groups() = %d, want 3", m.Groups())
+	}
+	if got := m.Match("c"); got != 3 {
+		t.Errorf("Match(c) = %d, want 3", got)
+	}
+}
+
+func BenchmarkCombinedGoMatcher_AllFiles(b *testing.B) {
+	m, err := NewCombinedGoMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewCombinedGoMatcher failed: %v", err)
+	}
+	benchmarkFilenames(b, m)
+}
+
+func BenchmarkCombinedGoMatcher_Benign(b *testing.B) {
+	benchmarkScanFiles(b, NewCombinedGoMatcher, testdata.BenignFilenames())
+}
@@ -0,0 +1,161 @@
+package matcher
+
+import (
+	"regexp/syntax"
+	"strings"
+)
+
+// literalKind classifies a pattern for HybridMatcher.
+type literalKind int
+
+const (
+	kindRegex    literalKind = iota // needs the regex engine
+	kindExact                       // ^literal$
+	kindSuffix                      // literal$
+	kindContains                    // literal anywhere
+)
+
+// maxExactFold bounds caseless exact keys so lookups can fold the input
+// into a stack buffer; longer literals stay on the regex path.
+const maxExactFold = 256
+
+// classifyLiteral reports whether the pattern is a plain literal, optionally
+// anchored: ^lit$, lit$ or lit. Caseless literals only qualify when folding
+// is ASCII-only (see foldSafe), so a byte-wise lower-case compare equals
+// what regexp would do. The returned literal is lower-cased when fold is set.
+func classifyLiteral(pattern string) (kind literalKind, lit string, fold bool) {
+	re, err := syntax.Parse(pattern, syntax.Perl)
+	if err != nil {
+		return kindRegex, "", false
+	}
+	for re.Op == syntax.OpCapture {
+		re = re.Sub[0]
+	}
+
+	var subs []*syntax.Regexp
+	if re.Op == syntax.OpConcat {
+		subs = re.Sub
+	} else {
+		subs = []*syntax.Regexp{re}
+	}
+
+	begin, end := false, false
+	if len(subs) > 0 && subs[0].Op == syntax.OpBeginText {
+		begin = true
+		subs = subs[1:]
+	}
+	if len(subs) > 0 && subs[len(subs)-1].Op == syntax.OpEndText {
+		end = true
+		subs = subs[:len(subs)-1]
+	}
+
+	var b strings.Builder
+	for i, sub := range subs {
+		for sub.Op == syntax.OpCapture {
+			sub = sub.Sub[0]
+		}
+		if sub.Op != syntax.OpLiteral {
+			return kindRegex, "", false
+		}
+		f := sub.Flags&syntax.FoldCase != 0
+		if i > 0 && f != fold {
+			return kindRegex, "", false
+		}
+		fold = f
+		for _, r := range sub.Rune {
+			if fold && !foldSafe(r) {
+				return kindRegex, "", false
+			}
+			b.WriteRune(r)
+		}
+	}
+	lit = b.String()
+	if fold {
+		lit = strings.ToLower(lit)
+	}
+
+	switch {
+	case begin && end:
+		if fold && len(lit) > maxExactFold {
+			return kindRegex, "", false
+		}
+		return kindExact, lit, fold
+	case begin:
+		return kindRegex, "", false
+	case lit == "":
+		return kindRegex, "", false
+	case end:
+		return kindSuffix, lit, fold
+	}
+	return kindContains, lit, fold
+}
+
+// suffixTrie indexes literals by their reversed bytes, so walking the input
+// backwards from its end visits every literal that is a suffix of it.
+type suffixTrie struct {
+	// (node<<8 | byte) -> child node
+	edges map[uint32]int32
+
+	// Pattern indices whose literal ends at each node, ascending
+	ids [][]int32
+}
+
+func newSuffixTrie() *suffixTrie {
+	return &suffixTrie{edges: make(map[uint32]int32), ids: make([][]int32, 1)}
+}
+
+func (t *suffixTrie) add(lit string, id int32) {
+	node := int32(0)
+	for i := len(lit) - 1; i >= 0; i-- {
+		key := uint32(node)<<8 | uint32(lit[i])
+		next, ok := t.edges[key]
+		if !ok {
+			next = int32(len(t.ids))
+			t.ids = append(t.ids, nil)
+			t.edges[key] = next
+		}
+		node = next
+	}
+	t.ids[node] = append(t.ids[node], id)
+}
+
+// walk calls fn with the ids of each literal that is a suffix of input,
+// shortest first, until fn returns false. fold lower-cases input bytes.
+func (t *suffixTrie) walk(input string, fold bool, fn func(ids []int32) bool) {
+	node := int32(0)
+	for i := len(input) - 1; i >= 0; i-- {
+		c := input[i]
+		if fold && 'A' <= c && c <= 'Z' {
+			c += 'a' - 'A'
+		}
+		next, ok := t.edges[uint32(node)<<8|uint32(c)]
+		if !ok {
+			return
+		}
+		node = next
+		if ids := t.ids[node]; len(ids) > 0 && !fn(ids) {
+			return
+		}
+	}
+}
+
+// empty reports whether the trie holds no literals.
+func (t *suffixTrie) empty() bool {
+	return len(t.ids) == 1
+}
+
+// foldASCII lower-cases input into buf, returning false if it does not fit.
+func foldASCII(buf []byte, input string) ([]byte, bool) {
+	if len(input) > len(buf) {
+		return nil, false
+	}
+	buf = buf[:len(input)]
+	for i := 0; i < len(input); i++ {
+		c := input[i]
+		if 'A' <= c && c <= 'Z' {
+			c += 'a' - 'A'
+		}
+		buf[i] = c
+	}
+	return buf, true
+}
@@ -7,6 +7,9 @@ package matcher
 import (
 	"fmt"
 	"regexp"
+	"sort"
+	"strings"
+	"sync"
 )
 
 // Matcher interface for multi-pattern regex matching.
@@ -28,6 +31,14 @@ type Matcher interface {
 // Patterns are matched sequentially in order.
 type GoMatcher struct {
 	patterns []*regexp.Regexp
+
+	// Optional literal prefilter (NewPrefilteredGoMatcher) and pooled
+	// candidate bitsets for it
+	prefilter  *Prefilter
+	candidates sync.Pool
+
+	// Alternation groups (NewCombinedGoMatcher), in pattern order
+	groups []altGroup
 }
 
 // NewGoMatcher creates a new GoMatcher from the given pattern strings.
@@ -44,9 +55,33 @@ func NewGoMatcher(patterns []string) (*GoMatcher, error) {
 	return &GoMatcher{patterns: compiled}, nil
 }
 
+// NewPrefilteredGoMatcher creates a GoMatcher with a literal prefilter.
+// One Aho-Corasick pass over the input selects the candidate patterns, and
+// only those run through regexp; an input containing none of the required
+// literals is rejected without a single MatchString call.
+func NewPrefilteredGoMatcher(patterns []string) (*GoMatcher, error) {
+	m, err := NewGoMatcher(patterns)
+	if err != nil {
+		return nil, err
+	}
+	m.prefilter = NewPrefilter(patterns, false)
+	words := m.prefilter.Words()
+	m.candidates.New = func() interface{} {
+		set := make([]uint64, words)
+		return &set
+	}
+	return m, nil
+}
+
 // Match returns the index of the first matching pattern, or -1 if no match.
 // Patterns are tested in order; returns on first match.
 func (m *GoMatcher) Match(input string) int {
+	if m.prefilter != nil {
+		return m.matchPrefiltered(input)
+	}
+	if m.groups != nil {
+		return m.matchCombined(input)
+	}
 	for i, re := range m.patterns {
 		if re.MatchString(input) {
 			return i
@@ -55,8 +90,33 @@ func (m *GoMatcher) Match(input string) int {
 	return -1
 }
 
+// matchPrefiltered confirms candidate patterns in index order.
+func (m *GoMatcher) matchPrefiltered(input string) int {
+	setp := m.candidates.Get().(*[]uint64)
+	defer m.candidates.Put(setp)
+	if !m.prefilter.Candidates(input, *setp) {
+		return -1
+	}
+
+	result := -1
+	forEachCandidate(*setp, func(i int) bool {
+		if m.patterns[i].MatchString(input) {
+			result = i
+			return false
+		}
+		return true
+	})
+	return result
+}
+
 // MatchAll returns indices of all matching patterns.
 func (m *GoMatcher) MatchAll(input string) []int {
+	if m.prefilter != nil {
+		return m.matchAllPrefiltered(input)
+	}
+	if m.groups != nil {
+		return m.matchAllCombined(input)
+	}
 	var matches []int
 	for i, re := range m.patterns {
 		if re.MatchString(input) {
@@ -66,6 +126,23 @@ func (m *GoMatcher) MatchAll(input string) []int {
 	return matches
 }
 
+func (m *GoMatcher) matchAllPrefiltered(input string) []int {
+	setp := m.candidates.Get().(*[]uint64)
+	defer m.candidates.Put(setp)
+	if !m.prefilter.Candidates(input, *setp) {
+		return nil
+	}
+
+	var matches []int
+	forEachCandidate(*setp, func(i int) bool {
+		if m.patterns[i].MatchString(input) {
+			matches = append(matches, i)
+		}
+		return true
+	})
+	return matches
+}
+
 // PatternCount returns the number of patterns.
 func (m *GoMatcher) PatternCount() int {
 	return len(m.patterns)
@@ -73,3 +150,224 @@ func (m *GoMatcher) PatternCount() int {
 
 // Close releases resources. For GoMatcher this is a no-op.
 func (m *GoMatcher) Close() {}
+
+// HybridMatcher implements Matcher by sending each pattern to the cheapest
+// engine that can decide it, while keeping GoMatcher's lowest-index result.
+//
+// Patterns are classified at construction:
+//   - ^literal$ goes into a hash table keyed by the whole input
+//   - literal$ goes into a reversed-suffix trie walked from the input's end
+//   - a bare literal goes into one Aho-Corasick automaton (see Prefilter)
+//   - everything else stays on regexp, behind its own Prefilter
+//
+// Match consults the literal indexes first, then runs only the candidate
+// regexps whose index is below the best literal hit, so a rule set
+// dominated by filenames and extensions rarely touches regexp at all.
+type HybridMatcher struct {
+	count int
+
+	// ^literal$: exact input -> ascending pattern indices
+	exact     map[string][]int32
+	exactFold map[string][]int32
+
+	// literal$
+	suffix     *suffixTrie
+	suffixFold *suffixTrie
+
+	// Bare literals: the automaton's local index maps to these
+	contains     *Prefilter
+	containsID   []int32
+	containsLit  []string
+	containsFold []bool
+	candidates   sync.Pool
+
+	// Fallback, in ascending pattern order
+	regexps  []*regexp.Regexp
+	regexIDs []int32
+	fallback *Prefilter
+}
+
+// NewHybridMatcher creates a HybridMatcher from the given pattern strings.
+// Returns an error if any pattern fails to compile.
+func NewHybridMatcher(patterns []string) (*HybridMatcher, error) {
+	m := &HybridMatcher{
+		count:      len(patterns),
+		exact:      make(map[string][]int32),
+		exactFold:  make(map[string][]int32),
+		suffix:     newSuffixTrie(),
+		suffixFold: newSuffixTrie(),
+	}
+
+	var quoted, rest []string
+	for i, p := range patterns {
+		re, err := regexp.Compile(p)
+		if err != nil {
+			return nil, fmt.Errorf("pattern %d (%q): %w", i, p, err)
+		}
+
+		id := int32(i)
+		kind, lit, fold := classifyLiteral(p)
+		switch kind {
+		case kindExact:
+			if fold {
+				m.exactFold[lit] = append(m.exactFold[lit], id)
+			} else {
+				m.exact[lit] = append(m.exact[lit], id)
+			}
+		case kindSuffix:
+			if fold {
+				m.suffixFold.add(lit, id)
+			} else {
+				m.suffix.add(lit, id)
+			}
+		case kindContains:
+			quoted = append(quoted, regexp.QuoteMeta(lit))
+			m.containsID = append(m.containsID, id)
+			m.containsLit = append(m.containsLit, lit)
+			m.containsFold = append(m.containsFold, fold)
+		default:
+			m.regexps = append(m.regexps, re)
+			m.regexIDs = append(m.regexIDs, id)
+			rest = append(rest, p)
+		}
+	}
+
+	m.contains = NewPrefilter(quoted, false)
+	m.fallback = NewPrefilter(rest, false)
+	words := m.fallback.Words()
+	if w := m.contains.Words(); w > words {
+		words = w
+	}
+	m.candidates.New = func() interface{} {
+		set := make([]uint64, words)
+		return &set
+	}
+	return m, nil
+}
+
+// IndexedCount returns the number of patterns served by the literal
+// indexes rather than regexp.
+func (m *HybridMatcher) IndexedCount() int {
+	return m.count - len(m.regexps)
+}
+
+// Match returns the index of the first matching pattern, or -1 if no match.
+// The result is the same as GoMatcher.Match for the same patterns.
+func (m *HybridMatcher) Match(input string) int {
+	best := int32(m.count)
+	m.lookupLiterals(input, func(id int32) bool {
+		if id < best {
+			best = id
+		}
+		return false
+	})
+
+	if len(m.regexps) > 0 && best > m.regexIDs[0] {
+		setp := m.candidates.Get().(*[]uint64)
+		if set := (*setp)[:m.fallback.Words()]; m.fallback.Candidates(input, set) {
+			forEachCandidate(set, func(i int) bool {
+				if m.regexIDs[i] >= best {
+					return false
+				}
+				if m.regexps[i].MatchString(input) {
+					best = m.regexIDs[i]
+					return false
+				}
+				return true
+			})
+		}
+		m.candidates.Put(setp)
+	}
+	if best == int32(m.count) {
+		return -1
+	}
+	return int(best)
+}
+
+// MatchAll returns indices of all matching patterns.
+func (m *HybridMatcher) MatchAll(input string) []int {
+	var matches []int
+	m.lookupLiterals(input, func(id int32) bool {
+		matches = append(matches, int(id))
+		return true
+	})
+	if len(m.regexps) > 0 {
+		setp := m.candidates.Get().(*[]uint64)
+		if set := (*setp)[:m.fallback.Words()]; m.fallback.Candidates(input, set) {
+			forEachCandidate(set, func(i int) bool {
+				if m.regexps[i].MatchString(input) {
+					matches = append(matches, int(m.regexIDs[i]))
+				}
+				return true
+			})
+		}
+		m.candidates.Put(setp)
+	}
+	sort.Ints(matches)
+	return matches
+}
+
+// lookupLiterals reports literal-pattern hits to fn. Hits arrive in
+// ascending order within each list (an exact key, a trie node, the
+// automaton's candidates); fn returns false to skip the rest of that list.
+func (m *HybridMatcher) lookupLiterals(input string, fn func(id int32) bool) {
+	each := func(ids []int32) bool {
+		for _, id := range ids {
+			if !fn(id) {
+				return false
+			}
+		}
+		return true
+	}
+
+	if ids := m.exact[input]; len(ids) > 0 {
+		each(ids)
+	}
+	if len(m.exactFold) > 0 {
+		var buf [maxExactFold]byte
+		if folded, ok := foldASCII(buf[:], input); ok {
+			if ids := m.exactFold[string(folded)]; len(ids) > 0 {
+				each(ids)
+			}
+		}
+	}
+
+	// Suffix walks visit shorter literals first, not lower indices, so they
+	// always run to the end
+	walk := func(ids []int32) bool {
+		each(ids)
+		return true
+	}
+	if !m.suffix.empty() {
+		m.suffix.walk(input, false, walk)
+	}
+	if !m.suffixFold.empty() {
+		m.suffixFold.walk(input, true, walk)
+	}
+
+	if len(m.containsID) == 0 {
+		return
+	}
+	setp := m.candidates.Get().(*[]uint64)
+	defer m.candidates.Put(setp)
+	set := (*setp)[:m.contains.Words()]
+	if !m.contains.Candidates(input, set) {
+		return
+	}
+	forEachCandidate(set, func(i int) bool {
+		// The automaton folds ASCII case; a case-sensitive literal still
+		// needs an exact compare
+		if !m.containsFold[i] && !strings.Contains(input, m.containsLit[i]) {
+			return true
+		}
+		return fn(m.containsID[i])
+	})
+}
+
+// PatternCount returns the number of patterns.
+func (m *HybridMatcher) PatternCount() int {
+	return m.count
+}
+
+// Close releases resources. For HybridMatcher this is a no-op.
+func (m *HybridMatcher) Close() {}
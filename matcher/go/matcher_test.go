@@ -3,6 +3,8 @@ package matcher
 import (
 	"fmt"
 	"testing"
+
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
 )
 
 func TestGoMatcher_Match(t *testing.T) {
@@ -197,3 +199,127 @@ func generateInput(length, patternIdx int) string {
 	}
 	return string(padding) + " " + pattern
 }
+
+func TestClassifyLiteral(t *testing.T) {
+	tests := []struct {
+		pattern string
+		kind    literalKind
+		lit     string
+		fold    bool
+	}{
+		{`^passwd$`, kindExact, "passwd", false},
+		{`(?i)^Autorun\.inf$`, kindExact, "autorun.inf", true},
+		{`(?i)^Thumbs\.db$`, kindRegex, "", false}, // 's' folds to U+017F
+		{`\.exe$`, kindSuffix, ".exe", false},
+		{`(?i)\.DLL$`, kindSuffix, ".dll", true},
+		{`mimikatz`, kindContains, "mimikatz", false},
+		{`(mimikatz)`, kindContains, "mimikatz", false},
+		{`(?i)kernel32`, kindRegex, "", false}, // 'k' folds to U+212A
+		{`^/etc/`, kindRegex, "", false},
+		{`\.(exe|dll)$`, kindRegex, "", false},
+		{`$`, kindRegex, "", false},
+		{`(?m)\.exe$`, kindRegex, "", false},
+	}
+
+	for _, tt := range tests {
+		kind, lit, fold := classifyLiteral(tt.pattern)
+		if kind != tt.kind || lit != tt.lit || fold != tt.fold {
+			t.Errorf("classifyLiteral(%q) = %d, %q, %v; want %d, %q, %v",
+				tt.pattern, kind, lit, fold, tt.kind, tt.lit, tt.fold)
+		}
+	}
+}
+
+// HybridMatcher must agree with the sequential reference on every input
+func TestHybridMatcher_Equivalent(t *testing.T) {
+	mixed := []string{
+		`(?i)\.scr$`,
+		`^/usr/bin/ls$`,
+		`(?i)^desktop\.ini$`,
+		`Invoice`,
+		`(?i)invoice`,
+		`\.(exe|dll)$`,
+		`\.sh$`,
+		`(?i)\.PDF\.sh$`,
+		`^\d+$`,
+		`ryuk`,
+	}
+	inputs := append(append([]string{}, testdata.TestFilenames...),
+		"/usr/bin/ls", "/USR/BIN/LS", "DESKTOP.INI", "invoice.pdf.SH",
+		"12345", "x.scr", "", "\u212aernel32.dll",
+	)
+
+	for name, patterns := range map[string][]string{
+		"mixed":   mixed,
+		"simple":  testdata.SimpleMalwarePatterns,
+		"malware": testdata.MalwarePatterns,
+	} {
+		plain, err := NewGoMatcher(patterns)
+		if err != nil {
+			t.Fatalf("%s: NewGoMatcher failed: %v", name, err)
+		}
+		hybrid, err := NewHybridMatcher(patterns)
+		if err != nil {
+			t.Fatalf("%s: NewHybridMatcher failed: %v", name, err)
+		}
+		t.Logf("%s: %d of %d patterns indexed", name, hybrid.IndexedCount(), hybrid.PatternCount())
+
+		for _, input := range inputs {
+			if got, want := hybrid.Match(input), plain.Match(input); got != want {
+				t.Errorf("%s: Match(%q) = %d, want %d", name, input, got, want)
+			}
+			if got, want := hybrid.MatchAll(input), plain.MatchAll(input); !intSliceEqual(got, want) {
+				t.Errorf("%s: MatchAll(%q) = %v, want %v", name, input, got, want)
+			}
+		}
+	}
+}
+
+func TestHybridMatcher_InvalidPattern(t *testing.T) {
+	if _, err := NewHybridMatcher([]string{`valid`, `[invalid`}); err == nil {
+		t.Error("expected error for invalid pattern")
+	}
+}
+
+// Filename scans: sequential regexp vs literal indexes with regexp fallback
+func BenchmarkGoMatcher_Filenames(b *testing.B) {
+	m, err := NewGoMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	benchmarkFilenames(b, m)
+}
+
+func BenchmarkHybridMatcher_Filenames(b *testing.B) {
+	m, err := NewHybridMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewHybridMatcher failed: %v", err)
+	}
+	benchmarkFilenames(b, m)
+}
+
+func BenchmarkHybridMatcher_Filenames_Simple(b *testing.B) {
+	m, err := NewHybridMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewHybridMatcher failed: %v", err)
+	}
+	benchmarkFilenames(b, m)
+}
+
+func BenchmarkGoMatcher_Filenames_Simple(b *testing.B) {
+	m, err := NewGoMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	benchmarkFilenames(b, m)
+}
+
+func benchmarkFilenames(b *testing.B, m Matcher) {
+	defer m.Close()
+	files := testdata.TestFilenames
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.Match(files[i%len(files)])
+	}
+}
@@ -0,0 +1,197 @@
+package matcher
+
+import (
+	"fmt"
+	"regexp"
+	"runtime"
+	"sync"
+	"sync/atomic"
+)
+
+// ParallelGoMatcher implements Matcher by splitting the patterns into
+// contiguous shards scanned concurrently, for deployments that cannot use
+// the cgo or WASM backends but have large rule sets.
+//
+// Each shard beyond the first is owned by a long-lived worker goroutine;
+// the calling goroutine scans shard 0 itself. Shards publish hits into a
+// shared atomic "best so far", and each shard stops once the best is below
+// its next pattern, so a match in a low shard cuts the others short while
+// the result stays the lowest matching index, exactly as GoMatcher.Match.
+//
+// Close must not race with Match or MatchAll.
+type ParallelGoMatcher struct {
+	patterns []*regexp.Regexp
+
+	// shards[i] = [bounds[i], bounds[i+1])
+	bounds  []int
+	workers []chan *parallelJob
+	wg      sync.WaitGroup
+	jobs    sync.Pool
+}
+
+// parallelJob is one Match or MatchAll call, shared by all shards.
+type parallelJob struct {
+	input string
+	all   bool
+
+	// Lowest matching index so far (len(patterns) if none)
+	best atomic.Int64
+
+	// Per-shard hits in MatchAll mode
+	hits [][]int
+	done sync.WaitGroup
+}
+
+// minShardSize keeps shards large enough that scanning dwarfs the handoff.
+const minShardSize = 32
+
+// Worker queue depth; several concurrent callers can be in flight per shard.
+const shardQueueDepth = 64
+
+// NewParallelGoMatcher creates a ParallelGoMatcher over at most workers
+// shards. A workers <= 0 uses runtime.GOMAXPROCS(0).
+// Returns an error if any pattern fails to compile.
+func NewParallelGoMatcher(patterns []string, workers int) (*ParallelGoMatcher, error) {
+	compiled := make([]*regexp.Regexp, len(patterns))
+	for i, p := range patterns {
+		re, err := regexp.Compile(p)
+		if err != nil {
+			return nil, fmt.Errorf("pattern %d (%q): %w", i, p, err)
+		}
+		compiled[i] = re
+	}
+
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
+	}
+	shards := (len(patterns) + minShardSize - 1) / minShardSize
+	if shards > workers {
+		shards = workers
+	}
+	if shards < 1 {
+		shards = 1
+	}
+
+	m := &ParallelGoMatcher{patterns: compiled}
+	for i := 0; i <= shards; i++ {
+		m.bounds = append(m.bounds, i*len(patterns)/shards)
+	}
+	for s := 1; s < shards; s++ {
+		ch := make(chan *parallelJob, shardQueueDepth)
+		m.workers = append(m.workers, ch)
+		m.wg.Add(1)
+		go m.worker(s, ch)
+	}
+	m.jobs.New = func() interface{} {
+		return &parallelJob{hits: make([][]int, shards)}
+	}
+	return m, nil
+}
+
+func (m *ParallelGoMatcher) worker(shard int, jobs <-chan *parallelJob) {
+	defer m.wg.Done()
+	for job := range jobs {
+		m.scanShard(shard, job)
+		job.done.Done()
+	}
+}
+
+// scanShard scans one shard for job.
+func (m *ParallelGoMatcher) scanShard(shard int, job *parallelJob) {
+	lo, hi := m.bounds[shard], m.bounds[shard+1]
+	if job.all {
+		var hits []int
+		for i := lo; i < hi; i++ {
+			if m.patterns[i].MatchString(job.input) {
+				hits = append(hits, i)
+			}
+		}
+		job.hits[shard] = hits
+		return
+	}
+
+	for i := lo; i < hi; i++ {
+		if int64(i) >= job.best.Load() {
+			return
+		}
+		if m.patterns[i].MatchString(job.input) {
+			lowerBest(&job.best, int64(i))
+			return
+		}
+	}
+}
+
+// lowerBest atomically sets best to min(best, i).
+func lowerBest(best *atomic.Int64, i int64) {
+	for {
+		cur := best.Load()
+		if i >= cur || best.CompareAndSwap(cur, i) {
+			return
+		}
+	}
+}
+
+// run fans job out to the workers, scans shard 0 inline and waits.
+func (m *ParallelGoMatcher) run(job *parallelJob) {
+	job.done.Add(len(m.workers))
+	for _, ch := range m.workers {
+		ch <- job
+	}
+	m.scanShard(0, job)
+	job.done.Wait()
+}
+
+// Match returns the index of the first matching pattern, or -1 if no match.
+func (m *ParallelGoMatcher) Match(input string) int {
+	job := m.jobs.Get().(*parallelJob)
+	job.input, job.all = input, false
+	job.best.Store(int64(len(m.patterns)))
+
+	m.run(job)
+
+	best := int(job.best.Load())
+	job.input = ""
+	m.jobs.Put(job)
+	if best == len(m.patterns) {
+		return -1
+	}
+	return best
+}
+
+// MatchAll returns indices of all matching patterns.
+func (m *ParallelGoMatcher) MatchAll(input string) []int {
+	job := m.jobs.Get().(*parallelJob)
+	job.input, job.all = input, true
+
+	m.run(job)
+
+	var matches []int
+	for s, hits := range job.hits {
+		matches = append(matches, hits...)
+		job.hits[s] = nil
+	}
+	job.input = ""
+	m.jobs.Put(job)
+	return matches
+}
+
+// PatternCount returns the number of patterns.
+func (m *ParallelGoMatcher) PatternCount() int {
+	return len(m.patterns)
+}
+
+// Shards returns the number of shards patterns are split into.
+func (m *ParallelGoMatcher) Shards() int {
+	return len(m.bounds) - 1
+}
+
+// Close stops the worker goroutines. The matcher stays usable afterwards,
+// scanning every pattern on the calling goroutine.
+func (m *ParallelGoMatcher) Close() {
+	for _, ch := range m.workers {
+		close(ch)
+	}
+	m.wg.Wait()
+	m.workers = nil
+	m.bounds = []int{0, len(m.patterns)}
+}
@@ -0,0 +1,130 @@
+package matcher
+
+import (
+	"fmt"
+	"sync"
+	"testing"
+
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+)
+
+func TestParallelGoMatcher_Equivalent(t *testing.T) {
+	ref, err := NewGoMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewGoMatcher failed: %v", err)
+	}
+
+	for _, workers := range []int{1, 2, 3, 8, 0} {
+		m, err := NewParallelGoMatcher(testdata.MalwarePatterns, workers)
+		if err != nil {
+			t.Fatalf("NewParallelGoMatcher failed: %v", err)
+		}
+		for _, f := range testdata.TestFilenames {
+			if got, want := m.Match(f), ref.Match(f); got != want {
+				t.Errorf("workers=%d shards=%d: Match(%q) = %d, want %d", workers, m.Shards(), f, got, want)
+			}
+			if got, want := m.MatchAll(f), ref.MatchAll(f); !intSliceEqual(got, want) {
+				t.Errorf("workers=%d: MatchAll(%q) = %v, want %v", workers, f, got, want)
+			}
+		}
+
+		// Still correct (sequential) after the workers stop
+		m.Close()
+		for _, f := range testdata.TestFilenames {
+			if got, want := m.Match(f), ref.Match(f); got != want {
+				t.Errorf("workers=%d after Close: Match(%q) = %d, want %d", workers, f, got, want)
+			}
+		}
+	}
+}
+
+func TestParallelGoMatcher_Shards(t *testing.T) {
+	small, err := NewParallelGoMatcher([]string{"a", "b"}, 8)
+	if err != nil {
+		t.Fatalf("NewParallelGoMatcher failed: %v", err)
+	}
+	defer small.Close()
+	if small.Shards() != 1 {
+		t.Errorf("Shards() = %d for 2 patterns, want 1", small.Shards())
+	}
+
+	large, err := NewParallelGoMatcher(generatePatterns(1000), 4)
+	if err != nil {
+		t.Fatalf("NewParallelGoMatcher failed: %v", err)
+	}
+	defer large.Close()
+	if large.Shards() != 4 {
+		t.Errorf("Shards() = %d, want 4", large.Shards())
+	}
+
+	if _, err := NewParallelGoMatcher([]string{`[bad`}, 2); err == nil {
+		t.Error("expected error for invalid pattern")
+	}
+}
+
+func TestParallelGoMatcher_Concurrent(t *testing.T) {
+	ref, err := NewGoMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	m, err := NewParallelGoMatcher(testdata.MalwarePatterns, 4)
+	if err != nil {
+		t.Fatalf("NewParallelGoMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	want := make([]int, len(testdata.TestFilenames))
+	for i, f := range testdata.TestFilenames {
+		want[i] = ref.Match(f)
+	}
+
+	var wg sync.WaitGroup
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i, f := range testdata.TestFilenames {
+				if got := m.Match(f); got != want[i] {
+					t.Errorf("Match(%q) = %d, want %d", f, got, want[i])
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+}
+
+// Per-input latency on a miss, which has to visit every pattern
+func BenchmarkParallelGoMatcher_NoMatch_256(b *testing.B) {
+	benchmarkParallelNoMatch(b, testdata.MalwarePatterns)
+}
+
+func BenchmarkParallelGoMatcher_NoMatch_5000(b *testing.B) {
+	benchmarkParallelNoMatch(b, generatePatterns(5000))
+}
+
+func benchmarkParallelNoMatch(b *testing.B, patterns []string) {
+	input := "/usr/share/doc/readme.txt"
+	for _, workers := range []int{1, 2, 4, 8} {
+		b.Run(fmt.Sprintf("workers=%d", workers), func(b *testing.B) {
+			m, err := NewParallelGoMatcher(patterns, workers)
+			if err != nil {
+				b.Fatalf("NewParallelGoMatcher failed: %v", err)
+			}
+			defer m.Close()
+
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				m.Match(input)
+			}
+		})
+	}
+}
+
+func BenchmarkParallelGoMatcher_AllFiles(b *testing.B) {
+	m, err := NewParallelGoMatcher(testdata.MalwarePatterns, 0)
+	if err != nil {
+		b.Fatalf("NewParallelGoMatcher failed: %v", err)
+	}
+	benchmarkFilenames(b, m)
+}
@@ -0,0 +1,364 @@
+package matcher
+
+import (
+	"math/bits"
+	"regexp/syntax"
+	"unicode/utf8"
+)
+
+// Prefilter is a literal index placed in front of a regex engine.
+//
+// At construction each pattern is parsed and reduced to a small set of
+// required literals: any match of the pattern must contain at least one of
+// them. All literals go into a single Aho-Corasick automaton, so one pass
+// over the input finds every pattern that could possibly match. Patterns
+// with no extractable literal (e.g. `^\d+$`) are always candidates.
+//
+// Matching is ASCII case-insensitive, which makes the index a safe superset
+// for both case-sensitive and (?i) patterns; candidates must still be
+// confirmed by the real engine.
+type Prefilter struct {
+	// Byte -> alphabet class; bytes absent from every literal share class 0
+	classes [256]byte
+	stride  int
+
+	// Dense DFA: trans[state*stride+class] is the next state (failure
+	// transitions pre-resolved), so the scan loop never backtracks
+	trans []int32
+
+	// Patterns whose literal ends at a state, and the next state along the
+	// suffix chain that also has output (-1 if none)
+	own    [][]int32
+	dict   []int32
+	output []bool
+
+	// Bitset of patterns that are always candidates
+	base []uint64
+
+	count      int
+	unfiltered int
+}
+
+// Limits on the literal set kept per pattern; larger alternations are
+// treated as unfiltered instead of bloating the automaton.
+const (
+	maxPrefilterLiterals = 16
+	minPrefilterLiteral  = 1
+)
+
+// NewPrefilter builds a prefilter for patterns. With caseless set, every
+// pattern is treated as if it had the (?i) flag, matching engines such as
+// Vectorscan compiled with HS_FLAG_CASELESS.
+func NewPrefilter(patterns []string, caseless bool) *Prefilter {
+	p := &Prefilter{
+		count: len(patterns),
+		base:  make([]uint64, (len(patterns)+63)/64),
+	}
+
+	literals := make([][]string, len(patterns))
+	for i, pat := range patterns {
+		if caseless {
+			pat = "(?i)" + pat
+		}
+		re, err := syntax.Parse(pat, syntax.Perl)
+		if err == nil {
+			literals[i] = requiredLiterals(re)
+		}
+		if len(literals[i]) == 0 {
+			p.base[i/64] |= 1 << (uint(i) % 64)
+			p.unfiltered++
+		}
+	}
+
+	p.build(literals)
+	return p
+}
+
+// Complete reports whether every pattern has a required literal, i.e. an
+// input with no literal hit cannot match any pattern.
+func (p *Prefilter) Complete() bool {
+	return p.unfiltered == 0
+}
+
+// Unfiltered returns the number of patterns that are always candidates.
+func (p *Prefilter) Unfiltered() int {
+	return p.unfiltered
+}
+
+// Words returns the bitset length Candidates expects.
+func (p *Prefilter) Words() int {
+	return len(p.base)
+}
+
+// MayMatch reports whether any pattern could match input.
+// It stops at the first literal hit and does not allocate.
+func (p *Prefilter) MayMatch(input string) bool {
+	if p.unfiltered > 0 {
+		return true
+	}
+	state := int32(0)
+	for i := 0; i < len(input); i++ {
+		state = p.trans[int(state)*p.stride+int(p.classes[input[i]])]
+		if p.output[state] {
+			return true
+		}
+	}
+	return false
+}
+
+// Candidates fills dst (Words() long) with the set of patterns
+// that could match input, as a bitset with bit i for pattern i.
+// Returns false if the set is empty.
+func (p *Prefilter) Candidates(input string, dst []uint64) bool {
+	copy(dst, p.base)
+	found := p.unfiltered > 0
+
+	state := int32(0)
+	for i := 0; i < len(input); i++ {
+		state = p.trans[int(state)*p.stride+int(p.classes[input[i]])]
+		if !p.output[state] {
+			continue
+		}
+		found = true
+		for s := state; s >= 0; s = p.dict[s] {
+			for _, id := range p.own[s] {
+				dst[id/64] |= 1 << (uint(id) % 64)
+			}
+		}
+	}
+	return found
+}
+
+// build constructs the Aho-Corasick automaton over the folded literals.
+func (p *Prefilter) build(literals [][]string) {
+	// Alphabet classes; upper-case ASCII shares the lower-case class
+	next := byte(1)
+	for _, lits := range literals {
+		for _, lit := range lits {
+			for i := 0; i < len(lit); i++ {
+				if c := lit[i]; p.classes[c] == 0 {
+					p.classes[c] = next
+					next++
+				}
+			}
+		}
+	}
+	for c := 'A'; c <= 'Z'; c++ {
+		p.classes[c] = p.classes[c+'a'-'A']
+	}
+	p.stride = int(next)
+
+	// Trie
+	newState := func() int32 {
+		for i := 0; i < p.stride; i++ {
+			p.trans = append(p.trans, -1)
+		}
+		p.own = append(p.own, nil)
+		return int32(len(p.own) - 1)
+	}
+	newState()
+	for id, lits := range literals {
+		for _, lit := range lits {
+			s := int32(0)
+			for i := 0; i < len(lit); i++ {
+				idx := int(s)*p.stride + int(p.classes[lit[i]])
+				if p.trans[idx] < 0 {
+					t := newState()
+					p.trans[idx] = t
+				}
+				s = p.trans[idx]
+			}
+			p.own[s] = append(p.own[s], int32(id))
+		}
+	}
+
+	// Breadth-first failure links, resolving missing transitions in place
+	states := len(p.own)
+	fail := make([]int32, states)
+	p.dict = make([]int32, states)
+	p.output = make([]bool, states)
+	p.dict[0] = -1
+
+	queue := make([]int32, 0, states)
+	for c := 0; c < p.stride; c++ {
+		if t := p.trans[c]; t > 0 {
+			fail[t] = 0
+			queue = append(queue, t)
+		} else {
+			p.trans[c] = 0
+		}
+	}
+	for len(queue) > 0 {
+		s := queue[0]
+		queue = queue[1:]
+
+		f := fail[s]
+		if len(p.own[f]) > 0 {
+			p.dict[s] = f
+		} else {
+			p.dict[s] = p.dict[f]
+		}
+		p.output[s] = len(p.own[s]) > 0 || p.dict[s] >= 0
+
+		for c := 0; c < p.stride; c++ {
+			idx := int(s)*p.stride + c
+			if t := p.trans[idx]; t >= 0 {
+				fail[t] = p.trans[int(f)*p.stride+c]
+				queue = append(queue, t)
+			} else {
+				p.trans[idx] = p.trans[int(f)*p.stride+c]
+			}
+		}
+	}
+}
+
+// requiredLiterals returns a set of folded literals such that every match of
+// re contains at least one of them, or nil if no useful set exists.
+func requiredLiterals(re *syntax.Regexp) []string {
+	switch re.Op {
+	case syntax.OpLiteral:
+		return bestRun(literalRuns(nil, re))
+
+	case syntax.OpCapture, syntax.OpPlus:
+		return requiredLiterals(re.Sub[0])
+
+	case syntax.OpRepeat:
+		if re.Min >= 1 {
+			return requiredLiterals(re.Sub[0])
+		}
+		return nil
+
+	case syntax.OpConcat:
+		// Adjacent literal children join into longer runs; any other child
+		// breaks the run but may carry a required set of its own
+		var best []string
+		var runs [][]byte
+		var cur []byte
+		for _, sub := range re.Sub {
+			if sub.Op == syntax.OpLiteral {
+				r := literalRuns(cur, sub)
+				cur = r[len(r)-1]
+				runs = append(runs, r[:len(r)-1]...)
+				continue
+			}
+			runs = append(runs, cur)
+			cur = nil
+			best = betterLiterals(best, requiredLiterals(sub))
+		}
+		runs = append(runs, cur)
+		return betterLiterals(best, bestRun(runs))
+
+	case syntax.OpAlternate:
+		// Each branch must contribute; the pattern needs any one of them
+		var set []string
+		for _, sub := range re.Sub {
+			lits := requiredLiterals(sub)
+			if len(lits) == 0 {
+				return nil
+			}
+			set = append(set, lits...)
+		}
+		if len(set) > maxPrefilterLiterals {
+			return nil
+		}
+		return set
+	}
+	return nil
+}
+
+// literalRuns appends the runes of a literal node to the run cur, folding
+// ASCII to lower case. Under (?i), runes whose case folding reaches outside
+// ASCII (non-ASCII letters, 'k' via U+212A, 's' via U+017F) cannot be matched
+// byte-wise, so they split the run. The last run returned is still open.
+func literalRuns(cur []byte, re *syntax.Regexp) [][]byte {
+	fold := re.Flags&syntax.FoldCase != 0
+	var runs [][]byte
+	var buf [utf8.UTFMax]byte
+	for _, r := range re.Rune {
+		if fold && !foldSafe(r) {
+			runs = append(runs, cur)
+			cur = nil
+			continue
+		}
+		if r < utf8.RuneSelf {
+			c := byte(r)
+			if 'A' <= c && c <= 'Z' {
+				c += 'a' - 'A'
+			}
+			cur = append(cur, c)
+			continue
+		}
+		n := utf8.EncodeRune(buf[:], r)
+		cur = append(cur, buf[:n]...)
+	}
+	return append(runs, cur)
+}
+
+func foldSafe(r rune) bool {
+	if r >= utf8.RuneSelf {
+		return false
+	}
+	switch r {
+	case 'k', 'K', 's', 'S':
+		return false
+	}
+	return true
+}
+
+// bestRun picks the longest run as a single-literal set.
+func bestRun(runs [][]byte) []string {
+	var best []byte
+	for _, r := range runs {
+		if len(r) > len(best) {
+			best = r
+		}
+	}
+	if len(best) < minPrefilterLiteral {
+		return nil
+	}
+	return []string{string(best)}
+}
+
+// betterLiterals returns whichever set is more selective: the one whose
+// shortest literal is longer, then the smaller one.
+func betterLiterals(a, b []string) []string {
+	if len(a) == 0 {
+		return b
+	}
+	if len(b) == 0 {
+		return a
+	}
+	ma, mb := shortest(a), shortest(b)
+	if ma != mb {
+		if ma > mb {
+			return a
+		}
+		return b
+	}
+	if len(b) < len(a) {
+		return b
+	}
+	return a
+}
+
+func shortest(set []string) int {
+	n := len(set[0])
+	for _, s := range set[1:] {
+		if len(s) < n {
+			n = len(s)
+		}
+	}
+	return n
+}
+
+// forEachCandidate calls fn for each set bit in ascending order until fn returns false.
+func forEachCandidate(set []uint64, fn func(i int) bool) {
+	for w, word := range set {
+		for word != 0 {
+			if !fn(w*64 + bits.TrailingZeros64(word)) {
+				return
+			}
+			word &= word - 1
+		}
+	}
+}
@@ -0,0 +1,150 @@
+package matcher
+
+import (
+	"reflect"
+	"regexp/syntax"
+	"testing"
+
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+)
+
+func TestRequiredLiterals(t *testing.T) {
+	tests := []struct {
+		pattern string
+		want    []string
+	}{
+		{`mimikatz`, []string{"mimikatz"}},
+		{`\.exe$`, []string{".exe"}},
+		{`Emotet`, []string{"emotet"}},
+		{`emotet[_\-]?(\d+)?\.`, []string{"emotet"}},
+		{`error|fail|panic`, []string{"error", "fail", "panic"}},
+		{`(ab)+cdef`, []string{"cdef"}},
+		{`x{2,}`, []string{"x"}},
+		{`^\d+$`, nil},
+		{`(foo)?bar`, []string{"bar"}},
+		{`a|\d`, nil},
+		{`(?i)kernel32`, []string{"ernel32"}}, // 'k' folds to U+212A
+		{`(?i)café`, []string{"caf"}},
+	}
+
+	for _, tt := range tests {
+		re, err := syntax.Parse(tt.pattern, syntax.Perl)
+		if err != nil {
+			t.Fatalf("Parse(%q) failed: %v", tt.pattern, err)
+		}
+		got := requiredLiterals(re)
+		if !reflect.DeepEqual(got, tt.want) {
+			t.Errorf("requiredLiterals(%q) = %q, want %q", tt.pattern, got, tt.want)
+		}
+	}
+}
+
+func TestPrefilter_Candidates(t *testing.T) {
+	p := NewPrefilter([]string{`error`, `fail`, `^\d+$`, `rror`}, false)
+	if p.Complete() || p.Unfiltered() != 1 {
+		t.Fatalf("Unfiltered() = %d, want 1", p.Unfiltered())
+	}
+
+	set := make([]uint64, p.Words())
+	if !p.Candidates("an ERROR", set) {
+		t.Fatal("Candidates returned false")
+	}
+	// Overlapping literals both report; the unfiltered pattern always does
+	if want := uint64(1<<0 | 1<<2 | 1<<3); set[0] != want {
+		t.Errorf("Candidates = %b, want %b", set[0], want)
+	}
+
+	complete := NewPrefilter([]string{`error`, `fail`}, false)
+	if complete.MayMatch("all good") {
+		t.Error("MayMatch(all good) = true, want false")
+	}
+	if !complete.MayMatch("it FAILed") {
+		t.Error("MayMatch(it FAILed) = false, want true")
+	}
+}
+
+// The prefilter must never change results, only skip patterns that cannot match
+func TestPrefilteredGoMatcher_Equivalent(t *testing.T) {
+	inputs := append(append([]string{}, testdata.TestFilenames...),
+		"C:\\Windows\\System32\\\u212aernel32.dll", // Kelvin sign folds to 'k'
+		"/tmp/ſvchost.exe",                         // long s folds to 's'
+		"",
+	)
+
+	for name, patterns := range map[string][]string{
+		"simple":  testdata.SimpleMalwarePatterns,
+		"malware": testdata.MalwarePatterns,
+	} {
+		for _, caseless := range []bool{false, true} {
+			pats := patterns
+			if caseless {
+				pats = make([]string, len(patterns))
+				for i, p := range patterns {
+					pats[i] = "(?i)" + p
+				}
+			}
+
+			plain, err := NewGoMatcher(pats)
+			if err != nil {
+				t.Fatalf("%s: NewGoMatcher failed: %v", name, err)
+			}
+			filtered, err := NewPrefilteredGoMatcher(pats)
+			if err != nil {
+				t.Fatalf("%s: NewPrefilteredGoMatcher failed: %v", name, err)
+			}
+
+			for _, input := range inputs {
+				if got, want := filtered.Match(input), plain.Match(input); got != want {
+					t.Errorf("%s caseless=%v: Match(%q) = %d, want %d", name, caseless, input, got, want)
+				}
+				if got, want := filtered.MatchAll(input), plain.MatchAll(input); !intSliceEqual(got, want) {
+					t.Errorf("%s caseless=%v: MatchAll(%q) = %v, want %v", name, caseless, input, got, want)
+				}
+			}
+		}
+	}
+}
+
+func TestPrefilter_MayMatchNoAllocs(t *testing.T) {
+	p := NewPrefilter(testdata.SimpleMalwarePatterns, true)
+	files := testdata.BenignFilenames()
+	allocs := testing.AllocsPerRun(100, func() {
+		for _, f := range files {
+			p.MayMatch(f)
+		}
+	})
+	if allocs != 0 {
+		t.Errorf("MayMatch allocated %.1f times per run, want 0", allocs)
+	}
+}
+
+// Miss-heavy scans are where the prefilter pays off: one automaton pass
+// instead of a MatchString per pattern
+func BenchmarkGoMatcher_Benign(b *testing.B) {
+	benchmarkScanFiles(b, NewGoMatcher, testdata.BenignFilenames())
+}
+
+func BenchmarkPrefilteredGoMatcher_Benign(b *testing.B) {
+	benchmarkScanFiles(b, NewPrefilteredGoMatcher, testdata.BenignFilenames())
+}
+
+func BenchmarkGoMatcher_AllFiles(b *testing.B) {
+	benchmarkScanFiles(b, NewGoMatcher, testdata.TestFilenames)
+}
+
+func BenchmarkPrefilteredGoMatcher_AllFiles(b *testing.B) {
+	benchmarkScanFiles(b, NewPrefilteredGoMatcher, testdata.TestFilenames)
+}
+
+func benchmarkScanFiles(b *testing.B, newMatcher func([]string) (*GoMatcher, error), files []string) {
+	m, err := newMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("matcher construction failed: %v", err)
+	}
+	defer m.Close()
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.Match(files[i%len(files)])
+	}
+}
@@ -0,0 +1,186 @@
+package vectorscan
+
+import (
+	"fmt"
+	"runtime"
+	"sync"
+	"sync/atomic"
+
+	hs "github.com/flier/gohs/hyperscan"
+
+	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
+)
+
+// vsDatabase is one compiled ruleset together with everything sized for it:
+// the raw copy for the Match fast path, scratch, and the lazily compiled
+// stream and vectored databases.
+//
+// A VsMatcher publishes its current vsDatabase through an atomic pointer.
+// Every scan pins it with tryRef and drops it with release; Reload swaps in
+// a new one and releases the owner reference, so the old database is freed
+// as soon as the last in-flight scan finishes (RCU-style, no reader locks).
+type vsDatabase struct {
+	db       hs.BlockDatabase
+	raw      *rawDatabase // C-owned copy of db for the Match fast path
+	scratch  *scanScratch // shared scratch (locked mode) or clone prototype
+	patterns []string
+	count    int
+
+	// Per-goroutine scratch clones, nil unless in concurrent mode
+	scratchPool *sync.Pool
+
+	// Literal prefilter, nil unless enabled and every pattern has a literal
+	prefilter *gomatcher.Prefilter
+
+	// 1 while current, plus one per in-flight scan; freed on reaching 0
+	refs atomic.Int64
+
+	// Stream-mode database, compiled on the first NewStream
+	streamOnce    sync.Once
+	streamDB      hs.StreamDatabase
+	streamScratch *hs.Scratch
+	streamErr     error
+
+	// Vectored-mode database, compiled on the first MatchFields
+	vectoredOnce sync.Once
+	vectoredDB   hs.VectoredDatabase
+	vectoredErr  error
+}
+
+// newVsDatabase wraps a compiled database, allocating scratch space for it.
+// Takes ownership of db; closes it on failure.
+func newVsDatabase(db hs.BlockDatabase, count int) (*vsDatabase, error) {
+	raw, err := newRawDatabase(db)
+	if err != nil {
+		db.Close()
+		return nil, err
+	}
+
+	// Allocate scratch space for scanning
+	scratch, err := hs.NewScratch(db)
+	if err != nil {
+		freeRawDatabase(raw)
+		db.Close()
+		return nil, fmt.Errorf("failed to allocate scratch: %w", err)
+	}
+	rawScratch, err := newRawScratch(raw)
+	if err != nil {
+		scratch.Free()
+		freeRawDatabase(raw)
+		db.Close()
+		return nil, err
+	}
+
+	d := &vsDatabase{
+		db:      db,
+		raw:     raw,
+		scratch: &scanScratch{hs: scratch, raw: rawScratch},
+		count:   count,
+	}
+	d.refs.Store(1)
+	return d, nil
+}
+
+// enablePool switches to pooled scratch clones.
+// d.scratch becomes the prototype for clones and is never scanned with directly.
+func (d *vsDatabase) enablePool() {
+	proto := d.scratch
+	d.scratchPool = &sync.Pool{
+		New: func() interface{} {
+			s, err := proto.clone()
+			if err != nil {
+				return nil
+			}
+			// sync.Pool may drop idle clones; free their C memory when collected
+			runtime.SetFinalizer(s, (*scanScratch).free)
+			return s
+		},
+	}
+}
+
+// enablePrefilter builds the literal prefilter for d's patterns. Vectorscan
+// compiles with HS_FLAG_CASELESS, so the prefilter folds case too. It is
+// only kept when complete: a pattern without a required literal could match
+// any input, leaving nothing to reject.
+func (d *vsDatabase) enablePrefilter() {
+	if len(d.patterns) == 0 {
+		return
+	}
+	if p := gomatcher.NewPrefilter(d.patterns, true); p.Complete() {
+		d.prefilter = p
+	}
+}
+
+// tryRef pins d for a scan. It fails once d has been fully released,
+// in which case the caller should reload the current database.
+func (d *vsDatabase) tryRef() bool {
+	for {
+		n := d.refs.Load()
+		if n == 0 {
+			return false
+		}
+		if d.refs.CompareAndSwap(n, n+1) {
+			return true
+		}
+	}
+}
+
+// release drops a reference, freeing d when it was the last one.
+func (d *vsDatabase) release() {
+	if d.refs.Add(-1) == 0 {
+		d.free()
+	}
+}
+
+// free releases all C resources. Pooled scratch clones are freed as they are collected.
+func (d *vsDatabase) free() {
+	if d.streamScratch != nil {
+		d.streamScratch.Free()
+	}
+	if d.streamDB != nil {
+		d.streamDB.Close()
+	}
+	if d.vectoredDB != nil {
+		d.vectoredDB.Close()
+	}
+	d.scratch.free()
+	freeRawDatabase(d.raw)
+	d.db.Close()
+}
+
+// initStream compiles the stream-mode database and its prototype scratch.
+func (d *vsDatabase) initStream() {
+	if len(d.patterns) == 0 {
+		d.streamErr = fmt.Errorf("streaming requires the source patterns")
+		return
+	}
+
+	db, err := hs.NewStreamDatabase(compilePatterns(d.patterns)...)
+	if err != nil {
+		d.streamErr = fmt.Errorf("failed to compile stream patterns: %w", err)
+		return
+	}
+	scratch, err := hs.NewScratch(db)
+	if err != nil {
+		db.Close()
+		d.streamErr = fmt.Errorf("failed to allocate stream scratch: %w", err)
+		return
+	}
+	d.streamDB = db
+	d.streamScratch = scratch
+}
+
+// initVectored compiles the vectored-mode database.
+func (d *vsDatabase) initVectored() {
+	if len(d.patterns) == 0 {
+		d.vectoredErr = fmt.Errorf("vectored matching requires the source patterns")
+		return
+	}
+
+	db, err := hs.NewVectoredDatabase(compilePatterns(d.patterns)...)
+	if err != nil {
+		d.vectoredErr = fmt.Errorf("failed to compile vectored patterns: %w", err)
+		return
+	}
+	d.vectoredDB = db
+}
@@ -13,29 +13,96 @@
 package vectorscan
 
 import (
+	"bytes"
+	"encoding/binary"
 	"fmt"
 	"sync"
+	"sync/atomic"
+	"unsafe"
 
 	hs "github.com/flier/gohs/hyperscan"
+
+	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
 )
 
 // VsMatcher implements multi-pattern matching using Vectorscan.
 // It compiles all patterns into a single database and matches them simultaneously.
+//
+// By default scans share one scratch behind a mutex. In concurrent mode
+// (NewConcurrentVsMatcher) the database is shared read-only and each scan
+// takes a scratch cloned with hs_clone_scratch from a sync.Pool, so scans
+// run fully in parallel.
+//
+// Reload replaces the database without blocking scans; see vsDatabase.
 type VsMatcher struct {
-	db       hs.BlockDatabase
-	scratch  *hs.Scratch
-	patterns []string
-	mu       sync.Mutex
+	current    atomic.Pointer[vsDatabase]
+	concurrent bool
+
+	// Guards the shared scratch outside concurrent mode
+	mu sync.Mutex
+
+	// First-match policy, see SetPriority
+	priorityCutoff int
+
+	// Build a literal prefilter for each database, see SetPrefilter
+	prefilter bool
 }
 
+// First-match policies for SetPriority.
+const (
+	// PriorityOffset stops at the first match in input offset order (default, fastest).
+	// The result may not be the lowest matching pattern index.
+	PriorityOffset = 0
+
+	// PriorityLowest returns the lowest matching pattern index, like GoMatcher.Match.
+	// Scanning only stops early when pattern 0 matches.
+	PriorityLowest = 1
+)
+
+// Serialized database blob layout (shared with the WASM matcher):
+//
+//	[0..3]  magic "VSDB"
+//	[4..7]  pattern count (little-endian)
+//	[8..]   hs_serialize_database output
+var dbMagic = []byte("VSDB")
+
+const dbHeaderSize = 8
+
 // NewVsMatcher creates a new Vectorscan-based matcher from the given patterns.
 // Patterns are compiled into a block-mode database for simultaneous matching.
 func NewVsMatcher(patterns []string) (*VsMatcher, error) {
+	d, err := compileDatabase(patterns)
+	if err != nil {
+		return nil, err
+	}
+
+	m := &VsMatcher{}
+	m.current.Store(d)
+	return m, nil
+}
+
+// compileDatabase compiles patterns into a ready-to-scan vsDatabase.
+func compileDatabase(patterns []string) (*vsDatabase, error) {
 	if len(patterns) == 0 {
 		return nil, fmt.Errorf("no patterns provided")
 	}
 
-	// Convert to Vectorscan patterns with IDs
+	// Compile all patterns into a single database
+	db, err := hs.NewBlockDatabase(compilePatterns(patterns)...)
+	if err != nil {
+		return nil, fmt.Errorf("failed to compile patterns: %w", err)
+	}
+
+	d, err := newVsDatabase(db, len(patterns))
+	if err != nil {
+		return nil, err
+	}
+	d.patterns = patterns
+	return d, nil
+}
+
+// compilePatterns converts patterns to Vectorscan patterns, using the index as ID.
+func compilePatterns(patterns []string) []*hs.Pattern {
 	vsPatterns := make([]*hs.Pattern, len(patterns))
 	for i, p := range patterns {
 		vsPatterns[i] = &hs.Pattern{
@@ -44,90 +111,344 @@ func NewVsMatcher(patterns []string) (*VsMatcher, error) {
 			Id:         i,
 		}
 	}
+	return vsPatterns
+}
 
-	// Compile all patterns into a single database
-	db, err := hs.NewBlockDatabase(vsPatterns...)
+// scanScratch pairs the gohs scratch used by MatchAll and MatchFields with
+// the raw scratch used by Match; a scan takes both together.
+type scanScratch struct {
+	hs  *hs.Scratch
+	raw *rawScratch
+}
+
+func (s *scanScratch) clone() (*scanScratch, error) {
+	h, err := s.hs.Clone()
 	if err != nil {
-		return nil, fmt.Errorf("failed to compile patterns: %w", err)
+		return nil, err
+	}
+	raw, err := cloneRawScratch(s.raw)
+	if err != nil {
+		h.Free()
+		return nil, err
+	}
+	return &scanScratch{hs: h, raw: raw}, nil
+}
+
+func (s *scanScratch) free() {
+	s.hs.Free()
+	freeRawScratch(s.raw)
+}
+
+// NewConcurrentVsMatcher creates a matcher whose Match/MatchAll take no global lock.
+// Scratch is cloned on demand, roughly one per concurrently scanning goroutine.
+func NewConcurrentVsMatcher(patterns []string) (*VsMatcher, error) {
+	m, err := NewVsMatcher(patterns)
+	if err != nil {
+		return nil, err
+	}
+	m.concurrent = true
+	m.current.Load().enablePool()
+	return m, nil
+}
+
+// pin returns the current database with a reference held; drop it with
+// release. Returns nil after Close.
+func (m *VsMatcher) pin() *vsDatabase {
+	for {
+		d := m.current.Load()
+		if d == nil || d.tryRef() {
+			return d
+		}
+		// Lost a race with Reload - d is already drained, retry on the new one
+	}
+}
+
+// acquire pins the current database and takes scratch for one scan;
+// return both with m.finish. Returns nil if closed or a clone could
+// not be allocated.
+func (m *VsMatcher) acquire() (*vsDatabase, *scanScratch) {
+	return m.take(m.pin())
+}
+
+// take is acquire for a database the caller has already pinned.
+// The reference passes to the result, or is dropped on failure.
+func (m *VsMatcher) take(d *vsDatabase) (*vsDatabase, *scanScratch) {
+	if d == nil {
+		return nil, nil
+	}
+	if d.scratchPool == nil {
+		m.mu.Lock()
+		return d, d.scratch
+	}
+	s, _ := d.scratchPool.Get().(*scanScratch)
+	if s == nil {
+		d.release()
+		return nil, nil
+	}
+	return d, s
+}
+
+func (m *VsMatcher) finish(d *vsDatabase, s *scanScratch) {
+	if d == nil {
+		return
+	}
+	if d.scratchPool == nil {
+		m.mu.Unlock()
+	} else {
+		d.scratchPool.Put(s)
+	}
+	d.release()
+}
+
+// NewVsMatcherFromDB creates a matcher from a database produced by Serialize.
+// This skips pattern compilation, so startup cost is roughly a memcpy.
+// The blob must have been serialized on a compatible platform.
+func NewVsMatcherFromDB(data []byte) (*VsMatcher, error) {
+	if len(data) < dbHeaderSize || !bytes.Equal(data[:4], dbMagic) {
+		return nil, fmt.Errorf("invalid serialized database header")
+	}
+	// Vectorscan cannot report a database's pattern count, so the header is
+	// trusted; MatchAllInto fails rather than record an ID beyond it
+	count := int(binary.LittleEndian.Uint32(data[4:dbHeaderSize]))
+	if count == 0 {
+		return nil, fmt.Errorf("serialized database header lists no patterns")
+	}
+
+	db, err := hs.UnmarshalBlockDatabase(data[dbHeaderSize:])
+	if err != nil {
+		return nil, fmt.Errorf("failed to deserialize database: %w", err)
+	}
+
+	d, err := newVsDatabase(db, count)
+	if err != nil {
+		return nil, err
+	}
+	m := &VsMatcher{}
+	m.current.Store(d)
+	return m, nil
+}
+
+// Reload compiles patterns into a new database and swaps it in atomically.
+//
+// Compilation happens before the swap, so scans keep running on the old
+// database meanwhile instead of stalling. Scans already in flight finish on
+// the old database, which is freed (with its scratch) once the last of them
+// completes; scans starting after the swap see the new one. Scratch is
+// allocated for the new database alone, so it is only as large as it needs.
+func (m *VsMatcher) Reload(patterns []string) error {
+	d, err := compileDatabase(patterns)
+	if err != nil {
+		return err
+	}
+	if m.concurrent {
+		d.enablePool()
 	}
+	if m.prefilter {
+		d.enablePrefilter()
+	}
+
+	old := m.current.Swap(d)
+	if old != nil {
+		old.release()
+	}
+	return nil
+}
 
-	// Allocate scratch space for scanning
-	scratch, err := hs.NewScratch(db)
+// Serialize returns the compiled database in a form NewVsMatcherFromDB can load.
+// Compile once at build or deploy time and ship the blob with the binary.
+func (m *VsMatcher) Serialize() ([]byte, error) {
+	d := m.pin()
+	if d == nil {
+		return nil, fmt.Errorf("matcher is closed")
+	}
+	defer d.release()
+
+	raw, err := d.db.Marshal()
 	if err != nil {
-		db.Close()
-		return nil, fmt.Errorf("failed to allocate scratch: %w", err)
+		return nil, fmt.Errorf("failed to serialize database: %w", err)
 	}
 
-	return &VsMatcher{
-		db:       db,
-		scratch:  scratch,
-		patterns: patterns,
-	}, nil
+	data := make([]byte, dbHeaderSize+len(raw))
+	copy(data, dbMagic)
+	binary.LittleEndian.PutUint32(data[4:dbHeaderSize], uint32(d.count))
+	copy(data[dbHeaderSize:], raw)
+	return data, nil
+}
+
+// SetPriority selects how Match picks among several matching patterns.
+// Use PriorityOffset or PriorityLowest. A cutoff n > 1 makes the first n
+// patterns one top-priority tier: the scan stops as soon as any of them
+// matches and returns the lowest index seen by then. That is a tier pattern
+// whenever one matches, and the exact lowest index when none does, but
+// within the tier it need not be the lowest; only PriorityLowest
+// guarantees that, since only pattern 0 is final before the scan ends.
+// Call before sharing the matcher between goroutines.
+func (m *VsMatcher) SetPriority(cutoff int) error {
+	if cutoff < 0 {
+		return fmt.Errorf("invalid priority cutoff %d", cutoff)
+	}
+	m.priorityCutoff = cutoff
+	return nil
+}
+
+// SetPrefilter enables a literal prefilter in front of Match and MatchBytes.
+// Required literals are extracted from each pattern and indexed in one
+// Aho-Corasick automaton (see gomatcher.Prefilter); inputs containing none
+// of them return -1 without entering Vectorscan. It only takes effect when
+// every pattern has a required literal, and is rebuilt on Reload. Matchers
+// created with NewVsMatcherFromDB have no source patterns and stay unfiltered.
+// Call before sharing the matcher between goroutines.
+func (m *VsMatcher) SetPrefilter(enabled bool) {
+	m.prefilter = enabled
+	if d := m.current.Load(); d != nil {
+		d.prefilter = nil
+		if enabled {
+			d.enablePrefilter()
+		}
+	}
+}
+
+// Prefiltered reports whether Match currently runs behind a literal prefilter.
+func (m *VsMatcher) Prefiltered() bool {
+	d := m.current.Load()
+	return d != nil && d.prefilter != nil
 }
 
 // Match returns the index of the first matching pattern, or -1 if no match.
 // All patterns are checked simultaneously - this is O(1) regardless of pattern count.
+// The string's bytes are scanned in place, so Match does not allocate.
 func (m *VsMatcher) Match(input string) int {
-	m.mu.Lock()
-	defer m.mu.Unlock()
+	return m.matchRaw(input)
+}
 
-	matchedID := -1
+// MatchBytes is Match for callers holding a byte slice, such as a network
+// buffer, avoiding the string conversion.
+func (m *VsMatcher) MatchBytes(input []byte) int {
+	return m.matchRaw(unsafe.String(unsafe.SliceData(input), len(input)))
+}
 
-	// Scan with a handler that captures the first match
-	handler := hs.MatchHandler(func(id uint, from, to uint64, flags uint, context interface{}) error {
-		matchedID = int(id)
-		// Return error to stop scanning after first match
-		return hs.ErrScanTerminated
-	})
+func (m *VsMatcher) matchRaw(input string) int {
+	// The prefilter runs before taking scratch, so rejected inputs never
+	// contend for the shared scratch lock
+	d := m.pin()
+	if d == nil {
+		return -1
+	}
+	if d.prefilter != nil && !d.prefilter.MayMatch(input) {
+		d.release()
+		return -1
+	}
 
-	// Scan the input - ignoring ErrScanTerminated as it just means we found a match
-	err := m.db.Scan([]byte(input), m.scratch, handler, nil)
-	if err != nil && err != hs.ErrScanTerminated {
+	d, scratch := m.take(d)
+	if d == nil {
 		return -1
 	}
+	defer m.finish(d, scratch)
 
+	return scanFirst(d.raw, scratch.raw, unsafe.StringData(input), len(input), m.priorityCutoff)
+}
+
+// MatchFields scans a record made of several fields (path, user agent,
+// header values...) as one logical input with hs_scan_vector, without
+// concatenating them. Matches may span field boundaries. Returns the matching
+// pattern index, or -1 if no match. The first call compiles a vectored
+// database from the matcher's patterns, so it is not available on matchers
+// created with NewVsMatcherFromDB.
+func (m *VsMatcher) MatchFields(fields [][]byte) int {
+	d, scratch := m.acquire()
+	if d == nil {
+		return -1
+	}
+	defer m.finish(d, scratch)
+
+	d.vectoredOnce.Do(d.initVectored)
+	if d.vectoredErr != nil {
+		return -1
+	}
+	// Scratch sized for the block database may be too small for this one;
+	// hs_alloc_scratch returns immediately once it fits
+	if err := scratch.hs.Realloc(d.vectoredDB); err != nil {
+		return -1
+	}
+
+	matchedID := -1
+	handler := newFirstMatchHandler(m.priorityCutoff, &matchedID)
+	err := d.vectoredDB.Scan(fields, scratch.hs, handler, nil)
+	if err != nil && err != hs.ErrScanTerminated {
+		return -1
+	}
 	return matchedID
 }
 
+// newFirstMatchHandler returns a handler that tracks the lowest matching ID in
+// *matchedID and stops the scan once the priority cutoff is satisfied (see
+// SetPriority).
+func newFirstMatchHandler(cutoff int, matchedID *int) hs.MatchHandler {
+	return func(id uint, from, to uint64, flags uint, context interface{}) error {
+		if *matchedID < 0 || int(id) < *matchedID {
+			*matchedID = int(id)
+		}
+		// Return error to stop scanning
+		if cutoff == PriorityOffset || *matchedID < cutoff {
+			return hs.ErrScanTerminated
+		}
+		return nil
+	}
+}
+
 // MatchAll returns indices of all matching patterns.
 // All patterns are checked simultaneously.
 func (m *VsMatcher) MatchAll(input string) []int {
-	m.mu.Lock()
-	defer m.mu.Unlock()
-
-	var matches []int
-	seen := make(map[int]bool)
+	var set gomatcher.Bitset
+	if m.MatchAllInto(input, &set) <= 0 {
+		return nil
+	}
+	return set.AppendTo(nil)
+}
 
-	handler := hs.MatchHandler(func(id uint, from, to uint64, flags uint, context interface{}) error {
-		if !seen[int(id)] {
-			matches = append(matches, int(id))
-			seen[int(id)] = true
-		}
-		return nil // Continue scanning
-	})
+// MatchAllInto scans input once and records every matching pattern in dst,
+// which is reset to PatternCount bits first. Returns the number of matching
+// patterns, or -1 on error. Reusing dst across calls, the scan does not
+// allocate.
+func (m *VsMatcher) MatchAllInto(input string, dst *gomatcher.Bitset) int {
+	d, scratch := m.acquire()
+	if d == nil {
+		dst.Reset(0)
+		return -1
+	}
+	defer m.finish(d, scratch)
 
-	m.db.Scan([]byte(input), m.scratch, handler, nil)
-	return matches
+	dst.Reset(d.count)
+	return scanAll(d.raw, scratch.raw, unsafe.StringData(input), len(input), dst.Words(), d.count)
 }
 
 // PatternCount returns the number of patterns.
 func (m *VsMatcher) PatternCount() int {
-	return len(m.patterns)
+	d := m.pin()
+	if d == nil {
+		return 0
+	}
+	defer d.release()
+	return d.count
 }
 
-// Close releases Vectorscan resources.
+// Close releases Vectorscan resources once in-flight scans finish.
+// In concurrent mode pooled scratch clones are freed as they are collected.
 func (m *VsMatcher) Close() {
-	if m.scratch != nil {
-		m.scratch.Free()
-	}
-	if m.db != nil {
-		m.db.Close()
+	if d := m.current.Swap(nil); d != nil {
+		d.release()
 	}
 }
 
 // DatabaseInfo returns information about the compiled database.
 func (m *VsMatcher) DatabaseInfo() (string, error) {
-	info, err := m.db.Info()
+	d := m.pin()
+	if d == nil {
+		return "", fmt.Errorf("matcher is closed")
+	}
+	defer d.release()
+
+	info, err := d.db.Info()
 	if err != nil {
 		return "", err
 	}
@@ -136,5 +457,11 @@ func (m *VsMatcher) DatabaseInfo() (string, error) {
 
 // DatabaseSize returns the size of the compiled database in bytes.
 func (m *VsMatcher) DatabaseSize() (int, error) {
-	return m.db.Size()
+	d := m.pin()
+	if d == nil {
+		return 0, fmt.Errorf("matcher is closed")
+	}
+	defer d.release()
+
+	return d.db.Size()
 }
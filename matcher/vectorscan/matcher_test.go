@@ -1,9 +1,14 @@
 package vectorscan
 
 import (
+	"bytes"
+	"encoding/binary"
 	"fmt"
+	"slices"
+	"sync"
 	"testing"
 
+	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
 	"github.com/paulstuart/cgo-ffi/matcher/testdata"
 )
 
@@ -125,6 +130,200 @@ func TestVsMatcher_MalwarePatterns(t *testing.T) {
 	}
 }
 
+func TestVsMatcher_SerializeRoundTrip(t *testing.T) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	db, err := m.Serialize()
+	if err != nil {
+		t.Fatalf("Serialize failed: %v", err)
+	}
+	t.Logf("Serialized database: %d bytes", len(db))
+
+	loaded, err := NewVsMatcherFromDB(db)
+	if err != nil {
+		t.Fatalf("NewVsMatcherFromDB failed: %v", err)
+	}
+	defer loaded.Close()
+
+	if loaded.PatternCount() != m.PatternCount() {
+		t.Errorf("PatternCount = %d, want %d", loaded.PatternCount(), m.PatternCount())
+	}
+	for _, f := range testdata.TestFilenames {
+		if got, want := loaded.Match(f), m.Match(f); got != want {
+			t.Errorf("Match(%q) = %d after reload, want %d", f, got, want)
+		}
+	}
+}
+
+func TestNewVsMatcherFromDB_Invalid(t *testing.T) {
+	for _, db := range [][]byte{nil, []byte("short"), []byte("XXXX\x01\x00\x00\x00garbage")} {
+		if m, err := NewVsMatcherFromDB(db); err == nil {
+			m.Close()
+			t.Errorf("NewVsMatcherFromDB(%q) succeeded, want error", db)
+		}
+	}
+}
+
+// A header listing fewer patterns than the database holds must not let a
+// high pattern ID write past the bitset
+func TestNewVsMatcherFromDB_ShortCount(t *testing.T) {
+	patterns := make([]string, 130)
+	for i := range patterns {
+		patterns[i] = fmt.Sprintf("pat%03d", i)
+	}
+	m, err := NewVsMatcher(patterns)
+	if err != nil {
+		t.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	db, err := m.Serialize()
+	if err != nil {
+		t.Fatalf("Serialize failed: %v", err)
+	}
+
+	binary.LittleEndian.PutUint32(db[4:8], 0)
+	if loaded, err := NewVsMatcherFromDB(db); err == nil {
+		loaded.Close()
+		t.Error("NewVsMatcherFromDB accepted a header with no patterns")
+	}
+
+	binary.LittleEndian.PutUint32(db[4:8], 1)
+	loaded, err := NewVsMatcherFromDB(db)
+	if err != nil {
+		t.Fatalf("NewVsMatcherFromDB failed: %v", err)
+	}
+	defer loaded.Close()
+	var set gomatcher.Bitset
+	if n := loaded.MatchAllInto("x pat129 x", &set); n != -1 {
+		t.Errorf("MatchAllInto with an out-of-range ID = %d, want -1", n)
+	}
+}
+
+// Inputs where a later-offset match has a lower pattern index than the first
+// match by offset, so PriorityOffset and PriorityLowest disagree
+var priorityInputs = []string{
+	"/tmp/ryuk_emotet.exe",
+	"/home/user/notpetya/wannacry.bin",
+	"/var/tmp/lockbit-mimikatz.dll",
+}
+
+// caselessGoMatcher builds the regexp reference with the same case folding
+// as the Vectorscan backends (HS_FLAG_CASELESS)
+func caselessGoMatcher(tb testing.TB, patterns []string) *gomatcher.GoMatcher {
+	tb.Helper()
+	folded := make([]string, len(patterns))
+	for i, p := range patterns {
+		folded[i] = "(?i)" + p
+	}
+	gm, err := gomatcher.NewGoMatcher(folded)
+	if err != nil {
+		tb.Fatalf("NewGoMatcher failed: %v", err)
+	}
+	return gm
+}
+
+func TestVsMatcher_PriorityLowest(t *testing.T) {
+	m, err := NewVsMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	if err := m.SetPriority(PriorityLowest); err != nil {
+		t.Fatalf("SetPriority failed: %v", err)
+	}
+
+	gm := caselessGoMatcher(t, testdata.SimpleMalwarePatterns)
+	inputs := append(append([]string{}, testdata.TestFilenames...), priorityInputs...)
+	for _, f := range inputs {
+		if got, want := m.Match(f), gm.Match(f); got != want {
+			t.Errorf("Match(%q) = %d, want %d (GoMatcher)", f, got, want)
+		}
+	}
+
+	if err := m.SetPriority(-1); err == nil {
+		t.Error("SetPriority(-1) succeeded, want error")
+	}
+}
+
+// A cutoff n > 1 must return a tier pattern whenever one matches, and
+// GoMatcher's answer when none does
+func TestVsMatcher_PriorityTier(t *testing.T) {
+	m, err := NewVsMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	gm := caselessGoMatcher(t, testdata.SimpleMalwarePatterns)
+	inputs := append(append([]string{}, testdata.TestFilenames...), priorityInputs...)
+	for _, n := range []int{2, 4, 16, len(testdata.SimpleMalwarePatterns)} {
+		if err := m.SetPriority(n); err != nil {
+			t.Fatalf("SetPriority(%d) failed: %v", n, err)
+		}
+		for _, f := range inputs {
+			checkTier(t, n, f, m.Match(f), gm)
+		}
+	}
+}
+
+// checkTier verifies got, Match under cutoff n, against the reference
+func checkTier(t *testing.T, n int, input string, got int, gm *gomatcher.GoMatcher) {
+	t.Helper()
+	want := gm.Match(input)
+	if want < 0 || want >= n {
+		if got != want {
+			t.Errorf("cutoff %d: Match(%q) = %d, want %d (GoMatcher)", n, input, got, want)
+		}
+		return
+	}
+	if got < 0 || got >= n || !slices.Contains(gm.MatchAll(input), got) {
+		t.Errorf("cutoff %d: Match(%q) = %d, want one of the first %d in %v", n, input, got, n, gm.MatchAll(input))
+	}
+}
+
+func TestVsMatcher_Concurrent(t *testing.T) {
+	locked, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer locked.Close()
+
+	m, err := NewConcurrentVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewConcurrentVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	want := make([]int, len(testdata.TestFilenames))
+	for i, f := range testdata.TestFilenames {
+		want[i] = locked.Match(f)
+	}
+
+	// Same fan-out as production request handling
+	var wg sync.WaitGroup
+	for g := 0; g < 64; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i, f := range testdata.TestFilenames {
+				if got := m.Match(f); got != want[i] {
+					t.Errorf("Match(%q) = %d, want %d", f, got, want[i])
+					return
+				}
+				if want[i] >= 0 && len(m.MatchAll(f)) == 0 {
+					t.Errorf("MatchAll(%q) returned no matches", f)
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+}
+
 // Benchmarks with varying pattern counts
 func BenchmarkVsMatcher_Match_10(b *testing.B)   { benchmarkVsMatch(b, 10) }
 func BenchmarkVsMatcher_Match_100(b *testing.B)  { benchmarkVsMatch(b, 100) }
@@ -216,6 +415,28 @@ func BenchmarkVsMatcher_ScanAllFiles(b *testing.B) {
 	}
 }
 
+// First match by offset vs lowest pattern index
+func BenchmarkVsMatcher_Priority_Offset(b *testing.B) { benchmarkVsPriority(b, PriorityOffset) }
+func BenchmarkVsMatcher_Priority_Lowest(b *testing.B) { benchmarkVsPriority(b, PriorityLowest) }
+
+func benchmarkVsPriority(b *testing.B, cutoff int) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	if err := m.SetPriority(cutoff); err != nil {
+		b.Fatalf("SetPriority failed: %v", err)
+	}
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		for _, f := range testdata.TestFilenames {
+			m.Match(f)
+		}
+	}
+}
+
 // Helper to generate simple patterns
 func generatePatterns(n int) []string {
 	patterns := make([]string, n)
@@ -224,3 +445,354 @@ func generatePatterns(n int) []string {
 	}
 	return patterns
 }
+
+// Parallel throughput: global scratch lock vs pooled scratch clones
+func BenchmarkVsMatcher_Parallel_Locked(b *testing.B) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	benchmarkVsParallel(b, m)
+}
+
+func BenchmarkVsMatcher_Parallel_Concurrent(b *testing.B) {
+	m, err := NewConcurrentVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewConcurrentVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	benchmarkVsParallel(b, m)
+}
+
+func benchmarkVsParallel(b *testing.B, m *VsMatcher) {
+	files := testdata.TestFilenames
+
+	b.ResetTimer()
+	b.RunParallel(func(pb *testing.PB) {
+		i := 0
+		for pb.Next() {
+			m.Match(files[i%len(files)])
+			i++
+		}
+	})
+}
+
+// Startup cost: compiling patterns vs loading a serialized database
+func BenchmarkVsMatcher_Compile(b *testing.B) {
+	for i := 0; i < b.N; i++ {
+		m, err := NewVsMatcher(testdata.MalwarePatterns)
+		if err != nil {
+			b.Fatalf("NewVsMatcher failed: %v", err)
+		}
+		m.Close()
+	}
+}
+
+func BenchmarkVsMatcher_LoadSerialized(b *testing.B) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	db, err := m.Serialize()
+	m.Close()
+	if err != nil {
+		b.Fatalf("Serialize failed: %v", err)
+	}
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		loaded, err := NewVsMatcherFromDB(db)
+		if err != nil {
+			b.Fatalf("NewVsMatcherFromDB failed: %v", err)
+		}
+		loaded.Close()
+	}
+}
+
+func TestVsMatcher_MatchFields(t *testing.T) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	// Splitting an input into fields must not change the result,
+	// including when the split lands inside a match
+	for _, f := range testdata.TestFilenames {
+		want := m.Match(f)
+		for _, cut := range []int{0, len(f) / 3, len(f) / 2, len(f)} {
+			fields := [][]byte{[]byte(f[:cut]), []byte(f[cut:])}
+			if got := m.MatchFields(fields); got != want {
+				t.Errorf("MatchFields(%q | %q) = %d, want %d", f[:cut], f[cut:], got, want)
+			}
+		}
+	}
+
+	if got := m.MatchFields([][]byte{[]byte("/tmp/mimi"), []byte("katz.exe")}); got < 0 {
+		t.Errorf("MatchFields across field boundary = %d, want match", got)
+	}
+	if got := m.MatchFields(nil); got != -1 {
+		t.Errorf("MatchFields(nil) = %d, want -1", got)
+	}
+}
+
+// Multi-field records: one vectored scan vs concatenating then Match
+var benchRecord = [][]byte{
+	[]byte("/home/user/downloads/report.pdf"),
+	[]byte("Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36"),
+	[]byte("session=abc123; theme=dark"),
+}
+
+func BenchmarkVsMatcher_MatchFields(b *testing.B) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	m.MatchFields(benchRecord)
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.MatchFields(benchRecord)
+	}
+}
+
+func BenchmarkVsMatcher_MatchConcat(b *testing.B) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.Match(string(bytes.Join(benchRecord, nil)))
+	}
+}
+
+func TestVsMatcher_MatchBytes(t *testing.T) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	for _, f := range testdata.TestFilenames {
+		if got, want := m.MatchBytes([]byte(f)), m.Match(f); got != want {
+			t.Errorf("MatchBytes(%q) = %d, Match = %d", f, got, want)
+		}
+	}
+	if got := m.Match(""); got != -1 {
+		t.Errorf("Match(\"\") = %d, want -1", got)
+	}
+	if got := m.MatchBytes(nil); got != -1 {
+		t.Errorf("MatchBytes(nil) = %d, want -1", got)
+	}
+}
+
+// Match scans the string in place with a C callback, so it must not allocate
+func TestVsMatcher_MatchZeroAllocs(t *testing.T) {
+	for _, concurrent := range []bool{false, true} {
+		newMatcher := NewVsMatcher
+		if concurrent {
+			newMatcher = NewConcurrentVsMatcher
+		}
+		m, err := newMatcher(testdata.MalwarePatterns)
+		if err != nil {
+			t.Fatalf("new matcher failed: %v", err)
+		}
+
+		input := testdata.TestFilenames[len(testdata.TestFilenames)/2]
+		buf := []byte(input)
+		m.Match(input) // warm the scratch pool
+
+		if n := testing.AllocsPerRun(100, func() { m.Match(input) }); n != 0 {
+			t.Errorf("concurrent=%v: Match allocs/op = %v, want 0", concurrent, n)
+		}
+		if n := testing.AllocsPerRun(100, func() { m.MatchBytes(buf) }); n != 0 {
+			t.Errorf("concurrent=%v: MatchBytes allocs/op = %v, want 0", concurrent, n)
+		}
+		m.Close()
+	}
+}
+
+func BenchmarkVsMatcher_Match_Allocs(b *testing.B) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	files := testdata.TestFilenames
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.Match(files[i%len(files)])
+	}
+}
+
+func BenchmarkVsMatcher_MatchBytes_Allocs(b *testing.B) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	bufs := make([][]byte, len(testdata.TestFilenames))
+	for i, f := range testdata.TestFilenames {
+		bufs[i] = []byte(f)
+	}
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.MatchBytes(bufs[i%len(bufs)])
+	}
+}
+
+func TestVsMatcher_Prefilter(t *testing.T) {
+	for name, patterns := range map[string][]string{
+		"simple":  testdata.SimpleMalwarePatterns,
+		"malware": testdata.MalwarePatterns,
+	} {
+		plain, err := NewVsMatcher(patterns)
+		if err != nil {
+			t.Fatalf("%s: NewVsMatcher failed: %v", name, err)
+		}
+		filtered, err := NewVsMatcher(patterns)
+		if err != nil {
+			t.Fatalf("%s: NewVsMatcher failed: %v", name, err)
+		}
+		filtered.SetPrefilter(true)
+		t.Logf("%s: prefiltered=%v", name, filtered.Prefiltered())
+
+		for _, f := range testdata.TestFilenames {
+			if got, want := filtered.Match(f), plain.Match(f); got != want {
+				t.Errorf("%s: Match(%q) = %d, want %d", name, f, got, want)
+			}
+			if got, want := filtered.MatchBytes([]byte(f)), plain.Match(f); got != want {
+				t.Errorf("%s: MatchBytes(%q) = %d, want %d", name, f, got, want)
+			}
+		}
+		plain.Close()
+		filtered.Close()
+	}
+
+	// Every pattern has a literal, so the prefilter engages and survives Reload
+	m, err := NewVsMatcher([]string{`\.exe$`, `mimikatz`})
+	if err != nil {
+		t.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	m.SetPrefilter(true)
+	if !m.Prefiltered() {
+		t.Fatal("Prefiltered() = false, want true")
+	}
+	if err := m.Reload([]string{`\.dll$`, `^\d+$`}); err != nil {
+		t.Fatalf("Reload failed: %v", err)
+	}
+	if m.Prefiltered() {
+		t.Error("Prefiltered() = true after reload with a literal-free pattern")
+	}
+	if got := m.Match("12345"); got != 1 {
+		t.Errorf("Match(12345) = %d, want 1", got)
+	}
+	if err := m.Reload([]string{`\.exe$`, `mimikatz`}); err != nil {
+		t.Fatalf("Reload failed: %v", err)
+	}
+	if !m.Prefiltered() {
+		t.Error("Prefiltered() = false after reload, want true")
+	}
+	if got := m.Match("/tmp/MIMIKATZ.bin"); got != 1 {
+		t.Errorf("Match(/tmp/MIMIKATZ.bin) = %d, want 1", got)
+	}
+}
+
+func BenchmarkVsMatcher_Benign(b *testing.B)             { benchmarkVsBenign(b, false) }
+func BenchmarkVsMatcher_Benign_Prefiltered(b *testing.B) { benchmarkVsBenign(b, true) }
+
+func benchmarkVsBenign(b *testing.B, prefilter bool) {
+	m, err := NewVsMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	m.SetPrefilter(prefilter)
+
+	files := testdata.BenignFilenames()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.Match(files[i%len(files)])
+	}
+}
+
+func TestVsMatcher_MatchAllInto(t *testing.T) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	gm := caselessGoMatcher(t, testdata.MalwarePatterns)
+
+	var set gomatcher.Bitset
+	for _, f := range testdata.TestFilenames {
+		want := gm.MatchAll(f)
+		n := m.MatchAllInto(f, &set)
+		if got := set.AppendTo(nil); n != len(want) || !intsEqual(got, want) {
+			t.Errorf("MatchAllInto(%q) = %d %v, want %v", f, n, got, want)
+		}
+		if got := m.MatchAll(f); !intsEqual(got, want) {
+			t.Errorf("MatchAll(%q) = %v, want %v", f, got, want)
+		}
+	}
+
+	input := testdata.TestFilenames[len(testdata.TestFilenames)/2]
+	if n := testing.AllocsPerRun(100, func() { m.MatchAllInto(input, &set) }); n != 0 {
+		t.Errorf("MatchAllInto allocs/op = %v, want 0", n)
+	}
+}
+
+func intsEqual(a, b []int) bool {
+	if len(a) != len(b) {
+		return false
+	}
+	for i := range a {
+		if a[i] != b[i] {
+			return false
+		}
+	}
+	return true
+}
+
+func BenchmarkVsMatcher_MatchAll(b *testing.B) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	files := testdata.TestFilenames
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.MatchAll(files[i%len(files)])
+	}
+}
+
+func BenchmarkVsMatcher_MatchAllInto(b *testing.B) {
+	m, err := NewVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+	files := testdata.TestFilenames
+	var set gomatcher.Bitset
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.MatchAllInto(files[i%len(files)], &set)
+	}
+}
@@ -0,0 +1,153 @@
+package vectorscan
+
+import (
+	"sort"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+)
+
+var (
+	reloadSetA = []string{"alpha", "beta"}
+	reloadSetB = []string{"gamma", "alpha"}
+)
+
+func TestVsMatcher_Reload(t *testing.T) {
+	m, err := NewVsMatcher(reloadSetA)
+	if err != nil {
+		t.Fatalf("NewVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	if got := m.Match("alpha"); got != 0 {
+		t.Errorf("before reload Match(alpha) = %d, want 0", got)
+	}
+
+	// A stream opened before the reload keeps its database
+	s, err := m.NewStream()
+	if err != nil {
+		t.Fatalf("NewStream failed: %v", err)
+	}
+
+	if err := m.Reload(reloadSetB); err != nil {
+		t.Fatalf("Reload failed: %v", err)
+	}
+	if got := m.Match("alpha"); got != 1 {
+		t.Errorf("after reload Match(alpha) = %d, want 1", got)
+	}
+	if got := m.Match("beta"); got != -1 {
+		t.Errorf("after reload Match(beta) = %d, want -1", got)
+	}
+	if got := m.MatchFields([][]byte{[]byte("gam"), []byte("ma")}); got != 0 {
+		t.Errorf("after reload MatchFields(gam|ma) = %d, want 0", got)
+	}
+
+	s.Write([]byte("beta"))
+	s.Close()
+	if got := s.Result(); got != 1 {
+		t.Errorf("pre-reload stream Result = %d, want 1", got)
+	}
+
+	if err := m.Reload(nil); err == nil {
+		t.Error("Reload(nil) succeeded, want error")
+	}
+	if got := m.PatternCount(); got != len(reloadSetB) {
+		t.Errorf("PatternCount after failed reload = %d, want %d", got, len(reloadSetB))
+	}
+}
+
+// Scans racing with reloads must always see one complete ruleset
+func TestVsMatcher_ReloadConcurrent(t *testing.T) {
+	for _, concurrent := range []bool{false, true} {
+		newMatcher := NewVsMatcher
+		if concurrent {
+			newMatcher = NewConcurrentVsMatcher
+		}
+		m, err := newMatcher(reloadSetA)
+		if err != nil {
+			t.Fatalf("new matcher failed: %v", err)
+		}
+
+		var stop atomic.Bool
+		var wg sync.WaitGroup
+		for g := 0; g < 8; g++ {
+			wg.Add(1)
+			go func() {
+				defer wg.Done()
+				for !stop.Load() {
+					// alpha is 0 in set A and 1 in set B
+					if got := m.Match("alpha"); got != 0 && got != 1 {
+						t.Errorf("concurrent=%v: Match(alpha) = %d during reload", concurrent, got)
+						return
+					}
+				}
+			}()
+		}
+
+		for i := 0; i < 50; i++ {
+			set := reloadSetA
+			if i%2 == 0 {
+				set = reloadSetB
+			}
+			if err := m.Reload(set); err != nil {
+				t.Fatalf("Reload failed: %v", err)
+			}
+		}
+		stop.Store(true)
+		wg.Wait()
+		m.Close()
+	}
+}
+
+// Match latency while the ruleset is continuously recompiled and swapped.
+// p99 should stay close to BenchmarkVsMatcher_Parallel_Concurrent.
+func BenchmarkVsMatcher_Parallel_Reloading(b *testing.B) {
+	m, err := NewConcurrentVsMatcher(testdata.MalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewConcurrentVsMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	var stop atomic.Bool
+	var reloads atomic.Int64
+	done := make(chan struct{})
+	go func() {
+		defer close(done)
+		for !stop.Load() {
+			m.Reload(testdata.MalwarePatterns)
+			reloads.Add(1)
+		}
+	}()
+
+	files := testdata.TestFilenames
+	var mu sync.Mutex
+	var latencies []time.Duration
+
+	b.ResetTimer()
+	b.RunParallel(func(pb *testing.PB) {
+		local := make([]time.Duration, 0, 1024)
+		i := 0
+		for pb.Next() {
+			start := time.Now()
+			m.Match(files[i%len(files)])
+			local = append(local, time.Since(start))
+			i++
+		}
+		mu.Lock()
+		latencies = append(latencies, local...)
+		mu.Unlock()
+	})
+	b.StopTimer()
+	stop.Store(true)
+	<-done
+
+	sort.Slice(latencies, func(i, j int) bool { return latencies[i] < latencies[j] })
+	if n := len(latencies); n > 0 {
+		b.ReportMetric(float64(latencies[n/2].Nanoseconds()), "p50-ns")
+		b.ReportMetric(float64(latencies[n*99/100].Nanoseconds()), "p99-ns")
+	}
+	b.ReportMetric(float64(reloads.Load()), "reloads")
+}
@@ -0,0 +1,167 @@
+package vectorscan
+
+/*
+#cgo pkg-config: libhs
+#include <hs.h>
+
+// First-match state for vs_scan_first, kept on the C stack
+typedef struct {
+	int matched;
+	int cutoff;
+} vs_first_match_t;
+
+static int vs_on_match(unsigned int id, unsigned long long from,
+                       unsigned long long to, unsigned int flags, void *ctx) {
+	vs_first_match_t *m = (vs_first_match_t *)ctx;
+	if (m->matched < 0 || (int)id < m->matched) m->matched = (int)id;
+
+	// Non-zero to stop scanning; only ID 0 is final before the scan ends,
+	// so a cutoff above 1 stops on the first tier match (see SetPriority)
+	if (m->cutoff == 0) return 1;
+	return m->matched < m->cutoff;
+}
+
+// Scan with a C callback so the hot path never calls back into Go
+// Returns first matching pattern ID, -1 if no match, -2 on scan error
+static int vs_scan_first(const hs_database_t *db, hs_scratch_t *scratch,
+                         const char *data, unsigned int len, int cutoff) {
+	static const char empty[1] = {0};
+	vs_first_match_t m = {-1, cutoff};
+	hs_error_t err = hs_scan(db, data ? data : empty, len, 0, scratch, vs_on_match, &m);
+	if (err != HS_SUCCESS && err != HS_SCAN_TERMINATED) return -2;
+	return m.matched;
+}
+
+// All-matches state for vs_scan_all: bit i of bits is pattern i, for the
+// first limit patterns
+typedef struct {
+	unsigned long long *bits;
+	unsigned int limit;
+	int count;
+	int out_of_range; // an ID >= limit fired: the database is not the one counted
+} vs_all_match_t;
+
+static int vs_on_match_all(unsigned int id, unsigned long long from,
+                           unsigned long long to, unsigned int flags, void *ctx) {
+	vs_all_match_t *m = (vs_all_match_t *)ctx;
+	if (id >= m->limit) {
+		m->out_of_range = 1;
+		return 1;
+	}
+	unsigned long long bit = 1ULL << (id & 63);
+	if (!(m->bits[id >> 6] & bit)) {
+		m->bits[id >> 6] |= bit;
+		m->count++;
+	}
+	return 0;
+}
+
+// Scan recording every matching pattern into a zeroed bitset of limit bits
+// Returns the number of matching patterns, -2 on scan error, -3 if an ID
+// at or above limit matched
+static int vs_scan_all(const hs_database_t *db, hs_scratch_t *scratch,
+                       const char *data, unsigned int len, unsigned long long *bits,
+                       unsigned int limit) {
+	static const char empty[1] = {0};
+	vs_all_match_t m = {bits, limit, 0, 0};
+	hs_error_t err = hs_scan(db, data ? data : empty, len, 0, scratch, vs_on_match_all, &m);
+	if (m.out_of_range) return -3;
+	if (err != HS_SUCCESS) return -2;
+	return m.count;
+}
+*/
+import "C"
+
+import (
+	"fmt"
+	"unsafe"
+
+	hs "github.com/flier/gohs/hyperscan"
+)
+
+// Raw Vectorscan handles for the cgo fast path used by Match and MatchBytes.
+//
+// gohs registers a Go callback handle on every Scan, which costs several
+// allocations per call. Match instead calls hs_scan directly with a C match
+// callback, passing the input's backing bytes without conversion, so a scan
+// performs no Go allocations at all.
+type (
+	rawDatabase = C.hs_database_t
+	rawScratch  = C.hs_scratch_t
+)
+
+// newRawDatabase makes a C-owned copy of db. gohs does not expose its
+// database handle, so the copy goes through the serialized form.
+func newRawDatabase(db hs.BlockDatabase) (*rawDatabase, error) {
+	data, err := db.Marshal()
+	if err != nil {
+		return nil, fmt.Errorf("failed to serialize database: %w", err)
+	}
+	if len(data) == 0 {
+		return nil, fmt.Errorf("empty serialized database")
+	}
+
+	var raw *C.hs_database_t
+	ret := C.hs_deserialize_database((*C.char)(unsafe.Pointer(&data[0])), C.size_t(len(data)), &raw)
+	if ret != C.HS_SUCCESS {
+		return nil, fmt.Errorf("hs_deserialize_database failed with code %d", int(ret))
+	}
+	return raw, nil
+}
+
+func freeRawDatabase(db *rawDatabase) {
+	if db != nil {
+		C.hs_free_database(db)
+	}
+}
+
+// newRawScratch allocates scratch space for db.
+func newRawScratch(db *rawDatabase) (*rawScratch, error) {
+	var s *C.hs_scratch_t
+	if ret := C.hs_alloc_scratch(db, &s); ret != C.HS_SUCCESS {
+		return nil, fmt.Errorf("hs_alloc_scratch failed with code %d", int(ret))
+	}
+	return s, nil
+}
+
+func cloneRawScratch(src *rawScratch) (*rawScratch, error) {
+	var s *C.hs_scratch_t
+	if ret := C.hs_clone_scratch(src, &s); ret != C.HS_SUCCESS {
+		return nil, fmt.Errorf("hs_clone_scratch failed with code %d", int(ret))
+	}
+	return s, nil
+}
+
+func freeRawScratch(s *rawScratch) {
+	if s != nil {
+		C.hs_free_scratch(s)
+	}
+}
+
+// scanFirst scans n bytes at data, returning the first matching pattern
+// according to cutoff (see SetPriority), or -1 if no match.
+// data is only read for the duration of the call.
+func scanFirst(db *rawDatabase, s *rawScratch, data *byte, n int, cutoff int) int {
+	id := int(C.vs_scan_first(db, s, (*C.char)(unsafe.Pointer(data)), C.uint(n), C.int(cutoff)))
+	if id < -1 {
+		return -1
+	}
+	return id
+}
+
+// scanAll scans n bytes at data, setting bit i of bits for each matching
+// pattern i < patterns. bits must be zeroed and hold at least that many bits;
+// both are only used for the duration of the call. Returns the match count,
+// or -1 on error, including a match on a pattern ID at or above patterns.
+func scanAll(db *rawDatabase, s *rawScratch, data *byte, n int, bits []uint64, patterns int) int {
+	if len(bits) == 0 {
+		return 0
+	}
+	patterns = min(patterns, 64*len(bits))
+	count := int(C.vs_scan_all(db, s, (*C.char)(unsafe.Pointer(data)), C.uint(n),
+		(*C.ulonglong)(unsafe.Pointer(&bits[0])), C.uint(patterns)))
+	if count < 0 {
+		return -1
+	}
+	return count
+}
@@ -0,0 +1,98 @@
+package vectorscan
+
+import (
+	"fmt"
+
+	hs "github.com/flier/gohs/hyperscan"
+)
+
+// MatchStream scans input that arrives in chunks, such as a request body read
+// off a socket. Matches may span chunk boundaries and memory stays constant
+// (one hs_stream_t plus a scratch clone). It implements io.WriteCloser:
+// write chunks as they arrive, Close, then read Result.
+type MatchStream struct {
+	db      *vsDatabase // pinned until Close
+	stream  hs.Stream
+	scratch *hs.Scratch
+	matched int
+	done    bool
+	closed  bool
+}
+
+// NewStream opens a stream on the matcher. Streams are independent of each
+// other and of Match, so any number can be open concurrently. A stream keeps
+// scanning the database that was current when it opened, even across Reload.
+// The first call compiles a streaming database from the matcher's patterns,
+// so it is not available on matchers created with NewVsMatcherFromDB.
+func (m *VsMatcher) NewStream() (*MatchStream, error) {
+	d := m.pin()
+	if d == nil {
+		return nil, fmt.Errorf("matcher is closed")
+	}
+
+	d.streamOnce.Do(d.initStream)
+	if d.streamErr != nil {
+		d.release()
+		return nil, d.streamErr
+	}
+
+	scratch, err := d.streamScratch.Clone()
+	if err != nil {
+		d.release()
+		return nil, fmt.Errorf("failed to clone stream scratch: %w", err)
+	}
+
+	s := &MatchStream{db: d, scratch: scratch, matched: -1}
+	handler := newFirstMatchHandler(m.priorityCutoff, &s.matched)
+	s.stream, err = d.streamDB.Open(0, scratch, handler, nil)
+	if err != nil {
+		scratch.Free()
+		d.release()
+		return nil, fmt.Errorf("failed to open stream: %w", err)
+	}
+	return s, nil
+}
+
+// Write scans the next chunk. Once the match is final (see SetPriority)
+// further chunks are accepted without scanning.
+func (s *MatchStream) Write(p []byte) (int, error) {
+	if s.closed {
+		return 0, fmt.Errorf("write to closed stream")
+	}
+	if s.done {
+		return len(p), nil
+	}
+
+	err := s.stream.Scan(p)
+	if err == hs.ErrScanTerminated {
+		s.done = true
+		return len(p), nil
+	}
+	if err != nil {
+		return 0, fmt.Errorf("stream scan failed: %w", err)
+	}
+	return len(p), nil
+}
+
+// Close ends the stream, picking up matches anchored at end of input,
+// and releases its scratch.
+func (s *MatchStream) Close() error {
+	if s.closed {
+		return nil
+	}
+	s.closed = true
+
+	err := s.stream.Close()
+	s.scratch.Free()
+	s.db.release()
+	if err != nil && err != hs.ErrScanTerminated {
+		return fmt.Errorf("failed to close stream: %w", err)
+	}
+	return nil
+}
+
+// Result returns the index of the matching pattern, or -1 if no match.
+// It is only meaningful after Close.
+func (s *MatchStream) Result() int {
+	return s.matched
+}
@@ -9,6 +9,9 @@ VS_DIR="$SCRIPT_DIR/vectorscan"
 OUT_DIR="$SCRIPT_DIR/out"
 
 # Default variant to build (all, simd, nosimd)
+# The host embeds both host/matcher.wasm (scalar) and host/matcher-simd.wasm
+# (SIMD128) and picks one at runtime, so "all" refreshes both. After
+# "nosimd" alone, build the host with -tags nosimd.
 VARIANT="${1:-all}"
 
 echo "=== Building Vectorscan for WASM (variant: $VARIANT) ==="
@@ -81,7 +84,7 @@ build_variant() {
         -s WASM=1 \
         -s STANDALONE_WASM=1 \
         --no-entry \
-        -s EXPORTED_FUNCTIONS='["_wasm_alloc","_wasm_free","_matcher_init","_matcher_match","_matcher_pattern_count","_matcher_close","_matcher_get_error","_matcher_check_platform","_malloc","_free"]' \
+        -s EXPORTED_FUNCTIONS='["_wasm_alloc","_wasm_free","_matcher_init","_matcher_create","_matcher_create_serialized","_matcher_destroy","_matcher_serialize","_matcher_load_serialized","_matcher_match","_matcher_match_batch","_matcher_match_all","_matcher_init_stream","_matcher_stream_open","_matcher_stream_write","_matcher_stream_close","_matcher_init_vectored","_matcher_match_fields","_matcher_input_ptr","_matcher_input_capacity","_matcher_input_reserve","_matcher_set_priority","_matcher_pattern_count","_matcher_close","_matcher_get_error","_matcher_check_platform","_malloc","_free"]' \
         -s ERROR_ON_UNDEFINED_SYMBOLS=0 \
         -s TOTAL_MEMORY=67108864 \
         -s ALLOW_MEMORY_GROWTH=1
@@ -105,7 +108,7 @@ case "$VARIANT" in
     simd)
         # With WASM SIMD (-msimd128)
         build_variant "simd-O3" "-O3" "-msimd128" ""
-        cp "$OUT_DIR/matcher-simd-O3.wasm" "$SCRIPT_DIR/host/matcher.wasm"
+        cp "$OUT_DIR/matcher-simd-O3.wasm" "$SCRIPT_DIR/host/matcher-simd.wasm"
         ;;
     nosimd)
         # Without SIMD (pure scalar fallback)
@@ -119,8 +122,9 @@ case "$VARIANT" in
         build_variant "nosimd-O3" "-O3" "" ""
         build_variant "nosimd-O2" "-O2" "" ""
 
-        # Default to nosimd-O3 for now (most compatible)
+        # Embed the -O3 builds; the host loads the SIMD one when the engine supports it
         cp "$OUT_DIR/matcher-nosimd-O3.wasm" "$SCRIPT_DIR/host/matcher.wasm"
+        cp "$OUT_DIR/matcher-simd-O3.wasm" "$SCRIPT_DIR/host/matcher-simd.wasm"
         ;;
     *)
         echo "Usage: $0 [simd|nosimd|all]"
@@ -132,4 +136,11 @@ echo ""
 echo "=== Build complete ==="
 ls -la "$OUT_DIR/"
 echo ""
-echo "Active variant in host/matcher.wasm: $(ls -lh $SCRIPT_DIR/host/matcher.wasm | awk '{print $5}')"
+for f in matcher.wasm matcher-simd.wasm; do
+    if [ -f "$SCRIPT_DIR/host/$f" ]; then
+        echo "Embedded host/$f: $(ls -lh $SCRIPT_DIR/host/$f | awk '{print $5}')"
+    else
+        echo "Missing host/$f: run ./build.sh all before building the host"
+        [ "$f" = matcher-simd.wasm ] && echo "  (or build the host with -tags nosimd for scalar only)"
+    fi
+done
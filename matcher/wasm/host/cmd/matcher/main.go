@@ -15,13 +15,32 @@ func main() {
 		patterns = flag.String("p", "", "Comma-separated patterns to compile")
 		input    = flag.String("i", "", "Input string to match")
 		file     = flag.String("f", "", "File containing patterns (one per line)")
+		dbFile   = flag.String("db", "", "Load a serialized database instead of compiling patterns")
+		save     = flag.String("save", "", "Write the compiled database to this file")
+		snapshot = flag.String("snapshot", "", "Instantiate a pre-initialized snapshot instead of compiling patterns")
+		saveSnap = flag.String("save-snapshot", "", "Write a pre-initialized snapshot module to this file")
+		cacheDir = flag.String("cache", os.Getenv("WASM_MODULE_CACHE"), "Cache the compiled WASM module in this directory")
 		verbose  = flag.Bool("v", false, "Verbose output")
 	)
 	flag.Parse()
+	wasmvs.SetModuleCacheDir(*cacheDir)
+
+	if *dbFile != "" {
+		runFromDB(*dbFile, *input, *verbose)
+		return
+	}
+	if *snapshot != "" {
+		runFromSnapshot(*snapshot, *input, *verbose)
+		return
+	}
 
 	if *patterns == "" && *file == "" {
 		fmt.Fprintln(os.Stderr, "Usage: matcher -p 'pattern1,pattern2' -i 'input string'")
 		fmt.Fprintln(os.Stderr, "       matcher -f patterns.txt -i 'input string'")
+		fmt.Fprintln(os.Stderr, "       matcher -f patterns.txt -save patterns.db")
+		fmt.Fprintln(os.Stderr, "       matcher -db patterns.db -i 'input string'")
+		fmt.Fprintln(os.Stderr, "       matcher -f patterns.txt -save-snapshot patterns.wasm")
+		fmt.Fprintln(os.Stderr, "       matcher -snapshot patterns.wasm -i 'input string'")
 		flag.PrintDefaults()
 		os.Exit(1)
 	}
@@ -67,6 +86,32 @@ func main() {
 		fmt.Printf("Platform check: %d\n", m.CheckPlatform())
 	}
 
+	if *save != "" {
+		db, err := m.Serialize()
+		if err != nil {
+			fmt.Fprintf(os.Stderr, "Failed to serialize database: %v\n", err)
+			os.Exit(1)
+		}
+		if err := os.WriteFile(*save, db, 0o644); err != nil {
+			fmt.Fprintf(os.Stderr, "Error writing database: %v\n", err)
+			os.Exit(1)
+		}
+		fmt.Printf("Wrote serialized database to %s (%d bytes)\n", *save, len(db))
+	}
+
+	if *saveSnap != "" {
+		snap, err := wasmvs.Snapshot(patternList, m.Variant())
+		if err != nil {
+			fmt.Fprintf(os.Stderr, "Failed to snapshot matcher: %v\n", err)
+			os.Exit(1)
+		}
+		if err := os.WriteFile(*saveSnap, snap, 0o644); err != nil {
+			fmt.Fprintf(os.Stderr, "Error writing snapshot: %v\n", err)
+			os.Exit(1)
+		}
+		fmt.Printf("Wrote %s snapshot to %s (%d bytes)\n", m.Variant(), *saveSnap, len(snap))
+	}
+
 	if *input == "" {
 		fmt.Println("Patterns compiled successfully")
 		return
@@ -79,3 +124,65 @@ func main() {
 		fmt.Println("No match")
 	}
 }
+
+// runFromDB matches input against a serialized database, skipping compilation
+func runFromDB(path, input string, verbose bool) {
+	db, err := os.ReadFile(path)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Error reading database: %v\n", err)
+		os.Exit(1)
+	}
+
+	m, err := wasmvs.NewWasmMatcherFromDB(db)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Failed to load database: %v\n", err)
+		os.Exit(1)
+	}
+	defer m.Close()
+
+	if verbose {
+		fmt.Printf("Loaded %d pattern(s) from %s\n", m.PatternCount(), path)
+	}
+
+	if input == "" {
+		fmt.Println("Database loaded successfully")
+		return
+	}
+
+	if result := m.Match(input); result >= 0 {
+		fmt.Printf("Match: pattern[%d]\n", result)
+	} else {
+		fmt.Println("No match")
+	}
+}
+
+// runFromSnapshot matches input on an instance of a pre-initialized snapshot
+func runFromSnapshot(path, input string, verbose bool) {
+	snap, err := os.ReadFile(path)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Error reading snapshot: %v\n", err)
+		os.Exit(1)
+	}
+
+	m, err := wasmvs.NewWasmMatcherFromSnapshot(snap)
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "Failed to load snapshot: %v\n", err)
+		os.Exit(1)
+	}
+	defer m.Close()
+
+	if verbose {
+		fmt.Printf("Loaded %d pattern(s) from %s (%s)\n", m.PatternCount(), path, m.Variant())
+	}
+
+	if input == "" {
+		fmt.Println("Snapshot loaded successfully")
+		return
+	}
+
+	if result := m.Match(input); result >= 0 {
+		fmt.Printf("Match: pattern[%d]\n", result)
+	} else {
+		fmt.Println("No match")
+	}
+}
@@ -3,55 +3,197 @@ package wasmvs
 
 import (
 	_ "embed"
+	"encoding/binary"
 	"fmt"
 	"strings"
 	"sync"
 
 	"github.com/bytecodealliance/wasmtime-go/v39"
+
+	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
 )
 
+// The scalar build of the matcher; see variant.go for the SIMD128 one.
+//
 //go:embed matcher.wasm
 var wasmBytes []byte
 
+// First-match policies for SetPriority.
+const (
+	// PriorityOffset stops at the first match in input offset order (default, fastest).
+	// The result may not be the lowest matching pattern index.
+	PriorityOffset = 0
+
+	// PriorityLowest returns the lowest matching pattern index, like GoMatcher.Match.
+	// Scanning only stops early when pattern 0 matches.
+	PriorityLowest = 1
+)
+
+// defaultHandle is the ruleset slot managed by matcher_init and
+// matcher_load_serialized; NewRuleset and Reload hand out the others.
+const defaultHandle int32 = 0
+
 // WasmMatcher implements multi-pattern matching using Vectorscan compiled to WASM.
 type WasmMatcher struct {
+	module   *wasmModule
 	engine   *wasmtime.Engine
 	store    *wasmtime.Store
 	instance *wasmtime.Instance
 	memory   *wasmtime.Memory
 
 	// Exported functions
-	wasmAlloc     *wasmtime.Func
-	wasmFree      *wasmtime.Func
+	inputPtrFn    *wasmtime.Func
+	inputCapFn    *wasmtime.Func
+	inputReserve  *wasmtime.Func
 	matcherInit   *wasmtime.Func
+	create        *wasmtime.Func
+	createDB      *wasmtime.Func
+	destroy       *wasmtime.Func
+	serialize     *wasmtime.Func
+	loadDB        *wasmtime.Func
 	matcherMatch  *wasmtime.Func
+	matchBatch    *wasmtime.Func
+	matchAll      *wasmtime.Func
+	setPriority   *wasmtime.Func
+	initStream    *wasmtime.Func
+	streamOpen    *wasmtime.Func
+	streamWrite   *wasmtime.Func
+	streamClose   *wasmtime.Func
+	initVectored  *wasmtime.Func
+	matchFields   *wasmtime.Func
 	matcherClose  *wasmtime.Func
 	patternCount  *wasmtime.Func
 	getError      *wasmtime.Func
 	checkPlatform *wasmtime.Func
 
+	// Persistent input arena owned by the WASM module.
+	// The offset only changes when the arena is regrown via matcher_input_reserve.
+	inputPtr int32
+	inputCap int
+
+	// inputPtr boxed once for Func.Call, so the hot path does not re-box it
+	inputPtrArg interface{}
+
+	// Cached view of linear memory, refreshed after memory growth
+	memData []byte
+	memGrew bool
+
+	// Streaming and vectored databases are compiled on first use
+	streamReady   bool
+	streamActive  bool
+	vectoredReady bool
+
+	// Ruleset slot holding this matcher's own patterns; changes on Reload
+	handle int32
+
 	patterns []string
+	count    int
 	mu       sync.Mutex
 }
 
 // NewWasmMatcher creates a new WASM-based Vectorscan matcher.
+// It runs the SIMD128 module when the engine supports it.
 func NewWasmMatcher(patterns []string) (*WasmMatcher, error) {
+	return NewWasmMatcherVariant(patterns, VariantAuto)
+}
+
+// NewWasmMatcherVariant creates a matcher backed by the given module variant.
+// VariantSIMD fails if the engine cannot run SIMD128.
+func NewWasmMatcherVariant(patterns []string, v Variant) (*WasmMatcher, error) {
 	if len(patterns) == 0 {
 		return nil, fmt.Errorf("no patterns provided")
 	}
 
-	// Create engine with exception handling enabled
+	m, err := newWasmMatcher(v)
+	if err != nil {
+		return nil, err
+	}
+	m.patterns = patterns
+
+	// Initialize with patterns
+	if err := m.initPatterns(patterns); err != nil {
+		m.Close()
+		return nil, fmt.Errorf("failed to initialize patterns: %w", err)
+	}
+
+	return m, nil
+}
+
+// NewWasmMatcherFromDB creates a matcher from a database produced by Serialize.
+// This skips pattern compilation entirely, so startup is roughly a memcpy.
+// The blob must come from the same matcher.wasm build.
+func NewWasmMatcherFromDB(db []byte) (*WasmMatcher, error) {
+	if len(db) == 0 {
+		return nil, fmt.Errorf("empty serialized database")
+	}
+
+	m, err := newWasmMatcher(VariantAuto)
+	if err != nil {
+		return nil, err
+	}
+
+	if err := m.loadSerialized(db); err != nil {
+		m.Close()
+		return nil, fmt.Errorf("failed to load serialized database: %w", err)
+	}
+
+	return m, nil
+}
+
+// wasmModule is the compiled matcher module.
+// Compilation is the expensive step, so one wasmModule backs every instance
+// of its variant in the process; see sharedModule.
+type wasmModule struct {
+	engine  *wasmtime.Engine
+	module  *wasmtime.Module
+	variant Variant
+}
+
+// newEngine creates an engine with exception handling enabled.
+func newEngine() *wasmtime.Engine {
 	cfg := wasmtime.NewConfig()
 	enableExceptions(cfg)
-	engine := wasmtime.NewEngineWithConfig(cfg)
+	return wasmtime.NewEngineWithConfig(cfg)
+}
 
-	// Create store
-	store := wasmtime.NewStore(engine)
+// compileModule compiles the embedded module for v, which must not be
+// VariantAuto. The caller must hold modulesMu; use sharedModule.
+func compileModule(v Variant) (*wasmModule, error) {
+	_, code, err := v.resolve()
+	if err != nil {
+		return nil, err
+	}
+
+	engine := newEngine()
+	module, err := newModule(engine, code)
+	if err != nil {
+		return nil, fmt.Errorf("failed to compile WASM module (%s): %w", v, err)
+	}
+
+	return &wasmModule{engine: engine, module: module, variant: v}, nil
+}
 
-	// Compile module
-	module, err := wasmtime.NewModule(engine, wasmBytes)
+// newWasmMatcher instantiates the shared module for v, ready for a database.
+func newWasmMatcher(v Variant) (*WasmMatcher, error) {
+	wm, err := sharedModule(v)
 	if err != nil {
-		return nil, fmt.Errorf("failed to compile WASM module: %w", err)
+		return nil, err
+	}
+	return wm.instantiate()
+}
+
+// instantiate creates a new instance in its own store.
+// Each instance has its own linear memory, database and scratch.
+func (wm *wasmModule) instantiate() (*WasmMatcher, error) {
+	engine, module := wm.engine, wm.module
+
+	// Create store
+	store := wasmtime.NewStore(engine)
+	m := &WasmMatcher{
+		module: wm,
+		engine: engine,
+		store:  store,
+		handle: defaultHandle,
 	}
 
 	// Create WASI config
@@ -92,9 +234,10 @@ func NewWasmMatcher(patterns []string) (*WasmMatcher, error) {
 		return nil, fmt.Errorf("failed to define WASI: %w", err)
 	}
 
-	// Define emscripten env function (takes memory index as parameter)
-	err = linker.DefineFunc(store, "env", "emscripten_notify_memory_growth", func(memIdx int32) {
-		// No-op - called when memory grows
+	// Define emscripten env function (takes memory index as parameter).
+	// Growth may move linear memory, so drop the cached view.
+	err := linker.DefineFunc(store, "env", "emscripten_notify_memory_growth", func(memIdx int32) {
+		m.memGrew = true
 	})
 	if err != nil {
 		return nil, fmt.Errorf("failed to define emscripten_notify_memory_growth: %w", err)
@@ -116,26 +259,40 @@ func NewWasmMatcher(patterns []string) (*WasmMatcher, error) {
 		return nil, fmt.Errorf("memory export is not a memory")
 	}
 
-	m := &WasmMatcher{
-		engine:   engine,
-		store:    store,
-		instance: instance,
-		memory:   memory,
-		patterns: patterns,
-	}
+	m.instance = instance
+	m.memory = memory
 
 	// Get exported functions
-	m.wasmAlloc = instance.GetFunc(store, "wasm_alloc")
-	m.wasmFree = instance.GetFunc(store, "wasm_free")
+	m.inputPtrFn = instance.GetFunc(store, "matcher_input_ptr")
+	m.inputCapFn = instance.GetFunc(store, "matcher_input_capacity")
+	m.inputReserve = instance.GetFunc(store, "matcher_input_reserve")
 	m.matcherInit = instance.GetFunc(store, "matcher_init")
+	m.create = instance.GetFunc(store, "matcher_create")
+	m.createDB = instance.GetFunc(store, "matcher_create_serialized")
+	m.destroy = instance.GetFunc(store, "matcher_destroy")
+	m.serialize = instance.GetFunc(store, "matcher_serialize")
+	m.loadDB = instance.GetFunc(store, "matcher_load_serialized")
 	m.matcherMatch = instance.GetFunc(store, "matcher_match")
+	m.matchBatch = instance.GetFunc(store, "matcher_match_batch")
+	m.matchAll = instance.GetFunc(store, "matcher_match_all")
+	m.setPriority = instance.GetFunc(store, "matcher_set_priority")
+	m.initStream = instance.GetFunc(store, "matcher_init_stream")
+	m.streamOpen = instance.GetFunc(store, "matcher_stream_open")
+	m.streamWrite = instance.GetFunc(store, "matcher_stream_write")
+	m.streamClose = instance.GetFunc(store, "matcher_stream_close")
+	m.initVectored = instance.GetFunc(store, "matcher_init_vectored")
+	m.matchFields = instance.GetFunc(store, "matcher_match_fields")
 	m.matcherClose = instance.GetFunc(store, "matcher_close")
 	m.patternCount = instance.GetFunc(store, "matcher_pattern_count")
 	m.getError = instance.GetFunc(store, "matcher_get_error")
 	m.checkPlatform = instance.GetFunc(store, "matcher_check_platform")
 
-	if m.wasmAlloc == nil || m.wasmFree == nil || m.matcherInit == nil ||
-		m.matcherMatch == nil || m.matcherClose == nil || m.patternCount == nil {
+	if m.inputPtrFn == nil || m.inputCapFn == nil || m.inputReserve == nil || m.matcherInit == nil ||
+		m.matcherMatch == nil || m.matchBatch == nil || m.matchAll == nil || m.matcherClose == nil ||
+		m.patternCount == nil || m.serialize == nil || m.loadDB == nil ||
+		m.setPriority == nil || m.initStream == nil || m.streamOpen == nil ||
+		m.streamWrite == nil || m.streamClose == nil || m.initVectored == nil ||
+		m.matchFields == nil || m.create == nil || m.createDB == nil || m.destroy == nil {
 		return nil, fmt.Errorf("missing required WASM exports")
 	}
 
@@ -147,41 +304,80 @@ func NewWasmMatcher(patterns []string) (*WasmMatcher, error) {
 		}
 	}
 
-	// Initialize with patterns
-	if err := m.initPatterns(patterns); err != nil {
-		m.Close()
-		return nil, fmt.Errorf("failed to initialize patterns: %w", err)
+	// Cache the input arena location
+	if err := m.cacheInputArena(); err != nil {
+		return nil, err
 	}
 
 	return m, nil
 }
 
+// cacheInputArena queries the arena pointer and capacity from the module.
+func (m *WasmMatcher) cacheInputArena() error {
+	result, err := m.inputPtrFn.Call(m.store)
+	if err != nil {
+		return fmt.Errorf("matcher_input_ptr failed: %w", err)
+	}
+	ptr := result.(int32)
+	if ptr == 0 {
+		return fmt.Errorf("matcher_input_ptr returned null")
+	}
+
+	result, err = m.inputCapFn.Call(m.store)
+	if err != nil {
+		return fmt.Errorf("matcher_input_capacity failed: %w", err)
+	}
+
+	m.inputPtr = ptr
+	m.inputPtrArg = ptr
+	m.inputCap = int(result.(int32))
+	return nil
+}
+
+// ensureInput makes sure the input arena holds at least size bytes.
+// Only crosses into WASM when the arena has to grow.
+func (m *WasmMatcher) ensureInput(size int) error {
+	if size <= m.inputCap {
+		return nil
+	}
+
+	result, err := m.inputReserve.Call(m.store, int32(size))
+	if err != nil {
+		return fmt.Errorf("matcher_input_reserve failed: %w", err)
+	}
+	if result.(int32) == 0 {
+		return fmt.Errorf("matcher_input_reserve(%d) failed: %s", size, m.GetError())
+	}
+	return m.cacheInputArena()
+}
+
+// data returns the cached view of linear memory, refreshing it after growth.
+func (m *WasmMatcher) data() []byte {
+	if m.memData == nil || m.memGrew {
+		m.memData = m.memory.UnsafeData(m.store)
+		m.memGrew = false
+	}
+	return m.memData
+}
+
 // initPatterns sends patterns to the WASM module
 func (m *WasmMatcher) initPatterns(patterns []string) error {
 	// Join patterns with newlines
 	data := strings.Join(patterns, "\n")
-	dataBytes := []byte(data)
 
-	// Allocate memory in WASM
-	result, err := m.wasmAlloc.Call(m.store, int32(len(dataBytes)))
-	if err != nil {
-		return fmt.Errorf("wasm_alloc failed: %w", err)
+	if err := m.ensureInput(len(data)); err != nil {
+		return err
 	}
-	ptr := result.(int32)
 
-	// Write patterns to WASM memory
-	memData := m.memory.UnsafeData(m.store)
-	copy(memData[ptr:], dataBytes)
+	// Write patterns into the input arena
+	copy(m.data()[m.inputPtr:], data)
 
 	// Call matcher_init
-	result, err = m.matcherInit.Call(m.store, ptr, int32(len(dataBytes)))
+	result, err := m.matcherInit.Call(m.store, m.inputPtr, int32(len(data)))
 	if err != nil {
 		return fmt.Errorf("matcher_init failed: %w", err)
 	}
 
-	// Free the temporary buffer
-	m.wasmFree.Call(m.store, ptr)
-
 	retCode := result.(int32)
 	if retCode != 0 {
 		errMsg := m.GetError()
@@ -191,59 +387,439 @@ func (m *WasmMatcher) initPatterns(patterns []string) error {
 		return fmt.Errorf("matcher_init returned error code: %d", retCode)
 	}
 
+	return m.cacheCount()
+}
+
+// Reload replaces the matcher's patterns without stalling matches for the
+// whole compile. The new patterns are compiled on a throwaway instance of
+// the same module; only loading the serialized result into a second handle
+// and swapping it in happens under the lock, after which the old database
+// is destroyed and the shared scratch is shrunk to fit what remains.
+func (m *WasmMatcher) Reload(patterns []string) error {
+	db, err := m.module.compileSerialized(patterns)
+	if err != nil {
+		return err
+	}
+
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	return m.swapLocked(db, patterns)
+}
+
+// compileSerialized compiles patterns on a new instance and returns the
+// serialized database, so no live instance's lock is held while compiling.
+func (wm *wasmModule) compileSerialized(patterns []string) ([]byte, error) {
+	if len(patterns) == 0 {
+		return nil, fmt.Errorf("no patterns provided")
+	}
+
+	tmp, err := wm.instantiate()
+	if err != nil {
+		return nil, err
+	}
+	defer tmp.Close()
+
+	if err := tmp.initPatterns(patterns); err != nil {
+		return nil, fmt.Errorf("failed to compile patterns: %w", err)
+	}
+	return tmp.Serialize()
+}
+
+// swapLocked loads db into a new handle and makes it the matcher's own
+// ruleset; the caller must hold m.mu.
+func (m *WasmMatcher) swapLocked(db []byte, patterns []string) error {
+	if err := m.ensureInput(len(db)); err != nil {
+		return err
+	}
+	copy(m.data()[m.inputPtr:], db)
+
+	r, err := m.createRulesetLocked(m.createDB, "matcher_create_serialized", len(db))
+	if err != nil {
+		return err
+	}
+
+	old := m.handle
+	m.handle = r.handle
+	m.count = r.count
+	m.patterns = patterns
+
+	// Stream and vectored databases are recompiled from the new patterns on next use
+	m.streamReady = false
+	m.vectoredReady = false
+
+	result, err := m.destroy.Call(m.store, old)
+	if err != nil {
+		return fmt.Errorf("matcher_destroy failed: %w", err)
+	}
+	if retCode := result.(int32); retCode != 0 {
+		return fmt.Errorf("matcher_destroy returned error code: %d (%s)", retCode, m.GetError())
+	}
+	return nil
+}
+
+// compileModeLocked compiles the source patterns into one of the extra
+// stream/vectored databases via init; the caller must hold m.mu.
+func (m *WasmMatcher) compileModeLocked(init *wasmtime.Func, name string) error {
+	if len(m.patterns) == 0 {
+		return fmt.Errorf("%s requires the source patterns", name)
+	}
+
+	data := strings.Join(m.patterns, "\n")
+	if err := m.ensureInput(len(data)); err != nil {
+		return err
+	}
+	copy(m.data()[m.inputPtr:], data)
+
+	result, err := init.Call(m.store, m.inputPtr, int32(len(data)))
+	if err != nil {
+		return fmt.Errorf("%s failed: %w", name, err)
+	}
+	if retCode := result.(int32); retCode != 0 {
+		return fmt.Errorf("%s returned error code: %d (%s)", name, retCode, m.GetError())
+	}
 	return nil
 }
 
+// loadSerialized loads a database blob produced by matcher_serialize
+func (m *WasmMatcher) loadSerialized(db []byte) error {
+	if err := m.ensureInput(len(db)); err != nil {
+		return err
+	}
+	copy(m.data()[m.inputPtr:], db)
+
+	result, err := m.loadDB.Call(m.store, m.inputPtr, int32(len(db)))
+	if err != nil {
+		return fmt.Errorf("matcher_load_serialized failed: %w", err)
+	}
+	if retCode := result.(int32); retCode != 0 {
+		return fmt.Errorf("matcher_load_serialized returned error code: %d (%s)", retCode, m.GetError())
+	}
+
+	return m.cacheCount()
+}
+
+// cacheCount records the pattern count of the default ruleset
+func (m *WasmMatcher) cacheCount() error {
+	count, err := m.patternCountLocked(m.handle)
+	if err != nil {
+		return err
+	}
+	m.count = count
+	return nil
+}
+
+// patternCountLocked queries a ruleset's pattern count; the caller must hold m.mu.
+func (m *WasmMatcher) patternCountLocked(handle int32) (int, error) {
+	result, err := m.patternCount.Call(m.store, handle)
+	if err != nil {
+		return 0, fmt.Errorf("matcher_pattern_count failed: %w", err)
+	}
+	return int(result.(int32)), nil
+}
+
+// Serialize returns the compiled database in a form NewWasmMatcherFromDB can load.
+// Compile once at build or deploy time and ship the blob next to matcher.wasm.
+func (m *WasmMatcher) Serialize() ([]byte, error) {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	return m.serializeLocked(m.handle)
+}
+
+// serializeLocked serializes a ruleset; the caller must hold m.mu.
+func (m *WasmMatcher) serializeLocked(handle int32) ([]byte, error) {
+	// matcher_serialize writes the blob pointer and length into the arena
+	outPtr := m.inputPtr
+	outLen := m.inputPtr + 4
+
+	result, err := m.serialize.Call(m.store, handle, outPtr, outLen)
+	if err != nil {
+		return nil, fmt.Errorf("matcher_serialize failed: %w", err)
+	}
+	if retCode := result.(int32); retCode != 0 {
+		return nil, fmt.Errorf("matcher_serialize returned error code: %d (%s)", retCode, m.GetError())
+	}
+
+	memData := m.data()
+	ptr := binary.LittleEndian.Uint32(memData[outPtr:])
+	n := binary.LittleEndian.Uint32(memData[outLen:])
+
+	db := make([]byte, n)
+	copy(db, memData[ptr:ptr+n])
+	return db, nil
+}
+
 // Match returns the index of the first matching pattern, or -1 if no match.
 func (m *WasmMatcher) Match(input string) int {
 	m.mu.Lock()
 	defer m.mu.Unlock()
 
-	inputBytes := []byte(input)
+	return m.matchLocked(m.handle, input)
+}
+
+// MatchBytes is Match for callers holding a byte slice, such as a network
+// buffer, avoiding the string conversion.
+func (m *WasmMatcher) MatchBytes(input []byte) int {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	return m.matchBytesLocked(m.handle, input)
+}
+
+// matchBytesLocked scans input; the caller must hold m.mu.
+func (m *WasmMatcher) matchBytesLocked(handle int32, input []byte) int {
+	if err := m.ensureInput(len(input)); err != nil {
+		return -1
+	}
+	copy(m.data()[m.inputPtr:], input)
+	return m.matchArena(handle, len(input))
+}
+
+// matchLocked scans input; the caller must hold m.mu.
+func (m *WasmMatcher) matchLocked(handle int32, input string) int {
+	if err := m.ensureInput(len(input)); err != nil {
+		return -1
+	}
+
+	// Copy from the string's backing bytes straight into the arena -
+	// no intermediate []byte, and a single WASM call per match
+	copy(m.data()[m.inputPtr:], input)
+	return m.matchArena(handle, len(input))
+}
 
-	// Allocate memory for input
-	result, err := m.wasmAlloc.Call(m.store, int32(len(inputBytes)))
+// matchArena scans the first n bytes of the input arena against a ruleset.
+func (m *WasmMatcher) matchArena(handle int32, n int) int {
+	result, err := m.matcherMatch.Call(m.store, handle, m.inputPtrArg, int32(n))
 	if err != nil {
 		return -1
 	}
-	ptr := result.(int32)
 
-	// Write input to WASM memory
-	memData := m.memory.UnsafeData(m.store)
-	copy(memData[ptr:], inputBytes)
+	return int(result.(int32))
+}
 
-	// Call matcher_match
-	result, err = m.matcherMatch.Call(m.store, ptr, int32(len(inputBytes)))
+// SetPriority selects how Match and MatchBatch pick among several matching patterns.
+// Use PriorityOffset or PriorityLowest. A cutoff n > 1 makes the first n
+// patterns one top-priority tier: the scan stops as soon as any of them
+// matches and returns the lowest index seen by then. That is a tier pattern
+// whenever one matches, and the exact lowest index when none does, but
+// within the tier it need not be the lowest; only PriorityLowest
+// guarantees that, since only pattern 0 is final before the scan ends.
+func (m *WasmMatcher) SetPriority(cutoff int) error {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	return m.setPriorityLocked(cutoff)
+}
+
+func (m *WasmMatcher) setPriorityLocked(cutoff int) error {
+	result, err := m.setPriority.Call(m.store, int32(cutoff))
 	if err != nil {
-		m.wasmFree.Call(m.store, ptr)
+		return fmt.Errorf("matcher_set_priority failed: %w", err)
+	}
+	if retCode := result.(int32); retCode != 0 {
+		return fmt.Errorf("matcher_set_priority returned error code: %d (%s)", retCode, m.GetError())
+	}
+	return nil
+}
+
+// MatchBatch returns the index of the first matching pattern for each input,
+// or -1 for inputs with no match.
+// All inputs are packed into the input arena and scanned in a single WASM call,
+// so the per-call boundary cost is shared across the whole batch.
+func (m *WasmMatcher) MatchBatch(inputs []string) []int {
+	if len(inputs) == 0 {
+		return []int{}
+	}
+
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	return m.matchBatchLocked(m.handle, inputs)
+}
+
+// matchBatchLocked scans a batch; the caller must hold m.mu.
+func (m *WasmMatcher) matchBatchLocked(handle int32, inputs []string) []int {
+	results := make([]int, len(inputs))
+
+	// Arena layout: offsets[n+1] uint32 | results[n] int32 | input bytes
+	offsetsSize := 4 * (len(inputs) + 1)
+	resultsSize := 4 * len(inputs)
+	blobSize := 0
+	for _, s := range inputs {
+		blobSize += len(s)
+	}
+
+	if err := m.ensureInput(offsetsSize + resultsSize + blobSize); err != nil {
+		for i := range results {
+			results[i] = -1
+		}
+		return results
+	}
+
+	offsetsPtr := m.inputPtr
+	resultsPtr := offsetsPtr + int32(offsetsSize)
+	blobPtr := resultsPtr + int32(resultsSize)
+
+	// Write offsets and input bytes directly into WASM memory
+	memData := m.data()
+	offsets := memData[offsetsPtr:resultsPtr]
+	blob := memData[blobPtr:]
+	pos := 0
+	for i, s := range inputs {
+		binary.LittleEndian.PutUint32(offsets[4*i:], uint32(pos))
+		pos += copy(blob[pos:], s)
+	}
+	binary.LittleEndian.PutUint32(offsets[4*len(inputs):], uint32(pos))
+
+	_, err := m.matchBatch.Call(m.store, handle, blobPtr, offsetsPtr, int32(len(inputs)), resultsPtr)
+	if err != nil {
+		for i := range results {
+			results[i] = -1
+		}
+		return results
+	}
+
+	// Re-fetch memory in case the scan grew it
+	memData = m.data()
+	out := memData[resultsPtr:blobPtr]
+	for i := range results {
+		results[i] = int(int32(binary.LittleEndian.Uint32(out[4*i:])))
+	}
+	return results
+}
+
+// MatchFields scans a record made of several fields (path, user agent,
+// header values...) as one logical input without concatenating them.
+// Matches may span field boundaries. Returns the matching pattern index,
+// or -1 if no match. The first call compiles a vectored database from the
+// matcher's patterns, so it is not available on matchers created with
+// NewWasmMatcherFromDB.
+func (m *WasmMatcher) MatchFields(fields [][]byte) int {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	return m.matchFieldsLocked(fields)
+}
+
+// matchFieldsLocked scans one record; the caller must hold m.mu.
+func (m *WasmMatcher) matchFieldsLocked(fields [][]byte) int {
+	if !m.vectoredReady {
+		if err := m.compileModeLocked(m.initVectored, "matcher_init_vectored"); err != nil {
+			return -1
+		}
+		m.vectoredReady = true
+	}
+
+	// Arena layout: offsets[n+1] uint32 | field bytes
+	offsetsSize := 4 * (len(fields) + 1)
+	blobSize := 0
+	for _, f := range fields {
+		blobSize += len(f)
+	}
+	if err := m.ensureInput(offsetsSize + blobSize); err != nil {
 		return -1
 	}
 
-	// Free input buffer
-	m.wasmFree.Call(m.store, ptr)
+	offsetsPtr := m.inputPtr
+	blobPtr := offsetsPtr + int32(offsetsSize)
 
-	return int(result.(int32))
+	memData := m.data()
+	offsets := memData[offsetsPtr:blobPtr]
+	blob := memData[blobPtr:]
+	pos := 0
+	for i, f := range fields {
+		binary.LittleEndian.PutUint32(offsets[4*i:], uint32(pos))
+		pos += copy(blob[pos:], f)
+	}
+	binary.LittleEndian.PutUint32(offsets[4*len(fields):], uint32(pos))
+
+	result, err := m.matchFields.Call(m.store, blobPtr, offsetsPtr, int32(len(fields)))
+	if err != nil {
+		return -1
+	}
+	if id := int(result.(int32)); id >= 0 {
+		return id
+	}
+	return -1
 }
 
 // MatchAll returns indices of all matching patterns.
 func (m *WasmMatcher) MatchAll(input string) []int {
-	result := m.Match(input)
-	if result < 0 {
+	var set gomatcher.Bitset
+	if m.MatchAllInto(input, &set) <= 0 {
 		return nil
 	}
-	return []int{result}
+	return set.AppendTo(nil)
+}
+
+// MatchAllInto scans input once and records every matching pattern in dst,
+// which is reset to PatternCount bits first. Returns the number of matching
+// patterns, or -1 on error. The module writes the bitset into the input
+// arena next to the input, so reusing dst keeps the call allocation-free
+// beyond Func.Call itself.
+func (m *WasmMatcher) MatchAllInto(input string, dst *gomatcher.Bitset) int {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	return m.matchAllLocked(m.handle, m.count, input, dst)
+}
+
+// matchAllLocked scans input against a ruleset of count patterns;
+// the caller must hold m.mu.
+func (m *WasmMatcher) matchAllLocked(handle int32, count int, input string, dst *gomatcher.Bitset) int {
+	dst.Reset(count)
+
+	// Arena layout: bitset words (8-byte aligned, as is the arena) | input bytes
+	bitsSize := 8 * len(dst.Words())
+	if err := m.ensureInput(bitsSize + len(input)); err != nil {
+		return -1
+	}
+	bitsPtr := m.inputPtr
+	dataPtr := bitsPtr + int32(bitsSize)
+	copy(m.data()[dataPtr:], input)
+
+	result, err := m.matchAll.Call(m.store, handle, dataPtr, int32(len(input)), bitsPtr)
+	if err != nil {
+		return -1
+	}
+	n := int(result.(int32))
+	if n < 0 {
+		return -1
+	}
+
+	bits := m.data()[bitsPtr:dataPtr]
+	words := dst.Words()
+	for i := range words {
+		words[i] = binary.LittleEndian.Uint64(bits[8*i:])
+	}
+	return n
 }
 
 // PatternCount returns the number of patterns.
 func (m *WasmMatcher) PatternCount() int {
-	return len(m.patterns)
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	return m.count
+}
+
+// Variant returns the module variant this matcher runs, never VariantAuto.
+func (m *WasmMatcher) Variant() Variant {
+	return m.module.variant
 }
 
 // Close releases WASM resources.
 func (m *WasmMatcher) Close() {
 	if m.matcherClose != nil {
+		// matcher_close also frees the input arena
 		m.matcherClose.Call(m.store)
 	}
+	m.inputPtr = 0
+	m.inputPtrArg = nil
+	m.inputCap = 0
+	m.memData = nil
+	m.streamReady = false
+	m.streamActive = false
+	m.vectoredReady = false
+	m.handle = defaultHandle
 }
 
 // GetError returns the last error message from the WASM module.
@@ -260,7 +836,7 @@ func (m *WasmMatcher) GetError() string {
 		return ""
 	}
 	// Read null-terminated string from WASM memory
-	memData := m.memory.UnsafeData(m.store)
+	memData := m.data()
 	var buf []byte
 	for i := int32(0); i < 512; i++ {
 		b := memData[ptr+i]
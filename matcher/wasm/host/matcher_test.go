@@ -1,9 +1,13 @@
 package wasmvs
 
 import (
+	"bytes"
+	"encoding/binary"
 	"fmt"
+	"slices"
 	"testing"
 
+	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
 	"github.com/paulstuart/cgo-ffi/matcher/testdata"
 )
 
@@ -103,6 +107,194 @@ func TestWasmMatcher_MalwarePatterns(t *testing.T) {
 	}
 }
 
+func TestWasmMatcher_MatchBatch(t *testing.T) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	// Batch results must agree with per-call Match, including empty inputs
+	inputs := append([]string{""}, testdata.TestFilenames...)
+	got := m.MatchBatch(inputs)
+	if len(got) != len(inputs) {
+		t.Fatalf("MatchBatch returned %d results, want %d", len(got), len(inputs))
+	}
+	for i, input := range inputs {
+		if want := m.Match(input); got[i] != want {
+			t.Errorf("MatchBatch[%d] (%q) = %d, Match = %d", i, input, got[i], want)
+		}
+	}
+
+	// A smaller batch reuses the arena
+	small := m.MatchBatch(inputs[:3])
+	for i := range small {
+		if small[i] != got[i] {
+			t.Errorf("second MatchBatch[%d] = %d, want %d", i, small[i], got[i])
+		}
+	}
+
+	if empty := m.MatchBatch(nil); len(empty) != 0 {
+		t.Errorf("MatchBatch(nil) = %v, want empty", empty)
+	}
+}
+
+func TestWasmMatcher_SerializeRoundTrip(t *testing.T) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	db, err := m.Serialize()
+	if err != nil {
+		t.Fatalf("Serialize failed: %v", err)
+	}
+	t.Logf("Serialized database: %d bytes", len(db))
+
+	loaded, err := NewWasmMatcherFromDB(db)
+	if err != nil {
+		t.Fatalf("NewWasmMatcherFromDB failed: %v", err)
+	}
+	defer loaded.Close()
+
+	if loaded.PatternCount() != m.PatternCount() {
+		t.Errorf("PatternCount = %d, want %d", loaded.PatternCount(), m.PatternCount())
+	}
+	for _, f := range testdata.TestFilenames {
+		if got, want := loaded.Match(f), m.Match(f); got != want {
+			t.Errorf("Match(%q) = %d after reload, want %d", f, got, want)
+		}
+	}
+
+	if _, err := NewWasmMatcherFromDB([]byte("not a database")); err == nil {
+		t.Error("NewWasmMatcherFromDB accepted an invalid blob")
+	}
+}
+
+// A header listing fewer patterns than the database holds must not let a
+// high pattern ID write past the bitset
+func TestNewWasmMatcherFromDB_ShortCount(t *testing.T) {
+	patterns := make([]string, 130)
+	for i := range patterns {
+		patterns[i] = fmt.Sprintf("pat%03d", i)
+	}
+	m, err := NewWasmMatcher(patterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+	db, err := m.Serialize()
+	if err != nil {
+		t.Fatalf("Serialize failed: %v", err)
+	}
+
+	binary.LittleEndian.PutUint32(db[4:8], 0)
+	if loaded, err := NewWasmMatcherFromDB(db); err == nil {
+		loaded.Close()
+		t.Error("NewWasmMatcherFromDB accepted a header with no patterns")
+	}
+
+	binary.LittleEndian.PutUint32(db[4:8], 1)
+	loaded, err := NewWasmMatcherFromDB(db)
+	if err != nil {
+		t.Fatalf("NewWasmMatcherFromDB failed: %v", err)
+	}
+	defer loaded.Close()
+	var set gomatcher.Bitset
+	if n := loaded.MatchAllInto("x pat129 x", &set); n != -1 {
+		t.Errorf("MatchAllInto with an out-of-range ID = %d, want -1", n)
+	}
+}
+
+func TestWasmMatcher_PriorityLowest(t *testing.T) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+	if err := m.SetPriority(PriorityLowest); err != nil {
+		t.Fatalf("SetPriority failed: %v", err)
+	}
+
+	// Reference uses the same case folding as the WASM backend
+	folded := make([]string, len(testdata.SimpleMalwarePatterns))
+	for i, p := range testdata.SimpleMalwarePatterns {
+		folded[i] = "(?i)" + p
+	}
+	gm, err := gomatcher.NewGoMatcher(folded)
+	if err != nil {
+		t.Fatalf("NewGoMatcher failed: %v", err)
+	}
+
+	// The extra inputs hit a low-index pattern after a higher-index one
+	inputs := append([]string{
+		"/tmp/ryuk_emotet.exe",
+		"/home/user/notpetya/wannacry.bin",
+		"/var/tmp/lockbit-mimikatz.dll",
+	}, testdata.TestFilenames...)
+
+	for _, f := range inputs {
+		if got, want := m.Match(f), gm.Match(f); got != want {
+			t.Errorf("Match(%q) = %d, want %d (GoMatcher)", f, got, want)
+		}
+	}
+
+	batch := m.MatchBatch(inputs)
+	for i, f := range inputs {
+		if want := gm.Match(f); batch[i] != want {
+			t.Errorf("MatchBatch[%d] (%q) = %d, want %d", i, f, batch[i], want)
+		}
+	}
+
+	if err := m.SetPriority(-1); err == nil {
+		t.Error("SetPriority(-1) succeeded, want error")
+	}
+}
+
+// A cutoff n > 1 must return a tier pattern whenever one matches, and
+// GoMatcher's answer when none does
+func TestWasmMatcher_PriorityTier(t *testing.T) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	folded := make([]string, len(testdata.SimpleMalwarePatterns))
+	for i, p := range testdata.SimpleMalwarePatterns {
+		folded[i] = "(?i)" + p
+	}
+	gm, err := gomatcher.NewGoMatcher(folded)
+	if err != nil {
+		t.Fatalf("NewGoMatcher failed: %v", err)
+	}
+
+	inputs := append([]string{
+		"/tmp/ryuk_emotet.exe",
+		"/home/user/notpetya/wannacry.bin",
+		"/var/tmp/lockbit-mimikatz.dll",
+	}, testdata.TestFilenames...)
+	for _, n := range []int{2, 4, 16, len(testdata.SimpleMalwarePatterns)} {
+		if err := m.SetPriority(n); err != nil {
+			t.Fatalf("SetPriority(%d) failed: %v", n, err)
+		}
+		batch := m.MatchBatch(inputs)
+		for i, f := range inputs {
+			for _, got := range []int{m.Match(f), batch[i]} {
+				want := gm.Match(f)
+				if want < 0 || want >= n {
+					if got != want {
+						t.Errorf("cutoff %d: Match(%q) = %d, want %d (GoMatcher)", n, f, got, want)
+					}
+				} else if got < 0 || got >= n || !slices.Contains(gm.MatchAll(f), got) {
+					t.Errorf("cutoff %d: Match(%q) = %d, want one of the first %d in %v", n, f, got, n, gm.MatchAll(f))
+				}
+			}
+		}
+	}
+}
+
 func BenchmarkWasmMatcher_Match_10(b *testing.B) { benchmarkWasmMatch(b, 10) }
 func BenchmarkWasmMatcher_Match_50(b *testing.B) { benchmarkWasmMatch(b, 50) }
 
@@ -142,3 +334,306 @@ func BenchmarkWasmMatcher_ScanAllFiles(b *testing.B) {
 		}
 	}
 }
+
+func BenchmarkWasmMatcher_MatchBatch_ScanAllFiles(b *testing.B) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.MatchBatch(testdata.TestFilenames)
+	}
+}
+
+// First match by offset vs lowest pattern index
+func BenchmarkWasmMatcher_Priority_Offset(b *testing.B) { benchmarkWasmPriority(b, PriorityOffset) }
+func BenchmarkWasmMatcher_Priority_Lowest(b *testing.B) { benchmarkWasmPriority(b, PriorityLowest) }
+
+func benchmarkWasmPriority(b *testing.B, cutoff int) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+	if err := m.SetPriority(cutoff); err != nil {
+		b.Fatalf("SetPriority failed: %v", err)
+	}
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		for _, f := range testdata.TestFilenames {
+			m.Match(f)
+		}
+	}
+}
+
+func TestWasmMatcher_MatchFields(t *testing.T) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	// Splitting an input into fields must not change the result,
+	// including when the split lands inside a match
+	for _, f := range testdata.TestFilenames {
+		want := m.Match(f)
+		for _, cut := range []int{0, len(f) / 3, len(f) / 2, len(f)} {
+			fields := [][]byte{[]byte(f[:cut]), []byte(f[cut:])}
+			if got := m.MatchFields(fields); got != want {
+				t.Errorf("MatchFields(%q | %q) = %d, want %d", f[:cut], f[cut:], got, want)
+			}
+		}
+	}
+
+	if got := m.MatchFields([][]byte{[]byte("/tmp/mimi"), []byte("katz.exe")}); got < 0 {
+		t.Errorf("MatchFields across field boundary = %d, want match", got)
+	}
+	if got := m.MatchFields(nil); got != -1 {
+		t.Errorf("MatchFields(nil) = %d, want -1", got)
+	}
+}
+
+// Multi-field records: one vectored scan vs concatenating then Match
+var benchRecord = [][]byte{
+	[]byte("/home/user/downloads/report.pdf"),
+	[]byte("Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36"),
+	[]byte("session=abc123; theme=dark"),
+}
+
+func BenchmarkWasmMatcher_MatchFields(b *testing.B) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+	m.MatchFields(benchRecord)
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.MatchFields(benchRecord)
+	}
+}
+
+func BenchmarkWasmMatcher_MatchConcat(b *testing.B) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.Match(string(bytes.Join(benchRecord, nil)))
+	}
+}
+
+func TestWasmMatcher_MatchBytes(t *testing.T) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	for _, f := range testdata.TestFilenames {
+		if got, want := m.MatchBytes([]byte(f)), m.Match(f); got != want {
+			t.Errorf("MatchBytes(%q) = %d, Match = %d", f, got, want)
+		}
+	}
+}
+
+// Match copies the string straight into the arena, so the only allocations
+// left are the ones wasmtime-go makes inside Func.Call itself
+func TestWasmMatcher_MatchZeroAllocs(t *testing.T) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	input := testdata.TestFilenames[len(testdata.TestFilenames)/2]
+	buf := []byte(input)
+	n := int32(len(input))
+
+	callAllocs := testing.AllocsPerRun(100, func() { m.matcherMatch.Call(m.store, m.handle, m.inputPtrArg, n) })
+	if got := testing.AllocsPerRun(100, func() { m.Match(input) }); got > callAllocs {
+		t.Errorf("Match allocs/op = %v, want 0 beyond Func.Call (%v)", got, callAllocs)
+	}
+	if got := testing.AllocsPerRun(100, func() { m.MatchBytes(buf) }); got > callAllocs {
+		t.Errorf("MatchBytes allocs/op = %v, want 0 beyond Func.Call (%v)", got, callAllocs)
+	}
+}
+
+func BenchmarkWasmMatcher_Match_Allocs(b *testing.B) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+	files := testdata.TestFilenames
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.Match(files[i%len(files)])
+	}
+}
+
+func BenchmarkWasmMatcher_MatchBytes_Allocs(b *testing.B) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+	bufs := make([][]byte, len(testdata.TestFilenames))
+	for i, f := range testdata.TestFilenames {
+		bufs[i] = []byte(f)
+	}
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.MatchBytes(bufs[i%len(bufs)])
+	}
+}
+
+func TestWasmMatcher_MatchAllInto(t *testing.T) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+	pool, err := NewWasmMatcherPool(testdata.SimpleMalwarePatterns, 2)
+	if err != nil {
+		t.Fatalf("NewWasmMatcherPool failed: %v", err)
+	}
+	defer pool.Close()
+	rs, err := m.NewRuleset(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewRuleset failed: %v", err)
+	}
+	defer rs.Close()
+
+	folded := make([]string, len(testdata.SimpleMalwarePatterns))
+	for i, p := range testdata.SimpleMalwarePatterns {
+		folded[i] = "(?i)" + p
+	}
+	gm, err := gomatcher.NewGoMatcher(folded)
+	if err != nil {
+		t.Fatalf("NewGoMatcher failed: %v", err)
+	}
+
+	inputs := append([]string{"/tmp/ryuk_emotet_mimikatz.exe"}, testdata.TestFilenames...)
+	var set gomatcher.Bitset
+	for _, f := range inputs {
+		want := fmt.Sprint(gm.MatchAll(f))
+		n := m.MatchAllInto(f, &set)
+		if got := fmt.Sprint(set.AppendTo(nil)); got != want || n != set.Count() {
+			t.Errorf("MatchAllInto(%q) = %d %s, want %s", f, n, got, want)
+		}
+		for name, mm := range map[string]gomatcher.Matcher{"matcher": m, "pool": pool, "ruleset": rs} {
+			if got := fmt.Sprint(mm.MatchAll(f)); got != want {
+				t.Errorf("%s.MatchAll(%q) = %s, want %s", name, f, got, want)
+			}
+		}
+	}
+
+	// The bitset is reused, so only Func.Call allocates
+	input := inputs[0]
+	callAllocs := testing.AllocsPerRun(100, func() { m.matcherMatch.Call(m.store, m.handle, m.inputPtrArg, int32(len(input))) })
+	if got := testing.AllocsPerRun(100, func() { m.MatchAllInto(input, &set) }); got > callAllocs+2 {
+		t.Errorf("MatchAllInto allocs/op = %v, want about Func.Call (%v)", got, callAllocs)
+	}
+}
+
+func BenchmarkWasmMatcher_MatchAllInto(b *testing.B) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+	files := testdata.TestFilenames
+	var set gomatcher.Bitset
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.MatchAllInto(files[i%len(files)], &set)
+	}
+}
+
+func TestWasmMatcher_Variants(t *testing.T) {
+	auto, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer auto.Close()
+
+	simd := simdEmbedded() && SIMDSupported()
+	want := VariantScalar
+	if simd {
+		want = VariantSIMD
+	}
+	if auto.Variant() != want {
+		t.Errorf("auto picked %s, want %s", auto.Variant(), want)
+	}
+
+	for _, v := range []Variant{VariantScalar, VariantSIMD} {
+		if v == VariantSIMD && !simd {
+			continue
+		}
+		m, err := NewWasmMatcherVariant(testdata.SimpleMalwarePatterns, v)
+		if err != nil {
+			t.Fatalf("NewWasmMatcherVariant(%s) failed: %v", v, err)
+		}
+		if m.Variant() != v {
+			t.Errorf("Variant() = %s, want %s", m.Variant(), v)
+		}
+		for _, f := range testdata.TestFilenames {
+			if got, want := m.Match(f), auto.Match(f) >= 0; (got >= 0) != want {
+				t.Errorf("%s: Match(%q) = %d, auto matched = %v", v, f, got, want)
+			}
+		}
+		m.Close()
+	}
+}
+
+// Throughput of each module variant as the rule set grows
+func BenchmarkWasmMatcher_Variants(b *testing.B) {
+	files := testdata.TestFilenames
+	var size int64
+	for _, f := range files {
+		size += int64(len(f))
+	}
+
+	for _, v := range []Variant{VariantScalar, VariantSIMD} {
+		for _, n := range []int{16, 64, 256} {
+			b.Run(fmt.Sprintf("%s/patterns=%d", v, n), func(b *testing.B) {
+				if v == VariantSIMD && !simdEmbedded() {
+					b.Skip("built with -tags nosimd")
+				}
+				if v == VariantSIMD && !SIMDSupported() {
+					b.Skip("engine does not support SIMD128")
+				}
+				m, err := NewWasmMatcherVariant(testdata.MalwarePatterns[:n], v)
+				if err != nil {
+					b.Fatalf("NewWasmMatcherVariant failed: %v", err)
+				}
+				defer m.Close()
+
+				b.SetBytes(size)
+				b.ResetTimer()
+				for i := 0; i < b.N; i++ {
+					for _, f := range files {
+						m.Match(f)
+					}
+				}
+			})
+		}
+	}
+}
@@ -0,0 +1,124 @@
+package wasmvs
+
+import (
+	"crypto/sha256"
+	"encoding/hex"
+	"os"
+	"path/filepath"
+	"runtime"
+	"sync"
+
+	"github.com/bytecodealliance/wasmtime-go/v39"
+)
+
+// Compiling matcher.wasm with Cranelift takes seconds, so it happens at most
+// once per process and variant: every WasmMatcher, pool and ruleset shares
+// one Engine and Module. Engines and Modules are safe for concurrent use;
+// each instance still gets its own Store.
+//
+// With a module cache directory set, the compiled code also outlives the
+// process: it is serialized to <dir>/<key>.cwasm and later starts
+// deserialize it (mmap) instead of compiling.
+var (
+	modulesMu sync.Mutex
+	modules   = map[Variant]*wasmModule{}
+	cacheDir  = os.Getenv("WASM_MODULE_CACHE")
+)
+
+// engineKey is hashed with the module bytes to name a cache entry; it
+// differs from wasm/host's because this engine enables exceptions and GC.
+const engineKey = "wasmtime-go/v39 exceptions,gc " + runtime.GOOS + "/" + runtime.GOARCH
+
+// SetModuleCacheDir sets the directory for precompiled modules; "" (the
+// default unless $WASM_MODULE_CACHE is set) disables it. As with
+// wasm/host.SetModuleCacheDir, the directory must be trusted.
+func SetModuleCacheDir(dir string) {
+	modulesMu.Lock()
+	cacheDir = dir
+	modulesMu.Unlock()
+}
+
+// sharedModule returns the process-wide module for v, compiling it on
+// first use. VariantAuto resolves to the SIMD module, or to the scalar one
+// when SIMD is unsupported or its module fails to compile.
+func sharedModule(v Variant) (*wasmModule, error) {
+	modulesMu.Lock()
+	defer modulesMu.Unlock()
+
+	if wm := modules[v]; wm != nil {
+		return wm, nil
+	}
+	if v != VariantAuto {
+		return sharedModuleLocked(v)
+	}
+
+	resolved, _, _ := v.resolve()
+	wm, err := sharedModuleLocked(resolved)
+	if err != nil && resolved == VariantSIMD {
+		wm, err = sharedModuleLocked(VariantScalar)
+	}
+	if err != nil {
+		return nil, err
+	}
+	modules[VariantAuto] = wm
+	return wm, nil
+}
+
+func sharedModuleLocked(v Variant) (*wasmModule, error) {
+	if wm := modules[v]; wm != nil {
+		return wm, nil
+	}
+	wm, err := compileModule(v)
+	if err != nil {
+		return nil, err
+	}
+	modules[v] = wm
+	return wm, nil
+}
+
+// newModule and writeCacheFile are the on-disk cache of wasm/host
+// (module.go, which documents the key and write protocol); the matcher
+// module does not depend on the root one, so they are repeated here.
+// The caller must hold modulesMu.
+func newModule(engine *wasmtime.Engine, code []byte) (*wasmtime.Module, error) {
+	if cacheDir == "" {
+		return wasmtime.NewModule(engine, code)
+	}
+
+	h := sha256.New()
+	h.Write([]byte(engineKey))
+	h.Write(code)
+	path := filepath.Join(cacheDir, hex.EncodeToString(h.Sum(nil)[:16])+".cwasm")
+	if module, err := wasmtime.NewModuleDeserializeFile(engine, path); err == nil {
+		return module, nil
+	}
+
+	module, err := wasmtime.NewModule(engine, code)
+	if err != nil {
+		return nil, err
+	}
+	if blob, err := module.Serialize(); err == nil {
+		writeCacheFile(path, blob)
+	}
+	return module, nil
+}
+
+func writeCacheFile(path string, blob []byte) {
+	if err := os.MkdirAll(filepath.Dir(path), 0o755); err != nil {
+		return
+	}
+	tmp, err := os.CreateTemp(filepath.Dir(path), ".cwasm-*")
+	if err != nil {
+		return
+	}
+	_, err = tmp.Write(blob)
+	if cerr := tmp.Close(); err == nil {
+		err = cerr
+	}
+	if err == nil {
+		err = os.Rename(tmp.Name(), path)
+	}
+	if err != nil {
+		os.Remove(tmp.Name())
+	}
+}
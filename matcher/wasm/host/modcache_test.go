@@ -0,0 +1,108 @@
+package wasmvs
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+)
+
+// resetModules drops the shared modules so the next matcher compiles again
+func resetModules() {
+	modulesMu.Lock()
+	modules = map[Variant]*wasmModule{}
+	modulesMu.Unlock()
+}
+
+func TestSharedModule(t *testing.T) {
+	a, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer a.Close()
+	b, err := NewWasmMatcherVariant(testdata.SimpleMalwarePatterns, a.Variant())
+	if err != nil {
+		t.Fatalf("NewWasmMatcherVariant failed: %v", err)
+	}
+	defer b.Close()
+
+	if a.module != b.module || a.engine != b.engine {
+		t.Error("matchers of one variant should share the engine and module")
+	}
+	if a.store == b.store {
+		t.Error("matchers must not share a store")
+	}
+}
+
+func TestModuleCacheDir(t *testing.T) {
+	dir := t.TempDir()
+	SetModuleCacheDir(dir)
+	resetModules()
+	defer func() {
+		SetModuleCacheDir("")
+		resetModules()
+	}()
+
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	want := m.Match("/tmp/mimikatz.exe")
+	m.Close()
+
+	files, _ := filepath.Glob(filepath.Join(dir, "*.cwasm"))
+	if len(files) != 1 {
+		t.Fatalf("cache holds %v, want one .cwasm", files)
+	}
+
+	// A fresh process would deserialize the artifact instead of compiling
+	resetModules()
+	m, err = NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher from cache failed: %v", err)
+	}
+	defer m.Close()
+	if got := m.Match("/tmp/mimikatz.exe"); got != want {
+		t.Errorf("Match from cached module = %d, want %d", got, want)
+	}
+
+	// A corrupt artifact is a miss and gets rewritten
+	if err := os.WriteFile(files[0], []byte("garbage"), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	resetModules()
+	m2, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher with corrupt cache failed: %v", err)
+	}
+	m2.Close()
+}
+
+// Cold start with and without a warm module cache
+func BenchmarkNewWasmMatcher_Compile(b *testing.B) {
+	SetModuleCacheDir("")
+	benchmarkColdStart(b)
+}
+
+func BenchmarkNewWasmMatcher_Cached(b *testing.B) {
+	SetModuleCacheDir(b.TempDir())
+	defer SetModuleCacheDir("")
+	resetModules()
+	if _, err := sharedModule(VariantAuto); err != nil {
+		b.Fatalf("warming cache failed: %v", err)
+	}
+	benchmarkColdStart(b)
+}
+
+func benchmarkColdStart(b *testing.B) {
+	defer resetModules()
+	for i := 0; i < b.N; i++ {
+		resetModules()
+		m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+		if err != nil {
+			b.Fatalf("NewWasmMatcher failed: %v", err)
+		}
+		m.Close()
+	}
+}
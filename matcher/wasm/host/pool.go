@@ -0,0 +1,196 @@
+package wasmvs
+
+import (
+	"fmt"
+	"runtime"
+	"sync/atomic"
+
+	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
+)
+
+// WasmMatcherPool spreads matching across several WASM matcher instances.
+//
+// A single WasmMatcher serializes every caller on one store and mutex.
+// The pool compiles the module once and shares its Engine/Module across
+// instances, each with its own store, linear memory and hs_scratch_t,
+// so concurrent callers scan in parallel.
+type WasmMatcherPool struct {
+	module   *wasmModule
+	matchers []*WasmMatcher
+	next     atomic.Uint32
+}
+
+// NewWasmMatcherPool creates a pool of size instances matching patterns.
+// A size <= 0 uses runtime.GOMAXPROCS(0), i.e. one instance per P.
+// Patterns are compiled once; the remaining instances load the serialized database.
+func NewWasmMatcherPool(patterns []string, size int) (*WasmMatcherPool, error) {
+	if len(patterns) == 0 {
+		return nil, fmt.Errorf("no patterns provided")
+	}
+	if size <= 0 {
+		size = runtime.GOMAXPROCS(0)
+	}
+
+	wm, err := sharedModule(VariantAuto)
+	if err != nil {
+		return nil, err
+	}
+	p := &WasmMatcherPool{module: wm}
+
+	// First instance compiles the patterns
+	first, err := wm.instantiate()
+	if err != nil {
+		return nil, err
+	}
+	first.patterns = patterns
+	if err := first.initPatterns(patterns); err != nil {
+		first.Close()
+		return nil, fmt.Errorf("failed to initialize patterns: %w", err)
+	}
+	p.matchers = append(p.matchers, first)
+
+	db, err := first.Serialize()
+	if err != nil {
+		p.Close()
+		return nil, err
+	}
+
+	// Remaining instances skip compilation
+	for i := 1; i < size; i++ {
+		m, err := wm.instantiate()
+		if err != nil {
+			p.Close()
+			return nil, err
+		}
+		if err := m.loadSerialized(db); err != nil {
+			m.Close()
+			p.Close()
+			return nil, fmt.Errorf("instance %d: failed to load database: %w", i, err)
+		}
+		m.patterns = patterns
+		p.matchers = append(p.matchers, m)
+	}
+
+	return p, nil
+}
+
+// acquire returns a locked instance; the caller must unlock m.mu.
+// Instances are tried without blocking from a rotating start position,
+// so uncontended checkout is one atomic add and one uncontended TryLock.
+func (p *WasmMatcherPool) acquire() *WasmMatcher {
+	n := uint32(len(p.matchers))
+	start := p.next.Add(1)
+	for i := uint32(0); i < n; i++ {
+		m := p.matchers[(start+i)%n]
+		if m.mu.TryLock() {
+			return m
+		}
+	}
+
+	// Every instance is busy - wait on our slot
+	m := p.matchers[start%n]
+	m.mu.Lock()
+	return m
+}
+
+// Reload compiles patterns once off the hot path and swaps them into every
+// instance in turn (see WasmMatcher.Reload). Each instance is only locked
+// for the load and swap, so the rest of the pool keeps serving.
+func (p *WasmMatcherPool) Reload(patterns []string) error {
+	db, err := p.module.compileSerialized(patterns)
+	if err != nil {
+		return err
+	}
+
+	for i, m := range p.matchers {
+		m.mu.Lock()
+		err := m.swapLocked(db, patterns)
+		m.mu.Unlock()
+		if err != nil {
+			return fmt.Errorf("instance %d: %w", i, err)
+		}
+	}
+	return nil
+}
+
+// SetPriority sets the first-match policy on every instance (see WasmMatcher.SetPriority).
+func (p *WasmMatcherPool) SetPriority(cutoff int) error {
+	for _, m := range p.matchers {
+		if err := m.SetPriority(cutoff); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// Match returns the index of the first matching pattern, or -1 if no match.
+func (p *WasmMatcherPool) Match(input string) int {
+	m := p.acquire()
+	defer m.mu.Unlock()
+	return m.matchLocked(m.handle, input)
+}
+
+// MatchBytes is Match for a byte slice (see WasmMatcher.MatchBytes).
+func (p *WasmMatcherPool) MatchBytes(input []byte) int {
+	m := p.acquire()
+	defer m.mu.Unlock()
+	return m.matchBytesLocked(m.handle, input)
+}
+
+// MatchBatch returns the first matching pattern index for each input.
+// The whole batch runs on one instance.
+func (p *WasmMatcherPool) MatchBatch(inputs []string) []int {
+	if len(inputs) == 0 {
+		return []int{}
+	}
+	m := p.acquire()
+	defer m.mu.Unlock()
+	return m.matchBatchLocked(m.handle, inputs)
+}
+
+// MatchFields scans a multi-field record on one instance (see WasmMatcher.MatchFields).
+func (p *WasmMatcherPool) MatchFields(fields [][]byte) int {
+	m := p.acquire()
+	defer m.mu.Unlock()
+	return m.matchFieldsLocked(fields)
+}
+
+// MatchAll returns indices of all matching patterns.
+func (p *WasmMatcherPool) MatchAll(input string) []int {
+	var set gomatcher.Bitset
+	if p.MatchAllInto(input, &set) <= 0 {
+		return nil
+	}
+	return set.AppendTo(nil)
+}
+
+// MatchAllInto records every matching pattern in dst on one instance
+// (see WasmMatcher.MatchAllInto).
+func (p *WasmMatcherPool) MatchAllInto(input string, dst *gomatcher.Bitset) int {
+	m := p.acquire()
+	defer m.mu.Unlock()
+	return m.matchAllLocked(m.handle, m.count, input, dst)
+}
+
+// PatternCount returns the number of patterns.
+func (p *WasmMatcherPool) PatternCount() int {
+	if len(p.matchers) == 0 {
+		return 0
+	}
+	return p.matchers[0].PatternCount()
+}
+
+// Size returns the number of instances in the pool.
+func (p *WasmMatcherPool) Size() int {
+	return len(p.matchers)
+}
+
+// Close releases all instances.
+func (p *WasmMatcherPool) Close() {
+	for _, m := range p.matchers {
+		m.mu.Lock()
+		m.Close()
+		m.mu.Unlock()
+	}
+	p.matchers = nil
+}
@@ -0,0 +1,103 @@
+package wasmvs
+
+import (
+	"sync"
+	"testing"
+
+	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+)
+
+// Both WASM backends plug into the common Matcher interface
+var (
+	_ gomatcher.Matcher = (*WasmMatcher)(nil)
+	_ gomatcher.Matcher = (*WasmMatcherPool)(nil)
+)
+
+func TestWasmMatcherPool_Concurrent(t *testing.T) {
+	single, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer single.Close()
+
+	pool, err := NewWasmMatcherPool(testdata.SimpleMalwarePatterns, 4)
+	if err != nil {
+		t.Fatalf("NewWasmMatcherPool failed: %v", err)
+	}
+	defer pool.Close()
+
+	if pool.Size() != 4 {
+		t.Errorf("Size() = %d, want 4", pool.Size())
+	}
+	if pool.PatternCount() != single.PatternCount() {
+		t.Errorf("PatternCount() = %d, want %d", pool.PatternCount(), single.PatternCount())
+	}
+
+	want := make([]int, len(testdata.TestFilenames))
+	for i, f := range testdata.TestFilenames {
+		want[i] = single.Match(f)
+	}
+
+	// More goroutines than instances so checkout has to wait
+	var wg sync.WaitGroup
+	for g := 0; g < 16; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i, f := range testdata.TestFilenames {
+				if got := pool.Match(f); got != want[i] {
+					t.Errorf("pool.Match(%q) = %d, want %d", f, got, want[i])
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+}
+
+func TestWasmMatcherPool_DefaultSize(t *testing.T) {
+	pool, err := NewWasmMatcherPool([]string{"abc"}, 0)
+	if err != nil {
+		t.Fatalf("NewWasmMatcherPool failed: %v", err)
+	}
+	defer pool.Close()
+
+	if pool.Size() < 1 {
+		t.Errorf("Size() = %d, want >= 1", pool.Size())
+	}
+}
+
+// Parallel throughput: one shared instance vs one instance per P
+func BenchmarkWasmMatcher_Parallel(b *testing.B) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	benchmarkParallelMatch(b, m)
+}
+
+func BenchmarkWasmMatcherPool_Parallel(b *testing.B) {
+	pool, err := NewWasmMatcherPool(testdata.SimpleMalwarePatterns, 0)
+	if err != nil {
+		b.Fatalf("NewWasmMatcherPool failed: %v", err)
+	}
+	defer pool.Close()
+
+	benchmarkParallelMatch(b, pool)
+}
+
+func benchmarkParallelMatch(b *testing.B, m gomatcher.Matcher) {
+	files := testdata.TestFilenames
+
+	b.ResetTimer()
+	b.RunParallel(func(pb *testing.PB) {
+		i := 0
+		for pb.Next() {
+			m.Match(files[i%len(files)])
+			i++
+		}
+	})
+}
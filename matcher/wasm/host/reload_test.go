@@ -0,0 +1,112 @@
+package wasmvs
+
+import (
+	"sync"
+	"testing"
+)
+
+var (
+	reloadSetA = []string{"alpha", "beta"}
+	reloadSetB = []string{"gamma", "alpha"}
+)
+
+func TestWasmMatcher_Reload(t *testing.T) {
+	m, err := NewWasmMatcher(reloadSetA)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	extra, err := m.NewRuleset([]string{"delta"})
+	if err != nil {
+		t.Fatalf("NewRuleset failed: %v", err)
+	}
+	defer extra.Close()
+
+	for i, set := range [][]string{reloadSetB, reloadSetA, reloadSetB} {
+		if err := m.Reload(set); err != nil {
+			t.Fatalf("reload %d failed: %v", i, err)
+		}
+		want := 0
+		if i%2 == 0 {
+			want = 1
+		}
+		if got := m.Match("alpha"); got != want {
+			t.Errorf("reload %d: Match(alpha) = %d, want %d", i, got, want)
+		}
+		if got := m.PatternCount(); got != len(set) {
+			t.Errorf("reload %d: PatternCount = %d, want %d", i, got, len(set))
+		}
+	}
+
+	// Other rulesets on the instance are untouched
+	if got := extra.Match("delta"); got != 0 {
+		t.Errorf("extra.Match(delta) = %d, want 0", got)
+	}
+
+	// Derived databases follow the reload
+	if got := m.MatchFields([][]byte{[]byte("gam"), []byte("ma")}); got != 0 {
+		t.Errorf("MatchFields(gam|ma) = %d, want 0", got)
+	}
+
+	if err := m.Reload(nil); err == nil {
+		t.Error("Reload(nil) succeeded, want error")
+	}
+}
+
+// Readers of the pattern count race with Reload (run with -race)
+func TestWasmMatcher_ReloadConcurrentCount(t *testing.T) {
+	m, err := NewWasmMatcher(reloadSetA)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	larger := []string{"gamma", "alpha", "delta"}
+	var wg sync.WaitGroup
+	stop := make(chan struct{})
+	wg.Add(1)
+	go func() {
+		defer wg.Done()
+		for {
+			select {
+			case <-stop:
+				return
+			default:
+			}
+			if n := m.PatternCount(); n != len(reloadSetA) && n != len(larger) {
+				t.Errorf("PatternCount = %d during reload", n)
+				return
+			}
+		}
+	}()
+	for i := 0; i < 20; i++ {
+		set := reloadSetA
+		if i%2 == 0 {
+			set = larger
+		}
+		if err := m.Reload(set); err != nil {
+			t.Errorf("reload %d failed: %v", i, err)
+			break
+		}
+	}
+	close(stop)
+	wg.Wait()
+}
+
+func TestWasmMatcherPool_Reload(t *testing.T) {
+	pool, err := NewWasmMatcherPool(reloadSetA, 3)
+	if err != nil {
+		t.Fatalf("NewWasmMatcherPool failed: %v", err)
+	}
+	defer pool.Close()
+
+	if err := pool.Reload(reloadSetB); err != nil {
+		t.Fatalf("Reload failed: %v", err)
+	}
+	for i := 0; i < 2*pool.Size(); i++ {
+		if got := pool.Match("alpha"); got != 1 {
+			t.Errorf("pool.Match(alpha) = %d, want 1", got)
+		}
+	}
+}
@@ -0,0 +1,138 @@
+package wasmvs
+
+import (
+	"fmt"
+	"strings"
+
+	"github.com/bytecodealliance/wasmtime-go/v39"
+
+	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
+)
+
+// Ruleset is an extra pattern set compiled into an existing WasmMatcher's
+// module instance, e.g. one per tenant. All rulesets of a matcher share its
+// linear memory, input arena and scratch, so each costs roughly the size of
+// its database instead of a whole module instance.
+//
+// Calls are serialized on the parent matcher's mutex, and SetPriority on the
+// parent applies to every ruleset.
+type Ruleset struct {
+	m      *WasmMatcher
+	handle int32
+	count  int
+}
+
+// NewRuleset compiles patterns into a new ruleset on m.
+func (m *WasmMatcher) NewRuleset(patterns []string) (*Ruleset, error) {
+	if len(patterns) == 0 {
+		return nil, fmt.Errorf("no patterns provided")
+	}
+
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	data := strings.Join(patterns, "\n")
+	if err := m.ensureInput(len(data)); err != nil {
+		return nil, err
+	}
+	copy(m.data()[m.inputPtr:], data)
+
+	return m.createRulesetLocked(m.create, "matcher_create", len(data))
+}
+
+// NewRulesetFromDB creates a ruleset on m from a blob produced by Serialize.
+func (m *WasmMatcher) NewRulesetFromDB(db []byte) (*Ruleset, error) {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	if err := m.ensureInput(len(db)); err != nil {
+		return nil, err
+	}
+	copy(m.data()[m.inputPtr:], db)
+
+	return m.createRulesetLocked(m.createDB, "matcher_create_serialized", len(db))
+}
+
+// createRulesetLocked calls a create export on the n bytes in the arena;
+// the caller must hold m.mu.
+func (m *WasmMatcher) createRulesetLocked(create *wasmtime.Func, name string, n int) (*Ruleset, error) {
+	result, err := create.Call(m.store, m.inputPtr, int32(n))
+	if err != nil {
+		return nil, fmt.Errorf("%s failed: %w", name, err)
+	}
+	handle := result.(int32)
+	if handle < 0 {
+		return nil, fmt.Errorf("%s returned error code: %d (%s)", name, handle, m.GetError())
+	}
+
+	count, err := m.patternCountLocked(handle)
+	if err != nil {
+		return nil, err
+	}
+	return &Ruleset{m: m, handle: handle, count: count}, nil
+}
+
+// Match returns the index of the first matching pattern, or -1 if no match.
+func (r *Ruleset) Match(input string) int {
+	r.m.mu.Lock()
+	defer r.m.mu.Unlock()
+	return r.m.matchLocked(r.handle, input)
+}
+
+// MatchBytes is Match for a byte slice.
+func (r *Ruleset) MatchBytes(input []byte) int {
+	r.m.mu.Lock()
+	defer r.m.mu.Unlock()
+	return r.m.matchBytesLocked(r.handle, input)
+}
+
+// MatchBatch returns the first matching pattern index for each input.
+func (r *Ruleset) MatchBatch(inputs []string) []int {
+	if len(inputs) == 0 {
+		return []int{}
+	}
+	r.m.mu.Lock()
+	defer r.m.mu.Unlock()
+	return r.m.matchBatchLocked(r.handle, inputs)
+}
+
+// MatchAll returns indices of all matching patterns.
+func (r *Ruleset) MatchAll(input string) []int {
+	var set gomatcher.Bitset
+	if r.MatchAllInto(input, &set) <= 0 {
+		return nil
+	}
+	return set.AppendTo(nil)
+}
+
+// MatchAllInto records every matching pattern in dst (see WasmMatcher.MatchAllInto).
+func (r *Ruleset) MatchAllInto(input string, dst *gomatcher.Bitset) int {
+	r.m.mu.Lock()
+	defer r.m.mu.Unlock()
+	return r.m.matchAllLocked(r.handle, r.count, input, dst)
+}
+
+// Serialize returns the ruleset's database in a form NewRulesetFromDB
+// and NewWasmMatcherFromDB can load.
+func (r *Ruleset) Serialize() ([]byte, error) {
+	r.m.mu.Lock()
+	defer r.m.mu.Unlock()
+	return r.m.serializeLocked(r.handle)
+}
+
+// PatternCount returns the number of patterns.
+func (r *Ruleset) PatternCount() int {
+	return r.count
+}
+
+// Close frees the ruleset's database and shrinks the shared scratch to fit
+// the databases that remain.
+func (r *Ruleset) Close() {
+	r.m.mu.Lock()
+	defer r.m.mu.Unlock()
+
+	if r.handle >= 0 {
+		r.m.destroy.Call(r.m.store, r.handle)
+	}
+	r.handle = -1
+}
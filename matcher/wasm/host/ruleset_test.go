@@ -0,0 +1,111 @@
+package wasmvs
+
+import (
+	"testing"
+
+	gomatcher "github.com/paulstuart/cgo-ffi/matcher/go"
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+)
+
+var _ gomatcher.Matcher = (*Ruleset)(nil)
+
+func TestWasmMatcher_Rulesets(t *testing.T) {
+	m, err := NewWasmMatcher([]string{"hello", "world"})
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	// Several tenants on one instance, each with its own ID space
+	tenantA, err := m.NewRuleset([]string{"foo", "bar"})
+	if err != nil {
+		t.Fatalf("NewRuleset failed: %v", err)
+	}
+	tenantB, err := m.NewRuleset(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewRuleset failed: %v", err)
+	}
+
+	tests := []struct {
+		m     gomatcher.Matcher
+		input string
+		want  int
+	}{
+		{m, "say world", 1},
+		{m, "bar", -1},
+		{tenantA, "bar", 1},
+		{tenantA, "hello", -1},
+		{tenantB, "/tmp/mimikatz.exe", tenantBMatch(t, "/tmp/mimikatz.exe")},
+	}
+	for _, tt := range tests {
+		if got := tt.m.Match(tt.input); got != tt.want {
+			t.Errorf("Match(%q) = %d, want %d", tt.input, got, tt.want)
+		}
+	}
+	if tenantA.PatternCount() != 2 || tenantB.PatternCount() != len(testdata.SimpleMalwarePatterns) {
+		t.Errorf("PatternCount = %d/%d", tenantA.PatternCount(), tenantB.PatternCount())
+	}
+
+	// Round-trip a ruleset and destroy the original
+	db, err := tenantA.Serialize()
+	if err != nil {
+		t.Fatalf("Serialize failed: %v", err)
+	}
+	tenantA.Close()
+	if got := tenantA.Match("bar"); got != -1 {
+		t.Errorf("Match after Close = %d, want -1", got)
+	}
+
+	// The freed slot is reused
+	loaded, err := m.NewRulesetFromDB(db)
+	if err != nil {
+		t.Fatalf("NewRulesetFromDB failed: %v", err)
+	}
+	defer loaded.Close()
+	if got := loaded.Match("foo"); got != 0 {
+		t.Errorf("loaded.Match(foo) = %d, want 0", got)
+	}
+	if got := m.Match("hello"); got != 0 {
+		t.Errorf("default ruleset Match(hello) = %d, want 0", got)
+	}
+}
+
+// tenantBMatch computes the expected result for SimpleMalwarePatterns on a
+// separate matcher, so the test exercises isolation rather than pattern order.
+func tenantBMatch(t *testing.T, input string) int {
+	t.Helper()
+	ref, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer ref.Close()
+	return ref.Match(input)
+}
+
+// Memory cost of one instance per ruleset vs rulesets sharing an instance
+func BenchmarkWasmMatcher_NewRuleset(b *testing.B) {
+	m, err := NewWasmMatcher([]string{"seed"})
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		r, err := m.NewRuleset(testdata.SimpleMalwarePatterns)
+		if err != nil {
+			b.Fatalf("NewRuleset failed: %v", err)
+		}
+		r.Close()
+	}
+}
+
+func BenchmarkWasmMatcher_NewInstance(b *testing.B) {
+	for i := 0; i < b.N; i++ {
+		m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+		if err != nil {
+			b.Fatalf("NewWasmMatcher failed: %v", err)
+		}
+		m.Close()
+	}
+}
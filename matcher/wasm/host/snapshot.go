@@ -0,0 +1,367 @@
+package wasmvs
+
+import (
+	"fmt"
+	"strings"
+
+	"github.com/bytecodealliance/wasmtime-go/v39"
+)
+
+// Snapshots, in the style of Wizer: run matcher_init once at build time and
+// bake the resulting instance state into a new module. The snapshot's data
+// segments hold the whole initialized linear memory - compiled database,
+// scratch, input arena, allocator state - and its globals start at the
+// values they had after init, so an instance of it is ready to scan as soon
+// as it exists. Neither _initialize nor matcher_init runs again.
+//
+// Instantiation then costs little more than mapping memory: wasmtime builds
+// a copy-on-write image from the data segments once per module, and each new
+// instance maps it instead of copying. That makes per-request matchers
+// practical, especially with the serialized-module cache (SetModuleCacheDir)
+// skipping compilation of the snapshot itself.
+
+// snapshotSection names the custom section recording what a snapshot holds.
+const snapshotSection = "wasmvs-snapshot"
+
+// snapshotGlobalPrefix names the exports added so the host can read
+// globals the module keeps private, such as the stack pointer.
+const snapshotGlobalPrefix = "__wasmvs_snapshot_global_"
+
+// snapshotDataGap is the longest run of zero bytes kept inside one data
+// segment; longer runs split the segment, since zeroed pages are free.
+const snapshotDataGap = 64
+
+// maxSnapshotSegments stays well under wasmtime's limit on data segments.
+const maxSnapshotSegments = 10000
+
+// Snapshot compiles patterns inside an instance of the v module and returns
+// a .wasm module pre-initialized with the result. Load it with LoadSnapshot
+// or NewWasmMatcherFromSnapshot. Snapshots are tied to the variant they were
+// taken from: a SIMD snapshot needs a SIMD-capable engine.
+func Snapshot(patterns []string, v Variant) ([]byte, error) {
+	if len(patterns) == 0 {
+		return nil, fmt.Errorf("no patterns provided")
+	}
+	// Patterns travel newline-separated and compile_patterns skips empty
+	// lines, either of which would shift the snapshot's pattern IDs
+	for i, p := range patterns {
+		if p == "" {
+			return nil, fmt.Errorf("pattern %d is empty", i)
+		}
+		if strings.Contains(p, "\n") {
+			return nil, fmt.Errorf("pattern %d contains a newline", i)
+		}
+	}
+
+	variant, code, err := v.resolve()
+	if err != nil {
+		return nil, err
+	}
+	secs, err := parseSections(code)
+	if err != nil {
+		return nil, err
+	}
+	globals, err := definedGlobals(secs)
+	if err != nil {
+		return nil, err
+	}
+
+	// Instrument a copy that exports every global, then initialize it
+	instrumented, err := exportGlobals(secs, globals)
+	if err != nil {
+		return nil, err
+	}
+	engine := newEngine()
+	module, err := wasmtime.NewModule(engine, encodeSections(instrumented))
+	if err != nil {
+		return nil, fmt.Errorf("failed to compile instrumented module: %w", err)
+	}
+	m, err := (&wasmModule{engine: engine, module: module, variant: variant}).instantiate()
+	if err != nil {
+		return nil, err
+	}
+	defer m.Close()
+	if err := m.initPatterns(patterns); err != nil {
+		return nil, fmt.Errorf("failed to initialize patterns: %w", err)
+	}
+	if m.count != len(patterns) {
+		return nil, fmt.Errorf("compiled %d patterns from %d", m.count, len(patterns))
+	}
+
+	for i := range globals {
+		g := &globals[i]
+		if !g.mutable {
+			continue
+		}
+		ext := m.instance.GetExport(m.store, fmt.Sprintf("%s%d", snapshotGlobalPrefix, g.index))
+		if ext == nil || ext.Global() == nil {
+			return nil, fmt.Errorf("global %d not exported by instrumented module", g.index)
+		}
+		val := ext.Global().Get(m.store)
+		switch g.valType {
+		case valI32:
+			g.init = constValue(valI32, uint64(uint32(val.I32())))
+		case valI64:
+			g.init = constValue(valI64, uint64(val.I64()))
+		case valF32:
+			g.init = constValue(valF32, f32Bits(val.F32()))
+		case valF64:
+			g.init = constValue(valF64, f64Bits(val.F64()))
+		default:
+			return nil, fmt.Errorf("global %d: cannot snapshot mutable v128", g.index)
+		}
+	}
+
+	meta := append([]byte{byte(variant)}, strings.Join(patterns, "\n")...)
+	return writeSnapshot(secs, globals, m.data(), m.memory.Size(m.store), meta)
+}
+
+// definedGlobals returns the module's own globals, rejecting what a
+// snapshot cannot reproduce: imported memories and passive data segments.
+func definedGlobals(secs []wasmSection) ([]wasmGlobal, error) {
+	var importedGlobals uint32
+	var globals []wasmGlobal
+	for _, s := range secs {
+		switch s.id {
+		case secImport:
+			g, mems, err := importCounts(s.data)
+			if err != nil {
+				return nil, err
+			}
+			if mems > 0 {
+				return nil, fmt.Errorf("cannot snapshot a module that imports its memory")
+			}
+			importedGlobals = g
+		case secGlobal:
+			var err error
+			if globals, err = parseGlobals(s.data, importedGlobals); err != nil {
+				return nil, err
+			}
+		case secData:
+			passive, err := hasPassiveData(s.data)
+			if err != nil {
+				return nil, err
+			}
+			if passive {
+				return nil, fmt.Errorf("cannot snapshot a module with passive data segments")
+			}
+		}
+	}
+	return globals, nil
+}
+
+// exportGlobals returns secs with an export added for every mutable global.
+func exportGlobals(secs []wasmSection, globals []wasmGlobal) ([]wasmSection, error) {
+	out := make([]wasmSection, len(secs))
+	copy(out, secs)
+	for i, s := range out {
+		if s.id != secExport {
+			continue
+		}
+		exports, err := parseExports(s.data)
+		if err != nil {
+			return nil, err
+		}
+		for _, g := range globals {
+			if g.mutable {
+				name := fmt.Sprintf("%s%d", snapshotGlobalPrefix, g.index)
+				exports = append(exports, wasmExport{name: name, kind: externGlobal, index: g.index})
+			}
+		}
+		out[i].data = encodeExports(exports)
+	}
+	return out, nil
+}
+
+// writeSnapshot re-encodes secs with mem as the only data, memory sized to
+// pages, globals at their snapshot values, no start function and no
+// _initialize export, plus the metadata section.
+func writeSnapshot(secs []wasmSection, globals []wasmGlobal, mem []byte, pages uint64, meta []byte) ([]byte, error) {
+	segments := memorySegments(mem)
+	var out []wasmSection
+	for _, s := range secs {
+		switch s.id {
+		case secStart:
+			continue
+		case secMemory:
+			data, err := resizeMemory(s.data, pages)
+			if err != nil {
+				return nil, err
+			}
+			s.data = data
+		case secGlobal:
+			s.data = encodeGlobals(globals)
+		case secExport:
+			exports, err := parseExports(s.data)
+			if err != nil {
+				return nil, err
+			}
+			kept := exports[:0]
+			for _, e := range exports {
+				if e.name != "_initialize" {
+					kept = append(kept, e)
+				}
+			}
+			s.data = encodeExports(kept)
+		case secDataCount:
+			s.data = appendU32(nil, uint32(len(segments)))
+		case secData:
+			s.data = encodeDataSegments(mem, segments)
+		}
+		out = append(out, s)
+	}
+
+	// A module without data would have had no data section to replace
+	hasData := false
+	for _, s := range out {
+		hasData = hasData || s.id == secData
+	}
+	if !hasData {
+		return nil, fmt.Errorf("module has no data section")
+	}
+
+	custom := appendName(nil, snapshotSection)
+	out = append(out, wasmSection{id: secCustom, data: append(custom, meta...)})
+	return encodeSections(out), nil
+}
+
+// memorySegments returns [start, end) ranges covering the non-zero bytes of
+// mem, merging ranges separated by short zero runs.
+func memorySegments(mem []byte) [][2]int {
+	for gap := snapshotDataGap; ; gap *= 2 {
+		var segs [][2]int
+		for i := 0; i < len(mem); {
+			if mem[i] == 0 {
+				i++
+				continue
+			}
+			start, end := i, i+1
+			for j := end; j < len(mem) && j-end <= gap; j++ {
+				if mem[j] != 0 {
+					end = j + 1
+				}
+			}
+			segs = append(segs, [2]int{start, end})
+			i = end
+		}
+		if len(segs) <= maxSnapshotSegments {
+			return segs
+		}
+	}
+}
+
+func encodeDataSegments(mem []byte, segs [][2]int) []byte {
+	out := appendU32(nil, uint32(len(segs)))
+	for _, s := range segs {
+		out = append(out, 0) // active, memory 0
+		out = append(out, constValue(valI32, uint64(s[0]))...)
+		out = appendU32(out, uint32(s[1]-s[0]))
+		out = append(out, mem[s[0]:s[1]]...)
+	}
+	return out
+}
+
+// resizeMemory sets the minimum size of the only memory to pages.
+func resizeMemory(data []byte, pages uint64) ([]byte, error) {
+	r := &wasmReader{b: data}
+	if n := r.u32(); n != 1 {
+		return nil, fmt.Errorf("cannot snapshot a module with %d memories", n)
+	}
+	flags, _, max := r.limits()
+	if r.err != nil {
+		return nil, r.err
+	}
+	if flags&^1 != 0 {
+		return nil, fmt.Errorf("unsupported memory flags %#x", flags)
+	}
+	out := append(appendU32(nil, 1), flags)
+	out = appendU32(out, uint32(pages))
+	if flags&1 != 0 {
+		out = appendU32(out, uint32(max))
+	}
+	return out, nil
+}
+
+// snapshotMeta reads the metadata section written by Snapshot.
+func snapshotMeta(snapshot []byte) (Variant, []string, error) {
+	secs, err := parseSections(snapshot)
+	if err != nil {
+		return 0, nil, err
+	}
+	for _, s := range secs {
+		if s.id != secCustom {
+			continue
+		}
+		r := &wasmReader{b: s.data}
+		if r.name() != snapshotSection || r.err != nil {
+			continue
+		}
+		meta := s.data[r.off:]
+		if len(meta) < 2 {
+			break
+		}
+		return Variant(meta[0]), strings.Split(string(meta[1:]), "\n"), nil
+	}
+	return 0, nil, fmt.Errorf("not a matcher snapshot: no %s section", snapshotSection)
+}
+
+// SnapshotModule is a compiled snapshot. Each NewMatcher call creates an
+// independent, ready-to-scan matcher without compiling anything.
+type SnapshotModule struct {
+	module   *wasmModule
+	patterns []string
+}
+
+// LoadSnapshot compiles a module produced by Snapshot, through the on-disk
+// module cache when one is set.
+func LoadSnapshot(snapshot []byte) (*SnapshotModule, error) {
+	variant, patterns, err := snapshotMeta(snapshot)
+	if err != nil {
+		return nil, err
+	}
+
+	engine := newEngine()
+	modulesMu.Lock()
+	module, err := newModule(engine, snapshot)
+	modulesMu.Unlock()
+	if err != nil {
+		return nil, fmt.Errorf("failed to compile snapshot (%s): %w", variant, err)
+	}
+	return &SnapshotModule{
+		module:   &wasmModule{engine: engine, module: module, variant: variant},
+		patterns: patterns,
+	}, nil
+}
+
+// NewMatcher instantiates the snapshot.
+func (s *SnapshotModule) NewMatcher() (*WasmMatcher, error) {
+	m, err := s.module.instantiate()
+	if err != nil {
+		return nil, err
+	}
+	m.patterns = s.patterns
+	if err := m.cacheCount(); err != nil {
+		m.Close()
+		return nil, err
+	}
+	if m.count != len(s.patterns) {
+		m.Close()
+		return nil, fmt.Errorf("snapshot holds %d patterns, metadata lists %d", m.count, len(s.patterns))
+	}
+	return m, nil
+}
+
+// PatternCount returns the number of patterns in the snapshot.
+func (s *SnapshotModule) PatternCount() int {
+	return len(s.patterns)
+}
+
+// NewWasmMatcherFromSnapshot loads and instantiates a snapshot in one step.
+// Use LoadSnapshot to create many matchers from one snapshot.
+func NewWasmMatcherFromSnapshot(snapshot []byte) (*WasmMatcher, error) {
+	s, err := LoadSnapshot(snapshot)
+	if err != nil {
+		return nil, err
+	}
+	return s.NewMatcher()
+}
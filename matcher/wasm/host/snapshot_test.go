@@ -0,0 +1,152 @@
+package wasmvs
+
+import (
+	"bytes"
+	"testing"
+
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+)
+
+func TestWasmSections_RoundTrip(t *testing.T) {
+	secs, err := parseSections(simdProbe)
+	if err != nil {
+		t.Fatalf("parseSections failed: %v", err)
+	}
+	if len(secs) != 3 {
+		t.Fatalf("got %d sections, want 3", len(secs))
+	}
+	if out := encodeSections(secs); !bytes.Equal(out, simdProbe) {
+		t.Errorf("encodeSections = %x, want %x", out, simdProbe)
+	}
+	if _, err := parseSections([]byte("not wasm")); err == nil {
+		t.Error("expected error for a non-module")
+	}
+}
+
+func TestWasmLEB(t *testing.T) {
+	for _, v := range []int64{0, 1, -1, 63, 64, -64, -65, 1 << 20, -(1 << 31), 1<<31 - 1} {
+		r := &wasmReader{b: appendS64(nil, v)}
+		if got := int64(r.leb(64, true)); got != v || r.err != nil {
+			t.Errorf("signed LEB of %d decoded as %d (%v)", v, got, r.err)
+		}
+	}
+	for _, v := range []uint32{0, 127, 128, 1 << 28, 1<<32 - 1} {
+		r := &wasmReader{b: appendU32(nil, v)}
+		if got := r.u32(); got != v || r.err != nil {
+			t.Errorf("LEB of %d decoded as %d (%v)", v, got, r.err)
+		}
+	}
+}
+
+func TestMemorySegments(t *testing.T) {
+	mem := make([]byte, 4096)
+	mem[10] = 1
+	mem[20] = 2                   // within the gap: same segment
+	mem[20+snapshotDataGap+2] = 3 // past it: new segment
+	mem[4095] = 4
+
+	segs := memorySegments(mem)
+	want := [][2]int{{10, 21}, {22 + snapshotDataGap, 23 + snapshotDataGap}, {4095, 4096}}
+	if len(segs) != len(want) {
+		t.Fatalf("segments = %v, want %v", segs, want)
+	}
+	for i := range want {
+		if segs[i] != want[i] {
+			t.Errorf("segment %d = %v, want %v", i, segs[i], want[i])
+		}
+	}
+}
+
+func TestSnapshot(t *testing.T) {
+	snap, err := Snapshot(testdata.SimpleMalwarePatterns, VariantAuto)
+	if err != nil {
+		t.Fatalf("Snapshot failed: %v", err)
+	}
+
+	ref, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer ref.Close()
+
+	s, err := LoadSnapshot(snap)
+	if err != nil {
+		t.Fatalf("LoadSnapshot failed: %v", err)
+	}
+	if s.PatternCount() != len(testdata.SimpleMalwarePatterns) {
+		t.Errorf("PatternCount() = %d, want %d", s.PatternCount(), len(testdata.SimpleMalwarePatterns))
+	}
+
+	// Instances are independent: matching on one leaves the other untouched
+	a, err := s.NewMatcher()
+	if err != nil {
+		t.Fatalf("NewMatcher failed: %v", err)
+	}
+	defer a.Close()
+	b, err := s.NewMatcher()
+	if err != nil {
+		t.Fatalf("NewMatcher failed: %v", err)
+	}
+	defer b.Close()
+
+	for _, f := range testdata.TestFilenames {
+		want := ref.Match(f)
+		if got := a.Match(f); got != want {
+			t.Errorf("snapshot Match(%q) = %d, want %d", f, got, want)
+		}
+	}
+	if a.Variant() != ref.Variant() {
+		t.Errorf("snapshot variant %s, want %s", a.Variant(), ref.Variant())
+	}
+	if got, want := b.Match("/tmp/mimikatz.exe"), ref.Match("/tmp/mimikatz.exe"); got != want {
+		t.Errorf("second instance Match = %d, want %d", got, want)
+	}
+
+	// A snapshot matcher still reloads like any other
+	if err := b.Reload([]string{`\.xyz$`}); err != nil {
+		t.Fatalf("Reload failed: %v", err)
+	}
+	if got := b.Match("file.xyz"); got != 0 {
+		t.Errorf("Match after Reload = %d, want 0", got)
+	}
+
+	if _, err := LoadSnapshot(wasmBytes); err == nil {
+		t.Error("expected LoadSnapshot error for a plain module")
+	}
+	for _, bad := range [][]string{{"a", ""}, {"a\nb"}} {
+		if _, err := Snapshot(bad, VariantAuto); err == nil {
+			t.Errorf("Snapshot(%q) succeeded, want error", bad)
+		}
+	}
+}
+
+// Creating a ready matcher: compiling patterns vs instantiating a snapshot
+func BenchmarkNewWasmMatcher_Patterns(b *testing.B) {
+	for i := 0; i < b.N; i++ {
+		m, err := NewWasmMatcher(testdata.MalwarePatterns)
+		if err != nil {
+			b.Fatalf("NewWasmMatcher failed: %v", err)
+		}
+		m.Close()
+	}
+}
+
+func BenchmarkNewWasmMatcher_Snapshot(b *testing.B) {
+	snap, err := Snapshot(testdata.MalwarePatterns, VariantAuto)
+	if err != nil {
+		b.Fatalf("Snapshot failed: %v", err)
+	}
+	s, err := LoadSnapshot(snap)
+	if err != nil {
+		b.Fatalf("LoadSnapshot failed: %v", err)
+	}
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m, err := s.NewMatcher()
+		if err != nil {
+			b.Fatalf("NewMatcher failed: %v", err)
+		}
+		m.Close()
+	}
+}
@@ -0,0 +1,111 @@
+package wasmvs
+
+import "fmt"
+
+// MatchStream scans input that arrives in chunks, such as a request body read
+// off a socket. Matches may span chunk boundaries. It implements io.WriteCloser:
+// write chunks as they arrive, Close, then read Result.
+//
+// Each chunk is copied through the module's input arena in arena-sized pieces,
+// so memory stays constant regardless of the total stream length.
+type MatchStream struct {
+	m      *WasmMatcher
+	done   bool
+	closed bool
+	result int
+}
+
+// NewStream opens a stream on the matcher. Only one stream can be open per
+// WasmMatcher at a time; Match and MatchBatch keep working while it is open.
+// The first call compiles a streaming database from the matcher's patterns,
+// so it is not available on matchers created with NewWasmMatcherFromDB.
+func (m *WasmMatcher) NewStream() (*MatchStream, error) {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	if m.streamActive {
+		return nil, fmt.Errorf("stream already open")
+	}
+	if !m.streamReady {
+		if err := m.compileModeLocked(m.initStream, "matcher_init_stream"); err != nil {
+			return nil, err
+		}
+		m.streamReady = true
+	}
+
+	result, err := m.streamOpen.Call(m.store)
+	if err != nil {
+		return nil, fmt.Errorf("matcher_stream_open failed: %w", err)
+	}
+	if retCode := result.(int32); retCode != 0 {
+		return nil, fmt.Errorf("matcher_stream_open returned error code: %d (%s)", retCode, m.GetError())
+	}
+
+	m.streamActive = true
+	return &MatchStream{m: m, result: -1}, nil
+}
+
+// Write scans the next chunk. Once the match is final (see SetPriority)
+// further chunks are accepted without scanning.
+func (s *MatchStream) Write(p []byte) (int, error) {
+	if s.closed {
+		return 0, fmt.Errorf("write to closed stream")
+	}
+	if s.done {
+		return len(p), nil
+	}
+
+	m := s.m
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	for off := 0; off < len(p); {
+		n := len(p) - off
+		if n > m.inputCap {
+			n = m.inputCap
+		}
+		copy(m.data()[m.inputPtr:], p[off:off+n])
+
+		result, err := m.streamWrite.Call(m.store, m.inputPtr, int32(n))
+		if err != nil {
+			return off, fmt.Errorf("matcher_stream_write failed: %w", err)
+		}
+		retCode := result.(int32)
+		if retCode < 0 {
+			return off, fmt.Errorf("matcher_stream_write returned error code: %d (%s)", retCode, m.GetError())
+		}
+		if retCode == 1 {
+			s.done = true
+			break
+		}
+		off += n
+	}
+
+	return len(p), nil
+}
+
+// Close ends the stream, picking up matches anchored at end of input.
+func (s *MatchStream) Close() error {
+	if s.closed {
+		return nil
+	}
+	s.closed = true
+
+	m := s.m
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	m.streamActive = false
+	result, err := m.streamClose.Call(m.store)
+	if err != nil {
+		return fmt.Errorf("matcher_stream_close failed: %w", err)
+	}
+	s.result = int(result.(int32))
+	return nil
+}
+
+// Result returns the index of the matching pattern, or -1 if no match.
+// It is only meaningful after Close.
+func (s *MatchStream) Result() int {
+	return s.result
+}
@@ -0,0 +1,104 @@
+package wasmvs
+
+import (
+	"io"
+	"strings"
+	"testing"
+
+	"github.com/paulstuart/cgo-ffi/matcher/testdata"
+)
+
+// Compile-time check that streams plug into io.Copy and friends
+var _ io.WriteCloser = (*MatchStream)(nil)
+
+func streamChunks(t testing.TB, m *WasmMatcher, input string, chunkSize int) int {
+	t.Helper()
+	s, err := m.NewStream()
+	if err != nil {
+		t.Fatalf("NewStream failed: %v", err)
+	}
+	for off := 0; off < len(input); off += chunkSize {
+		end := off + chunkSize
+		if end > len(input) {
+			end = len(input)
+		}
+		if _, err := s.Write([]byte(input[off:end])); err != nil {
+			t.Fatalf("Write failed: %v", err)
+		}
+	}
+	if err := s.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	return s.Result()
+}
+
+func TestWasmMatcher_Stream(t *testing.T) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	// Chunk sizes small enough that matches straddle write boundaries
+	for _, chunk := range []int{1, 3, 7, 64} {
+		for _, f := range testdata.TestFilenames {
+			if got, want := streamChunks(t, m, f, chunk), m.Match(f); got != want {
+				t.Errorf("chunk=%d: stream(%q) = %d, Match = %d", chunk, f, got, want)
+			}
+		}
+	}
+}
+
+func TestWasmMatcher_StreamLargePayload(t *testing.T) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		t.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	// Match buried at the end of a multi-megabyte body
+	body := strings.Repeat("x", 4<<20) + "/tmp/mimikatz.exe"
+	if got, want := streamChunks(t, m, body, 32*1024), m.Match(body); got != want || got < 0 {
+		t.Errorf("stream = %d, Match = %d, want equal and >= 0", got, want)
+	}
+
+	s, err := m.NewStream()
+	if err != nil {
+		t.Fatalf("NewStream failed: %v", err)
+	}
+	s.Close()
+	if _, err := s.Write([]byte("abc")); err == nil {
+		t.Error("Write after Close succeeded, want error")
+	}
+}
+
+// Streaming a 4MB body in 32KB chunks vs buffering it for one Match
+func BenchmarkWasmMatcher_Stream_4MB(b *testing.B) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	body := strings.Repeat("x", 4<<20)
+	b.SetBytes(int64(len(body)))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		streamChunks(b, m, body, 32*1024)
+	}
+}
+
+func BenchmarkWasmMatcher_Buffered_4MB(b *testing.B) {
+	m, err := NewWasmMatcher(testdata.SimpleMalwarePatterns)
+	if err != nil {
+		b.Fatalf("NewWasmMatcher failed: %v", err)
+	}
+	defer m.Close()
+
+	body := strings.Repeat("x", 4<<20)
+	b.SetBytes(int64(len(body)))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		m.Match(body)
+	}
+}
@@ -0,0 +1,93 @@
+package wasmvs
+
+import (
+	"fmt"
+	"sync"
+
+	"github.com/bytecodealliance/wasmtime-go/v39"
+)
+
+// Variant selects which embedded matcher module backs a WasmMatcher.
+type Variant int
+
+const (
+	// VariantAuto uses the SIMD128 module when the engine supports it and
+	// the scalar one otherwise (default).
+	VariantAuto Variant = iota
+
+	// VariantScalar uses matcher.wasm, built without -msimd128.
+	VariantScalar
+
+	// VariantSIMD uses matcher-simd.wasm, built with -msimd128.
+	VariantSIMD
+)
+
+func (v Variant) String() string {
+	switch v {
+	case VariantAuto:
+		return "auto"
+	case VariantScalar:
+		return "scalar"
+	case VariantSIMD:
+		return "simd"
+	}
+	return fmt.Sprintf("Variant(%d)", int(v))
+}
+
+// simdProbe is the smallest module using a SIMD128 instruction:
+// (module (func v128.const i64x2 0 0 drop))
+var simdProbe = []byte{
+	0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, // magic, version
+	0x01, 0x04, 0x01, 0x60, 0x00, 0x00, // type section: () -> ()
+	0x03, 0x02, 0x01, 0x00, // function section: func 0 has type 0
+	0x0a, 0x17, 0x01, 0x15, 0x00, // code section: one body, no locals
+	0xfd, 0x0c, // v128.const
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x1a, 0x0b, // drop, end
+}
+
+var (
+	simdOnce      sync.Once
+	simdSupported bool
+)
+
+// SIMDSupported reports whether the engine can run the SIMD128 module.
+// The probe is compiled, not just validated, so a host CPU the compiler
+// cannot lower v128 to is caught too. The result is cached.
+func SIMDSupported() bool {
+	simdOnce.Do(func() {
+		_, err := wasmtime.NewModule(newEngine(), simdProbe)
+		simdSupported = err == nil
+	})
+	return simdSupported
+}
+
+// simdEmbedded reports whether the SIMD128 module is compiled in, i.e. the
+// host was not built with -tags nosimd.
+func simdEmbedded() bool {
+	return len(wasmSIMDBytes) > 0
+}
+
+// resolve picks the module for v, falling back to scalar under VariantAuto
+// when the SIMD build is missing or unsupported.
+func (v Variant) resolve() (Variant, []byte, error) {
+	switch v {
+	case VariantAuto:
+		if simdEmbedded() && SIMDSupported() {
+			return VariantSIMD, wasmSIMDBytes, nil
+		}
+		return VariantScalar, wasmBytes, nil
+	case VariantScalar:
+		return VariantScalar, wasmBytes, nil
+	case VariantSIMD:
+		if !simdEmbedded() {
+			return v, nil, fmt.Errorf("matcher-simd.wasm is not embedded (built with -tags nosimd)")
+		}
+		if !SIMDSupported() {
+			return v, nil, fmt.Errorf("engine does not support WASM SIMD128")
+		}
+		return VariantSIMD, wasmSIMDBytes, nil
+	}
+	return v, nil, fmt.Errorf("unknown variant %d", int(v))
+}
@@ -0,0 +1,7 @@
+//go:build nosimd
+
+package wasmvs
+
+// Built with -tags nosimd: only the scalar matcher.wasm is embedded, and
+// VariantAuto always resolves to VariantScalar.
+var wasmSIMDBytes []byte
@@ -0,0 +1,13 @@
+//go:build !nosimd
+
+package wasmvs
+
+import _ "embed"
+
+// The SIMD128 build of the matcher (./build.sh simd). Vectorscan's SIMDe
+// backend maps its 128-bit vectors straight onto v128 there, instead of
+// emulating them with scalar loops as in matcher.wasm. Hosts built with
+// -tags nosimd leave it out and only need ./build.sh nosimd.
+//
+//go:embed matcher-simd.wasm
+var wasmSIMDBytes []byte
@@ -0,0 +1,350 @@
+package wasmvs
+
+import (
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"math"
+)
+
+// Just enough of the WebAssembly binary format for snapshot.go: split a
+// module into sections, parse the import, memory, global, export and data
+// sections, and re-encode a module from modified sections.
+
+// Section ids
+const (
+	secCustom    = 0
+	secImport    = 2
+	secMemory    = 5
+	secGlobal    = 6
+	secExport    = 7
+	secStart     = 8
+	secData      = 11
+	secDataCount = 12
+)
+
+// External kinds in import and export entries
+const (
+	externFunc   = 0
+	externTable  = 1
+	externMemory = 2
+	externGlobal = 3
+	externTag    = 4
+)
+
+// Number types a global may hold
+const (
+	valI32  = 0x7f
+	valI64  = 0x7e
+	valF32  = 0x7d
+	valF64  = 0x7c
+	valV128 = 0x7b
+)
+
+var wasmHeader = []byte{0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00}
+
+type wasmSection struct {
+	id   byte
+	data []byte
+}
+
+// wasmGlobal is a global defined (not imported) by the module.
+type wasmGlobal struct {
+	index   uint32 // in the global index space, after imported globals
+	valType byte
+	mutable bool
+	init    []byte // constant expression, including the final end opcode
+}
+
+// wasmExport is one export entry.
+type wasmExport struct {
+	name  string
+	kind  byte
+	index uint32
+}
+
+// wasmReader decodes LEB128 values and vectors; the first error sticks.
+type wasmReader struct {
+	b   []byte
+	off int
+	err error
+}
+
+func (r *wasmReader) fail(format string, args ...interface{}) {
+	if r.err == nil {
+		r.err = fmt.Errorf("wasm offset %d: %s", r.off, fmt.Sprintf(format, args...))
+	}
+}
+
+func (r *wasmReader) done() bool {
+	return r.err != nil || r.off >= len(r.b)
+}
+
+func (r *wasmReader) byte() byte {
+	if r.err != nil || r.off >= len(r.b) {
+		r.fail("unexpected end")
+		return 0
+	}
+	c := r.b[r.off]
+	r.off++
+	return c
+}
+
+func (r *wasmReader) bytes(n int) []byte {
+	if r.err != nil || n < 0 || n > len(r.b)-r.off {
+		r.fail("unexpected end")
+		return nil
+	}
+	s := r.b[r.off : r.off+n]
+	r.off += n
+	return s
+}
+
+// leb reads an LEB128 value of at most bits bits, sign-extending if signed.
+func (r *wasmReader) leb(bits uint, signed bool) uint64 {
+	var v uint64
+	var shift uint
+	for {
+		c := r.byte()
+		if r.err != nil {
+			return 0
+		}
+		v |= uint64(c&0x7f) << shift
+		shift += 7
+		if c&0x80 == 0 {
+			if signed && shift < 64 && c&0x40 != 0 {
+				v |= ^uint64(0) << shift
+			}
+			return v
+		}
+		if shift >= bits+7 {
+			r.fail("LEB128 too long")
+			return 0
+		}
+	}
+}
+
+func (r *wasmReader) u32() uint32 {
+	return uint32(r.leb(32, false))
+}
+
+func (r *wasmReader) name() string {
+	return string(r.bytes(int(r.u32())))
+}
+
+// limits skips a table or memory limits entry, returning min and max (if any).
+func (r *wasmReader) limits() (flags byte, min, max uint64) {
+	flags = r.byte()
+	min = r.leb(64, false)
+	if flags&1 != 0 {
+		max = r.leb(64, false)
+	}
+	return flags, min, max
+}
+
+// constExpr returns a constant expression up to and including its end opcode.
+func (r *wasmReader) constExpr() []byte {
+	start := r.off
+	for r.err == nil {
+		switch op := r.byte(); op {
+		case 0x0b: // end
+			return r.b[start:r.off]
+		case 0x41: // i32.const
+			r.leb(32, true)
+		case 0x42: // i64.const
+			r.leb(64, true)
+		case 0x43: // f32.const
+			r.bytes(4)
+		case 0x44: // f64.const
+			r.bytes(8)
+		case 0x23, 0xd2: // global.get, ref.func
+			r.u32()
+		case 0xd0: // ref.null
+			r.leb(33, true)
+		case 0x6a, 0x6b, 0x6c, 0x7c, 0x7d, 0x7e: // extended-const arithmetic
+		case 0xfd:
+			if sub := r.u32(); sub != 0x0c { // v128.const
+				r.fail("unsupported constant opcode 0xfd %d", sub)
+			}
+			r.bytes(16)
+		default:
+			r.fail("unsupported constant opcode %#x", op)
+		}
+	}
+	return nil
+}
+
+// parseSections splits a binary module into its sections.
+func parseSections(b []byte) ([]wasmSection, error) {
+	if !bytes.HasPrefix(b, wasmHeader) {
+		return nil, fmt.Errorf("not a WebAssembly 1.0 module")
+	}
+	r := &wasmReader{b: b, off: len(wasmHeader)}
+	var secs []wasmSection
+	for !r.done() {
+		id := r.byte()
+		data := r.bytes(int(r.u32()))
+		secs = append(secs, wasmSection{id: id, data: data})
+	}
+	return secs, r.err
+}
+
+// encodeSections builds a binary module from sections.
+func encodeSections(secs []wasmSection) []byte {
+	n := len(wasmHeader)
+	for _, s := range secs {
+		n += 1 + binary.MaxVarintLen32 + len(s.data)
+	}
+	out := make([]byte, 0, n)
+	out = append(out, wasmHeader...)
+	for _, s := range secs {
+		out = append(out, s.id)
+		out = appendU32(out, uint32(len(s.data)))
+		out = append(out, s.data...)
+	}
+	return out
+}
+
+// importCounts counts the imported globals and memories.
+func importCounts(data []byte) (globals, memories uint32, err error) {
+	r := &wasmReader{b: data}
+	for n := r.u32(); n > 0 && r.err == nil; n-- {
+		r.name()
+		r.name()
+		switch kind := r.byte(); kind {
+		case externFunc:
+			r.u32()
+		case externTable:
+			r.leb(33, true) // reftype, possibly a GC heap type
+			r.limits()
+		case externMemory:
+			r.limits()
+			memories++
+		case externGlobal:
+			r.byte()
+			r.byte()
+			globals++
+		case externTag:
+			r.byte()
+			r.u32()
+		default:
+			r.fail("unknown import kind %d", kind)
+		}
+	}
+	return globals, memories, r.err
+}
+
+// parseGlobals decodes the global section; first is the index of its first global.
+func parseGlobals(data []byte, first uint32) ([]wasmGlobal, error) {
+	r := &wasmReader{b: data}
+	var globals []wasmGlobal
+	for n, i := r.u32(), uint32(0); i < n && r.err == nil; i++ {
+		g := wasmGlobal{index: first + i, valType: r.byte()}
+		switch g.valType {
+		case valI32, valI64, valF32, valF64, valV128:
+		default:
+			r.fail("global %d: unsupported type %#x", g.index, g.valType)
+		}
+		g.mutable = r.byte() == 1
+		g.init = r.constExpr()
+		globals = append(globals, g)
+	}
+	return globals, r.err
+}
+
+func encodeGlobals(globals []wasmGlobal) []byte {
+	out := appendU32(nil, uint32(len(globals)))
+	for _, g := range globals {
+		mut := byte(0)
+		if g.mutable {
+			mut = 1
+		}
+		out = append(out, g.valType, mut)
+		out = append(out, g.init...)
+	}
+	return out
+}
+
+func parseExports(data []byte) ([]wasmExport, error) {
+	r := &wasmReader{b: data}
+	var exports []wasmExport
+	for n := r.u32(); n > 0 && r.err == nil; n-- {
+		exports = append(exports, wasmExport{name: r.name(), kind: r.byte(), index: r.u32()})
+	}
+	return exports, r.err
+}
+
+func encodeExports(exports []wasmExport) []byte {
+	out := appendU32(nil, uint32(len(exports)))
+	for _, e := range exports {
+		out = appendName(out, e.name)
+		out = append(out, e.kind)
+		out = appendU32(out, e.index)
+	}
+	return out
+}
+
+// hasPassiveData reports whether the data section has passive segments,
+// which memory.init may still copy from after a snapshot.
+func hasPassiveData(data []byte) (bool, error) {
+	r := &wasmReader{b: data}
+	for n := r.u32(); n > 0 && r.err == nil; n-- {
+		switch flags := r.u32(); flags {
+		case 0:
+			r.constExpr()
+		case 1:
+			return true, nil
+		case 2:
+			r.u32()
+			r.constExpr()
+		default:
+			r.fail("unknown data segment flags %d", flags)
+		}
+		r.bytes(int(r.u32()))
+	}
+	return false, r.err
+}
+
+// constValue encodes a constant expression producing a numeric global value.
+func constValue(valType byte, bits uint64) []byte {
+	var out []byte
+	switch valType {
+	case valI32:
+		out = appendS64(append(out, 0x41), int64(int32(bits)))
+	case valI64:
+		out = appendS64(append(out, 0x42), int64(bits))
+	case valF32:
+		out = binary.LittleEndian.AppendUint32(append(out, 0x43), uint32(bits))
+	case valF64:
+		out = binary.LittleEndian.AppendUint64(append(out, 0x44), bits)
+	}
+	return append(out, 0x0b)
+}
+
+// f32Bits and f64Bits pass float globals through constValue unchanged.
+func f32Bits(f float32) uint64 { return uint64(math.Float32bits(f)) }
+func f64Bits(f float64) uint64 { return math.Float64bits(f) }
+
+func appendU32(dst []byte, v uint32) []byte {
+	for v >= 0x80 {
+		dst = append(dst, byte(v)|0x80)
+		v >>= 7
+	}
+	return append(dst, byte(v))
+}
+
+func appendS64(dst []byte, v int64) []byte {
+	for {
+		c := byte(v & 0x7f)
+		v >>= 7
+		if (v == 0 && c&0x40 == 0) || (v == -1 && c&0x40 != 0) {
+			return append(dst, c)
+		}
+		dst = append(dst, c|0x80)
+	}
+}
+
+func appendName(dst []byte, s string) []byte {
+	dst = appendU32(dst, uint32(len(s)))
+	return append(dst, s...)
+}
@@ -2,6 +2,7 @@
 // Exports minimal API for pattern compilation and matching
 // Compiled without C++ exceptions - errors handled via return codes
 
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <cstdio>
@@ -12,19 +13,99 @@
 // Debug output buffer for WASM
 static char g_error_msg[512] = {0};
 
+// A compiled ruleset, addressed by handle. Slot 0 is the default ruleset
+// managed by matcher_init/matcher_load_serialized; matcher_create hands out
+// the rest. All rulesets share one scratch sized for the largest database.
+struct Ruleset {
+    hs_database_t *db;
+    int pattern_count;
+};
+
 // Global state
-static hs_database_t *g_database = nullptr;
+static Ruleset *g_rulesets = nullptr;
+static int g_ruleset_capacity = 0;
 static hs_scratch_t *g_scratch = nullptr;
-static int g_pattern_count = 0;
 
 // Match result for callback
 static int g_match_id = -1;
 
-// Callback for hs_scan - captures first match and terminates
+// First-match policy (see matcher_set_priority)
+//   0 - stop at the first match reported, in input offset order (fastest)
+//   1 - return the lowest matching pattern ID; only ID 0 stops early
+//   n - IDs below n form one top-priority tier: stop as soon as any of them
+//       matches, returning the lowest ID seen by then. That is a tier ID
+//       whenever one matches, but not necessarily the lowest (use 1)
+static int g_priority_cutoff = 0;
+
+// Streaming state - a separate HS_MODE_STREAM database sharing g_scratch,
+// and at most one open stream. g_stream_match_id carries the best match
+// across writes; g_stream_done is set once the priority cutoff was met.
+static hs_database_t *g_stream_database = nullptr;
+static hs_stream_t *g_stream = nullptr;
+static int g_stream_match_id = -1;
+static bool g_stream_done = false;
+
+// Vectored state - a separate HS_MODE_VECTORED database sharing g_scratch,
+// and reusable pointer/length arrays for hs_scan_vector
+static hs_database_t *g_vectored_database = nullptr;
+static const char **g_field_data = nullptr;
+static unsigned int *g_field_len = nullptr;
+static int g_field_capacity = 0;
+
+// Persistent input arena - the host writes inputs here directly, so the
+// hot path needs no malloc/free. Grown on demand, freed by matcher_close.
+static const int kInitialInputCapacity = 64 * 1024;
+static char *g_input = nullptr;
+static int g_input_capacity = 0;
+
+// Serialized database blob layout:
+//   [0..3]  magic "VSDB"
+//   [4..7]  pattern count (little-endian)
+//   [8..]   hs_serialize_database output
+// Kept until the next matcher_serialize or matcher_close so the host can copy it out
+static const char kDbMagic[4] = {'V', 'S', 'D', 'B'};
+static const size_t kDbHeaderSize = 8;
+static char *g_serialized = nullptr;
+
+// Callback for hs_scan - tracks the lowest pattern ID seen and
+// terminates according to the priority cutoff. Only ID 0 is final
+// mid-scan, so any cutoff above 1 trades exactness within the tier for
+// stopping early
 static int match_handler(unsigned int id, unsigned long long from,
                          unsigned long long to, unsigned int flags, void *ctx) {
-    g_match_id = static_cast<int>(id);
-    return 1;  // Non-zero to stop scanning
+    int match_id = static_cast<int>(id);
+    if (g_match_id < 0 || match_id < g_match_id) g_match_id = match_id;
+
+    // Non-zero to stop scanning
+    if (g_priority_cutoff == 0) return 1;
+    return g_match_id < g_priority_cutoff ? 1 : 0;
+}
+
+// All-matches state for matcher_match_all: bit i of bits is pattern i, for
+// the first limit patterns
+struct MatchAllContext {
+    uint64_t *bits;
+    unsigned int limit;
+    int count;
+    bool out_of_range;  // an ID >= limit fired: the database is not the one counted
+};
+
+// Callback for hs_scan in all-matches mode - records every pattern and
+// never terminates. HS_FLAG_SINGLEMATCH reports each ID at most once,
+// the bit test guards the count anyway
+static int match_all_handler(unsigned int id, unsigned long long from,
+                             unsigned long long to, unsigned int flags, void *ctx) {
+    MatchAllContext *m = static_cast<MatchAllContext*>(ctx);
+    if (id >= m->limit) {
+        m->out_of_range = true;
+        return 1;
+    }
+    uint64_t bit = uint64_t(1) << (id & 63);
+    if (!(m->bits[id >> 6] & bit)) {
+        m->bits[id >> 6] |= bit;
+        m->count++;
+    }
+    return 0;
 }
 
 // Helper to set error message
@@ -39,23 +120,184 @@ static void set_error_fmt(const char* fmt, ...) {
     va_end(args);
 }
 
-extern "C" {
+// Make sure the input arena holds at least size bytes
+// Contents are not preserved across growth
+static bool ensure_input_capacity(int size) {
+    if (g_input && size <= g_input_capacity) return true;
+    if (size < 0) return false;
+
+    uint64_t new_cap = g_input_capacity > 0 ? g_input_capacity : kInitialInputCapacity;
+    while (new_cap < static_cast<uint64_t>(size)) new_cap *= 2;
+    if (new_cap > INT32_MAX) new_cap = size;
+
+    char *buf = static_cast<char*>(malloc(new_cap));
+    if (!buf) {
+        set_error_fmt("Failed to grow input arena to %llu bytes",
+                      static_cast<unsigned long long>(new_cap));
+        return false;
+    }
+    free(g_input);
+    g_input = buf;
+    g_input_capacity = static_cast<int>(new_cap);
+    return true;
+}
 
-// Memory allocation exports for WASM host
-__attribute__((export_name("wasm_alloc")))
-void* wasm_alloc(int size) {
-    return malloc(size);
+// Make sure the field arrays hold at least count entries
+static bool ensure_field_capacity(int count) {
+    if (count <= g_field_capacity) return true;
+
+    int new_cap = g_field_capacity > 0 ? g_field_capacity : 16;
+    while (new_cap < count) new_cap *= 2;
+
+    const char **data = static_cast<const char**>(malloc(new_cap * sizeof(char*)));
+    unsigned int *len = static_cast<unsigned int*>(malloc(new_cap * sizeof(unsigned int)));
+    if (!data || !len) {
+        free(data);
+        free(len);
+        set_error_fmt("Failed to grow field arrays to %d entries", new_cap);
+        return false;
+    }
+    free(g_field_data);
+    free(g_field_len);
+    g_field_data = data;
+    g_field_len = len;
+    g_field_capacity = new_cap;
+    return true;
 }
 
-__attribute__((export_name("wasm_free")))
-void wasm_free(void* ptr) {
-    free(ptr);
+// Make sure the ruleset table holds at least count slots
+// New slots are zeroed; existing ones keep their contents
+static bool ensure_ruleset_capacity(int count) {
+    if (count <= g_ruleset_capacity) return true;
+
+    int new_cap = g_ruleset_capacity > 0 ? g_ruleset_capacity * 2 : 4;
+    while (new_cap < count) new_cap *= 2;
+
+    Ruleset *table = static_cast<Ruleset*>(realloc(g_rulesets, new_cap * sizeof(Ruleset)));
+    if (!table) {
+        set_error_fmt("Failed to grow ruleset table to %d entries", new_cap);
+        return false;
+    }
+    memset(table + g_ruleset_capacity, 0,
+           (new_cap - g_ruleset_capacity) * sizeof(Ruleset));
+    g_rulesets = table;
+    g_ruleset_capacity = new_cap;
+    return true;
 }
 
-// Initialize matcher with patterns (newline-separated)
+// Look up a live ruleset, or set the error and return null
+static Ruleset* get_ruleset(int handle) {
+    if (handle < 0 || handle >= g_ruleset_capacity || !g_rulesets[handle].db) {
+        set_error_fmt("Invalid matcher handle %d", handle);
+        return nullptr;
+    }
+    return &g_rulesets[handle];
+}
+
+// Swap a compiled or deserialized database into a slot and size scratch for it
+// Takes ownership of db; frees it on failure
+static int install_database(int handle, hs_database_t *db, int pattern_count) {
+    if (!ensure_ruleset_capacity(handle + 1)) {
+        hs_free_database(db);
+        return -2;
+    }
+
+    // hs_alloc_scratch grows an existing scratch in place if needed
+    hs_error_t err = hs_alloc_scratch(db, &g_scratch);
+    if (err != HS_SUCCESS) {
+        hs_free_database(db);
+        set_error_fmt("hs_alloc_scratch failed with code %d", err);
+        return -5;
+    }
+
+    Ruleset *rs = &g_rulesets[handle];
+    if (rs->db) hs_free_database(rs->db);
+    rs->db = db;
+    rs->pattern_count = pattern_count;
+    return 0;
+}
+
+// Reallocate scratch to fit only the live databases, so destroying a
+// large ruleset gives back its share of scratch
+static int rebuild_scratch(void) {
+    if (g_scratch) {
+        hs_free_scratch(g_scratch);
+        g_scratch = nullptr;
+    }
+
+    const hs_database_t *extra[] = {g_stream_database, g_vectored_database};
+    for (int i = 0; i < g_ruleset_capacity + 2; i++) {
+        const hs_database_t *db = i < g_ruleset_capacity ? g_rulesets[i].db
+                                                          : extra[i - g_ruleset_capacity];
+        if (!db) continue;
+        hs_error_t err = hs_alloc_scratch(db, &g_scratch);
+        if (err != HS_SUCCESS) {
+            set_error_fmt("hs_alloc_scratch failed with code %d", err);
+            return -5;
+        }
+    }
+    return 0;
+}
+
+// Find a free slot for matcher_create; slot 0 is never handed out
+static int free_ruleset_slot(void) {
+    for (int i = 1; i < g_ruleset_capacity; i++) {
+        if (!g_rulesets[i].db) return i;
+    }
+    return g_ruleset_capacity > 0 ? g_ruleset_capacity : 1;
+}
+
+// Validate a matcher_serialize blob and deserialize its database
 // Returns 0 on success, negative on error
-__attribute__((export_name("matcher_init")))
-int matcher_init(const char* patterns_data, int patterns_len) {
+static int parse_serialized(const char *data, int len, hs_database_t **out_db,
+                            int *out_count) {
+    if (!data || len < static_cast<int>(kDbHeaderSize) ||
+        memcmp(data, kDbMagic, sizeof(kDbMagic)) != 0) {
+        set_error("Invalid serialized database header");
+        return -1;
+    }
+
+    // Vectorscan cannot report a database's pattern count, so the header is
+    // trusted; matcher_match_all fails rather than record an ID beyond it
+    uint32_t count = 0;
+    memcpy(&count, data + 4, sizeof(count));
+    if (count == 0 || count > INT32_MAX) {
+        set_error_fmt("Invalid pattern count %u in serialized database header", count);
+        return -1;
+    }
+
+    hs_error_t err = hs_deserialize_database(data + kDbHeaderSize,
+                                             len - kDbHeaderSize, out_db);
+    if (err != HS_SUCCESS) {
+        set_error_fmt("hs_deserialize_database failed with code %d", err);
+        return -2;
+    }
+
+    *out_count = static_cast<int>(count);
+    return 0;
+}
+
+// Scan a single input, returning first matching pattern ID or -1
+static int scan_first(const hs_database_t *db, const char* input,
+                      unsigned int input_len) {
+    g_match_id = -1;
+
+    hs_error_t err = hs_scan(db, input, input_len, 0,
+                             g_scratch, match_handler, nullptr);
+
+    // HS_SCAN_TERMINATED means we found a match and stopped early
+    if (err != HS_SUCCESS && err != HS_SCAN_TERMINATED) {
+        return -1;
+    }
+
+    return g_match_id;
+}
+
+// Parse newline-separated patterns and compile them in the given mode
+// Empty lines are skipped. Returns 0 on success, negative on error
+static int compile_patterns(const char* patterns_data, int patterns_len,
+                            unsigned int mode, hs_database_t **out_db,
+                            int *out_count) {
     // Count patterns (number of newlines + 1, or 0 if empty)
     if (patterns_len == 0) {
         set_error("No patterns provided");
@@ -107,12 +349,16 @@ int matcher_init(const char* patterns_data, int patterns_len) {
         }
     }
 
-    int actual_count = idx;
-
     // Compile patterns into database
     hs_compile_error_t *compile_err = nullptr;
-    hs_error_t err = hs_compile_multi(expressions, flags, ids, actual_count,
-                                      HS_MODE_BLOCK, nullptr, &g_database, &compile_err);
+    hs_error_t err = hs_compile_multi(expressions, flags, ids, idx,
+                                      mode, nullptr, out_db, &compile_err);
+
+    // hs_compile_multi copies the expressions, so the parse buffers can go now
+    free(data_copy);
+    free(expressions);
+    free(flags);
+    free(ids);
 
     if (err != HS_SUCCESS) {
         if (compile_err) {
@@ -123,60 +369,390 @@ int matcher_init(const char* patterns_data, int patterns_len) {
         } else {
             set_error_fmt("hs_compile_multi failed with code %d", err);
         }
-        free(data_copy);
-        free(expressions);
-        free(flags);
-        free(ids);
         return -4;
     }
 
-    // Allocate scratch space
-    err = hs_alloc_scratch(g_database, &g_scratch);
+    *out_count = idx;
+    return 0;
+}
+
+extern "C" {
+
+// Memory allocation exports for WASM host
+__attribute__((export_name("wasm_alloc")))
+void* wasm_alloc(int size) {
+    return malloc(size);
+}
+
+__attribute__((export_name("wasm_free")))
+void wasm_free(void* ptr) {
+    free(ptr);
+}
+
+// Input arena exports - the host caches the pointer and only re-queries
+// after matcher_input_reserve or a memory growth notification
+__attribute__((export_name("matcher_input_ptr")))
+char* matcher_input_ptr(void) {
+    if (!ensure_input_capacity(0)) return nullptr;
+    return g_input;
+}
+
+__attribute__((export_name("matcher_input_capacity")))
+int matcher_input_capacity(void) {
+    return g_input_capacity;
+}
+
+// Grow the input arena to hold at least size bytes
+// Returns the (possibly moved) arena pointer, or null on failure
+__attribute__((export_name("matcher_input_reserve")))
+char* matcher_input_reserve(int size) {
+    if (!ensure_input_capacity(size)) return nullptr;
+    return g_input;
+}
+
+// Initialize matcher with patterns (newline-separated)
+// Returns 0 on success, negative on error
+__attribute__((export_name("matcher_init")))
+int matcher_init(const char* patterns_data, int patterns_len) {
+    hs_database_t *db = nullptr;
+    int count = 0;
+    int rc = compile_patterns(patterns_data, patterns_len, HS_MODE_BLOCK, &db, &count);
+    if (rc != 0) return rc;
+
+    // Allocate scratch space and make the database active
+    return install_database(0, db, count);
+}
+
+// Compile patterns (newline-separated) into a new ruleset
+// Returns a handle for matcher_match and friends, or negative on error
+__attribute__((export_name("matcher_create")))
+int matcher_create(const char* patterns_data, int patterns_len) {
+    hs_database_t *db = nullptr;
+    int count = 0;
+    int rc = compile_patterns(patterns_data, patterns_len, HS_MODE_BLOCK, &db, &count);
+    if (rc != 0) return rc;
+
+    int handle = free_ruleset_slot();
+    rc = install_database(handle, db, count);
+    return rc != 0 ? rc : handle;
+}
+
+// Create a ruleset from a matcher_serialize blob
+// Returns a handle, or negative on error
+__attribute__((export_name("matcher_create_serialized")))
+int matcher_create_serialized(const char *data, int len) {
+    hs_database_t *db = nullptr;
+    int count = 0;
+    int rc = parse_serialized(data, len, &db, &count);
+    if (rc != 0) return rc;
+
+    int handle = free_ruleset_slot();
+    rc = install_database(handle, db, count);
+    return rc != 0 ? rc : handle;
+}
+
+// Free a ruleset and shrink the shared scratch to what the rest need
+// Returns 0 on success, negative on error
+__attribute__((export_name("matcher_destroy")))
+int matcher_destroy(int handle) {
+    Ruleset *rs = get_ruleset(handle);
+    if (!rs) return -2;
+
+    hs_free_database(rs->db);
+    rs->db = nullptr;
+    rs->pattern_count = 0;
+    return rebuild_scratch();
+}
+
+// Serialize a ruleset's database so it can be shipped and loaded later
+// without recompiling. Writes blob pointer and length to out_ptr/out_len;
+// the blob stays valid until the next matcher_serialize or matcher_close.
+// Returns 0 on success, negative on error
+__attribute__((export_name("matcher_serialize")))
+int matcher_serialize(int handle, uint32_t *out_ptr, uint32_t *out_len) {
+    Ruleset *rs = get_ruleset(handle);
+    if (!rs) return -1;
+
+    char *bytes = nullptr;
+    size_t length = 0;
+    hs_error_t err = hs_serialize_database(rs->db, &bytes, &length);
     if (err != HS_SUCCESS) {
-        hs_free_database(g_database);
-        g_database = nullptr;
-        free(data_copy);
-        free(expressions);
-        free(flags);
-        free(ids);
+        set_error_fmt("hs_serialize_database failed with code %d", err);
+        return -2;
+    }
+
+    char *blob = static_cast<char*>(malloc(kDbHeaderSize + length));
+    if (!blob) {
+        free(bytes);
+        set_error("Memory allocation failed for serialized database");
+        return -3;
+    }
+    uint32_t count = static_cast<uint32_t>(rs->pattern_count);
+    memcpy(blob, kDbMagic, sizeof(kDbMagic));
+    memcpy(blob + 4, &count, sizeof(count));
+    memcpy(blob + kDbHeaderSize, bytes, length);
+    free(bytes);  // hs_serialize_database uses the default misc allocator (malloc)
+
+    free(g_serialized);
+    g_serialized = blob;
+    *out_ptr = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(blob));
+    *out_len = static_cast<uint32_t>(kDbHeaderSize + length);
+    return 0;
+}
+
+// Load a database produced by matcher_serialize into the default ruleset
+// instead of compiling patterns
+// Returns 0 on success, negative on error
+__attribute__((export_name("matcher_load_serialized")))
+int matcher_load_serialized(const char *data, int len) {
+    hs_database_t *db = nullptr;
+    int count = 0;
+    int rc = parse_serialized(data, len, &db, &count);
+    if (rc != 0) return rc;
+
+    return install_database(0, db, count);
+}
+
+// Match input against all patterns of a ruleset
+// Returns first matching pattern ID, or -1 if no match
+__attribute__((export_name("matcher_match")))
+int matcher_match(int handle, const char* input, int input_len) {
+    Ruleset *rs = get_ruleset(handle);
+    if (!rs || !g_scratch) return -1;
+
+    return scan_first(rs->db, input, input_len);
+}
+
+// Match input against every pattern, writing a bitset of matched IDs into
+// bits: (pattern_count + 63) / 64 little-endian 64-bit words, cleared first
+// Returns the number of matching patterns, or negative on error
+__attribute__((export_name("matcher_match_all")))
+int matcher_match_all(int handle, const char* input, int input_len, uint64_t* bits) {
+    Ruleset *rs = get_ruleset(handle);
+    if (!rs || !g_scratch) return -1;
+    if (!bits) {
+        set_error("Invalid bitset");
+        return -2;
+    }
+
+    memset(bits, 0, ((rs->pattern_count + 63) / 64) * sizeof(uint64_t));
+    MatchAllContext m = {bits, static_cast<unsigned int>(rs->pattern_count), 0, false};
+    hs_error_t err = hs_scan(rs->db, input, input_len, 0, g_scratch, match_all_handler, &m);
+    if (m.out_of_range) {
+        set_error_fmt("Pattern ID beyond the ruleset's %d patterns", rs->pattern_count);
+        return -4;
+    }
+    if (err != HS_SUCCESS) {
+        set_error_fmt("hs_scan failed with code %d", err);
+        return -3;
+    }
+    return m.count;
+}
+
+// Match a batch of inputs packed back-to-back into one blob
+// offsets holds count+1 entries: input i spans blob[offsets[i], offsets[i+1])
+// Writes first matching pattern ID (or -1) for each input into results
+// Returns number of inputs that matched, or negative on error
+__attribute__((export_name("matcher_match_batch")))
+int matcher_match_batch(int handle, const char* blob, const uint32_t* offsets,
+                        int count, int32_t* results) {
+    Ruleset *rs = get_ruleset(handle);
+    if (!rs || !g_scratch) return -1;
+    if (count < 0 || (count > 0 && (!blob || !offsets || !results))) {
+        set_error("Invalid batch arguments");
+        return -2;
+    }
+
+    int matched = 0;
+    for (int i = 0; i < count; i++) {
+        uint32_t start = offsets[i];
+        uint32_t end = offsets[i + 1];
+        if (end < start) {
+            set_error_fmt("Invalid batch offsets at input %d", i);
+            return -3;
+        }
+        results[i] = scan_first(rs->db, blob + start, end - start);
+        if (results[i] >= 0) matched++;
+    }
+
+    return matched;
+}
+
+// Compile patterns (newline-separated) into the vectored database
+// Must match the patterns given to matcher_init so IDs line up
+// Returns 0 on success, negative on error
+__attribute__((export_name("matcher_init_vectored")))
+int matcher_init_vectored(const char* patterns_data, int patterns_len) {
+    hs_database_t *db = nullptr;
+    int count = 0;
+    int rc = compile_patterns(patterns_data, patterns_len, HS_MODE_VECTORED, &db, &count);
+    if (rc != 0) return rc;
+
+    // Grow the shared scratch so it fits this database too
+    hs_error_t err = hs_alloc_scratch(db, &g_scratch);
+    if (err != HS_SUCCESS) {
+        hs_free_database(db);
         set_error_fmt("hs_alloc_scratch failed with code %d", err);
         return -5;
     }
 
-    g_pattern_count = actual_count;
+    if (g_vectored_database) hs_free_database(g_vectored_database);
+    g_vectored_database = db;
+    return 0;
+}
 
-    // Note: we keep data_copy allocated since expressions point into it
-    // This is a memory leak but acceptable for our benchmark use case
-    free(expressions);
-    free(flags);
-    free(ids);
+// Match one record made of several fields in a single scan
+// offsets holds count+1 entries: field i spans blob[offsets[i], offsets[i+1])
+// Fields are scanned as one logical input, so matches can span fields
+// Returns matching pattern ID, -1 if no match, or < -1 on error
+__attribute__((export_name("matcher_match_fields")))
+int matcher_match_fields(const char* blob, const uint32_t* offsets, int count) {
+    if (!g_vectored_database || !g_scratch) {
+        set_error("Vectored database not initialized");
+        return -2;
+    }
+    if (count < 0 || (count > 0 && (!blob || !offsets))) {
+        set_error("Invalid field arguments");
+        return -3;
+    }
+    if (!ensure_field_capacity(count)) return -4;
+
+    for (int i = 0; i < count; i++) {
+        uint32_t start = offsets[i];
+        uint32_t end = offsets[i + 1];
+        if (end < start) {
+            set_error_fmt("Invalid field offsets at field %d", i);
+            return -5;
+        }
+        g_field_data[i] = blob + start;
+        g_field_len[i] = end - start;
+    }
 
+    g_match_id = -1;
+    hs_error_t err = hs_scan_vector(g_vectored_database, g_field_data, g_field_len,
+                                    count, 0, g_scratch, match_handler, nullptr);
+    if (err != HS_SUCCESS && err != HS_SCAN_TERMINATED) {
+        set_error_fmt("hs_scan_vector failed with code %d", err);
+        return -6;
+    }
+    return g_match_id;
+}
+
+// Set the first-match policy used by matcher_match and matcher_match_batch
+// cutoff 0 stops on the first match by offset; cutoff 1 returns the lowest
+// pattern ID; cutoff n > 1 stops once any ID below n fires (see
+// g_priority_cutoff)
+// Returns 0 on success, negative on error
+__attribute__((export_name("matcher_set_priority")))
+int matcher_set_priority(int cutoff) {
+    if (cutoff < 0) {
+        set_error_fmt("Invalid priority cutoff %d", cutoff);
+        return -1;
+    }
+    g_priority_cutoff = cutoff;
     return 0;
 }
 
-// Match input against all patterns
-// Returns first matching pattern ID, or -1 if no match
-__attribute__((export_name("matcher_match")))
-int matcher_match(const char* input, int input_len) {
-    if (!g_database || !g_scratch) return -1;
+// Compile patterns (newline-separated) into the streaming database
+// Must match the patterns given to matcher_init so IDs line up
+// Returns 0 on success, negative on error
+__attribute__((export_name("matcher_init_stream")))
+int matcher_init_stream(const char* patterns_data, int patterns_len) {
+    if (g_stream) {
+        set_error("Cannot replace streaming database while a stream is open");
+        return -6;
+    }
 
-    g_match_id = -1;
+    hs_database_t *db = nullptr;
+    int count = 0;
+    int rc = compile_patterns(patterns_data, patterns_len, HS_MODE_STREAM, &db, &count);
+    if (rc != 0) return rc;
 
-    hs_error_t err = hs_scan(g_database, input, input_len, 0,
-                             g_scratch, match_handler, nullptr);
+    // Grow the shared scratch so it fits both databases
+    hs_error_t err = hs_alloc_scratch(db, &g_scratch);
+    if (err != HS_SUCCESS) {
+        hs_free_database(db);
+        set_error_fmt("hs_alloc_scratch failed with code %d", err);
+        return -5;
+    }
 
-    // HS_SCAN_TERMINATED means we found a match and stopped early
-    if (err != HS_SUCCESS && err != HS_SCAN_TERMINATED) {
+    if (g_stream_database) hs_free_database(g_stream_database);
+    g_stream_database = db;
+    return 0;
+}
+
+// Open a stream; only one stream can be open at a time
+// Returns 0 on success, negative on error
+__attribute__((export_name("matcher_stream_open")))
+int matcher_stream_open(void) {
+    if (!g_stream_database || !g_scratch) {
+        set_error("Streaming database not initialized");
         return -1;
     }
+    if (g_stream) {
+        set_error("Stream already open");
+        return -2;
+    }
 
-    return g_match_id;
+    hs_error_t err = hs_open_stream(g_stream_database, 0, &g_stream);
+    if (err != HS_SUCCESS) {
+        g_stream = nullptr;
+        set_error_fmt("hs_open_stream failed with code %d", err);
+        return -3;
+    }
+    g_stream_match_id = -1;
+    g_stream_done = false;
+    return 0;
 }
 
-// Get pattern count
+// Scan the next chunk of the open stream; matches may span chunks
+// Returns 1 once the result is final (later writes are skipped),
+// 0 to keep writing, negative on error
+__attribute__((export_name("matcher_stream_write")))
+int matcher_stream_write(const char* chunk, int len) {
+    if (!g_stream) {
+        set_error("No stream open");
+        return -1;
+    }
+    if (g_stream_done) return 1;
+
+    // The callback reports into g_match_id, which block scans also use
+    g_match_id = g_stream_match_id;
+    hs_error_t err = hs_scan_stream(g_stream, chunk, len, 0, g_scratch,
+                                    match_handler, nullptr);
+    g_stream_match_id = g_match_id;
+
+    if (err == HS_SCAN_TERMINATED) {
+        g_stream_done = true;
+        return 1;
+    }
+    if (err != HS_SUCCESS) {
+        set_error_fmt("hs_scan_stream failed with code %d", err);
+        return -2;
+    }
+    return 0;
+}
+
+// Close the open stream, flushing matches anchored at end of data
+// Returns the matching pattern ID, or -1 if no match (or no stream)
+__attribute__((export_name("matcher_stream_close")))
+int matcher_stream_close(void) {
+    if (!g_stream) return -1;
+
+    // A finished stream needs no end-of-data matches
+    g_match_id = g_stream_match_id;
+    hs_close_stream(g_stream, g_scratch,
+                    g_stream_done ? nullptr : match_handler, nullptr);
+    g_stream = nullptr;
+    g_stream_match_id = g_match_id;
+    return g_stream_match_id;
+}
+
+// Get pattern count of a ruleset, or 0 for an invalid handle
 __attribute__((export_name("matcher_pattern_count")))
-int matcher_pattern_count(void) {
-    return g_pattern_count;
+int matcher_pattern_count(int handle) {
+    if (handle < 0 || handle >= g_ruleset_capacity) return 0;
+    return g_rulesets[handle].pattern_count;
 }
 
 // Get last error message
@@ -194,15 +770,38 @@ int matcher_check_platform(void) {
 // Close and free resources
 __attribute__((export_name("matcher_close")))
 void matcher_close(void) {
+    if (g_stream) {
+        hs_close_stream(g_stream, g_scratch, nullptr, nullptr);
+        g_stream = nullptr;
+    }
+    if (g_stream_database) {
+        hs_free_database(g_stream_database);
+        g_stream_database = nullptr;
+    }
+    if (g_vectored_database) {
+        hs_free_database(g_vectored_database);
+        g_vectored_database = nullptr;
+    }
+    free(g_field_data);
+    free(g_field_len);
+    g_field_data = nullptr;
+    g_field_len = nullptr;
+    g_field_capacity = 0;
     if (g_scratch) {
         hs_free_scratch(g_scratch);
         g_scratch = nullptr;
     }
-    if (g_database) {
-        hs_free_database(g_database);
-        g_database = nullptr;
+    for (int i = 0; i < g_ruleset_capacity; i++) {
+        if (g_rulesets[i].db) hs_free_database(g_rulesets[i].db);
     }
-    g_pattern_count = 0;
+    free(g_rulesets);
+    g_rulesets = nullptr;
+    g_ruleset_capacity = 0;
+    free(g_serialized);
+    g_serialized = nullptr;
+    free(g_input);
+    g_input = nullptr;
+    g_input_capacity = 0;
 }
 
 } // extern "C"
@@ -0,0 +1,128 @@
+package ffi
+
+/*
+#include "vector.h"
+*/
+import "C"
+
+import "unsafe"
+
+// float32 and int8/int16 vector operations, for embeddings and quantized
+// vectors that would double (or octuple) their memory traffic if widened to
+// float64 first. They work on the caller's slices in place: Go pointers
+// passed to C stay valid for the duration of the call, so there is nothing
+// to copy or pin. Kernels are dispatched like the float64 ones (see Kernels).
+//
+// Integer sums and dot products are exact, accumulated in int32 lanes and
+// returned as int64. Binary operations use the length of the first operand
+// and do nothing (or return 0) if another operand is shorter.
+
+func f32Ptr(x []float32) *C.float { return (*C.float)(unsafe.Pointer(&x[0])) }
+func i8Ptr(x []int8) *C.int8_t    { return (*C.int8_t)(unsafe.Pointer(&x[0])) }
+func i16Ptr(x []int16) *C.int16_t { return (*C.int16_t)(unsafe.Pointer(&x[0])) }
+
+// SumF32 returns the sum of all elements.
+func SumF32(data []float32) float32 {
+	if len(data) == 0 {
+		return 0
+	}
+	initKernels()
+	return float32(C.vector_sum_f32(f32Ptr(data), C.size_t(len(data))))
+}
+
+// DotF32 computes the dot product of two vectors.
+func DotF32(a, b []float32) float32 {
+	if len(a) == 0 || len(b) < len(a) {
+		return 0
+	}
+	initKernels()
+	return float32(C.vector_dot_f32(f32Ptr(a), f32Ptr(b), C.size_t(len(a))))
+}
+
+// MulF32 performs element-wise multiplication: dst[i] = a[i] * b[i].
+// dst may be a or b.
+func MulF32(a, b, dst []float32) {
+	if len(a) == 0 || len(b) < len(a) || len(dst) < len(a) {
+		return
+	}
+	initKernels()
+	C.vector_mul_f32(f32Ptr(a), f32Ptr(b), f32Ptr(dst), C.size_t(len(a)))
+}
+
+// ScaleF32 multiplies all elements by a scalar in-place.
+func ScaleF32(data []float32, scalar float32) {
+	if len(data) == 0 {
+		return
+	}
+	initKernels()
+	C.vector_scale_f32(f32Ptr(data), C.float(scalar), C.size_t(len(data)))
+}
+
+// SumI8 returns the exact sum of all elements.
+func SumI8(data []int8) int64 {
+	if len(data) == 0 {
+		return 0
+	}
+	initKernels()
+	return int64(C.vector_sum_i8(i8Ptr(data), C.size_t(len(data))))
+}
+
+// DotI8 computes the exact dot product of two vectors, using VNNI where
+// the CPU has it.
+func DotI8(a, b []int8) int64 {
+	if len(a) == 0 || len(b) < len(a) {
+		return 0
+	}
+	initKernels()
+	return int64(C.vector_dot_i8(i8Ptr(a), i8Ptr(b), C.size_t(len(a))))
+}
+
+// MulI8 performs widening element-wise multiplication: dst[i] = a[i] * b[i].
+func MulI8(a, b []int8, dst []int16) {
+	if len(a) == 0 || len(b) < len(a) || len(dst) < len(a) {
+		return
+	}
+	C.vector_mul_i8(i8Ptr(a), i8Ptr(b), i16Ptr(dst), C.size_t(len(a)))
+}
+
+// ScaleI8 dequantizes: dst[i] = float32(data[i]) * scalar.
+func ScaleI8(data []int8, scalar float32, dst []float32) {
+	if len(data) == 0 || len(dst) < len(data) {
+		return
+	}
+	C.vector_scale_i8(i8Ptr(data), C.float(scalar), f32Ptr(dst), C.size_t(len(data)))
+}
+
+// SumI16 returns the exact sum of all elements.
+func SumI16(data []int16) int64 {
+	if len(data) == 0 {
+		return 0
+	}
+	initKernels()
+	return int64(C.vector_sum_i16(i16Ptr(data), C.size_t(len(data))))
+}
+
+// DotI16 computes the exact dot product of two vectors.
+func DotI16(a, b []int16) int64 {
+	if len(a) == 0 || len(b) < len(a) {
+		return 0
+	}
+	initKernels()
+	return int64(C.vector_dot_i16(i16Ptr(a), i16Ptr(b), C.size_t(len(a))))
+}
+
+// MulI16 performs widening element-wise multiplication: dst[i] = a[i] * b[i].
+func MulI16(a, b []int16, dst []int32) {
+	if len(a) == 0 || len(b) < len(a) || len(dst) < len(a) {
+		return
+	}
+	C.vector_mul_i16(i16Ptr(a), i16Ptr(b), (*C.int32_t)(unsafe.Pointer(&dst[0])), C.size_t(len(a)))
+}
+
+// ScaleI16 dequantizes: dst[i] = float32(data[i]) * scalar.
+func ScaleI16(data []int16, scalar float32, dst []float32) {
+	if len(data) == 0 || len(dst) < len(data) {
+		return
+	}
+	C.vector_scale_i16(i16Ptr(data), C.float(scalar), f32Ptr(dst), C.size_t(len(data)))
+}
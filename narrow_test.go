@@ -0,0 +1,235 @@
+package ffi
+
+import (
+	"fmt"
+	"math"
+	"math/rand"
+	"testing"
+)
+
+func makeDataF32(n int) []float32 {
+	data := make([]float32, n)
+	for i := range data {
+		data[i] = rand.Float32()
+	}
+	return data
+}
+
+func makeDataI8(n int) []int8 {
+	data := make([]int8, n)
+	for i := range data {
+		data[i] = int8(rand.Intn(256) - 128)
+	}
+	return data
+}
+
+func makeDataI16(n int) []int16 {
+	data := make([]int16, n)
+	for i := range data {
+		data[i] = int16(rand.Intn(65536) - 32768)
+	}
+	return data
+}
+
+// Lengths around every vector width exercise the kernels' main loops and
+// tails; the integer results must be exact
+func TestNarrowKernels(t *testing.T) {
+	defer SetKernels(Kernels())
+
+	for _, k := range kernelNames(t) {
+		if err := SetKernels(k); err != nil {
+			t.Fatalf("SetKernels(%q) failed: %v", k, err)
+		}
+		for n := 1; n <= 130; n++ {
+			a, b := makeDataF32(n), makeDataF32(n)
+			if got, want := SumF32(a), GoSumF32(a); math.Abs(float64(got-want)) > 1e-4*float64(want) {
+				t.Errorf("%s: SumF32(len %d) = %v, want %v", k, n, got, want)
+			}
+			if got, want := DotF32(a, b), GoDotF32(a, b); math.Abs(float64(got-want)) > 1e-4*float64(want) {
+				t.Errorf("%s: DotF32(len %d) = %v, want %v", k, n, got, want)
+			}
+			dst := make([]float32, n+1)
+			dst[n] = -1
+			MulF32(a, b, dst)
+			ScaleF32(dst[:n], 2)
+			for i := 0; i < n; i++ {
+				if dst[i] != a[i]*b[i]*2 {
+					t.Fatalf("%s: MulF32/ScaleF32(len %d)[%d] = %v, want %v", k, n, i, dst[i], a[i]*b[i]*2)
+				}
+			}
+			if dst[n] != -1 {
+				t.Fatalf("%s: MulF32(len %d) wrote past the end", k, n)
+			}
+
+			x, y := makeDataI8(n), makeDataI8(n)
+			var sum8 int64
+			for _, v := range x {
+				sum8 += int64(v)
+			}
+			if got := SumI8(x); got != sum8 {
+				t.Errorf("%s: SumI8(len %d) = %d, want %d", k, n, got, sum8)
+			}
+			if got, want := DotI8(x, y), GoDotI8(x, y); got != want {
+				t.Errorf("%s: DotI8(len %d) = %d, want %d", k, n, got, want)
+			}
+
+			p, q := makeDataI16(n), makeDataI16(n)
+			var sum16 int64
+			for _, v := range p {
+				sum16 += int64(v)
+			}
+			if got := SumI16(p); got != sum16 {
+				t.Errorf("%s: SumI16(len %d) = %d, want %d", k, n, got, sum16)
+			}
+			if got, want := DotI16(p, q), GoDotI16(p, q); got != want {
+				t.Errorf("%s: DotI16(len %d) = %d, want %d", k, n, got, want)
+			}
+		}
+	}
+}
+
+// Long runs of the most negative values would overflow int32 lanes that
+// were not flushed in time, or int16 pairs at 2 * (-32768)^2
+func TestNarrowKernelsOverflow(t *testing.T) {
+	defer SetKernels(Kernels())
+
+	const n = 300001
+	x := make([]int8, n)
+	p := make([]int16, n)
+	for i := range x {
+		x[i], p[i] = -128, -32768
+	}
+
+	for _, k := range kernelNames(t) {
+		SetKernels(k)
+		if got, want := SumI8(x), int64(-128*n); got != want {
+			t.Errorf("%s: SumI8 = %d, want %d", k, got, want)
+		}
+		if got, want := DotI8(x, x), int64(128*128*n); got != want {
+			t.Errorf("%s: DotI8 = %d, want %d", k, got, want)
+		}
+		if got, want := SumI16(p), int64(-32768*n); got != want {
+			t.Errorf("%s: SumI16 = %d, want %d", k, got, want)
+		}
+		if got, want := DotI16(p, p), int64(32768*32768*n); got != want {
+			t.Errorf("%s: DotI16 = %d, want %d", k, got, want)
+		}
+	}
+}
+
+func TestNarrowWidening(t *testing.T) {
+	x, y := makeDataI8(100), makeDataI8(100)
+	prod8 := make([]int16, 100)
+	MulI8(x, y, prod8)
+	deq := make([]float32, 100)
+	ScaleI8(x, 0.5, deq)
+	for i := range x {
+		if prod8[i] != int16(x[i])*int16(y[i]) {
+			t.Fatalf("MulI8[%d] = %d, want %d", i, prod8[i], int16(x[i])*int16(y[i]))
+		}
+		if deq[i] != float32(x[i])*0.5 {
+			t.Fatalf("ScaleI8[%d] = %v, want %v", i, deq[i], float32(x[i])*0.5)
+		}
+	}
+
+	p, q := makeDataI16(100), makeDataI16(100)
+	prod16 := make([]int32, 100)
+	MulI16(p, q, prod16)
+	ScaleI16(p, 0.25, deq)
+	for i := range p {
+		if prod16[i] != int32(p[i])*int32(q[i]) {
+			t.Fatalf("MulI16[%d] = %d, want %d", i, prod16[i], int32(p[i])*int32(q[i]))
+		}
+		if deq[i] != float32(p[i])*0.25 {
+			t.Fatalf("ScaleI16[%d] = %v, want %v", i, deq[i], float32(p[i])*0.25)
+		}
+	}
+}
+
+// BenchmarkDot for narrow types, alongside the float64 ones in ffi_test.go.
+// SetBytes counts input bytes, so MB/s compares bandwidth across types.
+func BenchmarkDot_Go_F32_100000(b *testing.B) { benchmarkGoDotF32(b, 100000) }
+func BenchmarkDot_C_F32_1000(b *testing.B)    { benchmarkCDotF32(b, 1000) }
+func BenchmarkDot_C_F32_100000(b *testing.B)  { benchmarkCDotF32(b, 100000) }
+func BenchmarkDot_Go_I8_100000(b *testing.B)  { benchmarkGoDotI8(b, 100000) }
+func BenchmarkDot_C_I8_1000(b *testing.B)     { benchmarkCDotI8(b, 1000) }
+func BenchmarkDot_C_I8_100000(b *testing.B)   { benchmarkCDotI8(b, 100000) }
+func BenchmarkDot_C_I16_100000(b *testing.B)  { benchmarkCDotI16(b, 100000) }
+
+func benchmarkGoDotF32(b *testing.B, n int) {
+	x, y := makeDataF32(n), makeDataF32(n)
+	b.SetBytes(int64(8 * n))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		_ = GoDotF32(x, y)
+	}
+}
+
+func benchmarkCDotF32(b *testing.B, n int) {
+	x, y := makeDataF32(n), makeDataF32(n)
+	b.SetBytes(int64(8 * n))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		_ = DotF32(x, y)
+	}
+}
+
+func benchmarkGoDotI8(b *testing.B, n int) {
+	x, y := makeDataI8(n), makeDataI8(n)
+	b.SetBytes(int64(2 * n))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		_ = GoDotI8(x, y)
+	}
+}
+
+func benchmarkCDotI8(b *testing.B, n int) {
+	x, y := makeDataI8(n), makeDataI8(n)
+	b.SetBytes(int64(2 * n))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		_ = DotI8(x, y)
+	}
+}
+
+func benchmarkCDotI16(b *testing.B, n int) {
+	x, y := makeDataI16(n), makeDataI16(n)
+	b.SetBytes(int64(4 * n))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		_ = DotI16(x, y)
+	}
+}
+
+// Narrow dot products per kernel set on this CPU, like BenchmarkKernels
+func BenchmarkNarrowKernels(b *testing.B) {
+	defer SetKernels(Kernels())
+	const n = 100000
+	f, g := makeDataF32(n), makeDataF32(n)
+	x, y := makeDataI8(n), makeDataI8(n)
+	p, q := makeDataI16(n), makeDataI16(n)
+
+	for _, k := range kernelNames(b) {
+		b.Run(fmt.Sprintf("DotF32/%s", k), func(b *testing.B) {
+			SetKernels(k)
+			b.SetBytes(8 * n)
+			for i := 0; i < b.N; i++ {
+				DotF32(f, g)
+			}
+		})
+		b.Run(fmt.Sprintf("DotI8/%s", k), func(b *testing.B) {
+			SetKernels(k)
+			b.SetBytes(2 * n)
+			for i := 0; i < b.N; i++ {
+				DotI8(x, y)
+			}
+		})
+		b.Run(fmt.Sprintf("DotI16/%s", k), func(b *testing.B) {
+			SetKernels(k)
+			b.SetBytes(4 * n)
+			for i := 0; i < b.N; i++ {
+				DotI16(p, q)
+			}
+		})
+	}
+}
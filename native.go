@@ -102,3 +102,42 @@ func GoScale(data []float64, scalar float64) {
 		data[i] *= scalar
 	}
 }
+
+// GoSumF32 computes a float32 sum using pure Go.
+func GoSumF32(data []float32) float32 {
+	var sum float32
+	for _, v := range data {
+		sum += v
+	}
+	return sum
+}
+
+// GoDotF32 computes a float32 dot product using pure Go.
+func GoDotF32(a, b []float32) float32 {
+	var dot float32
+	n := min(len(a), len(b))
+	for i := 0; i < n; i++ {
+		dot += a[i] * b[i]
+	}
+	return dot
+}
+
+// GoDotI8 computes an exact int8 dot product using pure Go.
+func GoDotI8(a, b []int8) int64 {
+	var dot int64
+	n := min(len(a), len(b))
+	for i := 0; i < n; i++ {
+		dot += int64(a[i]) * int64(b[i])
+	}
+	return dot
+}
+
+// GoDotI16 computes an exact int16 dot product using pure Go.
+func GoDotI16(a, b []int16) int64 {
+	var dot int64
+	n := min(len(a), len(b))
+	for i := 0; i < n; i++ {
+		dot += int64(a[i]) * int64(b[i])
+	}
+	return dot
+}
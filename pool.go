@@ -0,0 +1,98 @@
+package ffi
+
+import (
+	"runtime"
+	"sync/atomic"
+)
+
+// VectorOpsPool spreads vector operations across several VectorOps.
+//
+// A single VectorOps serializes every caller on one mutex around its
+// pinned buffers. The pool holds one VectorOps (and so one pinned buffer
+// set) per shard, and each call checks out a free shard, so concurrent
+// callers run in parallel instead of queueing.
+type VectorOpsPool struct {
+	shards []*VectorOps
+	next   atomic.Uint32
+}
+
+// NewVectorOpsPool creates a pool of size VectorOps, each with buffers for
+// capacity elements. A size <= 0 uses runtime.GOMAXPROCS(0), i.e. one
+// buffer set per P.
+func NewVectorOpsPool(capacity, size int) *VectorOpsPool {
+	if size <= 0 {
+		size = runtime.GOMAXPROCS(0)
+	}
+	p := &VectorOpsPool{shards: make([]*VectorOps, size)}
+	for i := range p.shards {
+		p.shards[i] = NewVectorOps(capacity)
+	}
+	return p
+}
+
+// acquire returns a locked shard; the caller must unlock v.mu.
+// Shards are tried without blocking from a rotating start position,
+// so uncontended checkout is one atomic add and one uncontended TryLock.
+func (p *VectorOpsPool) acquire() *VectorOps {
+	n := uint32(len(p.shards))
+	start := p.next.Add(1)
+	for i := uint32(0); i < n; i++ {
+		v := p.shards[(start+i)%n]
+		if v.mu.TryLock() {
+			return v
+		}
+	}
+
+	// Every shard is busy - wait on our slot
+	v := p.shards[start%n]
+	v.mu.Lock()
+	return v
+}
+
+// Size returns the number of shards.
+func (p *VectorOpsPool) Size() int {
+	return len(p.shards)
+}
+
+// Sum returns the sum of all elements.
+func (p *VectorOpsPool) Sum(data []float64) float64 {
+	v := p.acquire()
+	defer v.mu.Unlock()
+	return v.sumLocked(data)
+}
+
+// Dot computes the dot product of two vectors.
+func (p *VectorOpsPool) Dot(a, b []float64) float64 {
+	v := p.acquire()
+	defer v.mu.Unlock()
+	return v.dotLocked(a, b)
+}
+
+// Mul performs element-wise multiplication and returns a new slice.
+func (p *VectorOpsPool) Mul(a, b []float64) []float64 {
+	v := p.acquire()
+	defer v.mu.Unlock()
+	return v.mulLocked(a, b)
+}
+
+// MulInto performs element-wise multiplication into dst.
+func (p *VectorOpsPool) MulInto(a, b, dst []float64) {
+	v := p.acquire()
+	defer v.mu.Unlock()
+	v.mulIntoLocked(a, b, dst)
+}
+
+// Scale multiplies all elements by a scalar in-place.
+func (p *VectorOpsPool) Scale(data []float64, scalar float64) {
+	v := p.acquire()
+	defer v.mu.Unlock()
+	v.scaleLocked(data, scalar)
+}
+
+// Close releases every shard's pinned memory.
+func (p *VectorOpsPool) Close() {
+	for _, v := range p.shards {
+		v.Close()
+	}
+	p.shards = nil
+}
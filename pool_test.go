@@ -0,0 +1,127 @@
+package ffi
+
+import (
+	"fmt"
+	"math"
+	"runtime"
+	"sync"
+	"testing"
+)
+
+func TestVectorOpsPool_Concurrent(t *testing.T) {
+	pool := NewVectorOpsPool(100, 4)
+	defer pool.Close()
+
+	if pool.Size() != 4 {
+		t.Errorf("Size() = %d, want 4", pool.Size())
+	}
+
+	// More goroutines than shards so checkout has to wait; lengths vary so
+	// shards also grow while others are in use
+	var wg sync.WaitGroup
+	for g := 0; g < 16; g++ {
+		wg.Add(1)
+		go func(g int) {
+			defer wg.Done()
+			a, b := makeData(10+g*100), makeData(10+g*100)
+			wantSum, wantDot := GoSum(a), GoDot(a, b)
+			for i := 0; i < 100; i++ {
+				if got := pool.Sum(a); math.Abs(got-wantSum) > 1e-9*wantSum {
+					t.Errorf("pool.Sum = %v, want %v", got, wantSum)
+					return
+				}
+				if got := pool.Dot(a, b); math.Abs(got-wantDot) > 1e-9*wantDot {
+					t.Errorf("pool.Dot = %v, want %v", got, wantDot)
+					return
+				}
+			}
+		}(g)
+	}
+	wg.Wait()
+}
+
+func TestVectorOpsPool_DefaultSize(t *testing.T) {
+	pool := NewVectorOpsPool(10, 0)
+	defer pool.Close()
+	if pool.Size() != runtime.GOMAXPROCS(0) {
+		t.Errorf("Size() = %d, want GOMAXPROCS %d", pool.Size(), runtime.GOMAXPROCS(0))
+	}
+
+	a, b := makeData(10), makeData(10)
+	dst := make([]float64, 10)
+	pool.MulInto(a, b, dst)
+	want := GoMul(a, b)
+	for i := range want {
+		if dst[i] != want[i] {
+			t.Fatalf("MulInto[%d] = %v, want %v", i, dst[i], want[i])
+		}
+	}
+}
+
+// BenchmarkParallel runs Sum and Dot from GOMAXPROCS goroutines against one
+// VectorOps (every call on one mutex), a pool, and the lock-free Direct and
+// PinnedVec paths. Run with -cpu 1,2,4,8 to see how each scales.
+func BenchmarkParallel(b *testing.B) {
+	for _, n := range []int{1000, 100000} {
+		x, y := makeData(n), makeData(n)
+
+		b.Run(fmt.Sprintf("Sum/Single/%d", n), func(b *testing.B) {
+			ops := NewVectorOps(n)
+			defer ops.Close()
+			b.SetBytes(int64(8 * n))
+			b.RunParallel(func(pb *testing.PB) {
+				for pb.Next() {
+					_ = ops.Sum(x)
+				}
+			})
+		})
+		b.Run(fmt.Sprintf("Sum/Pool/%d", n), func(b *testing.B) {
+			pool := NewVectorOpsPool(n, 0)
+			defer pool.Close()
+			b.SetBytes(int64(8 * n))
+			b.RunParallel(func(pb *testing.PB) {
+				for pb.Next() {
+					_ = pool.Sum(x)
+				}
+			})
+		})
+		b.Run(fmt.Sprintf("Sum/Direct/%d", n), func(b *testing.B) {
+			b.SetBytes(int64(8 * n))
+			b.RunParallel(func(pb *testing.PB) {
+				for pb.Next() {
+					_ = DirectSum(x)
+				}
+			})
+		})
+		b.Run(fmt.Sprintf("Sum/Pinned/%d", n), func(b *testing.B) {
+			p := PinSlice(x)
+			defer p.Unpin()
+			b.SetBytes(int64(8 * n))
+			b.RunParallel(func(pb *testing.PB) {
+				for pb.Next() {
+					_ = p.Sum()
+				}
+			})
+		})
+		b.Run(fmt.Sprintf("Dot/Single/%d", n), func(b *testing.B) {
+			ops := NewVectorOps(n)
+			defer ops.Close()
+			b.SetBytes(int64(16 * n))
+			b.RunParallel(func(pb *testing.PB) {
+				for pb.Next() {
+					_ = ops.Dot(x, y)
+				}
+			})
+		})
+		b.Run(fmt.Sprintf("Dot/Pool/%d", n), func(b *testing.B) {
+			pool := NewVectorOpsPool(n, 0)
+			defer pool.Close()
+			b.SetBytes(int64(16 * n))
+			b.RunParallel(func(pb *testing.PB) {
+				for pb.Next() {
+					_ = pool.Dot(x, y)
+				}
+			})
+		})
+	}
+}
@@ -1,56 +1,1634 @@
 // vector.c - C implementations of vector operations
+//
+// Each operation has a portable kernel plus explicit SIMD kernels for
+// AVX2+FMA and AVX-512F (x86-64) and NEON (arm64), for float64, float32,
+// int8 and int16 data; AVX-512 CPUs with VNNI and arm64 CPUs with the
+// dot-product extension get int8 dot products built on vpdpbusd and sdot.
+// The SIMD kernels are compiled with target attributes, so the file builds
+// without -march flags and one binary runs everywhere; vector_init picks the
+// widest kernels the CPU supports. Until it runs, every call uses the
+// portable kernels.
 #include "vector.h"
 
-// Simple sum
-double vector_sum(const double* arr, size_t len) {
-    double sum = 0.0;
-    for (size_t i = 0; i < len; i++) {
-        sum += arr[i];
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define VECTOR_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define VECTOR_NEON 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_ASIMDDP
+#define HWCAP_ASIMDDP (1 << 20)
+#endif
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+#endif
+
+// --- Portable kernels ---
+
+// Four independent accumulators hide FP add latency
+static double sum_generic(const double* arr, size_t len) {
+    double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+    size_t i = 0;
+
+    // Process 4 elements at a time
+    for (; i + 3 < len; i += 4) {
+        sum0 += arr[i];
+        sum1 += arr[i + 1];
+        sum2 += arr[i + 2];
+        sum3 += arr[i + 3];
     }
-    return sum;
+
+    // Handle remainder
+    for (; i < len; i++) {
+        sum0 += arr[i];
+    }
+
+    return (sum0 + sum1) + (sum2 + sum3);
 }
 
-// Dot product
-double vector_dot(const double* a, const double* b, size_t len) {
-    double dot = 0.0;
+static double dot_generic(const double* a, const double* b, size_t len) {
+    double dot0 = 0.0, dot1 = 0.0, dot2 = 0.0, dot3 = 0.0;
+    size_t i = 0;
+
+    for (; i + 3 < len; i += 4) {
+        dot0 += a[i] * b[i];
+        dot1 += a[i + 1] * b[i + 1];
+        dot2 += a[i + 2] * b[i + 2];
+        dot3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < len; i++) {
+        dot0 += a[i] * b[i];
+    }
+
+    return (dot0 + dot1) + (dot2 + dot3);
+}
+
+// dot4 kernels score four rows of a matrix (stride elements apart) against
+// one query: out[j] = dot(q, m + j*stride). Each query load serves all four
+// rows, and the four rows are independent accumulator chains.
+static void dot4_generic(const double* q, const double* m, size_t stride, size_t len, double* out) {
+    const double *r0 = m, *r1 = m + stride, *r2 = r1 + stride, *r3 = r2 + stride;
+    double d0 = 0.0, d1 = 0.0, d2 = 0.0, d3 = 0.0;
+
     for (size_t i = 0; i < len; i++) {
-        dot += a[i] * b[i];
+        double x = q[i];
+        d0 += x * r0[i];
+        d1 += x * r1[i];
+        d2 += x * r2[i];
+        d3 += x * r3[i];
     }
-    return dot;
+    out[0] = d0;
+    out[1] = d1;
+    out[2] = d2;
+    out[3] = d3;
 }
 
-// Element-wise multiply
-void vector_mul(const double* a, const double* b, double* result, size_t len) {
+static void mul_generic(const double* a, const double* b, double* result, size_t len) {
     for (size_t i = 0; i < len; i++) {
         result[i] = a[i] * b[i];
     }
 }
 
-// Scale in-place
-void vector_scale(double* arr, double scalar, size_t len) {
+static void scale_generic(double* arr, double scalar, size_t len) {
     for (size_t i = 0; i < len; i++) {
         arr[i] *= scalar;
     }
 }
 
-// SIMD-optimized sum using loop unrolling
-// Compilers with -O2/-O3 will auto-vectorize this
-double vector_sum_simd(const double* arr, size_t len) {
-    double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
-    size_t i = 0;
+// float32 and integer kernels. Integer sums and dot products are exact:
+// lanes accumulate in int32 (or int16 where that is safe) and are widened
+// into an int64 total at least every NARROW_BLOCK elements, before a lane
+// could overflow. Integer mul widens (int8 -> int16, int16 -> int32) and
+// scale dequantizes to float32; those loops are store-bound, so no
+// explicit SIMD versions exist: the compiler vectorizes them for the
+// baseline ISA.
+#define NARROW_BLOCK 65536
 
-    // Process 4 elements at a time
+static float sum_f32_generic(const float* arr, size_t len) {
+    float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+    size_t i = 0;
     for (; i + 3 < len; i += 4) {
         sum0 += arr[i];
         sum1 += arr[i + 1];
         sum2 += arr[i + 2];
         sum3 += arr[i + 3];
     }
-
-    // Handle remainder
     for (; i < len; i++) {
         sum0 += arr[i];
     }
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
+static float dot_f32_generic(const float* a, const float* b, size_t len) {
+    float dot0 = 0.0f, dot1 = 0.0f, dot2 = 0.0f, dot3 = 0.0f;
+    size_t i = 0;
+    for (; i + 3 < len; i += 4) {
+        dot0 += a[i] * b[i];
+        dot1 += a[i + 1] * b[i + 1];
+        dot2 += a[i + 2] * b[i + 2];
+        dot3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < len; i++) {
+        dot0 += a[i] * b[i];
+    }
+    return (dot0 + dot1) + (dot2 + dot3);
+}
+
+static void mul_f32_generic(const float* a, const float* b, float* result, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        result[i] = a[i] * b[i];
+    }
+}
+
+static void scale_f32_generic(float* arr, float scalar, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        arr[i] *= scalar;
+    }
+}
+
+static int64_t sum_i8_generic(const int8_t* arr, size_t len) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < len; i++) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+static int64_t dot_i8_generic(const int8_t* a, const int8_t* b, size_t len) {
+    int64_t dot = 0;
+    for (size_t off = 0; off < len; off += NARROW_BLOCK) {
+        size_t end = len - off < NARROW_BLOCK ? len : off + NARROW_BLOCK;
+        int32_t d = 0;
+        for (size_t i = off; i < end; i++) {
+            d += (int32_t)a[i] * b[i];
+        }
+        dot += d;
+    }
+    return dot;
+}
+
+static int64_t sum_i16_generic(const int16_t* arr, size_t len) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < len; i++) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+static int64_t dot_i16_generic(const int16_t* a, const int16_t* b, size_t len) {
+    int64_t dot = 0;
+    for (size_t i = 0; i < len; i++) {
+        dot += (int32_t)a[i] * b[i];
+    }
+    return dot;
+}
+
+static void mul_i8_generic(const int8_t* a, const int8_t* b, int16_t* result, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        result[i] = (int16_t)(a[i] * b[i]);
+    }
+}
+
+static void mul_i16_generic(const int16_t* a, const int16_t* b, int32_t* result, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        result[i] = (int32_t)a[i] * b[i];
+    }
+}
+
+static void scale_i8_generic(const int8_t* arr, float scalar, float* result, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        result[i] = (float)arr[i] * scalar;
+    }
+}
+
+static void scale_i16_generic(const int16_t* arr, float scalar, float* result, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        result[i] = (float)arr[i] * scalar;
+    }
+}
+
+// --- AVX2 + FMA: 4 doubles per vector, 4 accumulators ---
+
+#ifdef VECTOR_X86
+#define AVX2 __attribute__((target("avx2,fma")))
+
+AVX2 static double hsum256(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+AVX2 static double sum_avx2(const double* arr, size_t len) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        s0 = _mm256_add_pd(s0, _mm256_loadu_pd(arr + i));
+        s1 = _mm256_add_pd(s1, _mm256_loadu_pd(arr + i + 4));
+        s2 = _mm256_add_pd(s2, _mm256_loadu_pd(arr + i + 8));
+        s3 = _mm256_add_pd(s3, _mm256_loadu_pd(arr + i + 12));
+    }
+    for (; i + 4 <= len; i += 4) {
+        s0 = _mm256_add_pd(s0, _mm256_loadu_pd(arr + i));
+    }
+
+    double sum = hsum256(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+    for (; i < len; i++) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+AVX2 static double dot_avx2(const double* a, const double* b, size_t len) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+        s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), s2);
+        s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), s3);
+    }
+    for (; i + 4 <= len; i += 4) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+    }
+
+    double dot = hsum256(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+    for (; i < len; i++) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+}
+
+AVX2 static void dot4_avx2(const double* q, const double* m, size_t stride, size_t len, double* out) {
+    const double *r0 = m, *r1 = m + stride, *r2 = r1 + stride, *r3 = r2 + stride;
+    __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    __m256d t0 = s0, t1 = s0, t2 = s0, t3 = s0;
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        __m256d x = _mm256_loadu_pd(q + i), y = _mm256_loadu_pd(q + i + 4);
+        s0 = _mm256_fmadd_pd(x, _mm256_loadu_pd(r0 + i), s0);
+        s1 = _mm256_fmadd_pd(x, _mm256_loadu_pd(r1 + i), s1);
+        s2 = _mm256_fmadd_pd(x, _mm256_loadu_pd(r2 + i), s2);
+        s3 = _mm256_fmadd_pd(x, _mm256_loadu_pd(r3 + i), s3);
+        t0 = _mm256_fmadd_pd(y, _mm256_loadu_pd(r0 + i + 4), t0);
+        t1 = _mm256_fmadd_pd(y, _mm256_loadu_pd(r1 + i + 4), t1);
+        t2 = _mm256_fmadd_pd(y, _mm256_loadu_pd(r2 + i + 4), t2);
+        t3 = _mm256_fmadd_pd(y, _mm256_loadu_pd(r3 + i + 4), t3);
+    }
+    if (i + 4 <= len) {
+        __m256d x = _mm256_loadu_pd(q + i);
+        s0 = _mm256_fmadd_pd(x, _mm256_loadu_pd(r0 + i), s0);
+        s1 = _mm256_fmadd_pd(x, _mm256_loadu_pd(r1 + i), s1);
+        s2 = _mm256_fmadd_pd(x, _mm256_loadu_pd(r2 + i), s2);
+        s3 = _mm256_fmadd_pd(x, _mm256_loadu_pd(r3 + i), s3);
+        i += 4;
+    }
+
+    double d0 = hsum256(_mm256_add_pd(s0, t0)), d1 = hsum256(_mm256_add_pd(s1, t1));
+    double d2 = hsum256(_mm256_add_pd(s2, t2)), d3 = hsum256(_mm256_add_pd(s3, t3));
+    for (; i < len; i++) {
+        d0 += q[i] * r0[i];
+        d1 += q[i] * r1[i];
+        d2 += q[i] * r2[i];
+        d3 += q[i] * r3[i];
+    }
+    out[0] = d0;
+    out[1] = d1;
+    out[2] = d2;
+    out[3] = d3;
+}
+
+AVX2 static void mul_avx2(const double* a, const double* b, double* result, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        _mm256_storeu_pd(result + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        _mm256_storeu_pd(result + i + 4, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+    }
+    for (; i < len; i++) {
+        result[i] = a[i] * b[i];
+    }
+}
+
+AVX2 static void scale_avx2(double* arr, double scalar, size_t len) {
+    __m256d s = _mm256_set1_pd(scalar);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        _mm256_storeu_pd(arr + i, _mm256_mul_pd(_mm256_loadu_pd(arr + i), s));
+        _mm256_storeu_pd(arr + i + 4, _mm256_mul_pd(_mm256_loadu_pd(arr + i + 4), s));
+    }
+    for (; i < len; i++) {
+        arr[i] *= scalar;
+    }
+}
+
+// float32 on AVX2: 8 floats per vector
+
+AVX2 static float hsum256_ps(__m256 v) {
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    return _mm_cvtss_f32(_mm_add_ss(lo, _mm_movehdup_ps(lo)));
+}
+
+AVX2 static int64_t hsum256_epi64(__m256i v) {
+    __m128i lo = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(_mm_add_epi64(lo, _mm_unpackhi_epi64(lo, lo)));
+}
+
+// Sign-extends the int32 lanes of v and adds them to the int64 lanes of acc
+AVX2 static __m256i widen_add256(__m256i acc, __m256i v) {
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+    return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+}
+
+AVX2 static float sum_f32_avx2(const float* arr, size_t len) {
+    __m256 s0 = _mm256_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        s0 = _mm256_add_ps(s0, _mm256_loadu_ps(arr + i));
+        s1 = _mm256_add_ps(s1, _mm256_loadu_ps(arr + i + 8));
+        s2 = _mm256_add_ps(s2, _mm256_loadu_ps(arr + i + 16));
+        s3 = _mm256_add_ps(s3, _mm256_loadu_ps(arr + i + 24));
+    }
+    for (; i + 8 <= len; i += 8) {
+        s0 = _mm256_add_ps(s0, _mm256_loadu_ps(arr + i));
+    }
+
+    float sum = hsum256_ps(_mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+    for (; i < len; i++) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+AVX2 static float dot_f32_avx2(const float* a, const float* b, size_t len) {
+    __m256 s0 = _mm256_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+        s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), s1);
+        s2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), s2);
+        s3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), s3);
+    }
+    for (; i + 8 <= len; i += 8) {
+        s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+    }
+
+    float dot = hsum256_ps(_mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3)));
+    for (; i < len; i++) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+}
+
+AVX2 static void mul_f32_avx2(const float* a, const float* b, float* result, size_t len) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        _mm256_storeu_ps(result + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        _mm256_storeu_ps(result + i + 8, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    for (; i < len; i++) {
+        result[i] = a[i] * b[i];
+    }
+}
+
+AVX2 static void scale_f32_avx2(float* arr, float scalar, size_t len) {
+    __m256 s = _mm256_set1_ps(scalar);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        _mm256_storeu_ps(arr + i, _mm256_mul_ps(_mm256_loadu_ps(arr + i), s));
+        _mm256_storeu_ps(arr + i + 8, _mm256_mul_ps(_mm256_loadu_ps(arr + i + 8), s));
+    }
+    for (; i < len; i++) {
+        arr[i] *= scalar;
+    }
+}
+
+// int8 and int16 on AVX2
+
+// Flipping the sign bit maps int8 x to uint8 x + 128, which psadbw sums
+// into 64-bit lanes; the bias comes off at the end
+AVX2 static int64_t sum_i8_avx2(const int8_t* arr, size_t len) {
+    const __m256i bias = _mm256_set1_epi8((char)0x80), zero = _mm256_setzero_si256();
+    __m256i s = zero;
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(arr + i)), bias);
+        s = _mm256_add_epi64(s, _mm256_sad_epu8(x, zero));
+    }
+
+    int64_t sum = hsum256_epi64(s) - 128 * (int64_t)i;
+    for (; i < len; i++) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+// pmaddwd on sign-extended bytes: each int32 lane gains at most 2 * 128^2
+// per step, so lanes are flushed every NARROW_BLOCK elements
+AVX2 static int64_t dot_i8_avx2(const int8_t* a, const int8_t* b, size_t len) {
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+
+    while (i + 32 <= len) {
+        size_t end = len - i > NARROW_BLOCK ? i + NARROW_BLOCK : len;
+        __m256i d0 = _mm256_setzero_si256(), d1 = d0;
+        for (; i + 32 <= end; i += 32) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+            __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+            d0 = _mm256_add_epi32(d0, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm256_castsi256_si128(x)),
+                                                        _mm256_cvtepi8_epi16(_mm256_castsi256_si128(y))));
+            d1 = _mm256_add_epi32(d1, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm256_extracti128_si256(x, 1)),
+                                                        _mm256_cvtepi8_epi16(_mm256_extracti128_si256(y, 1))));
+        }
+        total = widen_add256(widen_add256(total, d0), d1);
+    }
+
+    int64_t dot = hsum256_epi64(total);
+    for (; i < len; i++) {
+        dot += (int32_t)a[i] * b[i];
+    }
+    return dot;
+}
+
+AVX2 static int64_t sum_i16_avx2(const int16_t* arr, size_t len) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+
+    while (i + 16 <= len) {
+        size_t end = len - i > NARROW_BLOCK ? i + NARROW_BLOCK : len;
+        __m256i s = _mm256_setzero_si256();
+        for (; i + 16 <= end; i += 16) {
+            s = _mm256_add_epi32(s, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(arr + i)), ones));
+        }
+        total = widen_add256(total, s);
+    }
+
+    int64_t sum = hsum256_epi64(total);
+    for (; i < len; i++) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+// A pmaddwd lane holds a pair of int16 products, which fits int32 except
+// for 2 * (-32768)^2 = 2^31. That wraps to INT32_MIN, a value no pair can
+// produce otherwise, so such lanes are counted and 2^32 added back for each.
+AVX2 static int64_t dot_i16_avx2(const int16_t* a, const int16_t* b, size_t len) {
+    const __m256i min32 = _mm256_set1_epi32(INT32_MIN);
+    __m256i total = _mm256_setzero_si256(), wrapped = total;
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        __m256i p = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                      _mm256_loadu_si256((const __m256i*)(b + i)));
+        total = widen_add256(total, p);
+        wrapped = _mm256_sub_epi32(wrapped, _mm256_cmpeq_epi32(p, min32));
+    }
+
+    wrapped = widen_add256(_mm256_setzero_si256(), wrapped);
+    int64_t dot = hsum256_epi64(total) + hsum256_epi64(wrapped) * ((int64_t)1 << 32);
+    for (; i < len; i++) {
+        dot += (int32_t)a[i] * b[i];
+    }
+    return dot;
+}
+
+// --- AVX-512F: 8 doubles per vector, masked tails ---
+
+#define AVX512 __attribute__((target("avx512f")))
+
+// Mask selecting the low n (< 8) lanes
+#define TAIL_MASK(n) ((__mmask8)((1u << (n)) - 1))
+
+AVX512 static double sum_avx512(const double* arr, size_t len) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        s0 = _mm512_add_pd(s0, _mm512_loadu_pd(arr + i));
+        s1 = _mm512_add_pd(s1, _mm512_loadu_pd(arr + i + 8));
+        s2 = _mm512_add_pd(s2, _mm512_loadu_pd(arr + i + 16));
+        s3 = _mm512_add_pd(s3, _mm512_loadu_pd(arr + i + 24));
+    }
+    for (; i + 8 <= len; i += 8) {
+        s0 = _mm512_add_pd(s0, _mm512_loadu_pd(arr + i));
+    }
+    if (i < len) {
+        s1 = _mm512_add_pd(s1, _mm512_maskz_loadu_pd(TAIL_MASK(len - i), arr + i));
+    }
+
+    return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+}
+
+AVX512 static double dot_avx512(const double* a, const double* b, size_t len) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+        s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), s1);
+        s2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), s2);
+        s3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), s3);
+    }
+    for (; i + 8 <= len; i += 8) {
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+    }
+    if (i < len) {
+        __mmask8 m = TAIL_MASK(len - i);
+        s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i), s1);
+    }
+
+    return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+}
+
+AVX512 static void dot4_avx512(const double* q, const double* m, size_t stride, size_t len, double* out) {
+    const double *r0 = m, *r1 = m + stride, *r2 = r1 + stride, *r3 = r2 + stride;
+    __m512d s0 = _mm512_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    __m512d t0 = s0, t1 = s0, t2 = s0, t3 = s0;
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        __m512d x = _mm512_loadu_pd(q + i), y = _mm512_loadu_pd(q + i + 8);
+        s0 = _mm512_fmadd_pd(x, _mm512_loadu_pd(r0 + i), s0);
+        s1 = _mm512_fmadd_pd(x, _mm512_loadu_pd(r1 + i), s1);
+        s2 = _mm512_fmadd_pd(x, _mm512_loadu_pd(r2 + i), s2);
+        s3 = _mm512_fmadd_pd(x, _mm512_loadu_pd(r3 + i), s3);
+        t0 = _mm512_fmadd_pd(y, _mm512_loadu_pd(r0 + i + 8), t0);
+        t1 = _mm512_fmadd_pd(y, _mm512_loadu_pd(r1 + i + 8), t1);
+        t2 = _mm512_fmadd_pd(y, _mm512_loadu_pd(r2 + i + 8), t2);
+        t3 = _mm512_fmadd_pd(y, _mm512_loadu_pd(r3 + i + 8), t3);
+    }
+    for (; i < len; i += 8) {
+        __mmask8 k = len - i >= 8 ? 0xff : TAIL_MASK(len - i);
+        __m512d x = _mm512_maskz_loadu_pd(k, q + i);
+        s0 = _mm512_fmadd_pd(x, _mm512_maskz_loadu_pd(k, r0 + i), s0);
+        s1 = _mm512_fmadd_pd(x, _mm512_maskz_loadu_pd(k, r1 + i), s1);
+        s2 = _mm512_fmadd_pd(x, _mm512_maskz_loadu_pd(k, r2 + i), s2);
+        s3 = _mm512_fmadd_pd(x, _mm512_maskz_loadu_pd(k, r3 + i), s3);
+    }
+
+    out[0] = _mm512_reduce_add_pd(_mm512_add_pd(s0, t0));
+    out[1] = _mm512_reduce_add_pd(_mm512_add_pd(s1, t1));
+    out[2] = _mm512_reduce_add_pd(_mm512_add_pd(s2, t2));
+    out[3] = _mm512_reduce_add_pd(_mm512_add_pd(s3, t3));
+}
+
+AVX512 static void mul_avx512(const double* a, const double* b, double* result, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        _mm512_storeu_pd(result + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    if (i < len) {
+        __mmask8 m = TAIL_MASK(len - i);
+        __m512d p = _mm512_mul_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i));
+        _mm512_mask_storeu_pd(result + i, m, p);
+    }
+}
+
+AVX512 static void scale_avx512(double* arr, double scalar, size_t len) {
+    __m512d s = _mm512_set1_pd(scalar);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        _mm512_storeu_pd(arr + i, _mm512_mul_pd(_mm512_loadu_pd(arr + i), s));
+    }
+    if (i < len) {
+        __mmask8 m = TAIL_MASK(len - i);
+        _mm512_mask_storeu_pd(arr + i, m, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, arr + i), s));
+    }
+}
+
+// float32 on AVX-512F: 16 floats per vector, masked tails
+
+#define TAIL_MASK16(n) ((__mmask16)((1u << (n)) - 1))
+
+AVX512 static float sum_f32_avx512(const float* arr, size_t len) {
+    __m512 s0 = _mm512_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        s0 = _mm512_add_ps(s0, _mm512_loadu_ps(arr + i));
+        s1 = _mm512_add_ps(s1, _mm512_loadu_ps(arr + i + 16));
+        s2 = _mm512_add_ps(s2, _mm512_loadu_ps(arr + i + 32));
+        s3 = _mm512_add_ps(s3, _mm512_loadu_ps(arr + i + 48));
+    }
+    for (; i + 16 <= len; i += 16) {
+        s0 = _mm512_add_ps(s0, _mm512_loadu_ps(arr + i));
+    }
+    if (i < len) {
+        s1 = _mm512_add_ps(s1, _mm512_maskz_loadu_ps(TAIL_MASK16(len - i), arr + i));
+    }
+
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(s0, s1), _mm512_add_ps(s2, s3)));
+}
+
+AVX512 static float dot_f32_avx512(const float* a, const float* b, size_t len) {
+    __m512 s0 = _mm512_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        s0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), s0);
+        s1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), s1);
+        s2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 32), _mm512_loadu_ps(b + i + 32), s2);
+        s3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 48), _mm512_loadu_ps(b + i + 48), s3);
+    }
+    for (; i + 16 <= len; i += 16) {
+        s0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), s0);
+    }
+    if (i < len) {
+        __mmask16 m = TAIL_MASK16(len - i);
+        s1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i), s1);
+    }
+
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(s0, s1), _mm512_add_ps(s2, s3)));
+}
+
+AVX512 static void mul_f32_avx512(const float* a, const float* b, float* result, size_t len) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        _mm512_storeu_ps(result + i, _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    }
+    if (i < len) {
+        __mmask16 m = TAIL_MASK16(len - i);
+        __m512 p = _mm512_mul_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i));
+        _mm512_mask_storeu_ps(result + i, m, p);
+    }
+}
+
+AVX512 static void scale_f32_avx512(float* arr, float scalar, size_t len) {
+    __m512 s = _mm512_set1_ps(scalar);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        _mm512_storeu_ps(arr + i, _mm512_mul_ps(_mm512_loadu_ps(arr + i), s));
+    }
+    if (i < len) {
+        __mmask16 m = TAIL_MASK16(len - i);
+        _mm512_mask_storeu_ps(arr + i, m, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, arr + i), s));
+    }
+}
+
+// int8 and int16 on AVX-512BW, with VNNI for the int8 dot product. Only
+// the "avx512vnni" kernels use these; plain "avx512" keeps the AVX2 ones.
+
+#define VNNI __attribute__((target("avx512f,avx512bw,avx512vnni")))
+
+// Masks selecting the low n (< 64 or < 32) bytes or words
+#define TAIL_MASK64(n) ((__mmask64)((1ull << (n)) - 1))
+#define TAIL_MASK32(n) ((__mmask32)((1u << (n)) - 1))
+
+// Sign-extends the int32 lanes of v and adds them to the int64 lanes of acc
+VNNI static __m512i widen_add512(__m512i acc, __m512i v) {
+    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(v)));
+    return _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1)));
+}
+
+// As sum_i8_avx2; masked-off tail bytes load as 0 and bias to 128 like the
+// rest, so the tail is included in the correction
+VNNI static int64_t sum_i8_vnni(const int8_t* arr, size_t len) {
+    const __m512i bias = _mm512_set1_epi8((char)0x80), zero = _mm512_setzero_si512();
+    __m512i s = zero;
+    size_t i = 0;
+
+    for (; i + 64 <= len; i += 64) {
+        __m512i x = _mm512_xor_si512(_mm512_loadu_si512(arr + i), bias);
+        s = _mm512_add_epi64(s, _mm512_sad_epu8(x, zero));
+    }
+    if (i < len) {
+        __m512i x = _mm512_xor_si512(_mm512_maskz_loadu_epi8(TAIL_MASK64(len - i), arr + i), bias);
+        s = _mm512_add_epi64(s, _mm512_sad_epu8(x, zero));
+    }
+
+    return _mm512_reduce_add_epi64(s) - 128 * (int64_t)((len + 63) & ~(size_t)63);
+}
+
+// vpdpbusd multiplies unsigned by signed bytes, four per int32 lane. With
+// a biased to ua = a + 128: a.b = ua.b - 128 * sum(b), and sum(b) is one
+// more vpdpbusd against a vector of ones. Lanes gain at most
+// 4 * 255 * 128 per step, so they are flushed every NARROW_BLOCK elements.
+VNNI static int64_t dot_i8_vnni(const int8_t* a, const int8_t* b, size_t len) {
+    const __m512i bias = _mm512_set1_epi8((char)0x80), ones = _mm512_set1_epi8(1);
+    __m512i total = _mm512_setzero_si512(), bsum = total;
+    size_t i = 0;
+
+    while (i < len) {
+        size_t end = len - i > NARROW_BLOCK ? i + NARROW_BLOCK : len;
+        __m512i d = _mm512_setzero_si512(), s = d;
+        for (; i + 64 <= end; i += 64) {
+            __m512i y = _mm512_loadu_si512(b + i);
+            d = _mm512_dpbusd_epi32(d, _mm512_xor_si512(_mm512_loadu_si512(a + i), bias), y);
+            s = _mm512_dpbusd_epi32(s, ones, y);
+        }
+        if (i < end) {
+            // Zeroed tail bytes of b contribute nothing to either sum
+            __mmask64 m = TAIL_MASK64(end - i);
+            __m512i y = _mm512_maskz_loadu_epi8(m, b + i);
+            d = _mm512_dpbusd_epi32(d, _mm512_xor_si512(_mm512_maskz_loadu_epi8(m, a + i), bias), y);
+            s = _mm512_dpbusd_epi32(s, ones, y);
+            i = end;
+        }
+        total = widen_add512(total, d);
+        bsum = widen_add512(bsum, s);
+    }
+
+    return _mm512_reduce_add_epi64(total) - 128 * _mm512_reduce_add_epi64(bsum);
+}
+
+VNNI static int64_t sum_i16_vnni(const int16_t* arr, size_t len) {
+    const __m512i ones = _mm512_set1_epi16(1);
+    __m512i total = _mm512_setzero_si512();
+    size_t i = 0;
+
+    while (i < len) {
+        size_t end = len - i > NARROW_BLOCK ? i + NARROW_BLOCK : len;
+        __m512i s = _mm512_setzero_si512();
+        for (; i + 32 <= end; i += 32) {
+            s = _mm512_dpwssd_epi32(s, _mm512_loadu_si512(arr + i), ones);
+        }
+        if (i < end) {
+            s = _mm512_dpwssd_epi32(s, _mm512_maskz_loadu_epi16(TAIL_MASK32(end - i), arr + i), ones);
+            i = end;
+        }
+        total = widen_add512(total, s);
+    }
+
+    return _mm512_reduce_add_epi64(total);
+}
+
+// As dot_i16_avx2: vpmaddwd pairs, with lanes that wrapped to INT32_MIN
+// counted and corrected. vpdpwssd would fold the pairs into an int32
+// accumulator first, where the wrap can no longer be detected.
+VNNI static int64_t dot_i16_vnni(const int16_t* a, const int16_t* b, size_t len) {
+    const __m512i min32 = _mm512_set1_epi32(INT32_MIN), one = _mm512_set1_epi32(1);
+    __m512i total = _mm512_setzero_si512(), wrapped = total;
+    size_t i = 0;
+
+    for (; i < len; i += 32) {
+        __mmask32 m = len - i >= 32 ? (__mmask32)~0u : TAIL_MASK32(len - i);
+        __m512i p = _mm512_madd_epi16(_mm512_maskz_loadu_epi16(m, a + i), _mm512_maskz_loadu_epi16(m, b + i));
+        total = widen_add512(total, p);
+        wrapped = _mm512_mask_add_epi32(wrapped, _mm512_cmpeq_epi32_mask(p, min32), wrapped, one);
+    }
+
+    wrapped = widen_add512(_mm512_setzero_si512(), wrapped);
+    return _mm512_reduce_add_epi64(total) + _mm512_reduce_add_epi64(wrapped) * ((int64_t)1 << 32);
+}
+#endif // VECTOR_X86
+
+// --- NEON: 2 doubles per vector, 4 accumulators ---
+
+#ifdef VECTOR_NEON
+static double sum_neon(const double* arr, size_t len) {
+    float64x2_t s0 = vdupq_n_f64(0.0), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        s0 = vaddq_f64(s0, vld1q_f64(arr + i));
+        s1 = vaddq_f64(s1, vld1q_f64(arr + i + 2));
+        s2 = vaddq_f64(s2, vld1q_f64(arr + i + 4));
+        s3 = vaddq_f64(s3, vld1q_f64(arr + i + 6));
+    }
+
+    double sum = vaddvq_f64(vaddq_f64(vaddq_f64(s0, s1), vaddq_f64(s2, s3)));
+    for (; i < len; i++) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+static double dot_neon(const double* a, const double* b, size_t len) {
+    float64x2_t s0 = vdupq_n_f64(0.0), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        s0 = vfmaq_f64(s0, vld1q_f64(a + i), vld1q_f64(b + i));
+        s1 = vfmaq_f64(s1, vld1q_f64(a + i + 2), vld1q_f64(b + i + 2));
+        s2 = vfmaq_f64(s2, vld1q_f64(a + i + 4), vld1q_f64(b + i + 4));
+        s3 = vfmaq_f64(s3, vld1q_f64(a + i + 6), vld1q_f64(b + i + 6));
+    }
+
+    double dot = vaddvq_f64(vaddq_f64(vaddq_f64(s0, s1), vaddq_f64(s2, s3)));
+    for (; i < len; i++) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+}
+
+static void dot4_neon(const double* q, const double* m, size_t stride, size_t len, double* out) {
+    const double *r0 = m, *r1 = m + stride, *r2 = r1 + stride, *r3 = r2 + stride;
+    float64x2_t s0 = vdupq_n_f64(0.0), s1 = s0, s2 = s0, s3 = s0;
+    float64x2_t t0 = s0, t1 = s0, t2 = s0, t3 = s0;
+    size_t i = 0;
+
+    for (; i + 4 <= len; i += 4) {
+        float64x2_t x = vld1q_f64(q + i), y = vld1q_f64(q + i + 2);
+        s0 = vfmaq_f64(s0, x, vld1q_f64(r0 + i));
+        s1 = vfmaq_f64(s1, x, vld1q_f64(r1 + i));
+        s2 = vfmaq_f64(s2, x, vld1q_f64(r2 + i));
+        s3 = vfmaq_f64(s3, x, vld1q_f64(r3 + i));
+        t0 = vfmaq_f64(t0, y, vld1q_f64(r0 + i + 2));
+        t1 = vfmaq_f64(t1, y, vld1q_f64(r1 + i + 2));
+        t2 = vfmaq_f64(t2, y, vld1q_f64(r2 + i + 2));
+        t3 = vfmaq_f64(t3, y, vld1q_f64(r3 + i + 2));
+    }
+
+    double d0 = vaddvq_f64(vaddq_f64(s0, t0)), d1 = vaddvq_f64(vaddq_f64(s1, t1));
+    double d2 = vaddvq_f64(vaddq_f64(s2, t2)), d3 = vaddvq_f64(vaddq_f64(s3, t3));
+    for (; i < len; i++) {
+        d0 += q[i] * r0[i];
+        d1 += q[i] * r1[i];
+        d2 += q[i] * r2[i];
+        d3 += q[i] * r3[i];
+    }
+    out[0] = d0;
+    out[1] = d1;
+    out[2] = d2;
+    out[3] = d3;
+}
+
+static void mul_neon(const double* a, const double* b, double* result, size_t len) {
+    size_t i = 0;
+    for (; i + 2 <= len; i += 2) {
+        vst1q_f64(result + i, vmulq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+    }
+    for (; i < len; i++) {
+        result[i] = a[i] * b[i];
+    }
+}
+
+static void scale_neon(double* arr, double scalar, size_t len) {
+    size_t i = 0;
+    for (; i + 2 <= len; i += 2) {
+        vst1q_f64(arr + i, vmulq_n_f64(vld1q_f64(arr + i), scalar));
+    }
+    for (; i < len; i++) {
+        arr[i] *= scalar;
+    }
+}
+
+static float sum_f32_neon(const float* arr, size_t len) {
+    float32x4_t s0 = vdupq_n_f32(0.0f), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        s0 = vaddq_f32(s0, vld1q_f32(arr + i));
+        s1 = vaddq_f32(s1, vld1q_f32(arr + i + 4));
+        s2 = vaddq_f32(s2, vld1q_f32(arr + i + 8));
+        s3 = vaddq_f32(s3, vld1q_f32(arr + i + 12));
+    }
+
+    float sum = vaddvq_f32(vaddq_f32(vaddq_f32(s0, s1), vaddq_f32(s2, s3)));
+    for (; i < len; i++) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+static float dot_f32_neon(const float* a, const float* b, size_t len) {
+    float32x4_t s0 = vdupq_n_f32(0.0f), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        s0 = vfmaq_f32(s0, vld1q_f32(a + i), vld1q_f32(b + i));
+        s1 = vfmaq_f32(s1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        s2 = vfmaq_f32(s2, vld1q_f32(a + i + 8), vld1q_f32(b + i + 8));
+        s3 = vfmaq_f32(s3, vld1q_f32(a + i + 12), vld1q_f32(b + i + 12));
+    }
+
+    float dot = vaddvq_f32(vaddq_f32(vaddq_f32(s0, s1), vaddq_f32(s2, s3)));
+    for (; i < len; i++) {
+        dot += a[i] * b[i];
+    }
+    return dot;
+}
+
+static void mul_f32_neon(const float* a, const float* b, float* result, size_t len) {
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        vst1q_f32(result + i, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    }
+    for (; i < len; i++) {
+        result[i] = a[i] * b[i];
+    }
+}
+
+static void scale_f32_neon(float* arr, float scalar, size_t len) {
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        vst1q_f32(arr + i, vmulq_n_f32(vld1q_f32(arr + i), scalar));
+    }
+    for (; i < len; i++) {
+        arr[i] *= scalar;
+    }
+}
+
+// Pairwise add-accumulate into int16 lanes (at most 2 * 128 per step),
+// flushed to int64 every 64 steps
+static int64_t sum_i8_neon(const int8_t* arr, size_t len) {
+    int64_t sum = 0;
+    size_t i = 0;
+
+    while (i + 16 <= len) {
+        size_t end = len - i > 1024 ? i + 1024 : len;
+        int16x8_t s = vdupq_n_s16(0);
+        for (; i + 16 <= end; i += 16) {
+            s = vpadalq_s8(s, vld1q_s8(arr + i));
+        }
+        sum += vaddlvq_s16(s);
+    }
+
+    for (; i < len; i++) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+// Widening multiplies into int16 (at most 128^2), pairwise accumulated
+// into int32 lanes, flushed every NARROW_BLOCK elements
+static int64_t dot_i8_neon(const int8_t* a, const int8_t* b, size_t len) {
+    int64_t dot = 0;
+    size_t i = 0;
+
+    while (i + 16 <= len) {
+        size_t end = len - i > NARROW_BLOCK ? i + NARROW_BLOCK : len;
+        int32x4_t d0 = vdupq_n_s32(0), d1 = d0;
+        for (; i + 16 <= end; i += 16) {
+            int8x16_t x = vld1q_s8(a + i), y = vld1q_s8(b + i);
+            d0 = vpadalq_s16(d0, vmull_s8(vget_low_s8(x), vget_low_s8(y)));
+            d1 = vpadalq_s16(d1, vmull_high_s8(x, y));
+        }
+        dot += vaddlvq_s32(d0) + vaddlvq_s32(d1);
+    }
+
+    for (; i < len; i++) {
+        dot += (int32_t)a[i] * b[i];
+    }
+    return dot;
+}
+
+// --- NEON with the dot-product extension (optional before Armv8.4) ---
+
+#define DOTPROD __attribute__((target("arch=armv8.2-a+dotprod")))
+
+// SDOT sums four int8 products into each int32 lane (at most 4 * 128^2 per
+// step), two accumulators to hide its latency, flushed every NARROW_BLOCK
+// elements
+DOTPROD static int64_t dot_i8_dotprod(const int8_t* a, const int8_t* b, size_t len) {
+    int64_t dot = 0;
+    size_t i = 0;
+
+    while (i + 16 <= len) {
+        size_t end = len - i > NARROW_BLOCK ? i + NARROW_BLOCK : len;
+        int32x4_t d0 = vdupq_n_s32(0), d1 = d0;
+        for (; i + 32 <= end; i += 32) {
+            d0 = vdotq_s32(d0, vld1q_s8(a + i), vld1q_s8(b + i));
+            d1 = vdotq_s32(d1, vld1q_s8(a + i + 16), vld1q_s8(b + i + 16));
+        }
+        for (; i + 16 <= end; i += 16) {
+            d0 = vdotq_s32(d0, vld1q_s8(a + i), vld1q_s8(b + i));
+        }
+        dot += vaddlvq_s32(d0) + vaddlvq_s32(d1);
+    }
+
+    for (; i < len; i++) {
+        dot += (int32_t)a[i] * b[i];
+    }
+    return dot;
+}
+
+static int64_t sum_i16_neon(const int16_t* arr, size_t len) {
+    int64_t sum = 0;
+    size_t i = 0;
+
+    while (i + 8 <= len) {
+        size_t end = len - i > NARROW_BLOCK ? i + NARROW_BLOCK : len;
+        int32x4_t s = vdupq_n_s32(0);
+        for (; i + 8 <= end; i += 8) {
+            s = vpadalq_s16(s, vld1q_s16(arr + i));
+        }
+        sum += vaddlvq_s32(s);
+    }
+
+    for (; i < len; i++) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+// Widening multiplies into int32, pairwise accumulated into int64 lanes
+static int64_t dot_i16_neon(const int16_t* a, const int16_t* b, size_t len) {
+    int64x2_t d0 = vdupq_n_s64(0), d1 = d0;
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        int16x8_t x = vld1q_s16(a + i), y = vld1q_s16(b + i);
+        d0 = vpadalq_s32(d0, vmull_s16(vget_low_s16(x), vget_low_s16(y)));
+        d1 = vpadalq_s32(d1, vmull_high_s16(x, y));
+    }
+
+    int64_t dot = vaddvq_s64(vaddq_s64(d0, d1));
+    for (; i < len; i++) {
+        dot += (int32_t)a[i] * b[i];
+    }
+    return dot;
+}
+#endif // VECTOR_NEON
+
+// --- Dispatch ---
+
+typedef struct {
+    const char* name;
+    double (*sum)(const double*, size_t);
+    double (*dot)(const double*, const double*, size_t);
+    void (*mul)(const double*, const double*, double*, size_t);
+    void (*scale)(double*, double, size_t);
+    void (*dot4)(const double*, const double*, size_t, size_t, double*);
+
+    float (*sum_f32)(const float*, size_t);
+    float (*dot_f32)(const float*, const float*, size_t);
+    void (*mul_f32)(const float*, const float*, float*, size_t);
+    void (*scale_f32)(float*, float, size_t);
+    int64_t (*sum_i8)(const int8_t*, size_t);
+    int64_t (*dot_i8)(const int8_t*, const int8_t*, size_t);
+    int64_t (*sum_i16)(const int16_t*, size_t);
+    int64_t (*dot_i16)(const int16_t*, const int16_t*, size_t);
+} vector_kernels;
+
+static const vector_kernels kernels_generic = {
+    "generic", sum_generic, dot_generic, mul_generic, scale_generic, dot4_generic,
+    sum_f32_generic, dot_f32_generic, mul_f32_generic, scale_f32_generic,
+    sum_i8_generic, dot_i8_generic, sum_i16_generic, dot_i16_generic,
+};
+#ifdef VECTOR_X86
+static const vector_kernels kernels_avx2 = {
+    "avx2", sum_avx2, dot_avx2, mul_avx2, scale_avx2, dot4_avx2,
+    sum_f32_avx2, dot_f32_avx2, mul_f32_avx2, scale_f32_avx2,
+    sum_i8_avx2, dot_i8_avx2, sum_i16_avx2, dot_i16_avx2,
+};
+static const vector_kernels kernels_avx512 = {
+    "avx512", sum_avx512, dot_avx512, mul_avx512, scale_avx512, dot4_avx512,
+    sum_f32_avx512, dot_f32_avx512, mul_f32_avx512, scale_f32_avx512,
+    sum_i8_avx2, dot_i8_avx2, sum_i16_avx2, dot_i16_avx2,
+};
+static const vector_kernels kernels_avx512vnni = {
+    "avx512vnni", sum_avx512, dot_avx512, mul_avx512, scale_avx512, dot4_avx512,
+    sum_f32_avx512, dot_f32_avx512, mul_f32_avx512, scale_f32_avx512,
+    sum_i8_vnni, dot_i8_vnni, sum_i16_vnni, dot_i16_vnni,
+};
+
+static int cpu_avx512vnni(void) {
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+           __builtin_cpu_supports("avx512vnni");
+}
+#endif
+#ifdef VECTOR_NEON
+static const vector_kernels kernels_neon = {
+    "neon", sum_neon, dot_neon, mul_neon, scale_neon, dot4_neon,
+    sum_f32_neon, dot_f32_neon, mul_f32_neon, scale_f32_neon,
+    sum_i8_neon, dot_i8_neon, sum_i16_neon, dot_i16_neon,
+};
+static const vector_kernels kernels_neondot = {
+    "neondot", sum_neon, dot_neon, mul_neon, scale_neon, dot4_neon,
+    sum_f32_neon, dot_f32_neon, mul_f32_neon, scale_f32_neon,
+    sum_i8_neon, dot_i8_dotprod, sum_i16_neon, dot_i16_neon,
+};
+
+// The dot-product extension is optional before Armv8.4, so it is probed at
+// run time like the x86 features: HWCAP_ASIMDDP on Linux, the FEAT_DotProd
+// sysctl on macOS
+static int cpu_dotprod(void) {
+#if defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_ASIMDDP) != 0;
+#elif defined(__APPLE__)
+    int v = 0;
+    size_t n = sizeof(v);
+    return sysctlbyname("hw.optional.arm.FEAT_DotProd", &v, &n, NULL, 0) == 0 && v != 0;
+#else
+    return 0;
+#endif
+}
+#endif
+
+// Set by vector_init or vector_select while pool threads and other callers
+// may be reading it. Relaxed ordering suffices: the tables are constant, so
+// which one a call picks up is all that varies, and every table is correct.
+static const vector_kernels* _Atomic kernels = &kernels_generic;
+
+static inline const vector_kernels* active_kernels(void) {
+    return atomic_load_explicit(&kernels, memory_order_relaxed);
+}
+
+static inline void set_kernels(const vector_kernels* k) {
+    atomic_store_explicit(&kernels, k, memory_order_relaxed);
+}
+
+const char* vector_init(void) {
+#ifdef VECTOR_X86
+    // __builtin_cpu_supports reads CPUID and also checks XCR0, so AVX state
+    // disabled by the OS (or a hypervisor) is not mistaken for support
+    __builtin_cpu_init();
+    if (cpu_avx512vnni()) {
+        set_kernels(&kernels_avx512vnni);
+    } else if (__builtin_cpu_supports("avx512f")) {
+        set_kernels(&kernels_avx512);
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        set_kernels(&kernels_avx2);
+    }
+#endif
+#ifdef VECTOR_NEON
+    // Advanced SIMD is mandatory on AArch64; only sdot needs a probe
+    set_kernels(cpu_dotprod() ? &kernels_neondot : &kernels_neon);
+#endif
+    return active_kernels()->name;
+}
+
+int vector_select(const char* name) {
+    const vector_kernels* k = NULL;
+    if (strcmp(name, "generic") == 0) {
+        k = &kernels_generic;
+    }
+#ifdef VECTOR_X86
+    __builtin_cpu_init();
+    if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        k = &kernels_avx2;
+    }
+    if (strcmp(name, "avx512") == 0 && __builtin_cpu_supports("avx512f")) {
+        k = &kernels_avx512;
+    }
+    if (strcmp(name, "avx512vnni") == 0 && cpu_avx512vnni()) {
+        k = &kernels_avx512vnni;
+    }
+#endif
+#ifdef VECTOR_NEON
+    if (strcmp(name, "neon") == 0) {
+        k = &kernels_neon;
+    }
+    if (strcmp(name, "neondot") == 0 && cpu_dotprod()) {
+        k = &kernels_neondot;
+    }
+#endif
+    if (k == NULL) return -1;
+    set_kernels(k);
+    return 0;
+}
+
+const char* vector_kernel_name(void) {
+    return active_kernels()->name;
+}
+
+double vector_sum(const double* arr, size_t len) {
+    return active_kernels()->sum(arr, len);
+}
+
+double vector_dot(const double* a, const double* b, size_t len) {
+    return active_kernels()->dot(a, b, len);
+}
+
+void vector_mul(const double* a, const double* b, double* result, size_t len) {
+    active_kernels()->mul(a, b, result, len);
+}
+
+void vector_scale(double* arr, double scalar, size_t len) {
+    active_kernels()->scale(arr, scalar, len);
+}
+
+// Kept for existing callers; the dispatched vector_sum is already SIMD
+double vector_sum_simd(const double* arr, size_t len) {
+    return active_kernels()->sum(arr, len);
+}
+
+float vector_sum_f32(const float* arr, size_t len) {
+    return active_kernels()->sum_f32(arr, len);
+}
+
+float vector_dot_f32(const float* a, const float* b, size_t len) {
+    return active_kernels()->dot_f32(a, b, len);
+}
+
+void vector_mul_f32(const float* a, const float* b, float* result, size_t len) {
+    active_kernels()->mul_f32(a, b, result, len);
+}
+
+void vector_scale_f32(float* arr, float scalar, size_t len) {
+    active_kernels()->scale_f32(arr, scalar, len);
+}
+
+int64_t vector_sum_i8(const int8_t* arr, size_t len) {
+    return active_kernels()->sum_i8(arr, len);
+}
+
+int64_t vector_dot_i8(const int8_t* a, const int8_t* b, size_t len) {
+    return active_kernels()->dot_i8(a, b, len);
+}
+
+void vector_mul_i8(const int8_t* a, const int8_t* b, int16_t* result, size_t len) {
+    mul_i8_generic(a, b, result, len);
+}
+
+void vector_scale_i8(const int8_t* arr, float scalar, float* result, size_t len) {
+    scale_i8_generic(arr, scalar, result, len);
+}
+
+int64_t vector_sum_i16(const int16_t* arr, size_t len) {
+    return active_kernels()->sum_i16(arr, len);
+}
+
+int64_t vector_dot_i16(const int16_t* a, const int16_t* b, size_t len) {
+    return active_kernels()->dot_i16(a, b, len);
+}
+
+void vector_mul_i16(const int16_t* a, const int16_t* b, int32_t* result, size_t len) {
+    mul_i16_generic(a, b, result, len);
+}
+
+void vector_scale_i16(const int16_t* arr, float scalar, float* result, size_t len) {
+    scale_i16_generic(arr, scalar, result, len);
+}
+
+// --- Batched dot products ---
+
+// Query elements per column tile (16KB), small enough to stay in L1 while
+// every row streams past it
+#define DOT_TILE 2048
+
+// Rows scored per batch by vector_topk
+#define TOPK_BATCH 256
+
+void vector_dot_many(const double* query, const double* matrix, size_t rows, size_t dim, double* out) {
+    const vector_kernels* k = active_kernels();
+    if (dim == 0) {
+        memset(out, 0, rows * sizeof(double));
+        return;
+    }
+
+    // Rows shorter than a tile take one pass; longer ones accumulate
+    // tile by tile so the query slice is reused from cache by every row
+    for (size_t c = 0; c < dim; c += DOT_TILE) {
+        size_t w = dim - c < DOT_TILE ? dim - c : DOT_TILE;
+        const double* q = query + c;
+        size_t r = 0;
+        for (; r + 4 <= rows; r += 4) {
+            double d[4];
+            k->dot4(q, matrix + r * dim + c, dim, w, d);
+            for (int j = 0; j < 4; j++) {
+                out[r + j] = c == 0 ? d[j] : out[r + j] + d[j];
+            }
+        }
+        for (; r < rows; r++) {
+            double d = k->dot(q, matrix + r * dim + c, w);
+            out[r] = c == 0 ? d : out[r] + d;
+        }
+    }
+}
+
+// Higher score first, lower index on ties
+static int match_better(const vector_match* a, const vector_match* b) {
+    return a->score > b->score || (a->score == b->score && a->index < b->index);
+}
+
+static void match_swap(vector_match* a, vector_match* b) {
+    vector_match t = *a;
+    *a = *b;
+    *b = t;
+}
+
+// h[0..n) is a heap with the worst match on top; sift h[i] down
+static void heap_down(vector_match* h, size_t n, size_t i) {
+    for (;;) {
+        size_t l = 2 * i + 1, w = i;
+        if (l < n && match_better(&h[w], &h[l])) w = l;
+        if (l + 1 < n && match_better(&h[w], &h[l + 1])) w = l + 1;
+        if (w == i) return;
+        match_swap(&h[i], &h[w]);
+        i = w;
+    }
+}
+
+static void heap_up(vector_match* h, size_t i) {
+    while (i > 0) {
+        size_t p = (i - 1) / 2;
+        if (!match_better(&h[p], &h[i])) return;
+        match_swap(&h[p], &h[i]);
+        i = p;
+    }
+}
+
+size_t vector_topk(const double* query, const double* matrix, size_t rows, size_t dim,
+                   size_t k, vector_match* out) {
+    double scores[TOPK_BATCH];
+    size_t n = 0;
+    if (k == 0) return 0;
+
+    for (size_t r0 = 0; r0 < rows; r0 += TOPK_BATCH) {
+        size_t nb = rows - r0 < TOPK_BATCH ? rows - r0 : TOPK_BATCH;
+        vector_dot_many(query, matrix + r0 * dim, nb, dim, scores);
+        for (size_t j = 0; j < nb; j++) {
+            vector_match m = {(int64_t)(r0 + j), scores[j]};
+            if (m.score != m.score) continue;  // NaN never ranks
+            if (n < k) {
+                out[n] = m;
+                heap_up(out, n++);
+            } else if (match_better(&m, &out[0])) {
+                out[0] = m;
+                heap_down(out, n, 0);
+            }
+        }
+    }
+
+    // Heapsort: moving the worst remaining match to the back leaves the
+    // best first
+    for (size_t end = n; end > 1; end--) {
+        match_swap(&out[0], &out[end - 1]);
+        heap_down(out, end - 1, 0);
+    }
+    return n;
+}
+
+// --- Fused pipelines ---
+
+static int exec_valid(const vector_op* ops, int nops, int nvecs, int nresults) {
+    if (nops < 1 || ops[0].code != VECTOR_OP_LOAD) return 0;
+    for (int k = 0; k < nops; k++) {
+        const vector_op* op = &ops[k];
+        switch (op->code) {
+        case VECTOR_OP_LOAD:
+        case VECTOR_OP_STORE:
+        case VECTOR_OP_ADD:
+        case VECTOR_OP_MUL:
+            if (op->arg < 0 || op->arg >= nvecs) return 0;
+            break;
+        case VECTOR_OP_ADDS:
+        case VECTOR_OP_SCALE:
+            break;
+        case VECTOR_OP_DOT:
+            if (op->arg2 < 0 || op->arg2 >= nvecs) return 0;
+            // fallthrough
+        case VECTOR_OP_SUM:
+            if (op->arg < 0 || op->arg >= nresults) return 0;
+            break;
+        default:
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int vector_exec(const vector_op* ops, int nops, double* const* vecs, int nvecs,
+                size_t len, double* results, int nresults) {
+    if (!exec_valid(ops, nops, nvecs, nresults)) return -1;
+
+    // Blocks of 4KB: the accumulator and one block of each operand stay in L1
+    _Alignas(64) double acc[VECTOR_BLOCK];
+    const vector_kernels* k = active_kernels();
+
+    for (int j = 0; j < nops; j++) {
+        if (ops[j].code == VECTOR_OP_SUM || ops[j].code == VECTOR_OP_DOT) {
+            results[ops[j].arg] = 0.0;
+        }
+    }
+
+    for (size_t off = 0; off < len; off += VECTOR_BLOCK) {
+        size_t n = len - off < VECTOR_BLOCK ? len - off : VECTOR_BLOCK;
+        for (int j = 0; j < nops; j++) {
+            const vector_op* op = &ops[j];
+            switch (op->code) {
+            case VECTOR_OP_LOAD:
+                memcpy(acc, vecs[op->arg] + off, n * sizeof(double));
+                break;
+            case VECTOR_OP_STORE:
+                memcpy(vecs[op->arg] + off, acc, n * sizeof(double));
+                break;
+            case VECTOR_OP_ADD: {
+                const double* x = vecs[op->arg] + off;
+                for (size_t i = 0; i < n; i++) acc[i] += x[i];
+                break;
+            }
+            case VECTOR_OP_MUL:
+                k->mul(acc, vecs[op->arg] + off, acc, n);
+                break;
+            case VECTOR_OP_ADDS:
+                for (size_t i = 0; i < n; i++) acc[i] += op->imm;
+                break;
+            case VECTOR_OP_SCALE:
+                k->scale(acc, op->imm, n);
+                break;
+            case VECTOR_OP_SUM:
+                results[op->arg] += k->sum(acc, n);
+                break;
+            case VECTOR_OP_DOT:
+                results[op->arg] += k->dot(acc, vecs[op->arg2] + off, n);
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+// --- Parallel reductions ---
+
+typedef struct {
+    const double* a;
+    const double* b;  // NULL for a sum
+    size_t len;
+    size_t nchunks;
+    atomic_size_t next;  // next chunk to claim
+    double* partials;    // one per chunk
+} par_job;
+
+// Workers sleep on work until gen moves past the last job they ran. The
+// poster sets active to the worker count and waits on done for it to drop
+// to zero, so every worker finishes a job before the next is posted.
+static struct {
+    pthread_mutex_t busy;  // held while a job runs or the pool changes
+    pthread_mutex_t mu;    // guards the fields below
+    pthread_cond_t work;
+    pthread_cond_t done;
+    pthread_t* threads;
+    int nworkers;
+    int active;
+    int stop;
+    unsigned long gen;
+    par_job* job;
+} pool = {
+    .busy = PTHREAD_MUTEX_INITIALIZER,
+    .mu = PTHREAD_MUTEX_INITIALIZER,
+    .work = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+
+// Starts the default pool on the first parallel call, unless
+// vector_parallel_init or vector_parallel_shutdown ran first
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+
+static void run_chunks(par_job* job) {
+    const vector_kernels* k = active_kernels();
+    size_t c;
+    while ((c = atomic_fetch_add(&job->next, 1)) < job->nchunks) {
+        size_t off = c * VECTOR_CHUNK;
+        size_t n = job->len - off < VECTOR_CHUNK ? job->len - off : VECTOR_CHUNK;
+        job->partials[c] = job->b ? k->dot(job->a + off, job->b + off, n) : k->sum(job->a + off, n);
+    }
+}
+
+static void* par_worker(void* arg) {
+    (void)arg;
+    unsigned long seen = 0;  // gen restarts at 0 with each pool
+    pthread_mutex_lock(&pool.mu);
+    for (;;) {
+        while (!pool.stop && pool.gen == seen) {
+            pthread_cond_wait(&pool.work, &pool.mu);
+        }
+        if (pool.stop) break;
+        seen = pool.gen;
+        par_job* job = pool.job;
+        pthread_mutex_unlock(&pool.mu);
+
+        run_chunks(job);
+
+        pthread_mutex_lock(&pool.mu);
+        if (--pool.active == 0) pthread_cond_signal(&pool.done);
+    }
+    pthread_mutex_unlock(&pool.mu);
+    return NULL;
+}
+
+// The caller must hold pool.busy
+static void pool_stop_locked(void) {
+    pthread_mutex_lock(&pool.mu);
+    pool.stop = 1;
+    pthread_cond_broadcast(&pool.work);
+    pthread_mutex_unlock(&pool.mu);
+    for (int i = 0; i < pool.nworkers; i++) {
+        pthread_join(pool.threads[i], NULL);
+    }
+    free(pool.threads);
+    pool.threads = NULL;
+    pool.nworkers = 0;
+    pool.stop = 0;
+}
+
+static int pool_start(int nthreads) {
+    if (nthreads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = cpus > 0 ? (int)cpus : 1;
+    }
+
+    pthread_mutex_lock(&pool.busy);
+    pool_stop_locked();
+    pool.gen = 0;
+    int want = nthreads - 1;  // the caller is the last thread
+    if (want > 0) {
+        pool.threads = malloc((size_t)want * sizeof(pthread_t));
+    }
+    if (pool.threads != NULL) {
+        while (pool.nworkers < want &&
+               pthread_create(&pool.threads[pool.nworkers], NULL, par_worker, NULL) == 0) {
+            pool.nworkers++;
+        }
+    }
+    int rc = want > 0 && pool.nworkers == 0 ? -1 : pool.nworkers + 1;
+    pthread_mutex_unlock(&pool.busy);
+    return rc;
+}
+
+static void pool_default(void) {
+    pool_start(0);
+}
+
+static void pool_keep(void) {}
+
+int vector_parallel_init(int nthreads) {
+    pthread_once(&pool_once, pool_keep);
+    return pool_start(nthreads);
+}
+
+void vector_parallel_shutdown(void) {
+    pthread_once(&pool_once, pool_keep);
+    pthread_mutex_lock(&pool.busy);
+    pool_stop_locked();
+    pthread_mutex_unlock(&pool.busy);
+}
+
+int vector_parallel_threads(void) {
+    pthread_once(&pool_once, pool_default);
+    pthread_mutex_lock(&pool.busy);
+    int n = pool.nworkers + 1;
+    pthread_mutex_unlock(&pool.busy);
+    return n;
+}
+
+// Pairwise sum of p[0..n) with a fixed split, so rounding is reproducible
+static double combine(const double* p, size_t n) {
+    if (n == 1) return p[0];
+    size_t half = n / 2;
+    return combine(p, half) + combine(p + half, n - half);
+}
+
+static double run_parallel(const double* a, const double* b, size_t len) {
+    par_job job = {a, b, len, (len + VECTOR_CHUNK - 1) / VECTOR_CHUNK, 0, NULL};
+    double stack[64];
+    job.partials = job.nchunks <= 64 ? stack : malloc(job.nchunks * sizeof(double));
+    if (job.partials == NULL) {
+        return b ? active_kernels()->dot(a, b, len) : active_kernels()->sum(a, len);
+    }
+
+    pthread_once(&pool_once, pool_default);
+
+    // If another caller has the pool, run the same chunks on this thread:
+    // slower, but the result is identical
+    if (pthread_mutex_trylock(&pool.busy) == 0) {
+        int workers = pool.nworkers;
+        if (workers > 0) {
+            pthread_mutex_lock(&pool.mu);
+            pool.job = &job;
+            pool.active = workers;
+            pool.gen++;
+            pthread_cond_broadcast(&pool.work);
+            pthread_mutex_unlock(&pool.mu);
+        }
+
+        run_chunks(&job);
+
+        if (workers > 0) {
+            pthread_mutex_lock(&pool.mu);
+            while (pool.active > 0) {
+                pthread_cond_wait(&pool.done, &pool.mu);
+            }
+            pool.job = NULL;
+            pthread_mutex_unlock(&pool.mu);
+        }
+        pthread_mutex_unlock(&pool.busy);
+    } else {
+        run_chunks(&job);
+    }
+
+    double result = combine(job.partials, job.nchunks);
+    if (job.partials != stack) free(job.partials);
+    return result;
+}
+
+double vector_sum_parallel(const double* arr, size_t len) {
+    if (len < VECTOR_PARALLEL_MIN) return active_kernels()->sum(arr, len);
+    return run_parallel(arr, NULL, len);
+}
 
-    return sum0 + sum1 + sum2 + sum3;
+double vector_dot_parallel(const double* a, const double* b, size_t len) {
+    if (len < VECTOR_PARALLEL_MIN) return active_kernels()->dot(a, b, len);
+    return run_parallel(a, b, len);
 }
@@ -5,6 +5,19 @@
 #include <stdint.h>
 #include <stddef.h>
 
+// Select the widest SIMD kernels this CPU supports (AVX-512F, AVX2+FMA,
+// NEON) for the functions below, and return their name. Safe to call more
+// than once. Before the first call every function uses portable kernels.
+const char* vector_init(void);
+
+// Switch to the named kernels, e.g. "generic" or "avx2" to avoid AVX-512
+// frequency drops. Returns 0, or -1 if unknown or unsupported on this CPU.
+int vector_select(const char* name);
+
+// Name of the kernels in use: "avx512vnni", "avx512", "avx2", "neondot",
+// "neon" or "generic"
+const char* vector_kernel_name(void);
+
 // Sum all elements in a float64 array
 double vector_sum(const double* arr, size_t len);
 
@@ -17,7 +30,109 @@ void vector_mul(const double* a, const double* b, double* result, size_t len);
 // Scale array in-place: arr[i] *= scalar
 void vector_scale(double* arr, double scalar, size_t len);
 
-// SIMD-optimized sum (if available)
+// Same as vector_sum, which is SIMD-dispatched; kept for existing callers
 double vector_sum_simd(const double* arr, size_t len);
 
+// --- float32 ---
+
+float vector_sum_f32(const float* arr, size_t len);
+float vector_dot_f32(const float* a, const float* b, size_t len);
+void vector_mul_f32(const float* a, const float* b, float* result, size_t len);
+void vector_scale_f32(float* arr, float scalar, size_t len);
+
+// --- int8 and int16, e.g. quantized embeddings ---
+//
+// Sums and dot products are exact: lanes accumulate in int32 and widen to
+// the int64 result before they could overflow. Mul widens each product
+// (int8 -> int16, int16 -> int32); scale dequantizes: result[i] =
+// arr[i] * scalar as float32.
+
+int64_t vector_sum_i8(const int8_t* arr, size_t len);
+int64_t vector_dot_i8(const int8_t* a, const int8_t* b, size_t len);
+void vector_mul_i8(const int8_t* a, const int8_t* b, int16_t* result, size_t len);
+void vector_scale_i8(const int8_t* arr, float scalar, float* result, size_t len);
+
+int64_t vector_sum_i16(const int16_t* arr, size_t len);
+int64_t vector_dot_i16(const int16_t* a, const int16_t* b, size_t len);
+void vector_mul_i16(const int16_t* a, const int16_t* b, int32_t* result, size_t len);
+void vector_scale_i16(const int16_t* arr, float scalar, float* result, size_t len);
+
+// --- Batched dot products ---
+//
+// vector_dot_many scores one query against every row of a row-major
+// rows x dim matrix in a single call: out[r] = dot(query, matrix + r*dim).
+// Rows are scored four at a time so each query load serves four rows, and
+// rows longer than 2048 elements are tiled so the query slice stays in L1.
+void vector_dot_many(const double* query, const double* matrix, size_t rows, size_t dim,
+                     double* out);
+
+typedef struct {
+    int64_t index;  // matrix row
+    double score;   // dot(query, row)
+} vector_match;
+
+// Write the k highest-scoring rows to out, best first (lower index on
+// ties), and return how many were written: min(k, rows) less any rows that
+// scored NaN. Scores are computed in batches and selected as they come, so
+// no per-row score array is materialized.
+size_t vector_topk(const double* query, const double* matrix, size_t rows, size_t dim,
+                   size_t k, vector_match* out);
+
+// --- Fused pipelines ---
+//
+// vector_exec runs a list of operations over equal-length vectors in one
+// pass. It walks the input in blocks of VECTOR_BLOCK elements held in an
+// accumulator, applying every op to a block before moving on, so each
+// operand is read from memory once however many ops there are.
+#define VECTOR_BLOCK 512
+
+enum {
+    VECTOR_OP_LOAD = 1,  // acc = vecs[arg]
+    VECTOR_OP_STORE,     // vecs[arg] = acc
+    VECTOR_OP_ADD,       // acc += vecs[arg]
+    VECTOR_OP_MUL,       // acc *= vecs[arg]
+    VECTOR_OP_ADDS,      // acc += imm
+    VECTOR_OP_SCALE,     // acc *= imm
+    VECTOR_OP_SUM,       // results[arg] = sum(acc)
+    VECTOR_OP_DOT,       // results[arg] = dot(acc, vecs[arg2])
+};
+
+typedef struct {
+    int32_t code;  // VECTOR_OP_*
+    int32_t arg;   // vector index, or result index for SUM and DOT
+    int32_t arg2;  // vector index for DOT
+    double imm;    // scalar for ADDS and SCALE
+} vector_op;
+
+// Run nops ops over vecs[0..nvecs), each len elements long, writing one
+// result per SUM or DOT into results. The first op must be LOAD. Returns 0,
+// or -1 if an op is unknown or an index is out of range.
+int vector_exec(const vector_op* ops, int nops, double* const* vecs, int nvecs,
+                size_t len, double* results, int nresults);
+
+// --- Parallel reductions ---
+//
+// vector_sum_parallel and vector_dot_parallel split the input into
+// VECTOR_CHUNK-element chunks handed out to a persistent worker pool, then
+// combine the per-chunk partials pairwise in a fixed order, so the result
+// depends only on the input, not on the thread count or scheduling. Inputs
+// shorter than VECTOR_PARALLEL_MIN take the serial path.
+#define VECTOR_CHUNK 32768
+#define VECTOR_PARALLEL_MIN (8 * VECTOR_CHUNK)
+
+// Start the worker pool with nthreads threads including the caller (0 =
+// one per online CPU), replacing any running pool. Returns the thread
+// count, or -1 if no worker could be started. The first parallel call
+// starts a default pool if none is running.
+int vector_parallel_init(int nthreads);
+
+// Stop and join the workers. Parallel calls then run on the caller only.
+void vector_parallel_shutdown(void);
+
+// Threads a parallel call uses, including the caller
+int vector_parallel_threads(void);
+
+double vector_sum_parallel(const double* arr, size_t len);
+double vector_dot_parallel(const double* a, const double* b, size_t len);
+
 #endif
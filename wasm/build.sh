@@ -31,25 +31,33 @@ build_rust() {
         rustup target add wasm32-unknown-unknown
     fi
 
-    # Enable SIMD and other optimizations via RUSTFLAGS
-    export RUSTFLAGS="-C target-feature=+simd128"
-
-    if ! cargo build --release --target wasm32-unknown-unknown; then
+    # Portable build (MVP instruction set), then the SIMD variant with the
+    # explicit simd128 kernels, in its own target dir so neither rebuild
+    # invalidates the other
+    if ! RUSTFLAGS="" cargo build --release --target wasm32-unknown-unknown; then
         echo "ERROR: Rust build failed"
         cd ..
         return 1
     fi
-
-    # Copy to expected location
     cp target/wasm32-unknown-unknown/release/vector_wasm.wasm vector.wasm
 
+    if ! RUSTFLAGS="-C target-feature=+simd128" cargo build --release \
+        --target wasm32-unknown-unknown --target-dir target/simd; then
+        echo "ERROR: Rust SIMD build failed"
+        cd ..
+        return 1
+    fi
+    cp target/simd/wasm32-unknown-unknown/release/vector_wasm.wasm vector_simd.wasm
+
     # Run wasm-opt if available for additional optimization
     if command -v wasm-opt &> /dev/null; then
         echo "Running wasm-opt..."
-        wasm-opt -O3 --enable-simd vector.wasm -o vector.wasm
+        wasm-opt -O3 vector.wasm -o vector.wasm
+        wasm-opt -O3 --enable-simd vector_simd.wasm -o vector_simd.wasm
     fi
 
     echo "Rust WASM built: rust/vector.wasm ($(stat -f%z vector.wasm 2>/dev/null || stat -c%s vector.wasm 2>/dev/null) bytes)"
+    echo "Rust WASM built: rust/vector_simd.wasm ($(stat -f%z vector_simd.wasm 2>/dev/null || stat -c%s vector_simd.wasm 2>/dev/null) bytes)"
     cd ..
     return 0
 }
@@ -86,16 +94,18 @@ build_tinygo() {
     return 0
 }
 
-build_c() {
-    echo "=== Building C WASM ==="
+# build_c_variant <output> [extra flags...] compiles c/vector_wasm.c with
+# the first available toolchain; run from the c directory
+build_c_variant() {
+    local out="$1"
+    shift
 
-    # Try wasi-sdk first, then Emscripten, then clang with wasm target
     if [ -n "$WASI_SDK_PATH" ] && [ -f "$WASI_SDK_PATH/bin/clang" ]; then
-        echo "Using wasi-sdk..."
-        cd c
-        if "$WASI_SDK_PATH/bin/clang" \
+        echo "Using wasi-sdk for $out..."
+        "$WASI_SDK_PATH/bin/clang" \
             --target=wasm32-wasi \
             -O3 \
+            "$@" \
             -nostartfiles \
             -Wl,--no-entry \
             -Wl,--export=sum \
@@ -103,63 +113,68 @@ build_c() {
             -Wl,--export=mul \
             -Wl,--export=scale \
             -Wl,--export=sum_simd \
+            -Wl,--export=dot_many \
+            -Wl,--export=sum_f32 \
+            -Wl,--export=dot_f32 \
+            -Wl,--export=sum_i8 \
+            -Wl,--export=dot_i8 \
+            -Wl,--export=ensure_capacity \
             -Wl,--export=get_buffer_a_offset \
             -Wl,--export=get_buffer_b_offset \
             -Wl,--export=get_result_offset \
             -Wl,--export=get_capacity \
             -Wl,--export=memory \
-            -o vector.wasm \
-            vector_wasm.c; then
-            echo "C WASM built: c/vector.wasm"
-            cd ..
-            return 0
-        else
-            echo "ERROR: wasi-sdk build failed"
-            cd ..
-            return 1
-        fi
+            -o "$out" \
+            vector_wasm.c
     elif command -v emcc &> /dev/null; then
-        echo "Using Emscripten..."
-        cd c
-        if emcc -O3 \
+        echo "Using Emscripten for $out..."
+        emcc -O3 \
+            "$@" \
             -s STANDALONE_WASM=1 \
-            -s EXPORTED_FUNCTIONS='["_sum","_dot","_mul","_scale","_sum_simd","_get_buffer_a_offset","_get_buffer_b_offset","_get_result_offset","_get_capacity"]' \
+            -s ALLOW_MEMORY_GROWTH=1 \
+            -s EXPORTED_FUNCTIONS='["_sum","_dot","_mul","_scale","_sum_simd","_dot_many","_sum_f32","_dot_f32","_sum_i8","_dot_i8","_ensure_capacity","_get_buffer_a_offset","_get_buffer_b_offset","_get_result_offset","_get_capacity"]' \
             --no-entry \
-            -o vector.wasm \
-            vector_wasm.c; then
-            echo "C WASM built: c/vector.wasm"
-            cd ..
-            return 0
-        else
-            echo "ERROR: Emscripten build failed"
-            cd ..
-            return 1
-        fi
+            -o "$out" \
+            vector_wasm.c
     elif command -v clang &> /dev/null && clang --print-targets 2>/dev/null | grep -q wasm32; then
-        echo "Using clang with wasm32 target..."
-        cd c
-        if clang \
+        echo "Using clang with wasm32 target for $out..."
+        clang \
             --target=wasm32 \
             -O3 \
+            "$@" \
             -nostdlib \
             -Wl,--no-entry \
             -Wl,--export-all \
-            -o vector.wasm \
-            vector_wasm.c; then
-            echo "C WASM built: c/vector.wasm"
-            cd ..
-            return 0
-        else
-            echo "ERROR: clang build failed"
-            cd ..
-            return 1
-        fi
+            -o "$out" \
+            vector_wasm.c
     else
         echo "SKIP: No WASM C compiler found. Install one of:"
         echo "  wasi-sdk: https://github.com/WebAssembly/wasi-sdk"
         echo "  Emscripten: https://emscripten.org/docs/getting_started/downloads.html"
-        return 1
+        return 2
+    fi
+}
+
+build_c() {
+    echo "=== Building C WASM ==="
+
+    # Try wasi-sdk first, then Emscripten, then clang with wasm target.
+    # -msimd128 selects the explicit wasm_simd128.h kernels.
+    cd c
+    build_c_variant vector.wasm
+    local rc=$?
+    if [ $rc -eq 0 ]; then
+        echo "C WASM built: c/vector.wasm"
+        build_c_variant vector_simd.wasm -msimd128
+        rc=$?
+        [ $rc -eq 0 ] && echo "C WASM built: c/vector_simd.wasm"
+    fi
+    cd ..
+
+    if [ $rc -ne 0 ] && [ $rc -ne 2 ]; then
+        echo "ERROR: C build failed"
     fi
+    [ $rc -eq 0 ]
 }
 
 case "${1:-all}" in
@@ -1,64 +1,306 @@
 // C implementation of vector operations for WASM
 //
 // Uses pre-allocated static buffers to eliminate per-call allocation.
-// The host copies data into these buffers at known offsets.
+// The host copies data into these buffers at known offsets; ensure_capacity
+// grows linear memory and moves the buffers when the host needs more room.
 //
 // Build with wasi-sdk:
 //   $WASI_SDK/bin/clang --target=wasm32-wasi -O3 -nostartfiles \
 //     -Wl,--no-entry -Wl,--export-all -o vector.wasm vector_wasm.c
 //
 // Or with Emscripten:
-//   emcc -O3 -s STANDALONE_WASM=1 -s EXPORTED_FUNCTIONS='["_sum","_dot",...]' \
+//   emcc -O3 -s STANDALONE_WASM=1 -s EXPORTED_FUNCTIONS='["_sum","_dot","_dot_many","_sum_f32","_ensure_capacity",...]' \
 //     --no-entry -o vector.wasm vector_wasm.c
+//
+// Adding -msimd128 builds the SIMD variant (vector_simd.wasm), where every
+// operation runs on explicit wasm_simd128.h kernels instead of scalar loops.
+//
+// The float32 and int8 reductions (sum_f32, dot_f32, sum_i8, dot_i8) read
+// buffers A and B as arrays of the narrow type, so a buffer holds 2x or 8x
+// capacity elements of it.
 
 #include <stdint.h>
 #include <stddef.h>
 
-// Pre-allocated buffer capacity (100K f64 elements = 800KB per buffer)
-#define CAPACITY 100000
+// Initial buffer capacity (100K f64 elements = 800KB per buffer);
+// ensure_capacity grows past it
+#define INITIAL_CAPACITY 100000
+#define PAGE_SIZE 65536
+
+// Static buffers - the initial storage, allocated once
+static double initial_a[INITIAL_CAPACITY];
+static double initial_b[INITIAL_CAPACITY];
+static double initial_result[INITIAL_CAPACITY];
 
-// Static buffers - allocated once, stable addresses
-static double buffer_a[CAPACITY];
-static double buffer_b[CAPACITY];
-static double result_buf[CAPACITY];
+// Current buffers: stable addresses until ensure_capacity moves them
+static double* buffer_a = initial_a;
+static double* buffer_b = initial_b;
+static double* result_buf = initial_result;
+static size_t capacity = INITIAL_CAPACITY;
+
+// Start of the grown buffer region, always at the end of linear memory
+static uintptr_t heap_base;
 
 // WASM export attribute
 #define WASM_EXPORT __attribute__((visibility("default")))
 
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+
+// SIMD128 kernels: 2 doubles per v128, 4 accumulators to hide add latency.
+// v128.load has no alignment requirement.
+
+static double hsum_f64x2(v128_t v) {
+    return wasm_f64x2_extract_lane(v, 0) + wasm_f64x2_extract_lane(v, 1);
+}
+
+static double sum_f64x2(const double* a, size_t n) {
+    v128_t s0 = wasm_f64x2_splat(0.0), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        s0 = wasm_f64x2_add(s0, wasm_v128_load(a + i));
+        s1 = wasm_f64x2_add(s1, wasm_v128_load(a + i + 2));
+        s2 = wasm_f64x2_add(s2, wasm_v128_load(a + i + 4));
+        s3 = wasm_f64x2_add(s3, wasm_v128_load(a + i + 6));
+    }
+    for (; i + 2 <= n; i += 2) {
+        s0 = wasm_f64x2_add(s0, wasm_v128_load(a + i));
+    }
+
+    double s = hsum_f64x2(wasm_f64x2_add(wasm_f64x2_add(s0, s1), wasm_f64x2_add(s2, s3)));
+    for (; i < n; i++) {
+        s += a[i];
+    }
+    return s;
+}
+
+static double dot_f64x2(const double* a, const double* b, size_t n) {
+    v128_t s0 = wasm_f64x2_splat(0.0), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        s0 = wasm_f64x2_add(s0, wasm_f64x2_mul(wasm_v128_load(a + i), wasm_v128_load(b + i)));
+        s1 = wasm_f64x2_add(s1, wasm_f64x2_mul(wasm_v128_load(a + i + 2), wasm_v128_load(b + i + 2)));
+        s2 = wasm_f64x2_add(s2, wasm_f64x2_mul(wasm_v128_load(a + i + 4), wasm_v128_load(b + i + 4)));
+        s3 = wasm_f64x2_add(s3, wasm_f64x2_mul(wasm_v128_load(a + i + 6), wasm_v128_load(b + i + 6)));
+    }
+    for (; i + 2 <= n; i += 2) {
+        s0 = wasm_f64x2_add(s0, wasm_f64x2_mul(wasm_v128_load(a + i), wasm_v128_load(b + i)));
+    }
+
+    double d = hsum_f64x2(wasm_f64x2_add(wasm_f64x2_add(s0, s1), wasm_f64x2_add(s2, s3)));
+    for (; i < n; i++) {
+        d += a[i] * b[i];
+    }
+    return d;
+}
+
+static void mul_f64x2(const double* a, const double* b, double* r, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        wasm_v128_store(r + i, wasm_f64x2_mul(wasm_v128_load(a + i), wasm_v128_load(b + i)));
+        wasm_v128_store(r + i + 2, wasm_f64x2_mul(wasm_v128_load(a + i + 2), wasm_v128_load(b + i + 2)));
+    }
+    for (; i < n; i++) {
+        r[i] = a[i] * b[i];
+    }
+}
+
+static void scale_f64x2(double* a, double scalar, size_t n) {
+    v128_t s = wasm_f64x2_splat(scalar);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        wasm_v128_store(a + i, wasm_f64x2_mul(wasm_v128_load(a + i), s));
+        wasm_v128_store(a + i + 2, wasm_f64x2_mul(wasm_v128_load(a + i + 2), s));
+    }
+    for (; i < n; i++) {
+        a[i] *= scalar;
+    }
+}
+
+// Four rows dim apart against one query; each query load serves all four
+static void dot4_f64x2(const double* q, const double* m, size_t dim, double* out) {
+    const double *r0 = m, *r1 = m + dim, *r2 = r1 + dim, *r3 = r2 + dim;
+    v128_t s0 = wasm_f64x2_splat(0.0), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 2 <= dim; i += 2) {
+        v128_t x = wasm_v128_load(q + i);
+        s0 = wasm_f64x2_add(s0, wasm_f64x2_mul(x, wasm_v128_load(r0 + i)));
+        s1 = wasm_f64x2_add(s1, wasm_f64x2_mul(x, wasm_v128_load(r1 + i)));
+        s2 = wasm_f64x2_add(s2, wasm_f64x2_mul(x, wasm_v128_load(r2 + i)));
+        s3 = wasm_f64x2_add(s3, wasm_f64x2_mul(x, wasm_v128_load(r3 + i)));
+    }
+
+    double d0 = hsum_f64x2(s0), d1 = hsum_f64x2(s1), d2 = hsum_f64x2(s2), d3 = hsum_f64x2(s3);
+    for (; i < dim; i++) {
+        d0 += q[i] * r0[i];
+        d1 += q[i] * r1[i];
+        d2 += q[i] * r2[i];
+        d3 += q[i] * r3[i];
+    }
+    out[0] = d0;
+    out[1] = d1;
+    out[2] = d2;
+    out[3] = d3;
+}
+
+// 4 floats per v128, 4 accumulators
+static float hsum_f32x4(v128_t v) {
+    return (wasm_f32x4_extract_lane(v, 0) + wasm_f32x4_extract_lane(v, 1)) +
+           (wasm_f32x4_extract_lane(v, 2) + wasm_f32x4_extract_lane(v, 3));
+}
+
+static float sum_f32x4(const float* a, size_t n) {
+    v128_t s0 = wasm_f32x4_splat(0.0f), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        s0 = wasm_f32x4_add(s0, wasm_v128_load(a + i));
+        s1 = wasm_f32x4_add(s1, wasm_v128_load(a + i + 4));
+        s2 = wasm_f32x4_add(s2, wasm_v128_load(a + i + 8));
+        s3 = wasm_f32x4_add(s3, wasm_v128_load(a + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) {
+        s0 = wasm_f32x4_add(s0, wasm_v128_load(a + i));
+    }
+
+    float s = hsum_f32x4(wasm_f32x4_add(wasm_f32x4_add(s0, s1), wasm_f32x4_add(s2, s3)));
+    for (; i < n; i++) {
+        s += a[i];
+    }
+    return s;
+}
+
+static float dot_f32x4(const float* a, const float* b, size_t n) {
+    v128_t s0 = wasm_f32x4_splat(0.0f), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        s0 = wasm_f32x4_add(s0, wasm_f32x4_mul(wasm_v128_load(a + i), wasm_v128_load(b + i)));
+        s1 = wasm_f32x4_add(s1, wasm_f32x4_mul(wasm_v128_load(a + i + 4), wasm_v128_load(b + i + 4)));
+        s2 = wasm_f32x4_add(s2, wasm_f32x4_mul(wasm_v128_load(a + i + 8), wasm_v128_load(b + i + 8)));
+        s3 = wasm_f32x4_add(s3, wasm_f32x4_mul(wasm_v128_load(a + i + 12), wasm_v128_load(b + i + 12)));
+    }
+    for (; i + 4 <= n; i += 4) {
+        s0 = wasm_f32x4_add(s0, wasm_f32x4_mul(wasm_v128_load(a + i), wasm_v128_load(b + i)));
+    }
+
+    float d = hsum_f32x4(wasm_f32x4_add(wasm_f32x4_add(s0, s1), wasm_f32x4_add(s2, s3)));
+    for (; i < n; i++) {
+        d += a[i] * b[i];
+    }
+    return d;
+}
+
+static int64_t hsum_i32x4(v128_t v) {
+    return (int64_t)wasm_i32x4_extract_lane(v, 0) + wasm_i32x4_extract_lane(v, 1) +
+           wasm_i32x4_extract_lane(v, 2) + wasm_i32x4_extract_lane(v, 3);
+}
+
+// int8 lanes are widened pairwise into int32 lanes, which are flushed to
+// the int64 total every I8_BLOCK elements, long before they can overflow
+#define I8_BLOCK 65536
+
+static int64_t sum_i8x16(const int8_t* a, size_t n) {
+    int64_t sum = 0;
+    size_t i = 0;
+
+    while (i + 16 <= n) {
+        size_t end = n - i > I8_BLOCK ? i + I8_BLOCK : n;
+        v128_t s = wasm_i32x4_splat(0);
+        for (; i + 16 <= end; i += 16) {
+            s = wasm_i32x4_add(s, wasm_i32x4_extadd_pairwise_i16x8(
+                                      wasm_i16x8_extadd_pairwise_i8x16(wasm_v128_load(a + i))));
+        }
+        sum += hsum_i32x4(s);
+    }
+
+    for (; i < n; i++) {
+        sum += a[i];
+    }
+    return sum;
+}
+
+// Sign-extends to int16 and multiplies pairs with i32x4.dot_i16x8
+static int64_t dot_i8x16(const int8_t* a, const int8_t* b, size_t n) {
+    int64_t dot = 0;
+    size_t i = 0;
+
+    while (i + 16 <= n) {
+        size_t end = n - i > I8_BLOCK ? i + I8_BLOCK : n;
+        v128_t d0 = wasm_i32x4_splat(0), d1 = d0;
+        for (; i + 16 <= end; i += 16) {
+            v128_t x = wasm_v128_load(a + i), y = wasm_v128_load(b + i);
+            d0 = wasm_i32x4_add(d0, wasm_i32x4_dot_i16x8(wasm_i16x8_extend_low_i8x16(x),
+                                                         wasm_i16x8_extend_low_i8x16(y)));
+            d1 = wasm_i32x4_add(d1, wasm_i32x4_dot_i16x8(wasm_i16x8_extend_high_i8x16(x),
+                                                         wasm_i16x8_extend_high_i8x16(y)));
+        }
+        dot += hsum_i32x4(wasm_i32x4_add(d0, d1));
+    }
+
+    for (; i < n; i++) {
+        dot += (int32_t)a[i] * b[i];
+    }
+    return dot;
+}
+#endif
+
 WASM_EXPORT double sum(uint32_t len) {
-    size_t n = len < CAPACITY ? len : CAPACITY;
+    size_t n = len < capacity ? len : capacity;
+#ifdef __wasm_simd128__
+    return sum_f64x2(buffer_a, n);
+#else
     double s = 0.0;
     for (size_t i = 0; i < n; i++) {
         s += buffer_a[i];
     }
     return s;
+#endif
 }
 
 WASM_EXPORT double dot(uint32_t len) {
-    size_t n = len < CAPACITY ? len : CAPACITY;
+    size_t n = len < capacity ? len : capacity;
+#ifdef __wasm_simd128__
+    return dot_f64x2(buffer_a, buffer_b, n);
+#else
     double d = 0.0;
     for (size_t i = 0; i < n; i++) {
         d += buffer_a[i] * buffer_b[i];
     }
     return d;
+#endif
 }
 
 WASM_EXPORT void mul(uint32_t len) {
-    size_t n = len < CAPACITY ? len : CAPACITY;
+    size_t n = len < capacity ? len : capacity;
+#ifdef __wasm_simd128__
+    mul_f64x2(buffer_a, buffer_b, result_buf, n);
+#else
     for (size_t i = 0; i < n; i++) {
         result_buf[i] = buffer_a[i] * buffer_b[i];
     }
+#endif
 }
 
 WASM_EXPORT void scale(double scalar, uint32_t len) {
-    size_t n = len < CAPACITY ? len : CAPACITY;
+    size_t n = len < capacity ? len : capacity;
+#ifdef __wasm_simd128__
+    scale_f64x2(buffer_a, scalar, n);
+#else
     for (size_t i = 0; i < n; i++) {
         buffer_a[i] *= scalar;
     }
+#endif
 }
 
 WASM_EXPORT double sum_simd(uint32_t len) {
-    size_t n = len < CAPACITY ? len : CAPACITY;
+    size_t n = len < capacity ? len : capacity;
+#ifdef __wasm_simd128__
+    return sum_f64x2(buffer_a, n);
+#else
     // 4-way unrolling for better auto-vectorization
     double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
     size_t i = 0;
@@ -73,6 +315,139 @@ WASM_EXPORT double sum_simd(uint32_t len) {
         sum0 += buffer_a[i];
     }
     return sum0 + sum1 + sum2 + sum3;
+#endif
+}
+
+// Capacity of buffers A and B in elements of the given size
+static size_t narrow_capacity(size_t size) {
+    return capacity * sizeof(double) / size;
+}
+
+WASM_EXPORT float sum_f32(uint32_t len) {
+    size_t cap = narrow_capacity(sizeof(float));
+    size_t n = len < cap ? len : cap;
+    const float* a = (const float*)buffer_a;
+#ifdef __wasm_simd128__
+    return sum_f32x4(a, n);
+#else
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t i = 0;
+
+    for (; i + 3 < n; i += 4) {
+        s0 += a[i];
+        s1 += a[i + 1];
+        s2 += a[i + 2];
+        s3 += a[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += a[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+#endif
+}
+
+WASM_EXPORT float dot_f32(uint32_t len) {
+    size_t cap = narrow_capacity(sizeof(float));
+    size_t n = len < cap ? len : cap;
+    const float* a = (const float*)buffer_a;
+    const float* b = (const float*)buffer_b;
+#ifdef __wasm_simd128__
+    return dot_f32x4(a, b, n);
+#else
+    float d0 = 0.0f, d1 = 0.0f, d2 = 0.0f, d3 = 0.0f;
+    size_t i = 0;
+
+    for (; i + 3 < n; i += 4) {
+        d0 += a[i] * b[i];
+        d1 += a[i + 1] * b[i + 1];
+        d2 += a[i + 2] * b[i + 2];
+        d3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++) {
+        d0 += a[i] * b[i];
+    }
+    return (d0 + d1) + (d2 + d3);
+#endif
+}
+
+// The int8 reductions are exact: products and partial sums widen to int64
+WASM_EXPORT int64_t sum_i8(uint32_t len) {
+    size_t cap = narrow_capacity(sizeof(int8_t));
+    size_t n = len < cap ? len : cap;
+    const int8_t* a = (const int8_t*)buffer_a;
+#ifdef __wasm_simd128__
+    return sum_i8x16(a, n);
+#else
+    int64_t s = 0;
+    for (size_t i = 0; i < n; i++) {
+        s += a[i];
+    }
+    return s;
+#endif
+}
+
+WASM_EXPORT int64_t dot_i8(uint32_t len) {
+    size_t cap = narrow_capacity(sizeof(int8_t));
+    size_t n = len < cap ? len : cap;
+    const int8_t* a = (const int8_t*)buffer_a;
+    const int8_t* b = (const int8_t*)buffer_b;
+#ifdef __wasm_simd128__
+    return dot_i8x16(a, b, n);
+#else
+    int64_t d = 0;
+    for (size_t i = 0; i < n; i++) {
+        d += (int32_t)a[i] * b[i];
+    }
+    return d;
+#endif
+}
+
+// Scores the query in buffer A (dim elements) against each row of the
+// row-major matrix in buffer B, one dot product per row into the result
+// buffer. Rows are taken four at a time so each query element is loaded once
+// per four rows. Only as many rows as fit in buffer B are scored.
+WASM_EXPORT void dot_many(uint32_t rows, uint32_t dim) {
+    if (dim == 0 || dim > capacity) {
+        return;
+    }
+    size_t n = rows < capacity / dim ? rows : capacity / dim;
+    size_t r = 0;
+
+#ifdef __wasm_simd128__
+    for (; r + 3 < n; r += 4) {
+        dot4_f64x2(buffer_a, buffer_b + r * dim, dim, result_buf + r);
+    }
+    for (; r < n; r++) {
+        result_buf[r] = dot_f64x2(buffer_a, buffer_b + r * dim, dim);
+    }
+#else
+    for (; r + 3 < n; r += 4) {
+        const double* r0 = buffer_b + r * dim;
+        const double* r1 = r0 + dim;
+        const double* r2 = r1 + dim;
+        const double* r3 = r2 + dim;
+        double d0 = 0.0, d1 = 0.0, d2 = 0.0, d3 = 0.0;
+        for (size_t i = 0; i < dim; i++) {
+            double q = buffer_a[i];
+            d0 += q * r0[i];
+            d1 += q * r1[i];
+            d2 += q * r2[i];
+            d3 += q * r3[i];
+        }
+        result_buf[r] = d0;
+        result_buf[r + 1] = d1;
+        result_buf[r + 2] = d2;
+        result_buf[r + 3] = d3;
+    }
+    for (; r < n; r++) {
+        const double* row = buffer_b + r * dim;
+        double d = 0.0;
+        for (size_t i = 0; i < dim; i++) {
+            d += buffer_a[i] * row[i];
+        }
+        result_buf[r] = d;
+    }
+#endif
 }
 
 WASM_EXPORT uint32_t get_buffer_a_offset(void) {
@@ -88,5 +463,39 @@ WASM_EXPORT uint32_t get_result_offset(void) {
 }
 
 WASM_EXPORT uint32_t get_capacity(void) {
-    return CAPACITY;
+    return (uint32_t)capacity;
+}
+
+// Grows the three buffers to hold at least n elements each and returns the
+// capacity, unchanged if memory cannot grow. Growth at least doubles so a
+// run of slightly larger inputs does not grow memory every call. The
+// buffers move to the end of linear memory and their contents are not
+// preserved; the host re-queries the get_*_offset exports afterwards.
+WASM_EXPORT uint32_t ensure_capacity(uint32_t n) {
+    if (n <= capacity) {
+        return (uint32_t)capacity;
+    }
+    // Grown memory is never released, so later grows reuse the region
+    if (heap_base == 0) {
+        heap_base = (uintptr_t)__builtin_wasm_memory_size(0) * PAGE_SIZE;
+    }
+
+    uint64_t wants[2] = {2 * (uint64_t)capacity > n ? 2 * (uint64_t)capacity : n, n};
+    for (int i = 0; i < 2; i++) {
+        uint64_t want = wants[i];
+        uint64_t end = (uint64_t)heap_base + 3 * sizeof(double) * want;
+        uint64_t have = (uint64_t)__builtin_wasm_memory_size(0) * PAGE_SIZE;
+        if (end > have) {
+            uint64_t pages = (end - have + PAGE_SIZE - 1) / PAGE_SIZE;
+            if (end > ((uint64_t)1 << 32) || __builtin_wasm_memory_grow(0, (size_t)pages) == (size_t)-1) {
+                continue;
+            }
+        }
+        buffer_a = (double*)heap_base;
+        buffer_b = buffer_a + want;
+        result_buf = buffer_b + want;
+        capacity = (size_t)want;
+        return (uint32_t)capacity;
+    }
+    return (uint32_t)capacity;
 }
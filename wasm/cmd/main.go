@@ -2,7 +2,7 @@
 //
 // Usage:
 //
-//	go run ./cmd [rust|tinygo|c]
+//	go run ./cmd [rust|tinygo|c|rust-simd|c-simd]
 //
 // If no argument given, runs whichever WASM modules are available.
 package main
@@ -12,61 +12,15 @@ import (
 	"math/rand"
 	"os"
 	"path/filepath"
-	"slices"
 	"time"
 
+	"github.com/paulstuart/cgo-ffi/bench"
 	"github.com/paulstuart/cgo-ffi/wasm/host"
 )
 
-// stats holds timing statistics for a benchmark
-type stats struct {
-	min   time.Duration
-	avg   time.Duration
-	p95   time.Duration
-	total time.Duration
-	n     int
-}
-
-// benchmark runs a function n times and collects timing statistics
-func benchmark(n int, fn func()) stats {
-	times := make([]time.Duration, n)
-
-	for i := 0; i < n; i++ {
-		start := time.Now()
-		fn()
-		times[i] = time.Since(start)
-	}
-
-	// Sort for percentile calculation
-	slices.Sort(times)
-
-	// Calculate statistics
-	var total time.Duration
-	for _, t := range times {
-		total += t
-	}
-
-	p95idx := int(float64(n) * 0.95)
-	if p95idx >= n {
-		p95idx = n - 1
-	}
-
-	return stats{
-		min:   times[0],
-		avg:   total / time.Duration(n),
-		p95:   times[p95idx],
-		total: total,
-		n:     n,
-	}
-}
-
-func (s stats) String() string {
-	return fmt.Sprintf("avg=%v  min=%v  p95=%v  (n=%d, total=%v)",
-		s.avg.Round(time.Microsecond),
-		s.min.Round(time.Microsecond),
-		s.p95.Round(time.Microsecond),
-		s.n,
-		s.total.Round(time.Millisecond))
+// benchmark runs a function n times and collects its latency distribution
+func benchmark(n int, fn func()) *bench.Stats {
+	return bench.Measure(bench.Options{Iterations: n}, fn)
 }
 
 func main() {
@@ -79,6 +33,10 @@ func main() {
 		"rust":   filepath.Join(wasmDir, "rust", "vector.wasm"),
 		"tinygo": filepath.Join(wasmDir, "tinygo", "vector.wasm"),
 		"c":      filepath.Join(wasmDir, "c", "vector.wasm"),
+
+		// Explicit simd128 kernels
+		"rust-simd": filepath.Join(wasmDir, "rust", "vector_simd.wasm"),
+		"c-simd":    filepath.Join(wasmDir, "c", "vector_simd.wasm"),
 	}
 
 	// Filter to requested or available modules
@@ -0,0 +1,123 @@
+package host
+
+import (
+	"crypto/sha256"
+	"encoding/hex"
+	"fmt"
+	"os"
+	"path/filepath"
+	"runtime"
+	"sync"
+
+	"github.com/bytecodealliance/wasmtime-go/v39"
+)
+
+// WasmModule is a compiled vector module.
+// Compilation is the expensive step, so one WasmModule and its Engine can
+// back any number of WasmVectorOps, each with its own Store and memory.
+// Engines and Modules are safe for concurrent use.
+type WasmModule struct {
+	engine *wasmtime.Engine
+	module *wasmtime.Module
+}
+
+var (
+	cacheMu  sync.Mutex
+	cacheDir = os.Getenv("WASM_MODULE_CACHE")
+)
+
+// engineKey names the engine settings compiled code depends on besides the
+// module bytes. Wasmtime also stamps its version and compiler flags into
+// each artifact and refuses mismatched ones, which counts as a cache miss.
+const engineKey = "wasmtime-go/v39 default " + runtime.GOOS + "/" + runtime.GOARCH
+
+// SetModuleCacheDir sets the directory where compiled modules are kept
+// between processes as <hash>.cwasm; "" (the default unless
+// $WASM_MODULE_CACHE is set) disables it. Cached artifacts are native code
+// loaded without validation, so the directory must be trusted.
+func SetModuleCacheDir(dir string) {
+	cacheMu.Lock()
+	cacheDir = dir
+	cacheMu.Unlock()
+}
+
+// CompileModule compiles wasmBytes, or loads the cached compilation.
+func CompileModule(wasmBytes []byte) (*WasmModule, error) {
+	engine := wasmtime.NewEngine()
+	module, err := newModule(engine, wasmBytes)
+	if err != nil {
+		engine.Close()
+		return nil, fmt.Errorf("failed to compile module: %w", err)
+	}
+	return &WasmModule{engine: engine, module: module}, nil
+}
+
+// CompileModuleFromFile compiles the WASM module at path.
+func CompileModuleFromFile(path string) (*WasmModule, error) {
+	wasmBytes, err := os.ReadFile(path)
+	if err != nil {
+		return nil, fmt.Errorf("failed to load module from %s: %w", path, err)
+	}
+	return CompileModule(wasmBytes)
+}
+
+// NewVectorOps instantiates the module in a new store.
+// The returned ops must be closed before the module.
+func (m *WasmModule) NewVectorOps() (*WasmVectorOps, error) {
+	return newWasmVectorOpsFromModule(m.engine, wasmtime.NewStore(m.engine), m.module)
+}
+
+// Close releases the engine.
+func (m *WasmModule) Close() {
+	m.engine.Close()
+}
+
+// newModule compiles code, going through the on-disk cache when enabled.
+func newModule(engine *wasmtime.Engine, code []byte) (*wasmtime.Module, error) {
+	cacheMu.Lock()
+	dir := cacheDir
+	cacheMu.Unlock()
+	if dir == "" {
+		return wasmtime.NewModule(engine, code)
+	}
+
+	h := sha256.New()
+	h.Write([]byte(engineKey))
+	h.Write(code)
+	path := filepath.Join(dir, hex.EncodeToString(h.Sum(nil)[:16])+".cwasm")
+	if module, err := wasmtime.NewModuleDeserializeFile(engine, path); err == nil {
+		return module, nil
+	}
+
+	module, err := wasmtime.NewModule(engine, code)
+	if err != nil {
+		return nil, err
+	}
+	// Best effort: an unwritable cache only costs the next start a compile
+	if blob, err := module.Serialize(); err == nil {
+		writeCacheFile(path, blob)
+	}
+	return module, nil
+}
+
+// writeCacheFile writes blob via a temporary file and rename, so concurrent
+// processes never deserialize a partial artifact.
+func writeCacheFile(path string, blob []byte) {
+	if err := os.MkdirAll(filepath.Dir(path), 0o755); err != nil {
+		return
+	}
+	tmp, err := os.CreateTemp(filepath.Dir(path), ".cwasm-*")
+	if err != nil {
+		return
+	}
+	_, err = tmp.Write(blob)
+	if cerr := tmp.Close(); err == nil {
+		err = cerr
+	}
+	if err == nil {
+		err = os.Rename(tmp.Name(), path)
+	}
+	if err != nil {
+		os.Remove(tmp.Name())
+	}
+}
@@ -0,0 +1,97 @@
+package host
+
+import (
+	"fmt"
+	"unsafe"
+
+	"github.com/bytecodealliance/wasmtime-go/v39"
+)
+
+// float32 and int8 reductions. The guests read buffers A and B as arrays of
+// the narrow type, so one pass holds 2x (float32) or 8x (int8) as many
+// elements as a float64 call, and a transfer copies a half or an eighth of
+// the bytes. The exports are optional: against a module built without them
+// the methods return an error.
+
+// cacheNarrowFunctions looks up the optional narrow exports.
+func (w *WasmVectorOps) cacheNarrowFunctions() {
+	w.fnSumF32 = w.instance.GetFunc(w.store, "sum_f32")
+	w.fnDotF32 = w.instance.GetFunc(w.store, "dot_f32")
+	w.fnSumI8 = w.instance.GetFunc(w.store, "sum_i8")
+	w.fnDotI8 = w.instance.GetFunc(w.store, "dot_i8")
+}
+
+// SumF32 returns the sum of all elements.
+func (w *WasmVectorOps) SumF32(data []float32) (float32, error) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return narrowReduce[float32, float32](w, w.fnSumF32, "sum_f32", data, nil)
+}
+
+// DotF32 computes the dot product of two vectors.
+func (w *WasmVectorOps) DotF32(a, b []float32) (float32, error) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return narrowDot[float32, float32](w, w.fnDotF32, "dot_f32", a, b)
+}
+
+// SumI8 returns the exact sum of all elements.
+func (w *WasmVectorOps) SumI8(data []int8) (int64, error) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return narrowReduce[int8, int64](w, w.fnSumI8, "sum_i8", data, nil)
+}
+
+// DotI8 computes the exact dot product of two vectors.
+func (w *WasmVectorOps) DotI8(a, b []int8) (int64, error) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return narrowDot[int8, int64](w, w.fnDotI8, "dot_i8", a, b)
+}
+
+// narrowDot is narrowReduce for a two-input export; the caller must hold w.mu.
+func narrowDot[T float32 | int8, R float32 | int64](w *WasmVectorOps, fn *wasmtime.Func, name string, a, b []T) (R, error) {
+	if len(b) < len(a) {
+		return 0, fmt.Errorf("b has %d elements, a has %d", len(b), len(a))
+	}
+	return narrowReduce[T, R](w, fn, name, a, b[:len(a)])
+}
+
+// narrowReduce runs a narrow reduction over a (and b, unless nil), a chunk
+// at a time if the buffers cannot grow to hold them, and adds up the
+// chunks' results. The caller must hold w.mu.
+func narrowReduce[T float32 | int8, R float32 | int64](w *WasmVectorOps, fn *wasmtime.Func, name string, a, b []T) (R, error) {
+	if fn == nil {
+		return 0, fmt.Errorf("module does not export '%s'", name)
+	}
+	n := len(a)
+	if n == 0 {
+		return 0, nil
+	}
+	per := 8 / int(unsafe.Sizeof(a[0]))
+	if err := w.reserveLocked((n + per - 1) / per); err != nil {
+		return 0, err
+	}
+
+	var total R
+	for lo, hi := 0, 0; lo < n; lo = hi {
+		hi = min(lo+per*int(w.capacity), n)
+		copy(narrowView[T](w.viewA), a[lo:hi])
+		if b != nil {
+			copy(narrowView[T](w.viewB), b[lo:hi])
+		}
+
+		result, err := fn.Call(w.store, int32(hi-lo))
+		if err != nil {
+			return 0, fmt.Errorf("%s failed: %w", name, err)
+		}
+		total += result.(R)
+	}
+	return total, nil
+}
+
+// narrowView reinterprets a buffer view as elements of T.
+func narrowView[T float32 | int8](v []float64) []T {
+	var t T
+	return unsafe.Slice((*T)(unsafe.Pointer(unsafe.SliceData(v))), len(v)*8/int(unsafe.Sizeof(t)))
+}
@@ -0,0 +1,187 @@
+package host
+
+import (
+	"runtime"
+	"sync/atomic"
+)
+
+// WasmVectorOpsPool spreads vector operations across several instances of
+// one compiled module.
+//
+// A single WasmVectorOps serializes every caller on one store and mutex.
+// The pool shares one Engine/Module across instances, each with its own
+// store and linear memory, so concurrent callers run in parallel.
+type WasmVectorOpsPool struct {
+	module    *WasmModule
+	ownModule bool
+	shards    []*WasmVectorOps
+	next      atomic.Uint32
+}
+
+// NewPool creates a pool of size instances of m. A size <= 0 uses
+// runtime.GOMAXPROCS(0), i.e. one instance per P. The pool must be closed
+// before the module.
+func (m *WasmModule) NewPool(size int) (*WasmVectorOpsPool, error) {
+	if size <= 0 {
+		size = runtime.GOMAXPROCS(0)
+	}
+	p := &WasmVectorOpsPool{module: m}
+	for i := 0; i < size; i++ {
+		w, err := m.NewVectorOps()
+		if err != nil {
+			p.Close()
+			return nil, err
+		}
+		p.shards = append(p.shards, w)
+	}
+	return p, nil
+}
+
+// NewWasmVectorOpsPool compiles wasmBytes once and creates a pool of size
+// instances (see WasmModule.NewPool). Close releases the module too.
+func NewWasmVectorOpsPool(wasmBytes []byte, size int) (*WasmVectorOpsPool, error) {
+	m, err := CompileModule(wasmBytes)
+	if err != nil {
+		return nil, err
+	}
+	p, err := m.NewPool(size)
+	if err != nil {
+		m.Close()
+		return nil, err
+	}
+	p.ownModule = true
+	return p, nil
+}
+
+// acquire returns a locked instance; the caller must unlock w.mu.
+// Instances are tried without blocking from a rotating start position,
+// so uncontended checkout is one atomic add and one uncontended TryLock.
+func (p *WasmVectorOpsPool) acquire() *WasmVectorOps {
+	n := uint32(len(p.shards))
+	start := p.next.Add(1)
+	for i := uint32(0); i < n; i++ {
+		w := p.shards[(start+i)%n]
+		if w.mu.TryLock() {
+			return w
+		}
+	}
+
+	// Every instance is busy - wait on our slot
+	w := p.shards[start%n]
+	w.mu.Lock()
+	return w
+}
+
+// Size returns the number of instances.
+func (p *WasmVectorOpsPool) Size() int {
+	return len(p.shards)
+}
+
+// Capacity returns the smallest element capacity of the instances'
+// buffers, which grow independently.
+func (p *WasmVectorOpsPool) Capacity() int {
+	c := p.shards[0].Capacity()
+	for _, w := range p.shards[1:] {
+		c = min(c, w.Capacity())
+	}
+	return c
+}
+
+// Reserve grows every instance's buffers to hold n elements (see
+// WasmVectorOps.Reserve).
+func (p *WasmVectorOpsPool) Reserve(n int) error {
+	for _, w := range p.shards {
+		if err := w.Reserve(n); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// Sum returns the sum of all elements.
+func (p *WasmVectorOpsPool) Sum(data []float64) float64 {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	return w.sumLocked(data)
+}
+
+// Dot computes the dot product of two vectors.
+func (p *WasmVectorOpsPool) Dot(a, b []float64) float64 {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	return w.dotLocked(a, b)
+}
+
+// Mul performs element-wise multiplication and returns a new slice.
+func (p *WasmVectorOpsPool) Mul(a, b []float64) []float64 {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	return w.mulLocked(a, b)
+}
+
+// MulInto performs element-wise multiplication into dst.
+func (p *WasmVectorOpsPool) MulInto(a, b, dst []float64) {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	w.mulIntoLocked(a, b, dst)
+}
+
+// Scale multiplies all elements by a scalar in-place.
+func (p *WasmVectorOpsPool) Scale(data []float64, scalar float64) {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	w.scaleLocked(data, scalar)
+}
+
+// DotMany scores query against every row of matrix into out.
+func (p *WasmVectorOpsPool) DotMany(query, matrix, out []float64) error {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	return w.dotManyLocked(query, matrix, out)
+}
+
+// TopK returns the k rows of matrix with the highest dot product with query.
+func (p *WasmVectorOpsPool) TopK(query, matrix []float64, k int) ([]Match, error) {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	return w.topKLocked(query, matrix, k)
+}
+
+// SumF32 returns the sum of all elements.
+func (p *WasmVectorOpsPool) SumF32(data []float32) (float32, error) {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	return narrowReduce[float32, float32](w, w.fnSumF32, "sum_f32", data, nil)
+}
+
+// DotF32 computes the dot product of two vectors.
+func (p *WasmVectorOpsPool) DotF32(a, b []float32) (float32, error) {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	return narrowDot[float32, float32](w, w.fnDotF32, "dot_f32", a, b)
+}
+
+// SumI8 returns the exact sum of all elements.
+func (p *WasmVectorOpsPool) SumI8(data []int8) (int64, error) {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	return narrowReduce[int8, int64](w, w.fnSumI8, "sum_i8", data, nil)
+}
+
+// DotI8 computes the exact dot product of two vectors.
+func (p *WasmVectorOpsPool) DotI8(a, b []int8) (int64, error) {
+	w := p.acquire()
+	defer w.mu.Unlock()
+	return narrowDot[int8, int64](w, w.fnDotI8, "dot_i8", a, b)
+}
+
+// Close releases every instance, and the module if the pool compiled it.
+func (p *WasmVectorOpsPool) Close() {
+	for _, w := range p.shards {
+		w.Close()
+	}
+	p.shards = nil
+	if p.ownModule {
+		p.module.Close()
+	}
+}
@@ -0,0 +1,110 @@
+package host
+
+import (
+	"fmt"
+	"math"
+	"sync"
+	"testing"
+)
+
+// loadWasmPool compiles a WASM module once and creates a pool of size instances
+func loadWasmPool(t testing.TB, runtime WasmRuntime, size int) *WasmVectorOpsPool {
+	m, err := CompileModuleFromFile(wasmPathOrSkip(t, runtime))
+	if err != nil {
+		t.Fatalf("failed to compile %s WASM: %v", runtime, err)
+	}
+	p, err := m.NewPool(size)
+	if err != nil {
+		m.Close()
+		t.Fatalf("NewPool failed: %v", err)
+	}
+	p.ownModule = true
+	return p
+}
+
+func TestWasmVectorOpsPool_Concurrent(t *testing.T) {
+	pool := loadWasmPool(t, RuntimeC, 4)
+	defer pool.Close()
+
+	if pool.Size() != 4 {
+		t.Errorf("Size() = %d, want 4", pool.Size())
+	}
+
+	// More goroutines than instances so checkout has to wait
+	var wg sync.WaitGroup
+	for g := 0; g < 16; g++ {
+		wg.Add(1)
+		go func(g int) {
+			defer wg.Done()
+			a, b := makeData(10+g*50), makeData(10+g*50)
+			wantSum, wantDot := goSum(a), goDot(a, b)
+			for i := 0; i < 100; i++ {
+				if got := pool.Sum(a); math.Abs(got-wantSum) > 1e-9*wantSum {
+					t.Errorf("pool.Sum = %v, want %v", got, wantSum)
+					return
+				}
+				if got := pool.Dot(a, b); math.Abs(got-wantDot) > 1e-9*wantDot {
+					t.Errorf("pool.Dot = %v, want %v", got, wantDot)
+					return
+				}
+			}
+		}(g)
+	}
+	wg.Wait()
+}
+
+// BenchmarkParallel runs Sum and Dot from GOMAXPROCS goroutines against one
+// instance (every call on one store and mutex) and against a pool of one
+// instance per P. Run with -cpu 1,2,4,8 to see how each scales.
+func BenchmarkParallel(b *testing.B) {
+	for _, runtime := range []WasmRuntime{RuntimeC, RuntimeRust, RuntimeTinyGo} {
+		for _, n := range []int{1000, 10000} {
+			x, y := makeData(n), makeData(n)
+
+			b.Run(fmt.Sprintf("Sum/Single/%s/%d", runtime, n), func(b *testing.B) {
+				ops := loadWasmOps(b, runtime)
+				defer ops.Close()
+				b.SetBytes(int64(8 * n))
+				b.ResetTimer()
+				b.RunParallel(func(pb *testing.PB) {
+					for pb.Next() {
+						_ = ops.Sum(x)
+					}
+				})
+			})
+			b.Run(fmt.Sprintf("Sum/Pool/%s/%d", runtime, n), func(b *testing.B) {
+				pool := loadWasmPool(b, runtime, 0)
+				defer pool.Close()
+				b.SetBytes(int64(8 * n))
+				b.ResetTimer()
+				b.RunParallel(func(pb *testing.PB) {
+					for pb.Next() {
+						_ = pool.Sum(x)
+					}
+				})
+			})
+			b.Run(fmt.Sprintf("Dot/Single/%s/%d", runtime, n), func(b *testing.B) {
+				ops := loadWasmOps(b, runtime)
+				defer ops.Close()
+				b.SetBytes(int64(16 * n))
+				b.ResetTimer()
+				b.RunParallel(func(pb *testing.PB) {
+					for pb.Next() {
+						_ = ops.Dot(x, y)
+					}
+				})
+			})
+			b.Run(fmt.Sprintf("Dot/Pool/%s/%d", runtime, n), func(b *testing.B) {
+				pool := loadWasmPool(b, runtime, 0)
+				defer pool.Close()
+				b.SetBytes(int64(16 * n))
+				b.ResetTimer()
+				b.RunParallel(func(pb *testing.PB) {
+					for pb.Next() {
+						_ = pool.Dot(x, y)
+					}
+				})
+			})
+		}
+	}
+}
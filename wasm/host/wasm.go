@@ -9,6 +9,7 @@ package host
 
 import (
 	"fmt"
+	"math"
 	"sync"
 	"unsafe"
 
@@ -23,6 +24,7 @@ func wasiConfig() *wasmtime.WasiConfig {
 
 // WasmVectorOps provides WASM-backed vector operations.
 // After initialization, calls involve only memory copies and function invocations.
+// An input longer than the buffers grows them first (see Reserve).
 type WasmVectorOps struct {
 	engine   *wasmtime.Engine
 	store    *wasmtime.Store
@@ -35,13 +37,32 @@ type WasmVectorOps struct {
 	fnMul        *wasmtime.Func
 	fnScale      *wasmtime.Func
 	fnSumSimd    *wasmtime.Func
+	fnDotMany    *wasmtime.Func
 
-	// Pre-computed buffer offsets in WASM linear memory
+	// float32 and int8 reductions, nil if the module lacks them (see narrow.go)
+	fnSumF32, fnDotF32, fnSumI8, fnDotI8 *wasmtime.Func
+
+	// Layout getters, re-queried after the buffers grow
+	fnBufferAOffset *wasmtime.Func
+	fnBufferBOffset *wasmtime.Func
+	fnResultOffset  *wasmtime.Func
+	fnCapacity      *wasmtime.Func
+
+	// ensure_capacity, or nil for modules with fixed buffers
+	fnEnsureCapacity *wasmtime.Func
+
+	// Buffer offsets in WASM linear memory, cached by queryLayout
 	bufferAOffset uint32
 	bufferBOffset uint32
 	resultOffset  uint32
 	capacity      uint32
 
+	// Typed views of the buffers, cached by cacheViews
+	viewA, viewB, viewResult []float64
+
+	// Set when the engine is private to this instance (NewWasmVectorOps)
+	ownsEngine bool
+
 	// Thread safety
 	mu sync.Mutex
 }
@@ -53,33 +74,42 @@ const (
 	RuntimeRust   WasmRuntime = "rust"
 	RuntimeTinyGo WasmRuntime = "tinygo"
 	RuntimeC      WasmRuntime = "c"
+
+	// SIMD variants (vector_simd.wasm): the same exports on explicit
+	// simd128 kernels
+	RuntimeRustSIMD WasmRuntime = "rust-simd"
+	RuntimeCSIMD    WasmRuntime = "c-simd"
 )
 
 // NewWasmVectorOps loads a WASM module and initializes the vector operations.
-// The wasmBytes should be the compiled WASM binary.
+// The wasmBytes should be the compiled WASM binary. To run many instances of
+// one module, compile it once with CompileModule and call NewVectorOps.
 func NewWasmVectorOps(wasmBytes []byte) (*WasmVectorOps, error) {
-	engine := wasmtime.NewEngine()
-	store := wasmtime.NewStore(engine)
-
-	module, err := wasmtime.NewModule(engine, wasmBytes)
+	m, err := CompileModule(wasmBytes)
 	if err != nil {
-		return nil, fmt.Errorf("failed to compile module: %w", err)
+		return nil, err
 	}
-
-	return newWasmVectorOpsFromModule(engine, store, module)
+	return m.ownedVectorOps()
 }
 
 // NewWasmVectorOpsFromFile loads a WASM module from a file path.
 func NewWasmVectorOpsFromFile(path string) (*WasmVectorOps, error) {
-	engine := wasmtime.NewEngine()
-	store := wasmtime.NewStore(engine)
-
-	module, err := wasmtime.NewModuleFromFile(engine, path)
+	m, err := CompileModuleFromFile(path)
 	if err != nil {
-		return nil, fmt.Errorf("failed to load module from %s: %w", path, err)
+		return nil, err
 	}
+	return m.ownedVectorOps()
+}
 
-	return newWasmVectorOpsFromModule(engine, store, module)
+// ownedVectorOps instantiates m for callers that never see it; Close releases m too.
+func (m *WasmModule) ownedVectorOps() (*WasmVectorOps, error) {
+	w, err := m.NewVectorOps()
+	if err != nil {
+		m.Close()
+		return nil, err
+	}
+	w.ownsEngine = true
+	return w, nil
 }
 
 func newWasmVectorOpsFromModule(engine *wasmtime.Engine, store *wasmtime.Store, module *wasmtime.Module) (*WasmVectorOps, error) {
@@ -154,6 +184,7 @@ func (w *WasmVectorOps) cacheFunctions() error {
 		"mul":      &w.fnMul,
 		"scale":    &w.fnScale,
 		"sum_simd": &w.fnSumSimd,
+		"dot_many": &w.fnDotMany,
 	}
 
 	for name, ptr := range funcs {
@@ -163,225 +194,446 @@ func (w *WasmVectorOps) cacheFunctions() error {
 		}
 		*ptr = fn
 	}
+	w.cacheNarrowFunctions()
 	return nil
 }
 
 func (w *WasmVectorOps) cacheOffsets() error {
-	// Get buffer A offset
-	fn := w.instance.GetFunc(w.store, "get_buffer_a_offset")
-	if fn == nil {
-		return fmt.Errorf("module does not export 'get_buffer_a_offset'")
+	getters := map[string]**wasmtime.Func{
+		"get_buffer_a_offset": &w.fnBufferAOffset,
+		"get_buffer_b_offset": &w.fnBufferBOffset,
+		"get_result_offset":   &w.fnResultOffset,
+		"get_capacity":        &w.fnCapacity,
 	}
-	result, err := fn.Call(w.store)
-	if err != nil {
-		return fmt.Errorf("get_buffer_a_offset failed: %w", err)
+	for name, ptr := range getters {
+		fn := w.instance.GetFunc(w.store, name)
+		if fn == nil {
+			return fmt.Errorf("module does not export '%s'", name)
+		}
+		*ptr = fn
 	}
-	w.bufferAOffset = uint32(result.(int32))
 
-	// Get buffer B offset
-	fn = w.instance.GetFunc(w.store, "get_buffer_b_offset")
-	if fn == nil {
-		return fmt.Errorf("module does not export 'get_buffer_b_offset'")
+	// Optional: without it inputs past the capacity are streamed in chunks
+	w.fnEnsureCapacity = w.instance.GetFunc(w.store, "ensure_capacity")
+
+	return w.queryLayout()
+}
+
+// queryLayout reads the buffer offsets and capacity, which change when
+// ensure_capacity moves the buffers, and re-caches the views.
+func (w *WasmVectorOps) queryLayout() error {
+	getters := []struct {
+		name string
+		fn   *wasmtime.Func
+		dst  *uint32
+	}{
+		{"get_buffer_a_offset", w.fnBufferAOffset, &w.bufferAOffset},
+		{"get_buffer_b_offset", w.fnBufferBOffset, &w.bufferBOffset},
+		{"get_result_offset", w.fnResultOffset, &w.resultOffset},
+		{"get_capacity", w.fnCapacity, &w.capacity},
+	}
+	for _, g := range getters {
+		result, err := g.fn.Call(w.store)
+		if err != nil {
+			return fmt.Errorf("%s failed: %w", g.name, err)
+		}
+		*g.dst = uint32(result.(int32))
 	}
-	result, err = fn.Call(w.store)
-	if err != nil {
-		return fmt.Errorf("get_buffer_b_offset failed: %w", err)
+	if w.capacity == 0 {
+		return fmt.Errorf("module reports zero buffer capacity")
 	}
-	w.bufferBOffset = uint32(result.(int32))
+	return w.cacheViews()
+}
 
-	// Get result offset
-	fn = w.instance.GetFunc(w.store, "get_result_offset")
-	if fn == nil {
-		return fmt.Errorf("module does not export 'get_result_offset'")
+// Reserve grows the module's buffers to hold n elements, so later calls
+// with inputs up to n run in one pass. Operations reserve for their own
+// inputs, so this is only needed to move the growth out of a hot path.
+// If the module cannot grow that far (or has fixed buffers) Reserve
+// returns an error, and longer inputs are streamed through the buffers in
+// capacity-element chunks.
+func (w *WasmVectorOps) Reserve(n int) error {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	if err := w.reserveLocked(n); err != nil {
+		return err
 	}
-	result, err = fn.Call(w.store)
-	if err != nil {
-		return fmt.Errorf("get_result_offset failed: %w", err)
+	if n > int(w.capacity) {
+		return fmt.Errorf("buffers hold %d elements, cannot grow to %d", w.capacity, n)
 	}
-	w.resultOffset = uint32(result.(int32))
+	return nil
+}
 
-	// Get capacity
-	fn = w.instance.GetFunc(w.store, "get_capacity")
-	if fn == nil {
-		return fmt.Errorf("module does not export 'get_capacity'")
-	}
-	result, err = fn.Call(w.store)
-	if err != nil {
-		return fmt.Errorf("get_capacity failed: %w", err)
+// reserveLocked is Reserve without the capacity check; the caller must
+// hold w.mu. It fails only if the layout can no longer be read.
+func (w *WasmVectorOps) reserveLocked(n int) error {
+	if n <= int(w.capacity) || w.fnEnsureCapacity == nil {
+		return nil
 	}
-	w.capacity = uint32(result.(int32))
+	// A failed grow (even a trap) just leaves the capacity short, but the
+	// layout is re-read either way in case the buffers moved
+	_, _ = w.fnEnsureCapacity.Call(w.store, int32(min(n, math.MaxInt32)))
+	return w.queryLayout()
+}
 
-	return nil
+// chunkEnd returns the end of the chunk of an n-element input starting at
+// lo: inputs longer than the buffers go through them capacity elements at
+// a time.
+func (w *WasmVectorOps) chunkEnd(lo, n int) int {
+	return min(lo+int(w.capacity), n)
 }
 
 // Close releases WASM resources.
 func (w *WasmVectorOps) Close() {
 	w.store.Close()
-	w.engine.Close()
+	if w.ownsEngine {
+		w.engine.Close()
+	}
 }
 
-// Capacity returns the maximum number of elements the buffers can hold.
+// Capacity returns the number of elements the buffers currently hold in
+// one pass. It grows as Reserve or longer inputs grow the buffers.
 func (w *WasmVectorOps) Capacity() int {
+	w.mu.Lock()
+	defer w.mu.Unlock()
 	return int(w.capacity)
 }
 
-// copyToWasm copies float64 slice to WASM linear memory at the given offset.
-// Uses unsafe pointer casting for maximum performance (valid since f64 is same on both sides).
-func (w *WasmVectorOps) copyToWasm(data []float64, offset uint32) {
-	mem := w.memory.UnsafeData(w.store)
-	dst := mem[offset : offset+uint32(len(data)*8)]
-	src := unsafe.Slice((*byte)(unsafe.Pointer(&data[0])), len(data)*8)
-	copy(dst, src)
-}
-
-// copyFromWasm copies float64 values from WASM linear memory.
-// Uses unsafe pointer casting for maximum performance.
-func (w *WasmVectorOps) copyFromWasm(dst []float64, offset uint32) {
+// cacheViews slices typed views of the three buffers out of linear memory,
+// so each transfer is one bulk copy with no call into wasmtime (fetching
+// the memory is a cgo call per use). Only ensure_capacity grows memory,
+// and wasmtime reserves a 32-bit memory's whole address range up front on
+// 64-bit hosts, so the views stay valid until then; queryLayout calls
+// cacheViews again after every grow.
+func (w *WasmVectorOps) cacheViews() error {
 	mem := w.memory.UnsafeData(w.store)
-	src := mem[offset : offset+uint32(len(dst)*8)]
-	dstBytes := unsafe.Slice((*byte)(unsafe.Pointer(&dst[0])), len(dst)*8)
-	copy(dstBytes, src)
+	size := uint64(w.capacity) * 8
+	view := func(offset uint32) []float64 {
+		if size == 0 {
+			return nil
+		}
+		return unsafe.Slice((*float64)(unsafe.Pointer(&mem[offset])), w.capacity)
+	}
+	for _, offset := range []uint32{w.bufferAOffset, w.bufferBOffset, w.resultOffset} {
+		if uint64(offset)+size > uint64(len(mem)) {
+			return fmt.Errorf("buffer at offset %d with capacity %d exceeds linear memory (%d bytes)",
+				offset, w.capacity, len(mem))
+		}
+	}
+	w.viewA, w.viewB, w.viewResult = view(w.bufferAOffset), view(w.bufferBOffset), view(w.resultOffset)
+	return nil
 }
 
 // Sum returns the sum of all elements.
 func (w *WasmVectorOps) Sum(data []float64) float64 {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return w.sumLocked(data)
+}
+
+// sumLocked is Sum; the caller must hold w.mu.
+func (w *WasmVectorOps) sumLocked(data []float64) float64 {
+	return w.sumWith(w.fnSum, data)
+}
+
+// sumWith sums data with one of the sum exports, a chunk at a time if the
+// buffers cannot grow to hold it.
+func (w *WasmVectorOps) sumWith(fn *wasmtime.Func, data []float64) float64 {
 	n := len(data)
-	if n == 0 {
+	if n == 0 || w.reserveLocked(n) != nil {
 		return 0
 	}
-	if n > int(w.capacity) {
-		n = int(w.capacity)
-	}
 
-	w.mu.Lock()
-	defer w.mu.Unlock()
+	var total float64
+	for lo, hi := 0, 0; lo < n; lo = hi {
+		hi = w.chunkEnd(lo, n)
 
-	// Copy data to WASM buffer A
-	w.copyToWasm(data[:n], w.bufferAOffset)
+		// Copy data to WASM buffer A
+		copy(w.viewA, data[lo:hi])
 
-	// Call WASM function
-	result, err := w.fnSum.Call(w.store, int32(n))
-	if err != nil {
-		return 0
+		// Call WASM function
+		result, err := fn.Call(w.store, int32(hi-lo))
+		if err != nil {
+			return 0
+		}
+		total += result.(float64)
 	}
-	return result.(float64)
+	return total
 }
 
 // SumSIMD uses the SIMD-optimized sum function.
 func (w *WasmVectorOps) SumSIMD(data []float64) float64 {
-	n := len(data)
-	if n == 0 {
-		return 0
-	}
-	if n > int(w.capacity) {
-		n = int(w.capacity)
-	}
-
 	w.mu.Lock()
 	defer w.mu.Unlock()
-
-	w.copyToWasm(data[:n], w.bufferAOffset)
-
-	result, err := w.fnSumSimd.Call(w.store, int32(n))
-	if err != nil {
-		return 0
-	}
-	return result.(float64)
+	return w.sumWith(w.fnSumSimd, data)
 }
 
 // Dot computes the dot product of two vectors.
 func (w *WasmVectorOps) Dot(a, b []float64) float64 {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return w.dotLocked(a, b)
+}
+
+// dotLocked is Dot; the caller must hold w.mu.
+func (w *WasmVectorOps) dotLocked(a, b []float64) float64 {
 	n := len(a)
-	if n == 0 || len(b) < n {
+	if n == 0 || len(b) < n || w.reserveLocked(n) != nil {
 		return 0
 	}
-	if n > int(w.capacity) {
-		n = int(w.capacity)
-	}
 
-	w.mu.Lock()
-	defer w.mu.Unlock()
+	var total float64
+	for lo, hi := 0, 0; lo < n; lo = hi {
+		hi = w.chunkEnd(lo, n)
+		copy(w.viewA, a[lo:hi])
+		copy(w.viewB, b[lo:hi])
 
-	w.copyToWasm(a[:n], w.bufferAOffset)
-	w.copyToWasm(b[:n], w.bufferBOffset)
-
-	result, err := w.fnDot.Call(w.store, int32(n))
-	if err != nil {
-		return 0
+		result, err := w.fnDot.Call(w.store, int32(hi-lo))
+		if err != nil {
+			return 0
+		}
+		total += result.(float64)
 	}
-	return result.(float64)
+	return total
 }
 
 // Mul performs element-wise multiplication: result[i] = a[i] * b[i]
 func (w *WasmVectorOps) Mul(a, b []float64) []float64 {
-	n := len(a)
-	if n == 0 || len(b) < n {
-		return nil
-	}
-	if n > int(w.capacity) {
-		n = int(w.capacity)
-	}
-
 	w.mu.Lock()
 	defer w.mu.Unlock()
+	return w.mulLocked(a, b)
+}
 
-	w.copyToWasm(a[:n], w.bufferAOffset)
-	w.copyToWasm(b[:n], w.bufferBOffset)
-
-	_, err := w.fnMul.Call(w.store, int32(n))
-	if err != nil {
+// mulLocked is Mul; the caller must hold w.mu.
+func (w *WasmVectorOps) mulLocked(a, b []float64) []float64 {
+	n := len(a)
+	if n == 0 || len(b) < n {
 		return nil
 	}
 
 	result := make([]float64, n)
-	w.copyFromWasm(result, w.resultOffset)
+	if !w.mulChunks(a, b, result) {
+		return nil
+	}
 	return result
 }
 
 // MulInto performs element-wise multiplication into a provided destination.
 func (w *WasmVectorOps) MulInto(a, b, dst []float64) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	w.mulIntoLocked(a, b, dst)
+}
+
+// mulIntoLocked is MulInto; the caller must hold w.mu.
+func (w *WasmVectorOps) mulIntoLocked(a, b, dst []float64) {
 	n := len(a)
 	if n == 0 || len(b) < n || len(dst) < n {
 		return
 	}
-	if n > int(w.capacity) {
-		n = int(w.capacity)
+	w.mulChunks(a, b, dst)
+}
+
+// mulChunks multiplies a and b into dst a chunk at a time, reporting
+// whether every chunk succeeded.
+func (w *WasmVectorOps) mulChunks(a, b, dst []float64) bool {
+	n := len(a)
+	if w.reserveLocked(n) != nil {
+		return false
 	}
 
-	w.mu.Lock()
-	defer w.mu.Unlock()
+	for lo, hi := 0, 0; lo < n; lo = hi {
+		hi = w.chunkEnd(lo, n)
+		copy(w.viewA, a[lo:hi])
+		copy(w.viewB, b[lo:hi])
 
-	w.copyToWasm(a[:n], w.bufferAOffset)
-	w.copyToWasm(b[:n], w.bufferBOffset)
+		_, err := w.fnMul.Call(w.store, int32(hi-lo))
+		if err != nil {
+			return false
+		}
 
-	_, err := w.fnMul.Call(w.store, int32(n))
-	if err != nil {
-		return
+		copy(dst[lo:hi], w.viewResult)
 	}
-
-	w.copyFromWasm(dst[:n], w.resultOffset)
+	return true
 }
 
 // Scale multiplies all elements by a scalar.
 // Note: This modifies the internal buffer, not the input slice.
 func (w *WasmVectorOps) Scale(data []float64, scalar float64) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	w.scaleLocked(data, scalar)
+}
+
+// scaleLocked is Scale; the caller must hold w.mu.
+func (w *WasmVectorOps) scaleLocked(data []float64, scalar float64) {
 	n := len(data)
-	if n == 0 {
+	if n == 0 || w.reserveLocked(n) != nil {
 		return
 	}
-	if n > int(w.capacity) {
-		n = int(w.capacity)
+
+	for lo, hi := 0, 0; lo < n; lo = hi {
+		hi = w.chunkEnd(lo, n)
+		copy(w.viewA, data[lo:hi])
+
+		_, err := w.fnScale.Call(w.store, scalar, int32(hi-lo))
+		if err != nil {
+			return
+		}
+
+		copy(data[lo:hi], w.viewA)
 	}
+}
 
+// Match is a TopK result: a matrix row and its dot product with the query.
+type Match struct {
+	Index int
+	Score float64
+}
+
+// DotMany scores query against every row of matrix, a row-major array of
+// len(query)-element rows: out[r] = Dot(query, row r). The query is copied
+// into the module once, and rows in batches of as many as fit its buffer,
+// so a batch costs one call per capacity/len(query) rows instead of one
+// call and two copies per row.
+func (w *WasmVectorOps) DotMany(query, matrix, out []float64) error {
 	w.mu.Lock()
 	defer w.mu.Unlock()
+	return w.dotManyLocked(query, matrix, out)
+}
 
-	w.copyToWasm(data[:n], w.bufferAOffset)
+// dotManyLocked is DotMany; the caller must hold w.mu.
+func (w *WasmVectorOps) dotManyLocked(query, matrix, out []float64) error {
+	if len(query) > 0 && len(out) < len(matrix)/len(query) {
+		return fmt.Errorf("out has %d elements, matrix has %d rows", len(out), len(matrix)/len(query))
+	}
+	return w.scoreBatches(query, matrix, func(r0 int, scores []float64) {
+		copy(out[r0:], scores)
+	})
+}
 
-	_, err := w.fnScale.Call(w.store, scalar, int32(n))
+// TopK returns the k rows of matrix (laid out as for DotMany) with the
+// highest dot product with query, best first; ties go to the lower index
+// and rows scoring NaN are never returned. Selection reads each batch's
+// scores in place from the module's result buffer.
+func (w *WasmVectorOps) TopK(query, matrix []float64, k int) ([]Match, error) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return w.topKLocked(query, matrix, k)
+}
+
+// topKLocked is TopK; the caller must hold w.mu.
+func (w *WasmVectorOps) topKLocked(query, matrix []float64, k int) ([]Match, error) {
+	sel := topK{k: k}
+	if len(query) > 0 {
+		sel.heap = make([]Match, 0, max(0, min(k, len(matrix)/len(query))))
+	}
+	err := w.scoreBatches(query, matrix, func(r0 int, scores []float64) {
+		for j, s := range scores {
+			sel.push(Match{r0 + j, s})
+		}
+	})
 	if err != nil {
+		return nil, err
+	}
+	return sel.sorted(), nil
+}
+
+// scoreBatches runs dot_many over matrix in batches that fit the module's
+// buffers, handing fn each batch's first row and its scores. The scores
+// alias the result buffer and are overwritten by the next batch.
+func (w *WasmVectorOps) scoreBatches(query, matrix []float64, fn func(r0 int, scores []float64)) error {
+	dim := len(query)
+	if dim == 0 {
+		return fmt.Errorf("empty query")
+	}
+	if len(matrix)%dim != 0 {
+		return fmt.Errorf("matrix has %d elements, not a multiple of query length %d", len(matrix), dim)
+	}
+	if err := w.reserveLocked(dim); err != nil {
+		return err
+	}
+	if dim > int(w.capacity) {
+		return fmt.Errorf("query length %d exceeds buffer capacity %d", dim, w.capacity)
+	}
+	rows, batch := len(matrix)/dim, int(w.capacity)/dim
+	if rows == 0 {
+		return nil
+	}
+
+	copy(w.viewA, query)
+	for r0 := 0; r0 < rows; r0 += batch {
+		n := min(batch, rows-r0)
+		copy(w.viewB, matrix[r0*dim:(r0+n)*dim])
+		if _, err := w.fnDotMany.Call(w.store, int32(n), int32(dim)); err != nil {
+			return fmt.Errorf("dot_many failed: %w", err)
+		}
+		fn(r0, w.viewResult[:n])
+	}
+	return nil
+}
+
+// topK keeps the k best matches pushed so far in a heap with the worst on
+// top, so a candidate that does not make the cut costs one comparison.
+type topK struct {
+	k    int
+	heap []Match
+}
+
+// better orders by higher score, then lower index.
+func better(a, b Match) bool {
+	return a.Score > b.Score || (a.Score == b.Score && a.Index < b.Index)
+}
+
+func (t *topK) push(m Match) {
+	if math.IsNaN(m.Score) {
 		return
 	}
+	h := t.heap
+	if len(h) < t.k {
+		h = append(h, m)
+		for i := len(h) - 1; i > 0; {
+			p := (i - 1) / 2
+			if !better(h[p], h[i]) {
+				break
+			}
+			h[p], h[i] = h[i], h[p]
+			i = p
+		}
+		t.heap = h
+		return
+	}
+	if len(h) > 0 && better(m, h[0]) {
+		h[0] = m
+		t.down(len(h))
+	}
+}
+
+// down sifts the top of heap[:n] into place.
+func (t *topK) down(n int) {
+	h := t.heap
+	for i := 0; ; {
+		l, w := 2*i+1, i
+		if l < n && better(h[w], h[l]) {
+			w = l
+		}
+		if l+1 < n && better(h[w], h[l+1]) {
+			w = l + 1
+		}
+		if w == i {
+			return
+		}
+		h[i], h[w] = h[w], h[i]
+		i = w
+	}
+}
 
-	w.copyFromWasm(data[:n], w.bufferAOffset)
+// sorted heapsorts the matches best first: moving the worst remaining match
+// to the back leaves the best at the front.
+func (t *topK) sorted() []Match {
+	h := t.heap
+	for end := len(h); end > 1; end-- {
+		h[0], h[end-1] = h[end-1], h[0]
+		t.down(end - 1)
+	}
+	return h
 }
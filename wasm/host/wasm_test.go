@@ -13,6 +13,9 @@ var wasmPaths = map[WasmRuntime]string{
 	RuntimeRust:   "../rust/vector.wasm",
 	RuntimeTinyGo: "../tinygo/vector.wasm",
 	RuntimeC:      "../c/vector.wasm",
+
+	RuntimeRustSIMD: "../rust/vector_simd.wasm",
+	RuntimeCSIMD:    "../c/vector_simd.wasm",
 }
 
 // Helper to create random test data
@@ -112,6 +115,146 @@ func TestDotCorrectness_Rust(t *testing.T)   { testDotCorrectness(t, RuntimeRust
 func TestDotCorrectness_TinyGo(t *testing.T) { testDotCorrectness(t, RuntimeTinyGo) }
 func TestDotCorrectness_C(t *testing.T)      { testDotCorrectness(t, RuntimeC) }
 
+func TestSumCorrectness_RustSIMD(t *testing.T) { testSumCorrectness(t, RuntimeRustSIMD) }
+func TestSumCorrectness_CSIMD(t *testing.T)    { testSumCorrectness(t, RuntimeCSIMD) }
+func TestDotCorrectness_RustSIMD(t *testing.T) { testDotCorrectness(t, RuntimeRustSIMD) }
+func TestDotCorrectness_CSIMD(t *testing.T)    { testDotCorrectness(t, RuntimeCSIMD) }
+
+// Odd lengths leave scalar tails after the SIMD loops
+func testMulScaleCorrectness(t *testing.T, runtime WasmRuntime) {
+	ops := loadWasmOps(t, runtime)
+	defer ops.Close()
+
+	for _, n := range []int{1, 7, 1001} {
+		a, b := makeData(n), makeData(n)
+		got := ops.Mul(a, b)
+		for i := range a {
+			if got[i] != a[i]*b[i] {
+				t.Fatalf("%s Mul(len %d)[%d] = %v, want %v", runtime, n, i, got[i], a[i]*b[i])
+			}
+		}
+		scaled := append([]float64(nil), a...)
+		ops.Scale(scaled, 0.5)
+		for i := range a {
+			if scaled[i] != a[i]*0.5 {
+				t.Fatalf("%s Scale(len %d)[%d] = %v, want %v", runtime, n, i, scaled[i], a[i]*0.5)
+			}
+		}
+	}
+}
+
+func TestMulScaleCorrectness_Rust(t *testing.T)     { testMulScaleCorrectness(t, RuntimeRust) }
+func TestMulScaleCorrectness_TinyGo(t *testing.T)   { testMulScaleCorrectness(t, RuntimeTinyGo) }
+func TestMulScaleCorrectness_C(t *testing.T)        { testMulScaleCorrectness(t, RuntimeC) }
+func TestMulScaleCorrectness_RustSIMD(t *testing.T) { testMulScaleCorrectness(t, RuntimeRustSIMD) }
+func TestMulScaleCorrectness_CSIMD(t *testing.T)    { testMulScaleCorrectness(t, RuntimeCSIMD) }
+
+// Inputs past the initial capacity grow the buffers; once growth is ruled
+// out, longer inputs stream through them in chunks
+func testGrowCorrectness(t *testing.T, runtime WasmRuntime) {
+	ops := loadWasmOps(t, runtime)
+	defer ops.Close()
+
+	check := func(what string, n int) {
+		a, b := makeData(n), makeData(n)
+		if got, want := ops.Sum(a), goSum(a); math.Abs(got-want) > 1e-9*want {
+			t.Errorf("%s %s Sum(len %d) = %v, want %v", runtime, what, n, got, want)
+		}
+		if got, want := ops.Dot(a, b), goDot(a, b); math.Abs(got-want) > 1e-9*want {
+			t.Errorf("%s %s Dot(len %d) = %v, want %v", runtime, what, n, got, want)
+		}
+		got := ops.Mul(a, b)
+		if len(got) != n {
+			t.Fatalf("%s %s Mul(len %d) returned %d elements", runtime, what, n, len(got))
+		}
+		scaled := append([]float64(nil), a...)
+		ops.Scale(scaled, 0.5)
+		for i := range a {
+			if got[i] != a[i]*b[i] || scaled[i] != a[i]*0.5 {
+				t.Fatalf("%s %s Mul/Scale(len %d) wrong at %d", runtime, what, n, i)
+			}
+		}
+	}
+
+	initial := ops.Capacity()
+	n := 2*initial + 501
+	check("grown", n)
+	if ops.Capacity() < n {
+		t.Errorf("%s Capacity() = %d after len %d input, want >= %d", runtime, ops.Capacity(), n, n)
+	}
+	if err := ops.Reserve(n); err != nil {
+		t.Errorf("%s Reserve(%d) after growth: %v", runtime, n, err)
+	}
+
+	ops.fnEnsureCapacity = nil
+	if err := ops.Reserve(2 * ops.Capacity()); err == nil {
+		t.Errorf("%s: expected Reserve error without ensure_capacity", runtime)
+	}
+	check("chunked", 2*ops.Capacity()+7)
+}
+
+func TestGrowCorrectness_Rust(t *testing.T)     { testGrowCorrectness(t, RuntimeRust) }
+func TestGrowCorrectness_TinyGo(t *testing.T)   { testGrowCorrectness(t, RuntimeTinyGo) }
+func TestGrowCorrectness_C(t *testing.T)        { testGrowCorrectness(t, RuntimeC) }
+func TestGrowCorrectness_RustSIMD(t *testing.T) { testGrowCorrectness(t, RuntimeRustSIMD) }
+func TestGrowCorrectness_CSIMD(t *testing.T)    { testGrowCorrectness(t, RuntimeCSIMD) }
+
+// The float32 and int8 reductions at SIMD-boundary lengths, one past the
+// initial capacity in float64 elements (still one pass) and past 8x it
+// (grown), and chunked once growth is ruled out. int8 results must be exact.
+func testNarrowCorrectness(t *testing.T, runtime WasmRuntime) {
+	ops := loadWasmOps(t, runtime)
+	defer ops.Close()
+	if ops.fnSumF32 == nil {
+		t.Skipf("%s module predates the narrow exports (rebuild it)", runtime)
+	}
+
+	check := func(n int) {
+		fa, fb := make([]float32, n), make([]float32, n)
+		ia, ib := make([]int8, n), make([]int8, n)
+		var fs, fd float64
+		var is, id int64
+		for i := range fa {
+			fa[i], fb[i] = rand.Float32()*2-1, rand.Float32()*2-1
+			ia[i], ib[i] = int8(rand.Intn(256)-128), int8(rand.Intn(256)-128)
+			fs += float64(fa[i])
+			fd += float64(fa[i]) * float64(fb[i])
+			is += int64(ia[i])
+			id += int64(ia[i]) * int64(ib[i])
+		}
+		tol := 1e-3 * math.Sqrt(float64(n))
+		if got, err := ops.SumF32(fa); err != nil || math.Abs(float64(got)-fs) > tol {
+			t.Errorf("%s SumF32(len %d) = %v, %v; want %v", runtime, n, got, err, fs)
+		}
+		if got, err := ops.DotF32(fa, fb); err != nil || math.Abs(float64(got)-fd) > tol {
+			t.Errorf("%s DotF32(len %d) = %v, %v; want %v", runtime, n, got, err, fd)
+		}
+		if got, err := ops.SumI8(ia); err != nil || got != is {
+			t.Errorf("%s SumI8(len %d) = %v, %v; want %v", runtime, n, got, err, is)
+		}
+		if got, err := ops.DotI8(ia, ib); err != nil || got != id {
+			t.Errorf("%s DotI8(len %d) = %v, %v; want %v", runtime, n, got, err, id)
+		}
+	}
+
+	initial := ops.Capacity()
+	for _, n := range []int{1, 15, 16, 17, 33, 1001, initial + 1, 8*initial + 3} {
+		check(n)
+	}
+	if _, err := ops.DotI8(make([]int8, 4), make([]int8, 3)); err == nil {
+		t.Errorf("%s: expected DotI8 error for a short b", runtime)
+	}
+
+	ops.fnEnsureCapacity = nil
+	check(16*ops.Capacity() + 5)
+}
+
+func TestNarrowCorrectness_Rust(t *testing.T)     { testNarrowCorrectness(t, RuntimeRust) }
+func TestNarrowCorrectness_TinyGo(t *testing.T)   { testNarrowCorrectness(t, RuntimeTinyGo) }
+func TestNarrowCorrectness_C(t *testing.T)        { testNarrowCorrectness(t, RuntimeC) }
+func TestNarrowCorrectness_RustSIMD(t *testing.T) { testNarrowCorrectness(t, RuntimeRustSIMD) }
+func TestNarrowCorrectness_CSIMD(t *testing.T)    { testNarrowCorrectness(t, RuntimeCSIMD) }
+
 // --- Benchmarks ---
 
 // Benchmark helpers
@@ -220,6 +363,19 @@ func BenchmarkDot_Wasm_C_100000(b *testing.B) { benchmarkWasmDot(b, RuntimeC, 10
 
 func BenchmarkMul_Wasm_C_10000(b *testing.B) { benchmarkWasmMul(b, RuntimeC, 10000) }
 
+// SIMD variants
+func BenchmarkSum_Wasm_RustSIMD_10000(b *testing.B)  { benchmarkWasmSum(b, RuntimeRustSIMD, 10000) }
+func BenchmarkSum_Wasm_RustSIMD_100000(b *testing.B) { benchmarkWasmSum(b, RuntimeRustSIMD, 100000) }
+func BenchmarkDot_Wasm_RustSIMD_10000(b *testing.B)  { benchmarkWasmDot(b, RuntimeRustSIMD, 10000) }
+func BenchmarkDot_Wasm_RustSIMD_100000(b *testing.B) { benchmarkWasmDot(b, RuntimeRustSIMD, 100000) }
+func BenchmarkMul_Wasm_RustSIMD_10000(b *testing.B)  { benchmarkWasmMul(b, RuntimeRustSIMD, 10000) }
+
+func BenchmarkSum_Wasm_CSIMD_10000(b *testing.B)  { benchmarkWasmSum(b, RuntimeCSIMD, 10000) }
+func BenchmarkSum_Wasm_CSIMD_100000(b *testing.B) { benchmarkWasmSum(b, RuntimeCSIMD, 100000) }
+func BenchmarkDot_Wasm_CSIMD_10000(b *testing.B)  { benchmarkWasmDot(b, RuntimeCSIMD, 10000) }
+func BenchmarkDot_Wasm_CSIMD_100000(b *testing.B) { benchmarkWasmDot(b, RuntimeCSIMD, 100000) }
+func BenchmarkMul_Wasm_CSIMD_10000(b *testing.B)  { benchmarkWasmMul(b, RuntimeCSIMD, 10000) }
+
 // --- Go Reference Benchmarks (for WASM comparison) ---
 func BenchmarkSum_Go_Ref_100(b *testing.B)    { benchmarkGoSum(b, 100) }
 func BenchmarkSum_Go_Ref_1000(b *testing.B)   { benchmarkGoSum(b, 1000) }
@@ -268,3 +424,191 @@ func BenchmarkOverhead_Go_Ref(b *testing.B) {
 		_ = goSum(data)
 	}
 }
+
+// --- Module sharing and caching ---
+
+// wasmPathOrSkip returns the absolute path of a built module
+func wasmPathOrSkip(t testing.TB, runtime WasmRuntime) string {
+	absPath, err := filepath.Abs(getWasmPath(runtime))
+	if err != nil {
+		t.Skipf("cannot resolve path for %s: %v", runtime, err)
+	}
+	if _, err := os.Stat(absPath); os.IsNotExist(err) {
+		t.Skipf("WASM module not found: %s (run build script first)", absPath)
+	}
+	return absPath
+}
+
+func TestWasmModule_Shared(t *testing.T) {
+	m, err := CompileModuleFromFile(wasmPathOrSkip(t, RuntimeC))
+	if err != nil {
+		t.Fatalf("CompileModuleFromFile failed: %v", err)
+	}
+	defer m.Close()
+
+	a, err := m.NewVectorOps()
+	if err != nil {
+		t.Fatalf("NewVectorOps failed: %v", err)
+	}
+	b, err := m.NewVectorOps()
+	if err != nil {
+		t.Fatalf("NewVectorOps failed: %v", err)
+	}
+
+	// Instances have separate memories
+	x, y := makeData(100), makeData(200)
+	if got := a.Sum(x); math.Abs(got-goSum(x)) > 1e-9 {
+		t.Errorf("a.Sum = %v, want %v", got, goSum(x))
+	}
+	if got := b.Sum(y); math.Abs(got-goSum(y)) > 1e-9 {
+		t.Errorf("b.Sum = %v, want %v", got, goSum(y))
+	}
+
+	// Closing one instance leaves the shared engine usable
+	a.Close()
+	if got := b.Sum(x); math.Abs(got-goSum(x)) > 1e-9 {
+		t.Errorf("b.Sum after a.Close = %v, want %v", got, goSum(x))
+	}
+	b.Close()
+}
+
+func TestWasmModule_CacheDir(t *testing.T) {
+	path := wasmPathOrSkip(t, RuntimeC)
+	dir := t.TempDir()
+	SetModuleCacheDir(dir)
+	defer SetModuleCacheDir("")
+
+	for pass := 0; pass < 2; pass++ {
+		ops, err := NewWasmVectorOpsFromFile(path)
+		if err != nil {
+			t.Fatalf("pass %d: NewWasmVectorOpsFromFile failed: %v", pass, err)
+		}
+		data := makeData(1000)
+		if got := ops.Sum(data); math.Abs(got-goSum(data)) > 1e-9 {
+			t.Errorf("pass %d: Sum = %v, want %v", pass, got, goSum(data))
+		}
+		ops.Close()
+
+		files, _ := filepath.Glob(filepath.Join(dir, "*.cwasm"))
+		if len(files) != 1 {
+			t.Fatalf("pass %d: cache holds %v, want one .cwasm", pass, files)
+		}
+	}
+}
+
+// Startup cost: Cranelift compile vs deserializing a cached artifact
+func BenchmarkLoad_Compile_C(b *testing.B) {
+	benchmarkLoad(b, "")
+}
+
+func BenchmarkLoad_Cached_C(b *testing.B) {
+	benchmarkLoad(b, b.TempDir())
+}
+
+func benchmarkLoad(b *testing.B, dir string) {
+	path := wasmPathOrSkip(b, RuntimeC)
+	SetModuleCacheDir(dir)
+	defer SetModuleCacheDir("")
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		ops, err := NewWasmVectorOpsFromFile(path)
+		if err != nil {
+			b.Fatalf("NewWasmVectorOpsFromFile failed: %v", err)
+		}
+		ops.Close()
+	}
+}
+
+// --- Batched dot products ---
+
+func testDotManyCorrectness(t *testing.T, runtime WasmRuntime) {
+	ops := loadWasmOps(t, runtime)
+	defer ops.Close()
+
+	// Enough rows to need several batches, plus a partial last batch
+	dim := 100
+	rows := 3*ops.Capacity()/dim + 7
+	query, matrix := makeData(dim), makeData(rows*dim)
+	out := make([]float64, rows)
+	if err := ops.DotMany(query, matrix, out); err != nil {
+		t.Fatalf("%s DotMany failed: %v", runtime, err)
+	}
+	for r := range out {
+		if want := goDot(query, matrix[r*dim:(r+1)*dim]); math.Abs(out[r]-want) > 1e-9*want {
+			t.Fatalf("%s DotMany[%d] = %v, want %v", runtime, r, out[r], want)
+		}
+	}
+
+	top, err := ops.TopK(query, matrix, 5)
+	if err != nil {
+		t.Fatalf("%s TopK failed: %v", runtime, err)
+	}
+	if len(top) != 5 {
+		t.Fatalf("%s TopK returned %d matches, want 5", runtime, len(top))
+	}
+	for i, m := range top {
+		if m.Score != out[m.Index] || (i > 0 && m.Score > top[i-1].Score) {
+			t.Fatalf("%s TopK[%d] = %+v out of order or mis-scored", runtime, i, m)
+		}
+	}
+	for r, s := range out {
+		if s > top[4].Score {
+			found := false
+			for _, m := range top {
+				found = found || m.Index == r
+			}
+			if !found {
+				t.Fatalf("%s TopK missed row %d scoring %v", runtime, r, s)
+			}
+		}
+	}
+
+	if err := ops.DotMany(makeData(3), makeData(10), out); err == nil {
+		t.Errorf("%s: expected error for ragged matrix", runtime)
+	}
+	// Without ensure_capacity a query longer than the buffers cannot be scored
+	ops.fnEnsureCapacity = nil
+	if err := ops.DotMany(makeData(ops.Capacity()+1), nil, out); err == nil {
+		t.Errorf("%s: expected error for query longer than capacity", runtime)
+	}
+}
+
+func TestDotManyCorrectness_Rust(t *testing.T)     { testDotManyCorrectness(t, RuntimeRust) }
+func TestDotManyCorrectness_TinyGo(t *testing.T)   { testDotManyCorrectness(t, RuntimeTinyGo) }
+func TestDotManyCorrectness_C(t *testing.T)        { testDotManyCorrectness(t, RuntimeC) }
+func TestDotManyCorrectness_RustSIMD(t *testing.T) { testDotManyCorrectness(t, RuntimeRustSIMD) }
+func TestDotManyCorrectness_CSIMD(t *testing.T)    { testDotManyCorrectness(t, RuntimeCSIMD) }
+
+// benchmarkWasmDotMany scores 10K rows of 128 elements row by row (one call
+// and two copies per row) and as a batch.
+func benchmarkWasmDotMany(b *testing.B, runtime WasmRuntime, batch bool) {
+	ops := loadWasmOps(b, runtime)
+	defer ops.Close()
+
+	const rows, dim = 10000, 128
+	query, matrix := makeData(dim), makeData(rows*dim)
+	out := make([]float64, rows)
+	b.SetBytes(8 * rows * dim)
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if batch {
+			_ = ops.DotMany(query, matrix, out)
+			continue
+		}
+		for r := range out {
+			out[r] = ops.Dot(query, matrix[r*dim:(r+1)*dim])
+		}
+	}
+}
+
+func BenchmarkDotMany_Wasm_Rust_Loop(b *testing.B)    { benchmarkWasmDotMany(b, RuntimeRust, false) }
+func BenchmarkDotMany_Wasm_Rust_Batch(b *testing.B)   { benchmarkWasmDotMany(b, RuntimeRust, true) }
+func BenchmarkDotMany_Wasm_TinyGo_Loop(b *testing.B)  { benchmarkWasmDotMany(b, RuntimeTinyGo, false) }
+func BenchmarkDotMany_Wasm_TinyGo_Batch(b *testing.B) { benchmarkWasmDotMany(b, RuntimeTinyGo, true) }
+func BenchmarkDotMany_Wasm_C_Loop(b *testing.B)       { benchmarkWasmDotMany(b, RuntimeC, false) }
+func BenchmarkDotMany_Wasm_C_Batch(b *testing.B)      { benchmarkWasmDotMany(b, RuntimeC, true) }
+func BenchmarkDotMany_Wasm_CSIMD_Batch(b *testing.B)  { benchmarkWasmDotMany(b, RuntimeCSIMD, true) }
+func BenchmarkDotMany_Wasm_RustSIMD_Batch(b *testing.B) {
+	benchmarkWasmDotMany(b, RuntimeRustSIMD, true)
+}
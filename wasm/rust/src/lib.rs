@@ -1,42 +1,68 @@
 // Rust implementation of vector operations for WASM (Core Module)
 //
 // Uses pre-allocated static buffers to eliminate per-call allocation.
-// The host copies data into these buffers at known offsets.
+// The host copies data into these buffers at known offsets; ensure_capacity
+// grows linear memory and moves the buffers when the host needs more room.
 //
 // This version uses direct #[no_mangle] exports for compatibility with
 // wasmtime's core module API (not Component Model).
+//
+// Built with -C target-feature=+simd128 (vector_simd.wasm), every operation
+// runs on the explicit core::arch::wasm32 kernels in the simd128 module
+// instead of scalar loops.
+//
+// The f32 and i8 reductions (sum_f32, dot_f32, sum_i8, dot_i8) read
+// BUFFER_A and BUFFER_B as arrays of the narrow type, so a buffer holds 2x
+// or 8x capacity elements of it.
 
 #![no_std]
 
+use core::arch::wasm32::{memory_grow, memory_size};
 use core::cell::UnsafeCell;
-use core::ptr::addr_of;
+use core::sync::atomic::{AtomicUsize, Ordering::Relaxed};
 
-// Pre-allocated buffer capacity (100K f64 elements = 800KB per buffer)
-const CAPACITY: usize = 100_000;
+// Initial buffer capacity (100K f64 elements = 800KB per buffer);
+// ensure_capacity grows past it
+const INITIAL_CAPACITY: usize = 100_000;
+const PAGE_SIZE: usize = 65536;
 
-// Wrapper for static mutable buffers - safe in single-threaded WASM
+// Initial storage for each buffer - safe in single-threaded WASM
 #[repr(transparent)]
-struct StaticBuffer(UnsafeCell<[f64; CAPACITY]>);
+struct StaticBuffer(UnsafeCell<[f64; INITIAL_CAPACITY]>);
 
 // SAFETY: WASM is single-threaded, so this is safe
 unsafe impl Sync for StaticBuffer {}
 
 impl StaticBuffer {
     const fn new() -> Self {
-        StaticBuffer(UnsafeCell::new([0.0; CAPACITY]))
+        StaticBuffer(UnsafeCell::new([0.0; INITIAL_CAPACITY]))
+    }
+}
+
+// Current location of a buffer: its static storage until ensure_capacity
+// moves it into grown memory
+struct Buffer(UnsafeCell<*mut f64>);
+
+// SAFETY: WASM is single-threaded, so this is safe
+unsafe impl Sync for Buffer {}
+
+impl Buffer {
+    const fn new(storage: &'static StaticBuffer) -> Self {
+        Buffer(UnsafeCell::new(storage.0.get() as *mut f64))
     }
 
     #[inline]
     fn as_ptr(&self) -> *const f64 {
-        self.0.get() as *const f64
+        self.as_mut_ptr()
     }
 
     #[inline]
     fn as_mut_ptr(&self) -> *mut f64 {
-        self.0.get() as *mut f64
+        unsafe { *self.0.get() }
     }
 
     #[inline]
+    #[cfg_attr(target_feature = "simd128", allow(dead_code))]
     unsafe fn get(&self, i: usize) -> f64 {
         *self.as_ptr().add(i)
     }
@@ -45,40 +71,312 @@ impl StaticBuffer {
     unsafe fn set(&self, i: usize, val: f64) {
         *self.as_mut_ptr().add(i) = val;
     }
+
+    unsafe fn move_to(&self, p: *mut f64) {
+        *self.0.get() = p;
+    }
 }
 
-// Static buffers - allocated once, stable addresses
-static BUFFER_A: StaticBuffer = StaticBuffer::new();
-static BUFFER_B: StaticBuffer = StaticBuffer::new();
-static RESULT: StaticBuffer = StaticBuffer::new();
+static INITIAL_A: StaticBuffer = StaticBuffer::new();
+static INITIAL_B: StaticBuffer = StaticBuffer::new();
+static INITIAL_RESULT: StaticBuffer = StaticBuffer::new();
+
+// Current buffers: stable addresses until ensure_capacity moves them
+static BUFFER_A: Buffer = Buffer::new(&INITIAL_A);
+static BUFFER_B: Buffer = Buffer::new(&INITIAL_B);
+static RESULT: Buffer = Buffer::new(&INITIAL_RESULT);
+static CAPACITY: AtomicUsize = AtomicUsize::new(INITIAL_CAPACITY);
+
+// Start of the grown buffer region, always at the end of linear memory
+static HEAP_BASE: AtomicUsize = AtomicUsize::new(0);
+
+#[inline]
+fn capacity() -> usize {
+    CAPACITY.load(Relaxed)
+}
+
+// Capacity of BUFFER_A and BUFFER_B in elements of T
+#[inline]
+fn narrow_capacity<T>() -> usize {
+    capacity() * core::mem::size_of::<f64>() / core::mem::size_of::<T>()
+}
+
+// SIMD128 kernels: 2 f64 lanes per v128, 4 accumulators to hide add
+// latency. v128_load has no alignment requirement.
+#[cfg(target_feature = "simd128")]
+mod simd128 {
+    use core::arch::wasm32::*;
+
+    #[inline]
+    fn hsum(v: v128) -> f64 {
+        f64x2_extract_lane::<0>(v) + f64x2_extract_lane::<1>(v)
+    }
+
+    #[inline]
+    unsafe fn load(p: *const f64) -> v128 {
+        v128_load(p as *const v128)
+    }
+
+    pub unsafe fn sum(a: *const f64, n: usize) -> f64 {
+        let (mut s0, mut s1, mut s2, mut s3) = (f64x2_splat(0.0), f64x2_splat(0.0), f64x2_splat(0.0), f64x2_splat(0.0));
+        let mut i = 0;
+        while i + 8 <= n {
+            s0 = f64x2_add(s0, load(a.add(i)));
+            s1 = f64x2_add(s1, load(a.add(i + 2)));
+            s2 = f64x2_add(s2, load(a.add(i + 4)));
+            s3 = f64x2_add(s3, load(a.add(i + 6)));
+            i += 8;
+        }
+        while i + 2 <= n {
+            s0 = f64x2_add(s0, load(a.add(i)));
+            i += 2;
+        }
+        let mut s = hsum(f64x2_add(f64x2_add(s0, s1), f64x2_add(s2, s3)));
+        while i < n {
+            s += *a.add(i);
+            i += 1;
+        }
+        s
+    }
+
+    pub unsafe fn dot(a: *const f64, b: *const f64, n: usize) -> f64 {
+        let (mut s0, mut s1, mut s2, mut s3) = (f64x2_splat(0.0), f64x2_splat(0.0), f64x2_splat(0.0), f64x2_splat(0.0));
+        let mut i = 0;
+        while i + 8 <= n {
+            s0 = f64x2_add(s0, f64x2_mul(load(a.add(i)), load(b.add(i))));
+            s1 = f64x2_add(s1, f64x2_mul(load(a.add(i + 2)), load(b.add(i + 2))));
+            s2 = f64x2_add(s2, f64x2_mul(load(a.add(i + 4)), load(b.add(i + 4))));
+            s3 = f64x2_add(s3, f64x2_mul(load(a.add(i + 6)), load(b.add(i + 6))));
+            i += 8;
+        }
+        while i + 2 <= n {
+            s0 = f64x2_add(s0, f64x2_mul(load(a.add(i)), load(b.add(i))));
+            i += 2;
+        }
+        let mut d = hsum(f64x2_add(f64x2_add(s0, s1), f64x2_add(s2, s3)));
+        while i < n {
+            d += *a.add(i) * *b.add(i);
+            i += 1;
+        }
+        d
+    }
+
+    pub unsafe fn mul(a: *const f64, b: *const f64, r: *mut f64, n: usize) {
+        let mut i = 0;
+        while i + 4 <= n {
+            v128_store(r.add(i) as *mut v128, f64x2_mul(load(a.add(i)), load(b.add(i))));
+            v128_store(r.add(i + 2) as *mut v128, f64x2_mul(load(a.add(i + 2)), load(b.add(i + 2))));
+            i += 4;
+        }
+        while i < n {
+            *r.add(i) = *a.add(i) * *b.add(i);
+            i += 1;
+        }
+    }
+
+    pub unsafe fn scale(a: *mut f64, scalar: f64, n: usize) {
+        let s = f64x2_splat(scalar);
+        let mut i = 0;
+        while i + 4 <= n {
+            v128_store(a.add(i) as *mut v128, f64x2_mul(load(a.add(i)), s));
+            v128_store(a.add(i + 2) as *mut v128, f64x2_mul(load(a.add(i + 2)), s));
+            i += 4;
+        }
+        while i < n {
+            *a.add(i) *= scalar;
+            i += 1;
+        }
+    }
+
+    /// Four rows dim apart against one query; each query load serves all four.
+    pub unsafe fn dot4(q: *const f64, m: *const f64, dim: usize, out: *mut f64) {
+        let (r0, r1, r2, r3) = (m, m.add(dim), m.add(2 * dim), m.add(3 * dim));
+        let (mut s0, mut s1, mut s2, mut s3) = (f64x2_splat(0.0), f64x2_splat(0.0), f64x2_splat(0.0), f64x2_splat(0.0));
+        let mut i = 0;
+        while i + 2 <= dim {
+            let x = load(q.add(i));
+            s0 = f64x2_add(s0, f64x2_mul(x, load(r0.add(i))));
+            s1 = f64x2_add(s1, f64x2_mul(x, load(r1.add(i))));
+            s2 = f64x2_add(s2, f64x2_mul(x, load(r2.add(i))));
+            s3 = f64x2_add(s3, f64x2_mul(x, load(r3.add(i))));
+            i += 2;
+        }
+        let (mut d0, mut d1, mut d2, mut d3) = (hsum(s0), hsum(s1), hsum(s2), hsum(s3));
+        while i < dim {
+            let x = *q.add(i);
+            d0 += x * *r0.add(i);
+            d1 += x * *r1.add(i);
+            d2 += x * *r2.add(i);
+            d3 += x * *r3.add(i);
+            i += 1;
+        }
+        *out = d0;
+        *out.add(1) = d1;
+        *out.add(2) = d2;
+        *out.add(3) = d3;
+    }
+
+    // 4 f32 lanes per v128, 4 accumulators
+    #[inline]
+    fn hsum_f32(v: v128) -> f32 {
+        (f32x4_extract_lane::<0>(v) + f32x4_extract_lane::<1>(v))
+            + (f32x4_extract_lane::<2>(v) + f32x4_extract_lane::<3>(v))
+    }
+
+    pub unsafe fn sum_f32(a: *const f32, n: usize) -> f32 {
+        let load = |p: *const f32| v128_load(p as *const v128);
+        let (mut s0, mut s1, mut s2, mut s3) = (f32x4_splat(0.0), f32x4_splat(0.0), f32x4_splat(0.0), f32x4_splat(0.0));
+        let mut i = 0;
+        while i + 16 <= n {
+            s0 = f32x4_add(s0, load(a.add(i)));
+            s1 = f32x4_add(s1, load(a.add(i + 4)));
+            s2 = f32x4_add(s2, load(a.add(i + 8)));
+            s3 = f32x4_add(s3, load(a.add(i + 12)));
+            i += 16;
+        }
+        while i + 4 <= n {
+            s0 = f32x4_add(s0, load(a.add(i)));
+            i += 4;
+        }
+        let mut s = hsum_f32(f32x4_add(f32x4_add(s0, s1), f32x4_add(s2, s3)));
+        while i < n {
+            s += *a.add(i);
+            i += 1;
+        }
+        s
+    }
+
+    pub unsafe fn dot_f32(a: *const f32, b: *const f32, n: usize) -> f32 {
+        let load = |p: *const f32| v128_load(p as *const v128);
+        let (mut s0, mut s1, mut s2, mut s3) = (f32x4_splat(0.0), f32x4_splat(0.0), f32x4_splat(0.0), f32x4_splat(0.0));
+        let mut i = 0;
+        while i + 16 <= n {
+            s0 = f32x4_add(s0, f32x4_mul(load(a.add(i)), load(b.add(i))));
+            s1 = f32x4_add(s1, f32x4_mul(load(a.add(i + 4)), load(b.add(i + 4))));
+            s2 = f32x4_add(s2, f32x4_mul(load(a.add(i + 8)), load(b.add(i + 8))));
+            s3 = f32x4_add(s3, f32x4_mul(load(a.add(i + 12)), load(b.add(i + 12))));
+            i += 16;
+        }
+        while i + 4 <= n {
+            s0 = f32x4_add(s0, f32x4_mul(load(a.add(i)), load(b.add(i))));
+            i += 4;
+        }
+        let mut d = hsum_f32(f32x4_add(f32x4_add(s0, s1), f32x4_add(s2, s3)));
+        while i < n {
+            d += *a.add(i) * *b.add(i);
+            i += 1;
+        }
+        d
+    }
+
+    #[inline]
+    fn hsum_i32(v: v128) -> i64 {
+        i32x4_extract_lane::<0>(v) as i64
+            + i32x4_extract_lane::<1>(v) as i64
+            + i32x4_extract_lane::<2>(v) as i64
+            + i32x4_extract_lane::<3>(v) as i64
+    }
+
+    // i8 lanes are widened pairwise into i32 lanes, which are flushed to the
+    // i64 total every I8_BLOCK elements, long before they can overflow
+    const I8_BLOCK: usize = 65536;
+
+    pub unsafe fn sum_i8(a: *const i8, n: usize) -> i64 {
+        let mut sum = 0;
+        let mut i = 0;
+        while i + 16 <= n {
+            let end = if n - i > I8_BLOCK { i + I8_BLOCK } else { n };
+            let mut s = i32x4_splat(0);
+            while i + 16 <= end {
+                let x = v128_load(a.add(i) as *const v128);
+                s = i32x4_add(s, i32x4_extadd_pairwise_i16x8(i16x8_extadd_pairwise_i8x16(x)));
+                i += 16;
+            }
+            sum += hsum_i32(s);
+        }
+        while i < n {
+            sum += *a.add(i) as i64;
+            i += 1;
+        }
+        sum
+    }
+
+    /// Sign-extends to i16 and multiplies pairs with i32x4.dot_i16x8.
+    pub unsafe fn dot_i8(a: *const i8, b: *const i8, n: usize) -> i64 {
+        let mut dot = 0;
+        let mut i = 0;
+        while i + 16 <= n {
+            let end = if n - i > I8_BLOCK { i + I8_BLOCK } else { n };
+            let (mut d0, mut d1) = (i32x4_splat(0), i32x4_splat(0));
+            while i + 16 <= end {
+                let x = v128_load(a.add(i) as *const v128);
+                let y = v128_load(b.add(i) as *const v128);
+                d0 = i32x4_add(d0, i32x4_dot_i16x8(i16x8_extend_low_i8x16(x), i16x8_extend_low_i8x16(y)));
+                d1 = i32x4_add(d1, i32x4_dot_i16x8(i16x8_extend_high_i8x16(x), i16x8_extend_high_i8x16(y)));
+                i += 16;
+            }
+            dot += hsum_i32(i32x4_add(d0, d1));
+        }
+        while i < n {
+            dot += *a.add(i) as i64 * *b.add(i) as i64;
+            i += 1;
+        }
+        dot
+    }
+}
 
 #[no_mangle]
 pub extern "C" fn sum(len: u32) -> f64 {
-    let len = (len as usize).min(CAPACITY);
-    let mut s = 0.0;
+    let len = (len as usize).min(capacity());
+
+    #[cfg(target_feature = "simd128")]
     unsafe {
-        for i in 0..len {
-            s += BUFFER_A.get(i);
+        simd128::sum(BUFFER_A.as_ptr(), len)
+    }
+
+    #[cfg(not(target_feature = "simd128"))]
+    {
+        let mut s = 0.0;
+        unsafe {
+            for i in 0..len {
+                s += BUFFER_A.get(i);
+            }
         }
+        s
     }
-    s
 }
 
 #[no_mangle]
 pub extern "C" fn dot(len: u32) -> f64 {
-    let len = (len as usize).min(CAPACITY);
-    let mut d = 0.0;
+    let len = (len as usize).min(capacity());
+
+    #[cfg(target_feature = "simd128")]
     unsafe {
-        for i in 0..len {
-            d += BUFFER_A.get(i) * BUFFER_B.get(i);
+        simd128::dot(BUFFER_A.as_ptr(), BUFFER_B.as_ptr(), len)
+    }
+
+    #[cfg(not(target_feature = "simd128"))]
+    {
+        let mut d = 0.0;
+        unsafe {
+            for i in 0..len {
+                d += BUFFER_A.get(i) * BUFFER_B.get(i);
+            }
         }
+        d
     }
-    d
 }
 
 #[no_mangle]
 pub extern "C" fn mul(len: u32) {
-    let len = (len as usize).min(CAPACITY);
+    let len = (len as usize).min(capacity());
+
+    #[cfg(target_feature = "simd128")]
+    unsafe {
+        simd128::mul(BUFFER_A.as_ptr(), BUFFER_B.as_ptr(), RESULT.as_mut_ptr(), len);
+    }
+
+    #[cfg(not(target_feature = "simd128"))]
     unsafe {
         for i in 0..len {
             RESULT.set(i, BUFFER_A.get(i) * BUFFER_B.get(i));
@@ -88,7 +386,14 @@ pub extern "C" fn mul(len: u32) {
 
 #[no_mangle]
 pub extern "C" fn scale(scalar: f64, len: u32) {
-    let len = (len as usize).min(CAPACITY);
+    let len = (len as usize).min(capacity());
+
+    #[cfg(target_feature = "simd128")]
+    unsafe {
+        simd128::scale(BUFFER_A.as_mut_ptr(), scalar, len);
+    }
+
+    #[cfg(not(target_feature = "simd128"))]
     unsafe {
         for i in 0..len {
             BUFFER_A.set(i, BUFFER_A.get(i) * scalar);
@@ -98,34 +403,11 @@ pub extern "C" fn scale(scalar: f64, len: u32) {
 
 #[no_mangle]
 pub extern "C" fn sum_simd(len: u32) -> f64 {
-    let len = (len as usize).min(CAPACITY);
+    let len = (len as usize).min(capacity());
 
     #[cfg(target_feature = "simd128")]
-    {
-        use core::arch::wasm32::*;
-
-        unsafe {
-            let ptr = BUFFER_A.as_ptr();
-            let mut acc = f64x2_splat(0.0);
-            let mut i = 0;
-
-            // Process 2 f64s at a time using SIMD
-            while i + 1 < len {
-                let v = v128_load(ptr.add(i) as *const v128);
-                acc = f64x2_add(acc, v);
-                i += 2;
-            }
-
-            // Reduce SIMD lanes
-            let mut sum = f64x2_extract_lane::<0>(acc) + f64x2_extract_lane::<1>(acc);
-
-            // Handle remainder
-            while i < len {
-                sum += BUFFER_A.get(i);
-                i += 1;
-            }
-            sum
-        }
+    unsafe {
+        simd128::sum(BUFFER_A.as_ptr(), len)
     }
 
     #[cfg(not(target_feature = "simd128"))]
@@ -154,24 +436,227 @@ pub extern "C" fn sum_simd(len: u32) -> f64 {
     }
 }
 
+#[no_mangle]
+pub extern "C" fn sum_f32(len: u32) -> f32 {
+    let len = (len as usize).min(narrow_capacity::<f32>());
+    let a = BUFFER_A.as_ptr() as *const f32;
+
+    #[cfg(target_feature = "simd128")]
+    unsafe {
+        simd128::sum_f32(a, len)
+    }
+
+    #[cfg(not(target_feature = "simd128"))]
+    {
+        let (mut s0, mut s1, mut s2, mut s3) = (0.0f32, 0.0f32, 0.0f32, 0.0f32);
+        unsafe {
+            let mut i = 0;
+            while i + 3 < len {
+                s0 += *a.add(i);
+                s1 += *a.add(i + 1);
+                s2 += *a.add(i + 2);
+                s3 += *a.add(i + 3);
+                i += 4;
+            }
+            while i < len {
+                s0 += *a.add(i);
+                i += 1;
+            }
+        }
+        (s0 + s1) + (s2 + s3)
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn dot_f32(len: u32) -> f32 {
+    let len = (len as usize).min(narrow_capacity::<f32>());
+    let (a, b) = (BUFFER_A.as_ptr() as *const f32, BUFFER_B.as_ptr() as *const f32);
+
+    #[cfg(target_feature = "simd128")]
+    unsafe {
+        simd128::dot_f32(a, b, len)
+    }
+
+    #[cfg(not(target_feature = "simd128"))]
+    {
+        let (mut d0, mut d1, mut d2, mut d3) = (0.0f32, 0.0f32, 0.0f32, 0.0f32);
+        unsafe {
+            let mut i = 0;
+            while i + 3 < len {
+                d0 += *a.add(i) * *b.add(i);
+                d1 += *a.add(i + 1) * *b.add(i + 1);
+                d2 += *a.add(i + 2) * *b.add(i + 2);
+                d3 += *a.add(i + 3) * *b.add(i + 3);
+                i += 4;
+            }
+            while i < len {
+                d0 += *a.add(i) * *b.add(i);
+                i += 1;
+            }
+        }
+        (d0 + d1) + (d2 + d3)
+    }
+}
+
+/// Exact: products and partial sums widen to i64.
+#[no_mangle]
+pub extern "C" fn sum_i8(len: u32) -> i64 {
+    let len = (len as usize).min(narrow_capacity::<i8>());
+    let a = BUFFER_A.as_ptr() as *const i8;
+
+    #[cfg(target_feature = "simd128")]
+    unsafe {
+        simd128::sum_i8(a, len)
+    }
+
+    #[cfg(not(target_feature = "simd128"))]
+    {
+        let mut s = 0i64;
+        unsafe {
+            for i in 0..len {
+                s += *a.add(i) as i64;
+            }
+        }
+        s
+    }
+}
+
+/// Exact: products and partial sums widen to i64.
+#[no_mangle]
+pub extern "C" fn dot_i8(len: u32) -> i64 {
+    let len = (len as usize).min(narrow_capacity::<i8>());
+    let (a, b) = (BUFFER_A.as_ptr() as *const i8, BUFFER_B.as_ptr() as *const i8);
+
+    #[cfg(target_feature = "simd128")]
+    unsafe {
+        simd128::dot_i8(a, b, len)
+    }
+
+    #[cfg(not(target_feature = "simd128"))]
+    {
+        let mut d = 0i64;
+        unsafe {
+            for i in 0..len {
+                d += *a.add(i) as i64 * *b.add(i) as i64;
+            }
+        }
+        d
+    }
+}
+
+/// Scores the query in BUFFER_A (dim elements) against each row of the
+/// row-major matrix in BUFFER_B, one dot product per row into RESULT. Rows
+/// are taken four at a time so each query element is loaded once per four
+/// rows. Only as many rows as fit in BUFFER_B are scored.
+#[no_mangle]
+pub extern "C" fn dot_many(rows: u32, dim: u32) {
+    let dim = dim as usize;
+    if dim == 0 || dim > capacity() {
+        return;
+    }
+    let n = (rows as usize).min(capacity() / dim);
+    let mut r = 0;
+
+    #[cfg(target_feature = "simd128")]
+    unsafe {
+        let (q, m, out) = (BUFFER_A.as_ptr(), BUFFER_B.as_ptr(), RESULT.as_mut_ptr());
+        while r + 3 < n {
+            simd128::dot4(q, m.add(r * dim), dim, out.add(r));
+            r += 4;
+        }
+        while r < n {
+            RESULT.set(r, simd128::dot(q, m.add(r * dim), dim));
+            r += 1;
+        }
+    }
+
+    #[cfg(not(target_feature = "simd128"))]
+    unsafe {
+        while r + 3 < n {
+            let (r0, r1, r2, r3) = (r * dim, (r + 1) * dim, (r + 2) * dim, (r + 3) * dim);
+            let (mut d0, mut d1, mut d2, mut d3) = (0.0, 0.0, 0.0, 0.0);
+            for i in 0..dim {
+                let q = BUFFER_A.get(i);
+                d0 += q * BUFFER_B.get(r0 + i);
+                d1 += q * BUFFER_B.get(r1 + i);
+                d2 += q * BUFFER_B.get(r2 + i);
+                d3 += q * BUFFER_B.get(r3 + i);
+            }
+            RESULT.set(r, d0);
+            RESULT.set(r + 1, d1);
+            RESULT.set(r + 2, d2);
+            RESULT.set(r + 3, d3);
+            r += 4;
+        }
+        while r < n {
+            let row = r * dim;
+            let mut d = 0.0;
+            for i in 0..dim {
+                d += BUFFER_A.get(i) * BUFFER_B.get(row + i);
+            }
+            RESULT.set(r, d);
+            r += 1;
+        }
+    }
+}
+
 #[no_mangle]
 pub extern "C" fn get_buffer_a_offset() -> u32 {
-    addr_of!(BUFFER_A) as u32
+    BUFFER_A.as_ptr() as u32
 }
 
 #[no_mangle]
 pub extern "C" fn get_buffer_b_offset() -> u32 {
-    addr_of!(BUFFER_B) as u32
+    BUFFER_B.as_ptr() as u32
 }
 
 #[no_mangle]
 pub extern "C" fn get_result_offset() -> u32 {
-    addr_of!(RESULT) as u32
+    RESULT.as_ptr() as u32
 }
 
 #[no_mangle]
 pub extern "C" fn get_capacity() -> u32 {
-    CAPACITY as u32
+    capacity() as u32
+}
+
+/// Grows the three buffers to hold at least n elements each and returns the
+/// capacity, unchanged if memory cannot grow. Growth at least doubles so a
+/// run of slightly larger inputs does not grow memory every call. The
+/// buffers move to the end of linear memory and their contents are not
+/// preserved; the host re-queries the get_*_offset exports afterwards.
+#[no_mangle]
+pub extern "C" fn ensure_capacity(n: u32) -> u32 {
+    let (cap, n) = (capacity(), n as usize);
+    if n <= cap {
+        return cap as u32;
+    }
+    // Grown memory is never released, so later grows reuse the region
+    let mut base = HEAP_BASE.load(Relaxed);
+    if base == 0 {
+        base = memory_size::<0>() * PAGE_SIZE;
+        HEAP_BASE.store(base, Relaxed);
+    }
+
+    for want in [n.max(cap.saturating_mul(2)), n] {
+        let end = base as u64 + 3 * 8 * want as u64;
+        let have = (memory_size::<0>() * PAGE_SIZE) as u64;
+        if end > have {
+            let pages = (end - have).div_ceil(PAGE_SIZE as u64);
+            if end > 1 << 32 || memory_grow::<0>(pages as usize) == usize::MAX {
+                continue;
+            }
+        }
+        let a = base as *mut f64;
+        unsafe {
+            BUFFER_A.move_to(a);
+            BUFFER_B.move_to(a.add(want));
+            RESULT.move_to(a.add(2 * want));
+        }
+        CAPACITY.store(want, Relaxed);
+        return want as u32;
+    }
+    cap as u32
 }
 
 // Panic handler for no_std
@@ -1,21 +1,33 @@
 // TinyGo implementation of vector operations for WASM
 //
 // Uses pre-allocated static buffers to eliminate per-call allocation.
-// The host copies data into these buffers at known offsets.
+// The host copies data into these buffers at known offsets; ensure_capacity
+// grows linear memory and moves the buffers when the host needs more room.
 //
 // Build: tinygo build -o vector.wasm -target=wasi -opt=2 main.go
+//
+// The float32 and int8 reductions (sum_f32, dot_f32, sum_i8, dot_i8) read
+// bufferA and bufferB as arrays of the narrow type, so a buffer holds 2x or
+// 8x capacity elements of it.
 
 package main
 
 import "unsafe"
 
-// Pre-allocated buffer capacity (100K f64 elements = 800KB per buffer)
-const capacity = 100_000
+// Initial buffer capacity (100K f64 elements = 800KB per buffer);
+// ensure_capacity grows past it
+const initialCapacity = 100_000
+
+// Static buffers - the initial storage, allocated once
+var initialA, initialB, initialResult [initialCapacity]float64
 
-// Static buffers - allocated once, stable addresses
-var bufferA [capacity]float64
-var bufferB [capacity]float64
-var result [capacity]float64
+// Current buffers: stable addresses until ensure_capacity moves them
+var (
+	bufferA  = initialA[:]
+	bufferB  = initialB[:]
+	result   = initialResult[:]
+	capacity = initialCapacity
+)
 
 // main is required but empty for WASM library
 func main() {}
@@ -89,6 +101,105 @@ func sumSimd(len uint32) float64 {
 	return sum0 + sum1 + sum2 + sum3
 }
 
+// dotMany scores the query in bufferA (dim elements) against each row of
+// the row-major matrix in bufferB, one dot product per row into result.
+// Rows are taken four at a time so each query element is loaded once per
+// four rows. Only as many rows as fit in bufferB are scored.
+//
+//export dot_many
+func dotMany(rows, dim uint32) {
+	d := int(dim)
+	if d == 0 || d > capacity {
+		return
+	}
+	n := int(rows)
+	if n > capacity/d {
+		n = capacity / d
+	}
+	q := bufferA[:d]
+	r := 0
+	for ; r+3 < n; r += 4 {
+		r0 := bufferB[r*d : r*d+d]
+		r1 := bufferB[(r+1)*d : (r+1)*d+d]
+		r2 := bufferB[(r+2)*d : (r+2)*d+d]
+		r3 := bufferB[(r+3)*d : (r+3)*d+d]
+		var d0, d1, d2, d3 float64
+		for i, x := range q {
+			d0 += x * r0[i]
+			d1 += x * r1[i]
+			d2 += x * r2[i]
+			d3 += x * r3[i]
+		}
+		result[r], result[r+1], result[r+2], result[r+3] = d0, d1, d2, d3
+	}
+	for ; r < n; r++ {
+		row := bufferB[r*d : r*d+d]
+		var dot float64
+		for i, x := range q {
+			dot += x * row[i]
+		}
+		result[r] = dot
+	}
+}
+
+// narrowF32 and narrowI8 view the first n elements of a buffer as float32
+// or int8, n clamped to what the buffer holds.
+func narrowF32(buf []float64, n uint32) []float32 {
+	m := int(n)
+	if m > 2*capacity {
+		m = 2 * capacity
+	}
+	return unsafe.Slice((*float32)(unsafe.Pointer(&buf[0])), m)
+}
+
+func narrowI8(buf []float64, n uint32) []int8 {
+	m := int(n)
+	if m > 8*capacity {
+		m = 8 * capacity
+	}
+	return unsafe.Slice((*int8)(unsafe.Pointer(&buf[0])), m)
+}
+
+//export sum_f32
+func sumF32(len uint32) float32 {
+	var s float32
+	for _, x := range narrowF32(bufferA, len) {
+		s += x
+	}
+	return s
+}
+
+//export dot_f32
+func dotF32(len uint32) float32 {
+	a, b := narrowF32(bufferA, len), narrowF32(bufferB, len)
+	var d float32
+	for i, x := range a {
+		d += x * b[i]
+	}
+	return d
+}
+
+// sumI8 and dotI8 are exact: products and partial sums widen to int64.
+//
+//export sum_i8
+func sumI8(len uint32) int64 {
+	var s int64
+	for _, x := range narrowI8(bufferA, len) {
+		s += int64(x)
+	}
+	return s
+}
+
+//export dot_i8
+func dotI8(len uint32) int64 {
+	a, b := narrowI8(bufferA, len), narrowI8(bufferB, len)
+	var d int64
+	for i, x := range a {
+		d += int64(x) * int64(b[i])
+	}
+	return d
+}
+
 //export get_buffer_a_offset
 func getBufferAOffset() uint32 {
 	return uint32(uintptr(unsafe.Pointer(&bufferA[0])))
@@ -106,5 +217,28 @@ func getResultOffset() uint32 {
 
 //export get_capacity
 func getCapacity() uint32 {
-	return capacity
+	return uint32(capacity)
+}
+
+// ensureCapacity grows the three buffers to hold at least n elements each
+// and returns the capacity. Growth at least doubles so a run of slightly
+// larger inputs does not allocate every call. The buffers move and their
+// contents are not preserved; the host re-queries the get_*_offset exports
+// afterwards. With -gc=leaking the old buffers are never freed, which
+// doubling bounds to the size of the live ones.
+//
+//export ensure_capacity
+func ensureCapacity(n uint32) uint32 {
+	want := int(n)
+	if want <= capacity {
+		return uint32(capacity)
+	}
+	if want < 2*capacity {
+		want = 2 * capacity
+	}
+	// One allocation so a failed grow leaves the old buffers in place
+	buf := make([]float64, 3*want)
+	bufferA, bufferB, result = buf[:want:want], buf[want:2*want:2*want], buf[2*want:]
+	capacity = want
+	return uint32(capacity)
 }